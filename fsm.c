@@ -17,8 +17,11 @@
 /******************************************************************************/
 /*** Include files                                                            */
 /******************************************************************************/
-#include "fsm.h"    /* Own header */
-#include <stddef.h> /* for NULL */
+#include "fsm.h"          /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+#include "fsm_trace.h"    /* Tracing hooks, compiled out by default */
+#include "fsm_prof.h"     /* Profiling hooks, compiled out by default */
+#include <stddef.h>       /* for NULL */
 
 /******************************************************************************/
 /*** Local function prototypes                                                */
@@ -30,25 +33,1051 @@
  * Executes the actions function pointer with the argument
  *
  * @param action the fsm action to be performed, can be null
+ * @param i_state State the action belongs to, for the profiler
+ * @param i_slot Kind of the action, for the profiler
+ * @param i_obj Event object of the processed event, null if none
  */
-static void perform_action(const fsm_action_t *const i_action);
+static void perform_action(const fsm_action_t *const i_action,
+                           fsm_state_t i_state,
+                           fsm_prof_slot_t i_slot,
+                           const fsm_event_obj_t *const i_obj);
 
 /**
- * @brief Getting State Configuration from state
+ * @brief Checking the guard condition of a transition
  *
- * @param i_this Current fsm instance
- * @param i_state State to get the config struct from
+ * @param i_guard The guard, set
+ * @param i_state State the transition belongs to, for the profiler
+ * @param i_obj Event object of the processed event, null if none
  *
- * @return The State configuration or null if not defined in the fsm config
+ * @return Result of the guard function
  */
-static fsm_state_cfg_t const *get_state_cfg(const fsm_t *const i_this, fsm_state_t i_state);
+static bool check_guard(const fsm_guard_t *const i_guard, fsm_state_t i_state, const fsm_event_obj_t *const i_obj);
+
+/**
+ * @brief Processing an event on an instance, see fsm_process and fsm_process_obj
+ *
+ * @param io_this The FSM instance
+ * @param i_event The event to process
+ * @param io_obj [optional] Event object of the event, the reference is consumed
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t process_event(fsm_t *const io_this, fsm_event_t i_event, fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Raising an event on an instance, see fsm_raise_prio
+ *
+ * @param io_this The FSM instance
+ * @param i_event The event to raise
+ * @param i_priority Priority of the event
+ * @param io_obj [optional] Event object of the event, the reference is consumed
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t raise_event(fsm_t *const io_this, fsm_event_t i_event, uint8_t i_priority, fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Dropping the raised events of an instance, releasing their objects
+ *
+ * @param io_this The FSM instance
+ */
+static void drop_raised(fsm_t *const io_this);
+
+/**
+ * @brief Forwarding an event to a sub fsm
+ *
+ * @param i_subFsm The sub fsm, can be null
+ * @param i_event The event to process
+ * @param io_obj [optional] Event object of the event, referenced by the caller
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t forward_sub_fsm(const fsm_t *const i_subFsm, fsm_event_t i_event, fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Dropping a reference to an event object
+ *
+ * @param io_obj The event object, can be null
+ */
+static void release_obj(fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Running a state on an event, see fsm_run_state
+ *
+ * fsm_run_state wraps it into a profiler run frame.
+ */
+static fsm_RC_t run_state(const fsm_cfg_t *const i_config,
+                          const fsm_state_cfg_t *const i_currStateCfg,
+                          bool *const io_isFirstRun,
+                          fsm_event_t i_event,
+                          fsm_event_obj_t *const io_obj,
+                          fsm_state_cfg_t const **const o_nextStateCfg,
+                          fsm_state_t *const io_subStates,
+                          uint32_t i_subDepth,
+                          fsm_region_state_t *const io_regions);
+
+/**
+ * @brief Processing one event on an instance and saving the state change
+ *
+ * @param io_this The FSM instance
+ * @param io_stateCfg Configuration of the current state, set to the next one
+ * @param i_event The event to process
+ * @param io_obj [optional] Event object of the event, referenced by the caller
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t process_step(fsm_t *const io_this,
+                             const fsm_state_cfg_t **const io_stateCfg,
+                             fsm_event_t i_event,
+                             fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Processing the raised events of an instance by priority
+ *
+ * @param io_this The FSM instance
+ * @param io_stateCfg Configuration of the current state, set to the next one
+ *
+ * @return FSM_RC_OK on success, error code of the failed event otherwise
+ */
+static fsm_RC_t drain_raised(fsm_t *const io_this, const fsm_state_cfg_t **const io_stateCfg);
+
+/**
+ * @brief Taking the raised event of the highest priority out of the queue
+ *
+ * @param io_this The FSM instance, at least one event raised
+ * @param o_obj Event object of the event, the reference is passed on
+ *
+ * @return The event
+ */
+static fsm_event_t pop_raised(fsm_t *const io_this, fsm_event_obj_t **const o_obj);
+
+/**
+ * @brief Reporting the lookup of an event to the hooks of an instance
+ *
+ * @param i_this The FSM instance
+ * @param i_stateIndex Index of the current state in the states array
+ * @param i_event The event
+ */
+static void hooks_lookup(const fsm_t *const i_this, uint32_t i_stateIndex, fsm_event_t i_event);
+
+/**
+ * @brief Reporting a processed event to the hooks of an instance
+ *
+ * @param i_this The FSM instance after processing
+ * @param i_event The event passed to fsm_process
+ * @param i_res Result of processing the event
+ */
+static void hooks_processed(const fsm_t *const i_this, fsm_event_t i_event, fsm_RC_t i_res);
+
+/**
+ * @brief Getting the transition of a state for an event
+ *
+ * Uses the dispatch table if built, otherwise searches the transitions array.
+ * The first transition defined for the event wins.
+ *
+ * @param i_config The fsm configuration
+ * @param i_stateCfg State configuration the event is processed in
+ * @param i_event The event to look up
+ * @param o_toStateCfg Set to the target state configuration, null if undefined
+ *
+ * @return The transition configuration or null if the event is not handled
+ */
+static fsm_transition_cfg_t const *get_transition_cfg(const fsm_cfg_t *const i_config,
+                                                      const fsm_state_cfg_t *const i_stateCfg,
+                                                      fsm_event_t i_event,
+                                                      fsm_state_cfg_t const **const o_toStateCfg);
+
+/**
+ * @brief Building the dispatch table of a configuration
+ *
+ * @param i_config The fsm configuration, dispatch storage must be non null
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the
+ *         configuration does not fit into the table
+ */
+static fsm_RC_t build_dispatch(const fsm_cfg_t *const i_config);
+
+/**
+ * @brief Checking a configuration and its sub configurations
+ *
+ * @param i_config The fsm configuration
+ * @param i_depth Nesting level of the configuration, 0 for an instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t prepare_config(const fsm_cfg_t *const i_config, uint32_t i_depth);
+
+/**
+ * @brief Processing an event in the sub configuration of a state
+ *
+ * @param i_stateCfg The state whose sub configuration runs, if any
+ * @param i_isEntered true if the state was just entered, restarts the sub
+ *                    configuration in its initial state
+ * @param i_event The event to process
+ * @param io_obj [optional] Event object of the event, referenced by the caller
+ * @param io_subStates Inline states from the level of the sub configuration on
+ * @param i_subDepth Number of inline states left
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t run_sub_config(const fsm_state_cfg_t *const i_stateCfg,
+                               bool i_isEntered,
+                               fsm_event_t i_event,
+                               fsm_event_obj_t *const io_obj,
+                               fsm_state_t *const io_subStates,
+                               uint32_t i_subDepth);
+
+/**
+ * @brief Processing an event in the orthogonal regions of a state
+ *
+ * All regions process the event, on the runner of the regions if set.
+ *
+ * @param i_stateCfg The state whose regions run, if any
+ * @param io_regions Inline states of the regions, null if the caller has none
+ * @param i_isEntered true if the state was just entered, restarts the regions
+ * @param i_event The event to process
+ * @param io_obj [optional] Event object of the event, referenced by the caller
+ *
+ * @return FSM_RC_OK on success, error code of the first failing region in
+ *         array order otherwise
+ */
+static fsm_RC_t run_regions(const fsm_state_cfg_t *const i_stateCfg,
+                            fsm_region_state_t *const io_regions,
+                            bool i_isEntered,
+                            fsm_event_t i_event,
+                            fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Restarting the regions of a state in their initial states
+ *
+ * @param i_stateCfg The state whose regions restart, if any
+ * @param o_regions Inline states of the regions
+ */
+static void restart_regions(const fsm_state_cfg_t *const i_stateCfg, fsm_region_state_t *const o_regions);
 
 /******************************************************************************/
 /*** API function implementation                                              */
 /******************************************************************************/
+fsm_RC_t fsm_cfg_prepare(const fsm_cfg_t *const i_config)
+{
+  return prepare_config(i_config, 0);
+}
+
 fsm_RC_t fsm_init(fsm_t *const io_this, const fsm_cfg_t *const i_config)
 {
-  if (io_this == NULL || i_config == NULL)
+  if (io_this == NULL || i_config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_RC_t res = fsm_cfg_prepare(i_config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  io_this->config = i_config;
+  io_this->hooks = NULL;
+  io_this->isProcessing = false;
+  io_this->raisedCount = 0;
+  return fsm_reset(io_this);
+}
+
+fsm_RC_t fsm_reset(fsm_t *const io_this)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* The current state is left without exit action, e.g. stop its timers */
+  fsm_hooks_reset(io_this);
+
+  io_this->currentState = io_this->config->initialState;
+  io_this->isFirstRun = true;
+  drop_raised(io_this);
+
+  /* Initial states of the regions and the nested sub configurations */
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(io_this->config, io_this->currentState);
+  if (stateCfg != NULL)
+  {
+    restart_regions(stateCfg, io_this->regionStates);
+  }
+  for (uint32_t level = 0; level < FSM_MAX_DEPTH && stateCfg != NULL && stateCfg->subCfg != NULL; level++)
+  {
+    io_this->subStates[level] = stateCfg->subCfg->initialState;
+    stateCfg = fsm_get_state_cfg(stateCfg->subCfg, io_this->subStates[level]);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_process(fsm_t *const io_this, fsm_event_t i_event)
+{
+  return process_event(io_this, i_event, NULL);
+}
+
+fsm_RC_t fsm_process_many(fsm_t *const io_this,
+                          const fsm_event_t *const i_events,
+                          size_t i_eventsCount,
+                          size_t *const o_processed)
+{
+  if (o_processed != NULL)
+  {
+    *o_processed = 0;
+  }
+  if (io_this == NULL || i_events == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  size_t i = 0;
+  fsm_RC_t res = FSM_RC_OK;
+  if (io_this->isProcessing == true)
+  {
+    /* Called from an action, the events run after the current one */
+    for (; i < i_eventsCount; i++)
+    {
+      res = fsm_raise(io_this, i_events[i]);
+      if (res != FSM_RC_OK)
+      {
+        break;
+      }
+    }
+  }
+  else
+  {
+    /* Get the current state cfg once for the whole batch */
+    const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(io_this->config, io_this->currentState);
+    if (stateCfg == NULL)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+
+    io_this->isProcessing = true;
+    for (; i < i_eventsCount; i++)
+    {
+      res = process_step(io_this, &stateCfg, i_events[i], NULL);
+      if (res == FSM_RC_OK && io_this->raisedCount > 0)
+      {
+        res = drain_raised(io_this, &stateCfg);
+      }
+      if (io_this->hooks != NULL)
+      {
+        hooks_processed(io_this, i_events[i], res);
+      }
+      if (res != FSM_RC_OK)
+      {
+        break;
+      }
+    }
+    io_this->isProcessing = false;
+    if (res != FSM_RC_OK)
+    {
+      drop_raised(io_this);
+    }
+  }
+
+  if (o_processed != NULL)
+  {
+    *o_processed = i;
+  }
+  return res;
+}
+
+fsm_RC_t fsm_raise(fsm_t *const io_this, fsm_event_t i_event)
+{
+  return fsm_raise_prio(io_this, i_event, FSM_RAISE_PRIO_DEFAULT);
+}
+
+fsm_RC_t fsm_raise_prio(fsm_t *const io_this, fsm_event_t i_event, uint8_t i_priority)
+{
+  return raise_event(io_this, i_event, i_priority, NULL);
+}
+
+fsm_RC_t fsm_drain_raised(fsm_t *const io_this, fsm_RC_t i_res, fsm_step_func_t i_step)
+{
+  if (io_this == NULL || i_step == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Same order as drain_raised, without the modules the dispatcher rejects */
+  fsm_RC_t res = i_res;
+  while (res == FSM_RC_OK && io_this->raisedCount > 0)
+  {
+    fsm_event_obj_t *obj;
+    fsm_event_t event = pop_raised(io_this, &obj);
+    res = i_step(io_this, event, obj);
+    release_obj(obj);
+  }
+  if (res != FSM_RC_OK)
+  {
+    drop_raised(io_this);
+  }
+  return res;
+}
+
+fsm_RC_t fsm_process_sub(fsm_t *const io_subFsm, fsm_event_t i_event, fsm_event_obj_t *const io_obj)
+{
+  return forward_sub_fsm(io_subFsm, i_event, io_obj);
+}
+
+fsm_RC_t fsm_get_sub_state(const fsm_t *const i_this, uint32_t i_level, fsm_state_t *const o_state)
+{
+  if (i_this == NULL || i_this->config == NULL || o_state == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Follow the active states down to the level */
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(i_this->config, i_this->currentState);
+  for (uint32_t level = 0; level < FSM_MAX_DEPTH && stateCfg != NULL && stateCfg->subCfg != NULL; level++)
+  {
+    if (level == i_level)
+    {
+      *o_state = i_this->subStates[level];
+      return FSM_RC_OK;
+    }
+    stateCfg = fsm_get_state_cfg(stateCfg->subCfg, i_this->subStates[level]);
+  }
+  return FSM_RC_ERROR_INVALID_ARG;
+}
+
+fsm_RC_t fsm_get_region_state(const fsm_t *const i_this, uint32_t i_region, fsm_state_t *const o_state)
+{
+  if (i_this == NULL || i_this->config == NULL || o_state == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(i_this->config, i_this->currentState);
+  if (stateCfg == NULL || stateCfg->regions == NULL || i_region >= stateCfg->regions->count)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  *o_state = i_this->regionStates[i_region].state;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_region_run(fsm_region_job_t *const io_job)
+{
+  if (io_job == NULL || io_job->config == NULL || io_job->region == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Entering the parent state restarts the region */
+  fsm_region_state_t *region = io_job->region;
+  if (io_job->isEntered == true)
+  {
+    region->state = io_job->config->initialState;
+    region->isFirstRun = true;
+  }
+
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(io_job->config, region->state);
+  const fsm_state_cfg_t *nextStateCfg = NULL;
+  fsm_RC_t res = FSM_RC_ERROR_INVALID_CONFIG;
+  if (stateCfg != NULL)
+  {
+    res = fsm_run_state(io_job->config, stateCfg, &region->isFirstRun, io_job->event, io_job->obj, &nextStateCfg,
+                        NULL, 0, NULL);
+  }
+  if (res == FSM_RC_OK)
+  {
+    region->state = nextStateCfg->state;
+  }
+  io_job->res = res;
+  return res;
+}
+
+/******************************************************************************/
+/*** Internal function implementation                                         */
+/******************************************************************************/
+uint32_t fsm_state_enum_count(const fsm_cfg_t *const i_config)
+{
+  return (i_config->stateEnumCount != 0) ? i_config->stateEnumCount : (uint32_t)FSM_STATE_COUNT;
+}
+
+uint32_t fsm_event_enum_count(const fsm_cfg_t *const i_config)
+{
+  return (i_config->eventEnumCount != 0) ? i_config->eventEnumCount : (uint32_t)FSM_EVENT_COUNT;
+}
+
+fsm_RC_t fsm_process_obj(fsm_t *const io_this, fsm_event_t i_event, fsm_event_obj_t *const io_obj)
+{
+  return process_event(io_this, i_event, io_obj);
+}
+
+bool fsm_action_is_set(const fsm_action_t *const i_action)
+{
+  return i_action->func != NULL || i_action->eventFunc != NULL;
+}
+
+bool fsm_guard_is_set(const fsm_guard_t *const i_guard)
+{
+  return i_guard->func != NULL || i_guard->eventFunc != NULL;
+}
+
+bool fsm_state_uses_event_obj(const fsm_state_cfg_t *const i_stateCfg)
+{
+  if (i_stateCfg->entryAction.eventFunc != NULL || i_stateCfg->doAction.eventFunc != NULL ||
+      i_stateCfg->exitAction.eventFunc != NULL)
+  {
+    return true;
+  }
+  for (uint32_t t = 0; t < i_stateCfg->transitionsCount; t++)
+  {
+    if (i_stateCfg->transitions[t].guard.eventFunc != NULL || i_stateCfg->transitions[t].action.eventFunc != NULL)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void fsm_hook_add(fsm_t *const io_fsm, fsm_hook_t *const io_hook)
+{
+  (void)fsm_hook_remove(io_fsm, io_hook->ops);
+  io_hook->next = io_fsm->hooks;
+  io_fsm->hooks = io_hook;
+}
+
+fsm_hook_t *fsm_hook_remove(fsm_t *const io_fsm, const fsm_hook_ops_t *const i_ops)
+{
+  for (fsm_hook_t **link = &io_fsm->hooks; *link != NULL; link = &(*link)->next)
+  {
+    fsm_hook_t *hook = *link;
+    if (hook->ops == i_ops)
+    {
+      *link = hook->next;
+      hook->next = NULL;
+      return hook;
+    }
+  }
+  return NULL;
+}
+
+fsm_hook_t *fsm_hook_find(const fsm_t *const i_fsm, const fsm_hook_ops_t *const i_ops)
+{
+  for (fsm_hook_t *hook = i_fsm->hooks; hook != NULL; hook = hook->next)
+  {
+    if (hook->ops == i_ops)
+    {
+      return hook;
+    }
+  }
+  return NULL;
+}
+
+void fsm_hooks_enter(fsm_t *const io_fsm, const fsm_state_cfg_t *const i_stateCfg)
+{
+  for (fsm_hook_t *hook = io_fsm->hooks; hook != NULL; hook = hook->next)
+  {
+    if (hook->ops->enter != NULL)
+    {
+      hook->ops->enter(hook, io_fsm, i_stateCfg);
+    }
+  }
+}
+
+void fsm_hooks_reset(fsm_t *const io_fsm)
+{
+  for (fsm_hook_t *hook = io_fsm->hooks; hook != NULL; hook = hook->next)
+  {
+    if (hook->ops->reset != NULL)
+    {
+      hook->ops->reset(hook, io_fsm);
+    }
+  }
+}
+
+fsm_state_cfg_t const *fsm_get_state_cfg(const fsm_cfg_t *const i_config, fsm_state_t i_state)
+{
+  if (i_config == NULL)
+  {
+    return NULL;
+  }
+
+  const fsm_dispatch_t *dispatch = i_config->dispatch;
+  if (dispatch != NULL && dispatch->isBuilt == true)
+  {
+    if ((uint32_t)i_state >= dispatch->stateIndexCount)
+    {
+      return NULL;
+    }
+    fsm_index_t index = dispatch->stateIndex[i_state];
+    if (index == FSM_INDEX_NONE)
+    {
+      return NULL;
+    }
+    return &i_config->states[index];
+  }
+
+  const fsm_packed_t *packed = i_config->packed;
+  if (dispatch == NULL && packed != NULL)
+  {
+    if ((uint32_t)i_state >= packed->stateIndexCount || packed->stateIndex[i_state] == FSM_INDEX_NONE)
+    {
+      return NULL;
+    }
+    return &i_config->states[packed->stateIndex[i_state]];
+  }
+
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    if (i_config->states[i].state == i_state)
+    {
+      return &i_config->states[i];
+    }
+  }
+  return NULL;
+}
+
+fsm_RC_t fsm_run_state(const fsm_cfg_t *const i_config,
+                       const fsm_state_cfg_t *const i_currStateCfg,
+                       bool *const io_isFirstRun,
+                       fsm_event_t i_event,
+                       fsm_event_obj_t *const io_obj,
+                       fsm_state_cfg_t const **const o_nextStateCfg,
+                       fsm_state_t *const io_subStates,
+                       uint32_t i_subDepth,
+                       fsm_region_state_t *const io_regions)
+{
+  FSM_PROF_ENTER(i_config, i_currStateCfg->state);
+  fsm_RC_t res = run_state(i_config, i_currStateCfg, io_isFirstRun, i_event, io_obj, o_nextStateCfg,
+                           io_subStates, i_subDepth, io_regions);
+  FSM_PROF_LEAVE();
+  return res;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static fsm_RC_t run_state(const fsm_cfg_t *const i_config,
+                          const fsm_state_cfg_t *const i_currStateCfg,
+                          bool *const io_isFirstRun,
+                          fsm_event_t i_event,
+                          fsm_event_obj_t *const io_obj,
+                          fsm_state_cfg_t const **const o_nextStateCfg,
+                          fsm_state_t *const io_subStates,
+                          uint32_t i_subDepth,
+                          fsm_region_state_t *const io_regions)
+{
+  /* Get the Matching transistion cfg */
+  const fsm_state_cfg_t *toStateCfg = NULL;
+  const fsm_transition_cfg_t *transitionCfg = get_transition_cfg(i_config, i_currStateCfg, i_event, &toStateCfg);
+
+  /* Get next state cfg and transition action */
+  const fsm_state_cfg_t *nextStateCfg = NULL;
+  fsm_action_t const *actionTransition = NULL;
+  if (transitionCfg != NULL)
+  {
+    /* Transition defined for event */
+    bool guardCond = true;
+    /* Check Gurad condition */
+    if (fsm_guard_is_set(&transitionCfg->guard) == true)
+    {
+      guardCond = check_guard(&transitionCfg->guard, i_currStateCfg->state, io_obj);
+    }
+
+    if (guardCond == true)
+    {
+      /* Save next state cfg and transition action */
+      actionTransition = &transitionCfg->action;
+      nextStateCfg = toStateCfg;
+      if (nextStateCfg == NULL)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+      FSM_TRACE_EVENT(i_config, (uint32_t)(i_currStateCfg - i_config->states), i_currStateCfg->state, i_event,
+                      nextStateCfg->state,
+                      fsm_guard_is_set(&transitionCfg->guard) ? FSM_TRACE_GUARD_PASSED : FSM_TRACE_NO_GUARD);
+    }
+    else
+    {
+      /* Guard condition false, stay in current state */
+      nextStateCfg = i_currStateCfg;
+      FSM_TRACE_EVENT(i_config, (uint32_t)(i_currStateCfg - i_config->states), i_currStateCfg->state, i_event,
+                      nextStateCfg->state, FSM_TRACE_GUARD_REJECTED);
+    }
+  }
+  else
+  {
+    /* No transition defined for the current event, stay in the current state */
+    nextStateCfg = i_currStateCfg;
+    FSM_TRACE_EVENT(i_config, (uint32_t)(i_currStateCfg - i_config->states), i_currStateCfg->state, i_event,
+                    nextStateCfg->state, FSM_TRACE_NO_TRANSITION);
+  }
+
+  /* Check if it is the first run */
+  bool wasFirstRun = *io_isFirstRun;
+  if (*io_isFirstRun == true)
+  {
+    /* First run, perform entry action of initial state */
+    perform_action(&(i_currStateCfg->entryAction), i_currStateCfg->state, FSM_PROF_ENTRY, io_obj);
+    *io_isFirstRun = false;
+  }
+
+  /* Perfrom the actions */
+  if (i_currStateCfg == nextStateCfg)
+  {
+    /* No state change, perform do action */
+    perform_action(&(i_currStateCfg->doAction), i_currStateCfg->state, FSM_PROF_DO, io_obj);
+
+    /* Perform transition action if any */
+    perform_action(actionTransition, i_currStateCfg->state, FSM_PROF_TRANSITION, io_obj);
+
+    /* Process event in the sub fsm */
+    fsm_RC_t res = forward_sub_fsm(i_currStateCfg->subFsm, i_event, io_obj);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+
+    /* Process event in the sub configuration, started on the first run */
+    res = run_sub_config(i_currStateCfg, wasFirstRun, i_event, io_obj, io_subStates, i_subDepth);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+
+    /* Process event in the regions, restarted on the first run */
+    res = run_regions(i_currStateCfg, io_regions, wasFirstRun, i_event, io_obj);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  else
+  {
+    /* State change, perform do and exit of current state, */
+    /* transition action, entry and do action of next state */
+    perform_action(&(i_currStateCfg->doAction), i_currStateCfg->state, FSM_PROF_DO, io_obj);
+    perform_action(&(i_currStateCfg->exitAction), i_currStateCfg->state, FSM_PROF_EXIT, io_obj);
+    perform_action(actionTransition, i_currStateCfg->state, FSM_PROF_TRANSITION, io_obj);
+    perform_action(&(nextStateCfg->entryAction), nextStateCfg->state, FSM_PROF_ENTRY, io_obj);
+    perform_action(&(nextStateCfg->doAction), nextStateCfg->state, FSM_PROF_DO, io_obj);
+
+    /* Process the entering event in the sub fsm linked to the next state */
+    fsm_RC_t res = forward_sub_fsm(nextStateCfg->subFsm, i_event, io_obj);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+
+    /* Start the sub configuration of the entered state with the event */
+    res = run_sub_config(nextStateCfg, true, i_event, io_obj, io_subStates, i_subDepth);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+
+    /* Start the regions of the entered state with the event */
+    res = run_regions(nextStateCfg, io_regions, true, i_event, io_obj);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+
+  *o_nextStateCfg = nextStateCfg;
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t process_step(fsm_t *const io_this,
+                             const fsm_state_cfg_t **const io_stateCfg,
+                             fsm_event_t i_event,
+                             fsm_event_obj_t *const io_obj)
+{
+  /* Sub fsms processed by the previous event changed the traced instance */
+  FSM_TRACE_INSTANCE(io_this);
+  const fsm_state_cfg_t *currStateCfg = *io_stateCfg;
+  const fsm_state_cfg_t *nextStateCfg = NULL;
+  bool wasFirstRun = io_this->isFirstRun;
+
+  /* E.g. count the lookup for profile guided reordering */
+  if (io_this->hooks != NULL)
+  {
+    hooks_lookup(io_this, (uint32_t)(currStateCfg - io_this->config->states), i_event);
+  }
+
+  fsm_RC_t res = fsm_run_state(io_this->config, currStateCfg, &io_this->isFirstRun, i_event, io_obj, &nextStateCfg,
+                               io_this->subStates, FSM_MAX_DEPTH, io_this->regionStates);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  /* Save the state change, actions of the next event may read it */
+  io_this->currentState = nextStateCfg->state;
+  *io_stateCfg = nextStateCfg;
+
+  /* E.g. arm the timed transitions of an entered state */
+  if (io_this->hooks != NULL && (wasFirstRun == true || nextStateCfg != currStateCfg))
+  {
+    fsm_hooks_enter(io_this, nextStateCfg);
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t drain_raised(fsm_t *const io_this, const fsm_state_cfg_t **const io_stateCfg)
+{
+  /* Iterative, events raised meanwhile are inserted by priority */
+  while (io_this->raisedCount > 0)
+  {
+    fsm_event_obj_t *obj;
+    fsm_event_t event = pop_raised(io_this, &obj);
+    fsm_RC_t res = process_step(io_this, io_stateCfg, event, obj);
+    release_obj(obj);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_event_t pop_raised(fsm_t *const io_this, fsm_event_obj_t **const o_obj)
+{
+  fsm_event_t event = io_this->raised[0];
+  *o_obj = io_this->raisedObjs[0];
+  io_this->raisedCount--;
+  for (uint32_t i = 0; i < io_this->raisedCount; i++)
+  {
+    io_this->raised[i] = io_this->raised[i + 1u];
+    io_this->raisedPrio[i] = io_this->raisedPrio[i + 1u];
+    io_this->raisedObjs[i] = io_this->raisedObjs[i + 1u];
+  }
+  return event;
+}
+
+static void hooks_lookup(const fsm_t *const i_this, uint32_t i_stateIndex, fsm_event_t i_event)
+{
+  for (fsm_hook_t *hook = i_this->hooks; hook != NULL; hook = hook->next)
+  {
+    if (hook->ops->lookup != NULL)
+    {
+      hook->ops->lookup(hook, i_this, i_stateIndex, i_event);
+    }
+  }
+}
+
+static void hooks_processed(const fsm_t *const i_this, fsm_event_t i_event, fsm_RC_t i_res)
+{
+  for (fsm_hook_t *hook = i_this->hooks; hook != NULL; hook = hook->next)
+  {
+    if (hook->ops->processed != NULL)
+    {
+      hook->ops->processed(hook, i_this, i_event, i_res);
+    }
+  }
+}
+
+static void perform_action(const fsm_action_t *const i_action,
+                           fsm_state_t i_state,
+                           fsm_prof_slot_t i_slot,
+                           const fsm_event_obj_t *const i_obj)
+{
+  if (i_action != NULL)
+  {
+    if (i_action->eventFunc != NULL)
+    {
+      FSM_PROF_CALL(i_state, i_slot, i_action->eventFunc(i_action->arg, i_obj));
+    }
+    else if (i_action->func != NULL)
+    {
+      FSM_PROF_CALL(i_state, i_slot, i_action->func(i_action->arg));
+    }
+  }
+}
+
+static bool check_guard(const fsm_guard_t *const i_guard, fsm_state_t i_state, const fsm_event_obj_t *const i_obj)
+{
+  bool guardCond = true;
+  if (i_guard->eventFunc != NULL)
+  {
+    FSM_PROF_CALL(i_state, FSM_PROF_GUARD, guardCond = i_guard->eventFunc(i_guard->arg, i_obj));
+  }
+  else
+  {
+    FSM_PROF_CALL(i_state, FSM_PROF_GUARD, guardCond = i_guard->func(i_guard->arg));
+  }
+  return guardCond;
+}
+
+static fsm_RC_t process_event(fsm_t *const io_this, fsm_event_t i_event, fsm_event_obj_t *const io_obj)
+{
+  if (io_this == NULL || io_this->config == NULL)
+  {
+    release_obj(io_obj);
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Called from an action, the event runs after the current one */
+  if (io_this->isProcessing == true)
+  {
+    return raise_event(io_this, i_event, FSM_RAISE_PRIO_DEFAULT, io_obj);
+  }
+
+  /* Get the current state cfg */
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(io_this->config, io_this->currentState);
+  if (stateCfg == NULL)
+  {
+    release_obj(io_obj);
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* Run to completion, the raised events are processed before returning */
+  io_this->isProcessing = true;
+  fsm_RC_t res = process_step(io_this, &stateCfg, i_event, io_obj);
+  release_obj(io_obj);
+  if (res == FSM_RC_OK && io_this->raisedCount > 0)
+  {
+    res = drain_raised(io_this, &stateCfg);
+  }
+  io_this->isProcessing = false;
+  if (res != FSM_RC_OK)
+  {
+    drop_raised(io_this);
+  }
+
+  if (io_this->hooks != NULL)
+  {
+    hooks_processed(io_this, i_event, res);
+  }
+  return res;
+}
+
+static fsm_RC_t raise_event(fsm_t *const io_this, fsm_event_t i_event, uint8_t i_priority, fsm_event_obj_t *const io_obj)
+{
+  if (io_this == NULL)
+  {
+    release_obj(io_obj);
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Not running, nothing to complete first */
+  if (io_this->isProcessing == false)
+  {
+    return process_event(io_this, i_event, io_obj);
+  }
+
+  if (io_this->raisedCount >= FSM_RAISE_QUEUE_SIZE)
+  {
+    release_obj(io_obj);
+    return FSM_RC_ERROR_QUEUE_FULL;
+  }
+
+  /* Insert behind the pending events of the same or a higher priority */
+  uint32_t pos = io_this->raisedCount;
+  while (pos > 0 && io_this->raisedPrio[pos - 1u] < i_priority)
+  {
+    io_this->raised[pos] = io_this->raised[pos - 1u];
+    io_this->raisedPrio[pos] = io_this->raisedPrio[pos - 1u];
+    io_this->raisedObjs[pos] = io_this->raisedObjs[pos - 1u];
+    pos--;
+  }
+  io_this->raised[pos] = i_event;
+  io_this->raisedPrio[pos] = i_priority;
+  io_this->raisedObjs[pos] = io_obj;
+  io_this->raisedCount++;
+  return FSM_RC_OK;
+}
+
+static void drop_raised(fsm_t *const io_this)
+{
+  for (uint32_t i = 0; i < io_this->raisedCount; i++)
+  {
+    release_obj(io_this->raisedObjs[i]);
+  }
+  io_this->raisedCount = 0;
+}
+
+static fsm_RC_t forward_sub_fsm(const fsm_t *const i_subFsm, fsm_event_t i_event, fsm_event_obj_t *const io_obj)
+{
+  if (i_subFsm == NULL)
+  {
+    return FSM_RC_OK;
+  }
+
+  /* The sub fsm consumes a reference of its own, e.g. when it queues the event */
+  if (io_obj != NULL)
+  {
+    ((const fsm_event_head_t *)(const void *)io_obj)->retain(io_obj);
+  }
+  return process_event((fsm_t *)i_subFsm, i_event, io_obj);
+}
+
+static void release_obj(fsm_event_obj_t *const io_obj)
+{
+  if (io_obj != NULL)
+  {
+    ((const fsm_event_head_t *)(const void *)io_obj)->release(io_obj);
+  }
+}
+
+static fsm_transition_cfg_t const *get_transition_cfg(const fsm_cfg_t *const i_config,
+                                                      const fsm_state_cfg_t *const i_stateCfg,
+                                                      fsm_event_t i_event,
+                                                      fsm_state_cfg_t const **const o_toStateCfg)
+{
+  *o_toStateCfg = NULL;
+
+  const fsm_dispatch_t *dispatch = i_config->dispatch;
+  if (dispatch != NULL && dispatch->isBuilt == true)
+  {
+    if ((uint32_t)i_event >= dispatch->rowSize)
+    {
+      return NULL;
+    }
+    uint32_t row = (uint32_t)(i_stateCfg - i_config->states);
+    const fsm_dispatch_cell_t *cell = &dispatch->cells[row * dispatch->rowSize + (uint32_t)i_event];
+    if (cell->transition == FSM_INDEX_NONE)
+    {
+      return NULL;
+    }
+    if (cell->toState != FSM_INDEX_NONE)
+    {
+      *o_toStateCfg = &i_config->states[cell->toState];
+    }
+    return &i_stateCfg->transitions[cell->transition];
+  }
+
+  const fsm_packed_t *packed = i_config->packed;
+  if (dispatch == NULL && packed != NULL)
+  {
+    if ((uint32_t)i_event >= packed->rowSize)
+    {
+      return NULL;
+    }
+    fsm_index_t row = (fsm_index_t)(i_stateCfg - i_config->states);
+    const fsm_packed_cell_t *cell = &packed->cells[packed->rowBase[row] + (uint32_t)i_event];
+    if (cell->state != row)
+    {
+      return NULL;
+    }
+    *o_toStateCfg = &i_config->states[cell->toState];
+    return &i_stateCfg->transitions[cell->transition];
+  }
+
+  for (uint32_t i = 0; i < i_stateCfg->transitionsCount; i++)
+  {
+    if (i_stateCfg->transitions[i].event == i_event)
+    {
+      *o_toStateCfg = fsm_get_state_cfg(i_config, i_stateCfg->transitions[i].toState);
+      return &i_stateCfg->transitions[i];
+    }
+  }
+  return NULL;
+}
+
+static fsm_RC_t prepare_config(const fsm_cfg_t *const i_config, uint32_t i_depth)
+{
+  if (i_config == NULL)
   {
     return FSM_RC_ERROR_NULLPTR;
   }
@@ -100,175 +1129,237 @@ fsm_RC_t fsm_init(fsm_t *const io_this, const fsm_cfg_t *const i_config)
     }
   }
 
+  /* Check the sub configurations, their states are kept inline per instance */
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    if (i_depth > 0)
+    {
+      /* Timers are only armed for the states of the instance itself */
+      for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+      {
+        if (stateCfg->transitions[t].after != 0 || stateCfg->transitions[t].every != 0)
+        {
+          return FSM_RC_ERROR_INVALID_CONFIG;
+        }
+      }
+    }
+    if (stateCfg->regions != NULL)
+    {
+      /* The region states are kept inline per instance, one level only */
+      const fsm_regions_t *regions = stateCfg->regions;
+      if (i_depth > 0 || regions->configs == NULL || regions->count == 0 || regions->count > FSM_MAX_REGIONS)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+      for (uint32_t r = 0; r < regions->count; r++)
+      {
+        /* Checked as the deepest level: no sub configurations, regions or timers */
+        fsm_RC_t res = prepare_config(regions->configs[r], FSM_MAX_DEPTH);
+        if (res != FSM_RC_OK)
+        {
+          return res;
+        }
+      }
+    }
+    if (stateCfg->subCfg == NULL)
+    {
+      continue;
+    }
+    if (i_depth >= FSM_MAX_DEPTH || stateCfg->subFsm != NULL)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    fsm_RC_t res = prepare_config(stateCfg->subCfg, i_depth + 1u);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+
   /*** Configuration checks done ***/
-  io_this->config = i_config;
-  return fsm_reset(io_this);
-}
 
-fsm_RC_t fsm_reset(fsm_t *const io_this)
-{
-  if (io_this == NULL)
+  /* Precompile the dispatch table, shared by all instances of the config */
+  if (i_config->dispatch != NULL && i_config->dispatch->isBuilt == false)
   {
-    return FSM_RC_ERROR_NULLPTR;
+    return build_dispatch(i_config);
   }
-
-  io_this->currentState = io_this->config->initialState;
-  io_this->isFirstRun = true;
   return FSM_RC_OK;
 }
 
-fsm_RC_t fsm_process(fsm_t *const io_this, fsm_event_t i_event)
+static fsm_RC_t run_sub_config(const fsm_state_cfg_t *const i_stateCfg,
+                               bool i_isEntered,
+                               fsm_event_t i_event,
+                               fsm_event_obj_t *const io_obj,
+                               fsm_state_t *const io_subStates,
+                               uint32_t i_subDepth)
 {
-  if (io_this == NULL)
+  const fsm_cfg_t *subCfg = i_stateCfg->subCfg;
+  if (subCfg == NULL)
   {
-    return FSM_RC_ERROR_NULLPTR;
+    return FSM_RC_OK;
   }
-  if (io_this->config == NULL)
+  if (io_subStates == NULL || i_subDepth == 0)
   {
-    return FSM_RC_ERROR_NULLPTR;
+    return FSM_RC_ERROR_INVALID_CONFIG;
   }
 
-  const fsm_cfg_t *cfg = io_this->config;
-
-  /* Get the current state cfg */
-  fsm_state_t currState = io_this->currentState;
-  const fsm_state_cfg_t *currStateCfg = get_state_cfg(io_this, currState);
-  if (currStateCfg == NULL)
+  /* Entering the parent state restarts the sub configuration */
+  bool isFirstRun = i_isEntered;
+  if (i_isEntered == true)
+  {
+    io_subStates[0] = subCfg->initialState;
+  }
+  const fsm_state_cfg_t *subStateCfg = fsm_get_state_cfg(subCfg, io_subStates[0]);
+  if (subStateCfg == NULL)
   {
     return FSM_RC_ERROR_INVALID_CONFIG;
   }
 
-  /* Get the Matching transistion cfg */
-  const fsm_transition_cfg_t *transitionCfg = NULL;
-  for (uint32_t i = 0; i < currStateCfg->transitionsCount; i++)
+  const fsm_state_cfg_t *nextSubStateCfg = NULL;
+  fsm_RC_t res = fsm_run_state(subCfg, subStateCfg, &isFirstRun, i_event, io_obj, &nextSubStateCfg,
+                               &io_subStates[1], i_subDepth - 1u, NULL);
+  if (res != FSM_RC_OK)
   {
-    if (currStateCfg->transitions[i].event == i_event)
-    {
-      transitionCfg = &currStateCfg->transitions[i];
-      break;
-    }
+    return res;
   }
+  io_subStates[0] = nextSubStateCfg->state;
+  return FSM_RC_OK;
+}
 
-  /* Get next state cfg and transition action */
-  const fsm_state_cfg_t *nextStateCfg = NULL;
-  fsm_action_t const *actionTransition = NULL;
-  if (transitionCfg != NULL)
+static fsm_RC_t run_regions(const fsm_state_cfg_t *const i_stateCfg,
+                            fsm_region_state_t *const io_regions,
+                            bool i_isEntered,
+                            fsm_event_t i_event,
+                            fsm_event_obj_t *const io_obj)
+{
+  const fsm_regions_t *regions = i_stateCfg->regions;
+  if (regions == NULL)
   {
-    /* Transition defined for event */
-    bool guardCond = true;
-    /* Check Gurad condition */
-    if (transitionCfg->guard.func != NULL)
-    {
-      guardCond = transitionCfg->guard.func(transitionCfg->guard.arg);
-    }
-
-    if (guardCond == true)
-    {
-      /* Save next state cfg and transition action */
-      actionTransition = &transitionCfg->action;
-      nextStateCfg = get_state_cfg(io_this, transitionCfg->toState);
-      if (nextStateCfg == NULL)
-      {
-        return FSM_RC_ERROR_INVALID_CONFIG;
-      }
-    }
-    else
-    {
-      /* Guard condition false, stay in current state */
-      nextStateCfg = currStateCfg;
-    }
+    return FSM_RC_OK;
   }
-  else
+  if (io_regions == NULL)
   {
-    /* No transition defined for the current event, stay in the current state */
-    nextStateCfg = currStateCfg;
+    return FSM_RC_ERROR_INVALID_CONFIG;
   }
 
-  /* Check if it is the first run */
-  if (io_this->isFirstRun == true)
+  fsm_region_job_t jobs[FSM_MAX_REGIONS];
+  for (uint32_t i = 0; i < regions->count; i++)
   {
-    /* First run, perform entry action of initial state */
-    perform_action(&(currStateCfg->entryAction));
-    io_this->isFirstRun = false;
+    jobs[i] = (fsm_region_job_t){regions->configs[i], &io_regions[i], i_isEntered, i_event, io_obj, FSM_RC_OK};
   }
 
-  /* Perfrom the actions */
-  if (currStateCfg == nextStateCfg)
+#if FSM_TRACE || FSM_PROF
+  /* The trace ring and the profiler tree belong to the processing thread */
+  const bool isConcurrent = false;
+#else
+  const bool isConcurrent = (regions->run != NULL);
+#endif
+  if (isConcurrent == true)
   {
-    /* No state change, perform do action */
-    perform_action(&(currStateCfg->doAction));
-
-    /* Perform transition action if any */
-    perform_action(actionTransition);
-
-    /* Process event in the sub fsm */
-    if (currStateCfg->subFsm != NULL)
-    {
-      fsm_RC_t res = fsm_process((fsm_t *)currStateCfg->subFsm, i_event);
-      if (res != FSM_RC_OK)
-      {
-        return res;
-      }
-    }
+    regions->run(regions->runner, jobs, regions->count);
   }
   else
   {
-    /* State change, perform do and exit of current state, */
-    /* transition action, entry and do action of next state */
-    perform_action(&(currStateCfg->doAction));
-    perform_action(&(currStateCfg->exitAction));
-    perform_action(actionTransition);
-    perform_action(&(nextStateCfg->entryAction));
-    perform_action(&(nextStateCfg->doAction));
-
-    /* Check if a sub fsm is linked to the next state*/
-    if (nextStateCfg->subFsm != NULL)
+    for (uint32_t i = 0; i < regions->count; i++)
     {
-      /* Process the entering event in the sub fsm */
-      fsm_RC_t res = fsm_process((fsm_t *)nextStateCfg->subFsm, i_event);
-      if (res != FSM_RC_OK)
-      {
-        return res;
-      }
+      (void)fsm_region_run(&jobs[i]);
     }
   }
 
-  /* Save the state change (if happened) */
-  io_this->currentState = nextStateCfg->state;
+  /* Every region processed the event, the first failing one reports */
+  for (uint32_t i = 0; i < regions->count; i++)
+  {
+    if (jobs[i].res != FSM_RC_OK)
+    {
+      return jobs[i].res;
+    }
+  }
   return FSM_RC_OK;
 }
 
-/******************************************************************************/
-/*** Local function implementation                                            */
-/******************************************************************************/
-static void perform_action(const fsm_action_t *const i_action)
+static void restart_regions(const fsm_state_cfg_t *const i_stateCfg, fsm_region_state_t *const o_regions)
 {
-  if (i_action != NULL)
+  const fsm_regions_t *regions = i_stateCfg->regions;
+  for (uint32_t i = 0; regions != NULL && i < regions->count; i++)
   {
-    if (i_action->func != NULL)
-    {
-      i_action->func(i_action->arg);
-    }
+    o_regions[i].state = regions->configs[i]->initialState;
+    o_regions[i].isFirstRun = true;
   }
 }
 
-static fsm_state_cfg_t const *get_state_cfg(const fsm_t *const i_this, fsm_state_t i_state)
+static fsm_RC_t build_dispatch(const fsm_cfg_t *const i_config)
 {
-  if (i_this == NULL)
+  fsm_dispatch_t *dispatch = i_config->dispatch;
+  const uint32_t stateEnumCount = fsm_state_enum_count(i_config);
+  const uint32_t eventEnumCount = fsm_event_enum_count(i_config);
+
+  /* Check if the configuration fits into the table */
+  if (i_config->statesCount >= FSM_INDEX_NONE ||
+      dispatch->stateIndex == NULL ||
+      dispatch->stateIndexCount < stateEnumCount ||
+      dispatch->cells == NULL ||
+      (uint64_t)dispatch->cellsCount < (uint64_t)i_config->statesCount * eventEnumCount)
   {
-    return NULL;
+    return FSM_RC_ERROR_INVALID_CONFIG;
   }
-  if (i_this->config == NULL)
+
+  /* Map the state enums, the first definition of a state wins */
+  for (uint32_t i = 0; i < dispatch->stateIndexCount; i++)
   {
-    return NULL;
+    dispatch->stateIndex[i] = FSM_INDEX_NONE;
+  }
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    uint32_t state = (uint32_t)i_config->states[i].state;
+    if (state >= stateEnumCount)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    if (dispatch->stateIndex[state] == FSM_INDEX_NONE)
+    {
+      dispatch->stateIndex[state] = (fsm_index_t)i;
+    }
   }
 
-  for (uint32_t i = 0; i < i_this->config->statesCount; i++)
+  /* Fill the rows, the first transition defined for an event wins */
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
   {
-    if (i_this->config->states[i].state == i_state)
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    fsm_dispatch_cell_t *row = &dispatch->cells[i * eventEnumCount];
+    for (uint32_t e = 0; e < eventEnumCount; e++)
+    {
+      row[e].transition = FSM_INDEX_NONE;
+      row[e].toState = FSM_INDEX_NONE;
+    }
+
+    if (stateCfg->transitionsCount >= FSM_INDEX_NONE)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
     {
-      return &i_this->config->states[i];
+      const fsm_transition_cfg_t *transitionCfg = &stateCfg->transitions[t];
+      uint32_t event = (uint32_t)transitionCfg->event;
+      uint32_t toState = (uint32_t)transitionCfg->toState;
+      if (event >= eventEnumCount)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+      if (row[event].transition != FSM_INDEX_NONE)
+      {
+        continue;
+      }
+      row[event].transition = (fsm_index_t)t;
+      /* An undefined target is reported when the transition is taken */
+      if (toState < stateEnumCount)
+      {
+        row[event].toState = dispatch->stateIndex[toState];
+      }
     }
   }
-  return NULL;
-}
\ No newline at end of file
+
+  dispatch->rowSize = eventEnumCount;
+  dispatch->isBuilt = true;
+  return FSM_RC_OK;
+}
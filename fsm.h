@@ -23,6 +23,7 @@
 #include "fsm_events_states.h" /* "extern" defined events and states */
 
 #include <stdbool.h> /* for bool */
+#include <stddef.h>  /* for size_t */
 #include <stdint.h>  /* for int types */
 
 /******************************************************************************/
@@ -32,25 +33,98 @@ typedef void *fsm_arg_t;                     /**< Argument for FSM */
 typedef void (*fsm_func_t)(fsm_arg_t);       /**< FuncPtr for FSM funcs */
 typedef bool (*fsm_guard_func_t)(fsm_arg_t); /**< FuncPtr for FSM guards */
 
+typedef uint16_t fsm_index_t;                    /**< Index into a states or transitions array */
+#define FSM_INDEX_NONE ((fsm_index_t)UINT16_MAX) /**< Marks a missing index */
+
+#ifndef FSM_MAX_DEPTH
+#define FSM_MAX_DEPTH 4u /**< Maximum nesting of sub configurations, inline states per instance */
+#endif
+
+#ifndef FSM_RAISE_QUEUE_SIZE
+#define FSM_RAISE_QUEUE_SIZE 4u /**< Events raised by actions per instance, see fsm_raise, at most 255 */
+#endif
+
+#ifndef FSM_MAX_REGIONS
+#define FSM_MAX_REGIONS 4u /**< Orthogonal regions of a state, inline region states per instance */
+#endif
+
+#define FSM_RAISE_PRIO_DEFAULT 0u /**< Priority of the events raised with fsm_raise */
+
+/**
+ * @brief Declare the zero based state or event enum of one machine
+ *
+ * Machines with their own enums coexist with the ones using the project wide
+ * fsm_events_states.h, see stateEnumCount and eventEnumCount of fsm_cfg_t.
+ * The values are passed as fsm_state_t and fsm_event_t, see FSM_STATE and
+ * FSM_EVENT, and must fit their underlying type.
+ *
+ *   #define DOOR_STATES(X) X(DOOR_OPEN) X(DOOR_CLOSED)
+ *   FSM_ENUM(door_state_t, DOOR_STATES, DOOR_STATE_COUNT);
+ */
+#define FSM_ENUM(type, list, count) typedef enum { list(FSM_ENUM_VALUE_) count } type
+#define FSM_ENUM_VALUE_(value) value, /**< Entry of FSM_ENUM */
+
+#define FSM_STATE(state) ((fsm_state_t)(state)) /**< Value of a machine state enum as fsm_state_t */
+#define FSM_EVENT(event) ((fsm_event_t)(event)) /**< Value of a machine event enum as fsm_event_t */
+
+struct fsm_cfg;                   /**< Forward declaration of the configuration struct */
+typedef struct fsm_cfg fsm_cfg_t; /**< Statemachine Configuration */
+
 struct fsm;               /**< Forward declaration of statemachine struct*/
 typedef struct fsm fsm_t; /**< Statemachine struct */
 
+struct fsm_event_obj;                         /**< Forward declaration of the event object, see fsm_event.h */
+typedef struct fsm_event_obj fsm_event_obj_t; /**< Event Object */
+
+typedef void (*fsm_event_func_t)(fsm_arg_t, const fsm_event_obj_t *);       /**< FuncPtr for FSM funcs with the event object */
+typedef bool (*fsm_event_guard_func_t)(fsm_arg_t, const fsm_event_obj_t *); /**< FuncPtr for FSM guards with the event object */
+
+/**
+ * @brief Return Codes for FSM functions
+ */
+typedef enum
+{
+  FSM_RC_OK,                   /**< Operation successful */
+  FSM_RC_ERROR,                /**< Generic error */
+  FSM_RC_ERROR_NULLPTR,        /**< Null pointer error */
+  FSM_RC_ERROR_INVALID_CONFIG, /**< Invalid configuration error */
+  FSM_RC_ERROR_INVALID_ARG,    /**< Invalid argument error (e.g. index out of range) */
+  FSM_RC_ERROR_QUEUE_FULL,     /**< Event queue full, event dropped */
+  FSM_RC_ERROR_POOL_EMPTY,     /**< Event pool exhausted, no event allocated */
+} fsm_RC_t;
+
+/**
+ * @brief Specialized processing of one event, see fsm_gen.h
+ *
+ * Runs the actions of the event, forwards it to the sub fsm with
+ * fsm_process_sub and saves the next state. The raised events are left to
+ * fsm_drain_raised.
+ */
+typedef fsm_RC_t (*fsm_step_func_t)(fsm_t *io_this, fsm_event_t i_event, fsm_event_obj_t *io_obj);
+
 /**
  * @brief Action Function
+ *
+ * An action set with eventFunc instead of func also receives the event object
+ * of the processed event (fsm_process_event), null for a plain event.
  */
 typedef struct
 {
-  const fsm_func_t func; /**< Function Pointer */
-  const fsm_arg_t arg;   /**< Argument for the function */
+  const fsm_func_t func;            /**< Function Pointer */
+  const fsm_arg_t arg;              /**< Argument for the function */
+  const fsm_event_func_t eventFunc; /**< [optional] Function Pointer receiving the event object, used if set */
 } fsm_action_t;
 
 /**
  * @brief Guard Condition Function
+ *
+ * Like fsm_action_t, a guard set with eventFunc receives the event object.
  */
 typedef struct
 {
-  const fsm_guard_func_t func; /**< Function Pointer */
-  const fsm_arg_t arg;         /**< Argument for the function */
+  const fsm_guard_func_t func;            /**< Function Pointer */
+  const fsm_arg_t arg;                    /**< Argument for the function */
+  const fsm_event_guard_func_t eventFunc; /**< [optional] Function Pointer receiving the event object, used if set */
 } fsm_guard_t;
 
 /**
@@ -59,6 +133,8 @@ typedef struct
  * Defines a transition from one state to another on a specific event,
  * with an optional guard condition and an action to be performed during the
  * transition.
+ * A timed transition (after and/or every set) additionally gets its event
+ * raised by the timer wheel while the state is active, see fsm_timer.h.
  */
 typedef struct
 {
@@ -66,13 +142,68 @@ typedef struct
   const fsm_state_t toState; /**< The next state entered by the transition */
   const fsm_guard_t guard;   /**< Optional guard condition */
   const fsm_action_t action; /**< Optional transition action */
+  const uint32_t after;      /**< [optional] Ticks after state entry until the event is raised */
+  const uint32_t every;      /**< [optional] Ticks between repeated raises while in the state */
 } fsm_transition_cfg_t;
 
+/**
+ * @brief Inline State of an Orthogonal Region
+ */
+typedef struct
+{
+  fsm_state_t state; /**< The current state of the region */
+  bool isFirstRun;   /**< Flag indicating if the region has been run since its parent state was entered */
+} fsm_region_state_t;
+
+/**
+ * @brief Processing of an event in one orthogonal region, see fsm_region_run
+ */
+typedef struct
+{
+  const fsm_cfg_t *config;    /**< Configuration of the region */
+  fsm_region_state_t *region; /**< Inline state of the region in the parent instance */
+  bool isEntered;             /**< Parent state just entered, restart the region */
+  fsm_event_t event;          /**< The event to process */
+  fsm_event_obj_t *obj;       /**< [optional] Event object of the event, referenced by the caller */
+  fsm_RC_t res;               /**< Result of the region, set by fsm_region_run */
+} fsm_region_job_t;
+
+/**
+ * @brief Runner processing the regions of a state, e.g. concurrently
+ *
+ * Calls fsm_region_run for every job and returns once all of them are done.
+ */
+typedef void (*fsm_regions_run_t)(void *io_runner, fsm_region_job_t *io_jobs, uint32_t i_count);
+
+/**
+ * @brief Orthogonal Regions
+ *
+ * Independent machines active together during a state of an instance. Their
+ * states are kept inline in the instance like the ones of the sub
+ * configurations, so one configuration tree can back any number of instances.
+ * Every event processed in the state is dispatched to all regions in array
+ * order, after the actions of the state and its sub fsm or sub configuration.
+ * Entering the state restarts the regions in their initial states. All regions
+ * process the event, the first failing one in array order gives the result.
+ * Only the states of an instance configuration have regions, a region
+ * configuration has no sub configurations, regions or timed transitions.
+ * With a runner the regions are processed concurrently instead, see
+ * fsm_fork.h.
+ */
+typedef struct
+{
+  const fsm_cfg_t *const *const configs; /**< Configurations of the regions, processed in order */
+  const uint32_t count;                  /**< Number of regions, at most FSM_MAX_REGIONS */
+  const fsm_regions_run_t run;           /**< [optional] Runner processing the regions, e.g. fsm_fork_run */
+  void *const runner;                    /**< [optional] Argument of the runner, e.g. the fsm_fork_t */
+} fsm_regions_t;
+
 /**
  * @brief State Configuration
  *
  * Defines a state in the FSM, including its entry, do, and exit actions,
  * as well as the transitions that can occur from this state.
+ * New members are appended, positional initializers stay valid.
  */
 typedef struct
 {
@@ -83,52 +214,213 @@ typedef struct
   const fsm_action_t exitAction;                 /**< [optional] Action perfored on state exit */
   const fsm_transition_cfg_t *const transitions; /**< Array of transitions from this state */
   const uint32_t transitionsCount;               /**< Number of transitions in the transitions array */
+  const fsm_cfg_t *const subCfg;                 /**< [optional] Sub configuration run during this state, see fsm_t */
+  const fsm_regions_t *const regions;            /**< [optional] Orthogonal regions active during this state */
 } fsm_state_cfg_t;
 
+/**
+ * @brief Dispatch Table Cell
+ *
+ * Precompiled result of looking up one event in one state.
+ */
+typedef struct
+{
+  fsm_index_t transition; /**< Index in the transitions array, FSM_INDEX_NONE if the event is not handled */
+  fsm_index_t toState;    /**< Index of the target state in the states array, FSM_INDEX_NONE if undefined */
+} fsm_dispatch_cell_t;
+
+/**
+ * @brief Dispatch Table
+ *
+ * Lookup table built by fsm_cfg_prepare from the configuration. Maps a state
+ * enum to its index in the states array and holds one row of cells per entry
+ * of the states array, one cell per value of the event enum, so that finding
+ * the state and the transition is a single indexed load each. Both are sized
+ * by the enums of the configuration, see stateEnumCount and eventEnumCount.
+ * Use FSM_DISPATCH_TABLE to provide the storage.
+ * The dense table costs statesCount * eventEnumCount cells. Machines with
+ * sparse event sets use the compressed fsm_packed_t instead, built by
+ * fsm_builder_set_packed, see fsm_optimize.h.
+ */
+typedef struct
+{
+  bool isBuilt;                     /**< Set by fsm_cfg_prepare once the table is filled */
+  uint32_t rowSize;                 /**< Cells per row, size of the event enum, set by fsm_cfg_prepare */
+  fsm_index_t *const stateIndex;    /**< State enum to index in the states array */
+  const uint32_t stateIndexCount;   /**< Number of entries in the stateIndex array */
+  fsm_dispatch_cell_t *const cells; /**< statesCount * rowSize cells, row per state */
+  const uint32_t cellsCount;        /**< Number of cells in the cells array */
+} fsm_dispatch_t;
+
+/**
+ * @brief Storage for the dispatch table of a configuration with statesCount states
+ *
+ * Sized for the machine enums of the configuration, see FSM_ENUM. Usage
+ * within a configuration:
+ * .dispatch = FSM_DISPATCH_TABLE_FOR(3, DOOR_STATE_COUNT, DOOR_EVENT_COUNT),
+ */
+#define FSM_DISPATCH_TABLE_FOR(statesCount, stateEnumCount, eventEnumCount)  \
+  (&(fsm_dispatch_t){                                                        \
+      .stateIndex = (fsm_index_t[(stateEnumCount)]){0},                      \
+      .stateIndexCount = (stateEnumCount),                                   \
+      .cells = (fsm_dispatch_cell_t[(statesCount) * (eventEnumCount)]){{0}}, \
+      .cellsCount = (statesCount) * (eventEnumCount),                        \
+  })
+
+/**
+ * @brief Storage for the dispatch table of a configuration with statesCount states
+ *
+ * Sized for the enums of fsm_events_states.h.
+ *
+ * Usage within a configuration: .dispatch = FSM_DISPATCH_TABLE(3),
+ */
+#define FSM_DISPATCH_TABLE(statesCount) FSM_DISPATCH_TABLE_FOR(statesCount, FSM_STATE_COUNT, FSM_EVENT_COUNT)
+
+/**
+ * @brief Row Displaced Dispatch Table Cell
+ */
+typedef struct
+{
+  fsm_index_t state;      /**< Index of the state owning the cell, FSM_INDEX_NONE if unused */
+  fsm_index_t transition; /**< Index in the transitions array of the owning state */
+  fsm_index_t toState;    /**< Index of the target state in the states array */
+} fsm_packed_cell_t;
+
+/**
+ * @brief Row Displaced Dispatch Table
+ *
+ * Compressed alternative to fsm_dispatch_t: the rows of all states overlap in
+ * one cells array, only cells of handled events are owned by the state.
+ * The row of a state starts at rowBase[index], a cell belongs to the lookup
+ * only if its state field matches. Built by fsm_builder_finalize, see
+ * fsm_optimize.h.
+ */
+typedef struct
+{
+  const fsm_index_t *stateIndex;  /**< State enum to index in the states array */
+  uint32_t stateIndexCount;       /**< Number of entries in the stateIndex array */
+  uint32_t rowSize;               /**< Cells per row, size of the event enum */
+  const uint32_t *rowBase;        /**< Start of the row of each state in the cells array */
+  const fsm_packed_cell_t *cells; /**< The overlapping rows */
+  uint32_t cellsCount;            /**< Number of cells, covers every row start + rowSize */
+} fsm_packed_t;
+
 /**
  * @brief Statemachine Configuration
  *
  * Defines the configuration of the FSM, including its initial state and
- * the states that make up the FSM.
+ * the states that make up the FSM. A machine declaring its own enums (see
+ * FSM_ENUM) sets their sizes, so its tables are sized to the machine instead
+ * of to fsm_events_states.h.
  */
-typedef struct
+struct fsm_cfg
 {
   const fsm_state_t initialState;      /**< The initial state of the FSM */
   const fsm_state_cfg_t *const states; /**< Array of states in the FSM */
   const uint32_t statesCount;          /**< Number of states in the states array */
-} fsm_cfg_t;
+  fsm_dispatch_t *const dispatch;      /**< [optional] Storage for the dispatch table, linear search if null */
+  const fsm_packed_t *const packed;    /**< [optional] Row displaced dispatch table, used if dispatch is null */
+  const uint32_t stateEnumCount;       /**< [optional] Size of the state enum of the machine, FSM_STATE_COUNT if 0 */
+  const uint32_t eventEnumCount;       /**< [optional] Size of the event enum of the machine, FSM_EVENT_COUNT if 0 */
+};
 
 /**
- * @brief Statemachine Struct
+ * @brief Header of an event object, its first member
  *
- * Represents an instance of the FSM, including its current state and
- * configuration.
+ * The core keeps a reference to the objects raised from actions (see
+ * fsm_event.h) until they are processed, without linking the event module.
  */
-struct fsm
+typedef struct
 {
-  const fsm_cfg_t *config;  /**< Pointer to the FSM configuration */
-  fsm_state_t currentState; /**< The current state of the FSM */
-  bool isFirstRun;          /**< Flag indicating if the FSM has been run yet */
-};
+  fsm_RC_t (*retain)(fsm_event_obj_t *io_obj);  /**< Takes an additional reference */
+  fsm_RC_t (*release)(fsm_event_obj_t *io_obj); /**< Drops a reference */
+} fsm_event_head_t;
+
+struct fsm_hook; /**< Forward declaration of the hook struct */
 
 /**
- * @brief Return Codes for FSM functions
+ * @brief Hook Operations
+ *
+ * Optional modules (timers, event log recorder, hit counters) attach to an
+ * instance through a hook, so the core does not link them. The core calls the
+ * operations set, every operation is optional.
  */
-typedef enum
+typedef struct
 {
-  FSM_RC_OK,                   /**< Operation successful */
-  FSM_RC_ERROR,                /**< Generic error */
-  FSM_RC_ERROR_NULLPTR,        /**< Null pointer error */
-  FSM_RC_ERROR_INVALID_CONFIG, /**< Invalid configuration error */
-} fsm_RC_t;
+  /** An event is looked up in the state at i_stateIndex of the configuration of the instance */
+  void (*lookup)(struct fsm_hook *io_hook, const fsm_t *i_fsm, uint32_t i_stateIndex, fsm_event_t i_event);
+  /** A state of the instance was entered, the initial state with the first event */
+  void (*enter)(struct fsm_hook *io_hook, fsm_t *io_fsm, const fsm_state_cfg_t *i_stateCfg);
+  /** An event passed to fsm_process is done, i_res is its result */
+  void (*processed)(struct fsm_hook *io_hook, const fsm_t *i_fsm, fsm_event_t i_event, fsm_RC_t i_res);
+  /** The instance was reset, its state left without exit action */
+  void (*reset)(struct fsm_hook *io_hook, fsm_t *io_fsm);
+} fsm_hook_ops_t;
+
+/**
+ * @brief Hook of a module bound to an instance
+ *
+ * Embedded into the per instance binding of the module, e.g. fsm_timers_t.
+ */
+typedef struct fsm_hook
+{
+  const fsm_hook_ops_t *ops; /**< Operations of the module */
+  struct fsm_hook *next;     /**< Next hook bound to the same instance */
+} fsm_hook_t;
+
+/**
+ * @brief Statemachine Struct
+ *
+ * Represents an instance of the FSM, including its current state and
+ * configuration. The states of nested sub configurations (subCfg) are kept
+ * inline, one per nesting level of the active state, so one configuration
+ * tree can back any number of instances. A sub configuration starts in its
+ * initial state whenever its parent state is entered.
+ * The states of the orthogonal regions of the current state are kept inline
+ * too. Events raised by the actions (fsm_raise) are queued inline as well, by
+ * priority, and drained before fsm_process returns.
+ */
+struct fsm
+{
+  const fsm_cfg_t *config;                           /**< Pointer to the FSM configuration */
+  fsm_state_t currentState;                          /**< The current state of the FSM */
+  bool isFirstRun;                                   /**< Flag indicating if the FSM has been run yet */
+  fsm_hook_t *hooks;                                 /**< [optional] Bound modules, see fsm_timer.h, fsm_record.h, fsm_reorder.h */
+  fsm_state_t subStates[FSM_MAX_DEPTH];              /**< States of the active sub configurations, level by level */
+  fsm_region_state_t regionStates[FSM_MAX_REGIONS];  /**< States of the regions of the current state */
+  bool isProcessing;                                 /**< Set while fsm_process runs, events are raised into the queue */
+  uint8_t raisedCount;                               /**< Number of raised events not processed yet */
+  uint8_t raisedPrio[FSM_RAISE_QUEUE_SIZE];          /**< Priority of each raised event */
+  fsm_event_t raised[FSM_RAISE_QUEUE_SIZE];          /**< Raised events, next to process first */
+  fsm_event_obj_t *raisedObjs[FSM_RAISE_QUEUE_SIZE]; /**< Event object of each raised event, null if none, referenced */
+};
 
 /******************************************************************************/
 /*** API Functions                                                            */
 /******************************************************************************/
 
+/**
+ * @brief Check a configuration and build its dispatch tables
+ *
+ * Fills the dispatch tables of the configuration, its sub configurations and
+ * its regions, which are shared by all instances. Call it once before
+ * instances of the configuration are initialized or processed on several
+ * threads, afterwards the configuration is only read. Preparing a prepared
+ * configuration only checks it.
+ *
+ * @param i_config Pointer to the FSM configuration
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_cfg_prepare(const fsm_cfg_t *const i_config);
+
 /**
  * @brief Initialize the FSM with the given configuration
  *
+ * Prepares the configuration with fsm_cfg_prepare if that was not done yet,
+ * which writes its dispatch tables: instances sharing a configuration across
+ * threads need it prepared up front.
+ *
  * @param io_this Pointer to the FSM instance to initialize
  * @param i_config Pointer to the FSM configuration
  *
@@ -148,6 +440,11 @@ fsm_RC_t fsm_reset(fsm_t *const io_this);
 /**
  * @brief Process an event in the FSM, potentially causing a state transition
  *
+ * Run to completion: the events raised by the actions are processed one after
+ * another before returning, by priority (see fsm_raise_prio). Called from an
+ * action of the same instance it behaves like fsm_raise. On an error the
+ * remaining raised events are dropped.
+ *
  * @param io_this Pointer to the FSM instance
  * @param i_event The event to process
  *
@@ -155,4 +452,120 @@ fsm_RC_t fsm_reset(fsm_t *const io_this);
  */
 fsm_RC_t fsm_process(fsm_t *const io_this, fsm_event_t i_event);
 
+/**
+ * @brief Process a batch of events in the FSM
+ *
+ * Same per event semantics as calling fsm_process for each event, including
+ * the action order, sub fsm forwarding and draining the raised events. The
+ * current state configuration is kept across the batch instead of being looked
+ * up for every event.
+ * Processing stops at the first error.
+ *
+ * @param io_this Pointer to the FSM instance
+ * @param i_events Array of events to process in order
+ * @param i_eventsCount Number of events in the array
+ * @param o_processed [optional] Number of successfully processed events, which
+ *                    is the index of the failed event on error
+ *
+ * @return FSM_RC_OK on success, error code of the failed event otherwise
+ */
+fsm_RC_t fsm_process_many(fsm_t *const io_this,
+                          const fsm_event_t *const i_events,
+                          size_t i_eventsCount,
+                          size_t *const o_processed);
+
+/**
+ * @brief Raise an event on the FSM from one of its actions
+ *
+ * The event is queued and processed after the current one, once its actions
+ * and the state change are done, so it sees the new current state. Raised
+ * events take precedence over the next event passed to fsm_process. The queue
+ * is drained in a loop, the stack does not grow with the number of raised
+ * events. Outside of fsm_process (e.g. raised on another instance) the event
+ * is processed right away.
+ * Raises with FSM_RAISE_PRIO_DEFAULT, see fsm_raise_prio.
+ *
+ * @param io_this Pointer to the FSM instance
+ * @param i_event The event to raise
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_QUEUE_FULL if
+ *         FSM_RAISE_QUEUE_SIZE events are pending, error code otherwise
+ */
+fsm_RC_t fsm_raise(fsm_t *const io_this, fsm_event_t i_event);
+
+/**
+ * @brief Raise an event with a priority on the FSM from one of its actions
+ *
+ * Like fsm_raise, the pending events are processed by descending priority,
+ * events of the same priority in the order they were raised.
+ *
+ * @param io_this Pointer to the FSM instance
+ * @param i_event The event to raise
+ * @param i_priority Priority of the event, higher runs first
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_QUEUE_FULL if
+ *         FSM_RAISE_QUEUE_SIZE events are pending, error code otherwise
+ */
+fsm_RC_t fsm_raise_prio(fsm_t *const io_this, fsm_event_t i_event, uint8_t i_priority);
+
+/**
+ * @brief Process the raised events with a step function, used by fsm_gen.h
+ *
+ * Called while isProcessing is set, after the step of the event passed to a
+ * generated dispatcher. Like fsm_process the raised events are processed by
+ * priority and dropped on an error, including an error of the passed event.
+ *
+ * @param io_this Pointer to the FSM instance
+ * @param i_res Result of the step of the passed event
+ * @param i_step The step function of the machine
+ *
+ * @return FSM_RC_OK on success, i_res or the error code of the failed raised
+ *         event otherwise
+ */
+fsm_RC_t fsm_drain_raised(fsm_t *const io_this, fsm_RC_t i_res, fsm_step_func_t i_step);
+
+/**
+ * @brief Process an event in a sub fsm, used by fsm_gen.h
+ *
+ * @param io_subFsm [optional] The sub fsm, nothing is done if null
+ * @param i_event The event to process
+ * @param io_obj [optional] The event object, the sub fsm takes its own reference
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_process_sub(fsm_t *const io_subFsm, fsm_event_t i_event, fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Get the state of an active sub configuration
+ *
+ * @param i_this Pointer to the FSM instance
+ * @param i_level Nesting level, 0 for the sub configuration of the current state
+ * @param o_state The state
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if no sub
+ *         configuration is active at the level, error code otherwise
+ */
+fsm_RC_t fsm_get_sub_state(const fsm_t *const i_this, uint32_t i_level, fsm_state_t *const o_state);
+
+/**
+ * @brief Get the state of an orthogonal region of the current state
+ *
+ * @param i_this Pointer to the FSM instance
+ * @param i_region Index of the region in the regions of the current state
+ * @param o_state The state
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the current state
+ *         has no such region, error code otherwise
+ */
+fsm_RC_t fsm_get_region_state(const fsm_t *const i_this, uint32_t i_region, fsm_state_t *const o_state);
+
+/**
+ * @brief Process an event in one orthogonal region, called by the runners
+ *
+ * @param io_job The region and the event, res is set to the result
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_region_run(fsm_region_job_t *const io_job);
+
 #endif /* FSM_H_ */
\ No newline at end of file
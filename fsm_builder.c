@@ -0,0 +1,654 @@
+/**
+ * @file       fsm_builder.c
+ * @brief      Runtime builder for FSM configurations
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_builder.h"  /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <stdlib.h> /* for malloc, free */
+#include <string.h> /* for memcpy, memset */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define ARENA_ALIGN 16u /**< Alignment of every arena allocation */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Arena block, the data follows the struct
+ */
+struct fsm_builder_block
+{
+  struct fsm_builder_block *next; /**< Next older block */
+  size_t size;                    /**< Size of the data */
+  size_t used;                    /**< Bytes of the data in use */
+};
+
+/**
+ * @brief Staged transition
+ */
+typedef struct fsm_builder_transition
+{
+  struct fsm_builder_transition *next; /**< Next transition of the state, sorted by event */
+  fsm_transition_cfg_t cfg;            /**< The transition */
+} fsm_builder_transition_t;
+
+/**
+ * @brief Staged state
+ */
+struct fsm_builder_state
+{
+  struct fsm_builder_state *next;        /**< Next added state */
+  fsm_builder_transition_t *transitions; /**< Transitions sorted by event */
+  fsm_builder_transition_t *last;        /**< Last transition */
+  uint32_t transitionsCount;             /**< Number of transitions */
+  fsm_state_t state;                     /**< The Enum entry for this state */
+  const fsm_t *subFsm;                   /**< [optional] Sub-FSM */
+  const fsm_cfg_t *subCfg;               /**< [optional] Sub configuration */
+  const fsm_regions_t *regions;          /**< [optional] Orthogonal regions */
+  fsm_action_t actions[3];               /**< Entry, do and exit action */
+};
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Allocate zeroed memory from the arena
+ *
+ * @param io_this Pointer to the builder
+ * @param i_size Number of bytes
+ *
+ * @return The memory, null if a new block could not be allocated
+ */
+static void *arena_alloc(fsm_builder_t *const io_this, size_t i_size);
+
+/**
+ * @brief Get a staged state which can still be changed
+ *
+ * @param i_this Pointer to the builder
+ * @param i_state The state
+ * @param o_state The staged state
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if already finalized,
+ *         FSM_RC_ERROR_INVALID_ARG if the state is not added
+ */
+static fsm_RC_t get_state(const fsm_builder_t *const i_this,
+                          fsm_state_t i_state,
+                          struct fsm_builder_state **const o_state);
+
+/**
+ * @brief Build the row displaced dispatch table of the laid out states
+ *
+ * Rows are placed first fit, the fullest rows first.
+ *
+ * @param io_this Pointer to the builder
+ * @param i_states The laid out states, statesCount entries
+ * @param o_packed The table, allocated from the arena
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if an allocation failed
+ */
+static fsm_RC_t build_packed(fsm_builder_t *const io_this,
+                             const fsm_state_cfg_t *const i_states,
+                             const fsm_packed_t **const o_packed);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_builder_init(fsm_builder_t *const o_this, size_t i_blockSize)
+{
+  if (o_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  memset(o_this, 0, sizeof(*o_this));
+  o_this->blockSize = (i_blockSize == 0) ? FSM_BUILDER_BLOCK_SIZE : i_blockSize;
+  o_this->stateEnumCount = (uint32_t)FSM_STATE_COUNT;
+  o_this->eventEnumCount = (uint32_t)FSM_EVENT_COUNT;
+  o_this->stateLookup = arena_alloc(o_this, sizeof(struct fsm_builder_state *) * (size_t)FSM_STATE_COUNT);
+  if (o_this->stateLookup == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_free(fsm_builder_t *const io_this)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  struct fsm_builder_block *block = io_this->blocks;
+  while (block != NULL)
+  {
+    struct fsm_builder_block *next = block->next;
+    free(block);
+    block = next;
+  }
+  memset(io_this, 0, sizeof(*io_this));
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_enums(fsm_builder_t *const io_this, uint32_t i_stateEnumCount, uint32_t i_eventEnumCount)
+{
+  if (io_this == NULL || io_this->stateLookup == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != NULL || io_this->statesCount != 0)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  /* The previous lookup stays in the arena until fsm_builder_free */
+  uint32_t stateEnumCount = (i_stateEnumCount == 0) ? (uint32_t)FSM_STATE_COUNT : i_stateEnumCount;
+  struct fsm_builder_state **stateLookup = arena_alloc(io_this, sizeof(struct fsm_builder_state *) * stateEnumCount);
+  if (stateLookup == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  io_this->stateLookup = stateLookup;
+  io_this->stateEnumCount = stateEnumCount;
+  io_this->eventEnumCount = (i_eventEnumCount == 0) ? (uint32_t)FSM_EVENT_COUNT : i_eventEnumCount;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_add_state(fsm_builder_t *const io_this, fsm_state_t i_state)
+{
+  if (io_this == NULL || io_this->stateLookup == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  if ((uint32_t)i_state >= io_this->stateEnumCount || io_this->stateLookup[i_state] != NULL)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  struct fsm_builder_state *state = arena_alloc(io_this, sizeof(*state));
+  if (state == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  state->state = i_state;
+
+  if (io_this->lastState == NULL)
+  {
+    io_this->states = state;
+  }
+  else
+  {
+    io_this->lastState->next = state;
+  }
+  io_this->lastState = state;
+  io_this->stateLookup[i_state] = state;
+  io_this->statesCount++;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_actions(fsm_builder_t *const io_this,
+                                 fsm_state_t i_state,
+                                 fsm_action_t i_entryAction,
+                                 fsm_action_t i_doAction,
+                                 fsm_action_t i_exitAction)
+{
+  struct fsm_builder_state *state = NULL;
+  fsm_RC_t res = get_state(io_this, i_state, &state);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  memcpy(&state->actions[0], &i_entryAction, sizeof(fsm_action_t));
+  memcpy(&state->actions[1], &i_doAction, sizeof(fsm_action_t));
+  memcpy(&state->actions[2], &i_exitAction, sizeof(fsm_action_t));
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_sub_fsm(fsm_builder_t *const io_this, fsm_state_t i_state, const fsm_t *const i_subFsm)
+{
+  struct fsm_builder_state *state = NULL;
+  fsm_RC_t res = get_state(io_this, i_state, &state);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  state->subFsm = i_subFsm;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_sub_cfg(fsm_builder_t *const io_this, fsm_state_t i_state, const fsm_cfg_t *const i_subCfg)
+{
+  struct fsm_builder_state *state = NULL;
+  fsm_RC_t res = get_state(io_this, i_state, &state);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  state->subCfg = i_subCfg;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_regions(fsm_builder_t *const io_this,
+                                 fsm_state_t i_state,
+                                 const fsm_regions_t *const i_regions)
+{
+  struct fsm_builder_state *state = NULL;
+  fsm_RC_t res = get_state(io_this, i_state, &state);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  state->regions = i_regions;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_add_transition(fsm_builder_t *const io_this,
+                                    fsm_state_t i_fromState,
+                                    const fsm_transition_cfg_t *const i_transition)
+{
+  if (i_transition == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  struct fsm_builder_state *state = NULL;
+  fsm_RC_t res = get_state(io_this, i_fromState, &state);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  if ((uint32_t)i_transition->event >= io_this->eventEnumCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_builder_transition_t *transition = arena_alloc(io_this, sizeof(*transition));
+  if (transition == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  memcpy(&transition->cfg, i_transition, sizeof(fsm_transition_cfg_t));
+
+  /* Insert behind the last transition with the same or a smaller event, */
+  /* keeps the order of transitions sharing an event, linear ones are appended */
+  if (state->last == NULL || state->last->cfg.event <= i_transition->event || io_this->isLinear == true)
+  {
+    if (state->last == NULL)
+    {
+      state->transitions = transition;
+    }
+    else
+    {
+      state->last->next = transition;
+    }
+    state->last = transition;
+  }
+  else if (state->transitions->cfg.event > i_transition->event)
+  {
+    transition->next = state->transitions;
+    state->transitions = transition;
+  }
+  else
+  {
+    fsm_builder_transition_t *prev = state->transitions;
+    while (prev->next->cfg.event <= i_transition->event)
+    {
+      prev = prev->next;
+    }
+    transition->next = prev->next;
+    prev->next = transition;
+  }
+  state->transitionsCount++;
+  io_this->transitionsCount++;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_initial(fsm_builder_t *const io_this, fsm_state_t i_state)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  io_this->initialState = i_state;
+  io_this->hasInitialState = true;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_packed(fsm_builder_t *const io_this, bool i_isPacked)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  io_this->isPacked = i_isPacked;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_set_linear(fsm_builder_t *const io_this, bool i_isLinear)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != NULL || io_this->transitionsCount > 0)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  io_this->isLinear = i_isLinear;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_builder_finalize(fsm_builder_t *const io_this, const fsm_cfg_t **const o_config)
+{
+  if (io_this == NULL || o_config == NULL || io_this->stateLookup == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != NULL)
+  {
+    *o_config = io_this->config;
+    return FSM_RC_OK;
+  }
+  if (io_this->hasInitialState == false || io_this->statesCount == 0 || io_this->statesCount >= FSM_INDEX_NONE)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* Every transition must target an added state */
+  for (const struct fsm_builder_state *state = io_this->states; state != NULL; state = state->next)
+  {
+    for (const fsm_builder_transition_t *t = state->transitions; t != NULL; t = t->next)
+    {
+      if ((uint32_t)t->cfg.toState >= io_this->stateEnumCount || io_this->stateLookup[t->cfg.toState] == NULL)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+    }
+  }
+
+  /* Lay out states and transitions contiguously */
+  fsm_state_cfg_t *states = arena_alloc(io_this, sizeof(fsm_state_cfg_t) * io_this->statesCount);
+  fsm_transition_cfg_t *transitions = arena_alloc(io_this, sizeof(fsm_transition_cfg_t) * io_this->transitionsCount);
+  fsm_cfg_t *config = arena_alloc(io_this, sizeof(fsm_cfg_t));
+  if (states == NULL || (transitions == NULL && io_this->transitionsCount > 0) || config == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  uint32_t stateIndex = 0;
+  fsm_transition_cfg_t *stateTransitions = transitions;
+  for (const struct fsm_builder_state *state = io_this->states; state != NULL; state = state->next, stateIndex++)
+  {
+    uint32_t t = 0;
+    for (const fsm_builder_transition_t *transition = state->transitions; transition != NULL; transition = transition->next)
+    {
+      memcpy(&stateTransitions[t++], &transition->cfg, sizeof(fsm_transition_cfg_t));
+    }
+
+    const fsm_state_cfg_t stateCfg = {
+        .state = state->state,
+        .subFsm = state->subFsm,
+        .entryAction = state->actions[0],
+        .doAction = state->actions[1],
+        .exitAction = state->actions[2],
+        .transitions = (state->transitionsCount > 0) ? stateTransitions : NULL,
+        .transitionsCount = state->transitionsCount,
+        .subCfg = state->subCfg,
+        .regions = state->regions,
+    };
+    memcpy(&states[stateIndex], &stateCfg, sizeof(stateCfg));
+    stateTransitions += state->transitionsCount;
+  }
+
+  /* Attach the dense or the row displaced dispatch table, none for linear */
+  fsm_dispatch_t *dispatch = NULL;
+  const fsm_packed_t *packed = NULL;
+  if (io_this->isLinear == false && io_this->isPacked == true)
+  {
+    if (build_packed(io_this, states, &packed) != FSM_RC_OK)
+    {
+      return FSM_RC_ERROR;
+    }
+  }
+  else if (io_this->isLinear == false)
+  {
+    uint32_t cellsCount = io_this->statesCount * io_this->eventEnumCount;
+    fsm_dispatch_cell_t *cells = arena_alloc(io_this, sizeof(fsm_dispatch_cell_t) * cellsCount);
+    fsm_index_t *stateIndex = arena_alloc(io_this, sizeof(fsm_index_t) * io_this->stateEnumCount);
+    dispatch = arena_alloc(io_this, sizeof(fsm_dispatch_t));
+    if (cells == NULL || stateIndex == NULL || dispatch == NULL)
+    {
+      return FSM_RC_ERROR;
+    }
+    const fsm_dispatch_t dispatchCfg = {
+        .stateIndex = stateIndex,
+        .stateIndexCount = io_this->stateEnumCount,
+        .cells = cells,
+        .cellsCount = cellsCount,
+    };
+    memcpy(dispatch, &dispatchCfg, sizeof(dispatchCfg));
+  }
+
+  const fsm_cfg_t cfg = {
+      .initialState = io_this->initialState,
+      .states = states,
+      .statesCount = io_this->statesCount,
+      .dispatch = dispatch,
+      .packed = packed,
+      .stateEnumCount = io_this->stateEnumCount,
+      .eventEnumCount = io_this->eventEnumCount,
+  };
+  memcpy(config, &cfg, sizeof(cfg));
+
+  /* Same checks as fsm_init, also builds the dispatch table */
+  fsm_RC_t res = fsm_cfg_prepare(config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  io_this->config = config;
+  *o_config = config;
+  return FSM_RC_OK;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void *arena_alloc(fsm_builder_t *const io_this, size_t i_size)
+{
+  if (i_size == 0)
+  {
+    return NULL;
+  }
+
+  /* Bump allocate from the newest block */
+  struct fsm_builder_block *block = io_this->blocks;
+  if (block != NULL)
+  {
+    uintptr_t data = (uintptr_t)(block + 1);
+    uintptr_t start = (data + block->used + (ARENA_ALIGN - 1u)) & ~(uintptr_t)(ARENA_ALIGN - 1u);
+    if (start + i_size <= data + block->size)
+    {
+      block->used = (size_t)(start + i_size - data);
+      return (void *)start;
+    }
+  }
+
+  /* New block, large allocations get a block of their own size */
+  size_t size = (i_size + ARENA_ALIGN > io_this->blockSize) ? i_size + ARENA_ALIGN : io_this->blockSize;
+  block = calloc(1, sizeof(*block) + size);
+  if (block == NULL)
+  {
+    return NULL;
+  }
+  block->size = size;
+  block->next = io_this->blocks;
+  io_this->blocks = block;
+
+  uintptr_t data = (uintptr_t)(block + 1);
+  uintptr_t start = (data + (ARENA_ALIGN - 1u)) & ~(uintptr_t)(ARENA_ALIGN - 1u);
+  block->used = (size_t)(start + i_size - data);
+  return (void *)start;
+}
+
+static fsm_RC_t get_state(const fsm_builder_t *const i_this,
+                          fsm_state_t i_state,
+                          struct fsm_builder_state **const o_state)
+{
+  if (i_this == NULL || i_this->stateLookup == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_this->config != NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  if ((uint32_t)i_state >= i_this->stateEnumCount || i_this->stateLookup[i_state] == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  *o_state = i_this->stateLookup[i_state];
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t build_packed(fsm_builder_t *const io_this,
+                             const fsm_state_cfg_t *const i_states,
+                             const fsm_packed_t **const o_packed)
+{
+  const uint32_t statesCount = io_this->statesCount;
+  const uint32_t eventCount = io_this->eventEnumCount;
+
+  /* Worst case every row gets cells of its own */
+  size_t capacity = (size_t)statesCount * eventCount + eventCount;
+  fsm_packed_cell_t *cells = malloc(sizeof(fsm_packed_cell_t) * capacity);
+  uint32_t *order = malloc(sizeof(uint32_t) * statesCount);
+  uint32_t *rowBase = arena_alloc(io_this, sizeof(uint32_t) * statesCount);
+  fsm_index_t *stateIndex = arena_alloc(io_this, sizeof(fsm_index_t) * io_this->stateEnumCount);
+  fsm_packed_t *packed = arena_alloc(io_this, sizeof(fsm_packed_t));
+  if (cells == NULL || order == NULL || rowBase == NULL || stateIndex == NULL || packed == NULL)
+  {
+    free(cells);
+    free(order);
+    return FSM_RC_ERROR;
+  }
+  for (size_t c = 0; c < capacity; c++)
+  {
+    cells[c].state = FSM_INDEX_NONE;
+    cells[c].transition = FSM_INDEX_NONE;
+    cells[c].toState = FSM_INDEX_NONE;
+  }
+  for (uint32_t i = 0; i < io_this->stateEnumCount; i++)
+  {
+    stateIndex[i] = FSM_INDEX_NONE;
+  }
+  for (uint32_t i = 0; i < statesCount; i++)
+  {
+    stateIndex[i_states[i].state] = (fsm_index_t)i;
+  }
+
+  /* Fullest rows first, transitions are sorted by event */
+  uint32_t ordered = 0;
+  for (uint32_t count = eventCount + 1u; count-- > 0;)
+  {
+    for (uint32_t i = 0; i < statesCount; i++)
+    {
+      uint32_t handled = 0;
+      for (uint32_t t = 0; t < i_states[i].transitionsCount; t++)
+      {
+        if (t == 0 || i_states[i].transitions[t].event != i_states[i].transitions[t - 1u].event)
+        {
+          handled++;
+        }
+      }
+      if (handled == count)
+      {
+        order[ordered++] = i;
+      }
+    }
+  }
+
+  uint32_t maxBase = 0;
+  for (uint32_t o = 0; o < statesCount; o++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_states[order[o]];
+
+    /* First base where all handled events hit unused cells */
+    uint32_t base = 0;
+    for (bool fits = false; fits == false; base += (fits ? 0u : 1u))
+    {
+      fits = true;
+      for (uint32_t t = 0; t < stateCfg->transitionsCount && fits; t++)
+      {
+        fits = cells[base + (uint32_t)stateCfg->transitions[t].event].state == FSM_INDEX_NONE;
+      }
+    }
+
+    /* The first transition for an event wins */
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      fsm_packed_cell_t *cell = &cells[base + (uint32_t)stateCfg->transitions[t].event];
+      if (cell->state == FSM_INDEX_NONE)
+      {
+        cell->state = (fsm_index_t)order[o];
+        cell->transition = (fsm_index_t)t;
+        cell->toState = stateIndex[stateCfg->transitions[t].toState];
+      }
+    }
+    rowBase[order[o]] = base;
+    maxBase = (base > maxBase) ? base : maxBase;
+  }
+  free(order);
+
+  uint32_t cellsCount = maxBase + eventCount;
+  fsm_packed_cell_t *packedCells = arena_alloc(io_this, sizeof(fsm_packed_cell_t) * cellsCount);
+  if (packedCells == NULL)
+  {
+    free(cells);
+    return FSM_RC_ERROR;
+  }
+  memcpy(packedCells, cells, sizeof(fsm_packed_cell_t) * cellsCount);
+  free(cells);
+
+  packed->stateIndex = stateIndex;
+  packed->stateIndexCount = io_this->stateEnumCount;
+  packed->rowSize = eventCount;
+  packed->rowBase = rowBase;
+  packed->cells = packedCells;
+  packed->cellsCount = cellsCount;
+  *o_packed = packed;
+  return FSM_RC_OK;
+}
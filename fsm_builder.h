@@ -0,0 +1,248 @@
+/**
+ * @file       fsm_builder.h
+ * @brief      Runtime builder for FSM configurations
+ *
+ *             Builds a fsm_cfg_t at runtime, e.g. from rule files, instead of
+ *             a compile time compound literal. All memory, the staged states
+ *             and transitions as well as the finalized configuration, comes
+ *             from one arena of large blocks which is freed in one call.
+ *             The finalized configuration stores the states in the order they
+ *             were added and the transitions of each state contiguously,
+ *             sorted by event, with a dense or row displaced dispatch table
+ *             attached. A linear builder keeps the transitions in the order
+ *             they were added and attaches no table instead.
+ *
+ *             fsm_builder_init(&builder, 0);
+ *             fsm_builder_add_state(&builder, FSM_STATE_MAIN_1);
+ *             fsm_builder_set_actions(&builder, FSM_STATE_MAIN_1, entry, doAction, exit);
+ *             fsm_builder_add_transition(&builder, FSM_STATE_MAIN_1, &transition);
+ *             fsm_builder_set_initial(&builder, FSM_STATE_MAIN_1);
+ *             fsm_builder_finalize(&builder, &config);
+ *             fsm_init(&fsm, config);
+ *             ...
+ *             fsm_builder_free(&builder); (config is invalid afterwards)
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_BUILDER_H_
+#define FSM_BUILDER_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_BUILDER_BLOCK_SIZE 65536u /**< Default size of an arena block */
+
+struct fsm_builder_block; /**< Forward declaration of an arena block */
+struct fsm_builder_state; /**< Forward declaration of a staged state */
+
+/**
+ * @brief Builder Struct
+ */
+typedef struct
+{
+  struct fsm_builder_block *blocks;       /**< Arena blocks, newest first */
+  size_t blockSize;                       /**< Minimum size of a new block */
+  struct fsm_builder_state **stateLookup; /**< State enum to staged state, stateEnumCount entries */
+  uint32_t stateEnumCount;                /**< Size of the state enum, see fsm_builder_set_enums */
+  uint32_t eventEnumCount;                /**< Size of the event enum, see fsm_builder_set_enums */
+  struct fsm_builder_state *states;       /**< Staged states in the order they were added */
+  struct fsm_builder_state *lastState;    /**< Last staged state */
+  uint32_t statesCount;                   /**< Number of staged states */
+  uint32_t transitionsCount;              /**< Number of staged transitions */
+  fsm_state_t initialState;               /**< The initial state */
+  bool hasInitialState;                   /**< Set by fsm_builder_set_initial */
+  bool isPacked;                          /**< Attach a row displaced instead of a dense dispatch table */
+  bool isLinear;                          /**< Keep the transition order and attach no dispatch table */
+  const fsm_cfg_t *config;                /**< Finalized configuration, null before fsm_builder_finalize */
+} fsm_builder_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize a builder and allocate its first arena block
+ *
+ * @param o_this Pointer to the builder to initialize
+ * @param i_blockSize Minimum size of an arena block, 0 for FSM_BUILDER_BLOCK_SIZE
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if the allocation failed, error
+ *         code otherwise
+ */
+fsm_RC_t fsm_builder_init(fsm_builder_t *const o_this, size_t i_blockSize);
+
+/**
+ * @brief Free the arena, including the finalized configuration
+ *
+ * @param io_this Pointer to the builder
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_builder_free(fsm_builder_t *const io_this);
+
+/**
+ * @brief Build a machine with its own state and event enums, see FSM_ENUM
+ *
+ * Sets stateEnumCount and eventEnumCount of the configuration and sizes the
+ * dispatch table to them, by default the enums of fsm_events_states.h are
+ * used. Call before adding the first state.
+ *
+ * @param io_this Pointer to the builder
+ * @param i_stateEnumCount Size of the state enum, 0 for FSM_STATE_COUNT
+ * @param i_eventEnumCount Size of the event enum, 0 for FSM_EVENT_COUNT
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if states are added already or
+ *         the allocation failed, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_enums(fsm_builder_t *const io_this, uint32_t i_stateEnumCount, uint32_t i_eventEnumCount);
+
+/**
+ * @brief Add a state without actions and transitions
+ *
+ * @param io_this Pointer to the builder
+ * @param i_state The state to add
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the state is out of
+ *         range or already added, error code otherwise
+ */
+fsm_RC_t fsm_builder_add_state(fsm_builder_t *const io_this, fsm_state_t i_state);
+
+/**
+ * @brief Set the entry, do and exit action of an added state
+ *
+ * @param io_this Pointer to the builder
+ * @param i_state The state
+ * @param i_entryAction Action performed on state entry, {NULL, NULL} for none
+ * @param i_doAction Action performed during every event, {NULL, NULL} for none
+ * @param i_exitAction Action performed on state exit, {NULL, NULL} for none
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the state is not
+ *         added, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_actions(fsm_builder_t *const io_this,
+                                 fsm_state_t i_state,
+                                 fsm_action_t i_entryAction,
+                                 fsm_action_t i_doAction,
+                                 fsm_action_t i_exitAction);
+
+/**
+ * @brief Set the sub fsm run during an added state
+ *
+ * @param io_this Pointer to the builder
+ * @param i_state The state
+ * @param i_subFsm The sub fsm, null for none
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the state is not
+ *         added, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_sub_fsm(fsm_builder_t *const io_this, fsm_state_t i_state, const fsm_t *const i_subFsm);
+
+/**
+ * @brief Set the sub configuration run during an added state
+ *
+ * @param io_this Pointer to the builder
+ * @param i_state The state
+ * @param i_subCfg The sub configuration, e.g. finalized by another builder,
+ *                 null for none
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the state is not
+ *         added, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_sub_cfg(fsm_builder_t *const io_this, fsm_state_t i_state, const fsm_cfg_t *const i_subCfg);
+
+/**
+ * @brief Set the orthogonal regions active during an added state
+ *
+ * @param io_this Pointer to the builder
+ * @param i_state The state
+ * @param i_regions The regions, must stay valid, null for none
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the state is not
+ *         added, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_regions(fsm_builder_t *const io_this,
+                                 fsm_state_t i_state,
+                                 const fsm_regions_t *const i_regions);
+
+/**
+ * @brief Add a transition to an added state
+ *
+ * If several transitions of a state share an event, the first added wins.
+ *
+ * @param io_this Pointer to the builder
+ * @param i_fromState The state the transition leaves
+ * @param i_transition The transition, copied into the arena
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the state is not
+ *         added or the event is out of range, error code otherwise
+ */
+fsm_RC_t fsm_builder_add_transition(fsm_builder_t *const io_this,
+                                    fsm_state_t i_fromState,
+                                    const fsm_transition_cfg_t *const i_transition);
+
+/**
+ * @brief Set the initial state
+ *
+ * @param io_this Pointer to the builder
+ * @param i_state The initial state
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_initial(fsm_builder_t *const io_this, fsm_state_t i_state);
+
+/**
+ * @brief Select the dispatch table attached by fsm_builder_finalize
+ *
+ * The row displaced table (fsm_packed_t) overlaps the rows of all states and
+ * needs less memory for sparse machines, the dense table is the default.
+ *
+ * @param io_this Pointer to the builder
+ * @param i_isPacked true for the row displaced table
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_builder_set_packed(fsm_builder_t *const io_this, bool i_isPacked);
+
+/**
+ * @brief Build a configuration for linear lookups in a given order
+ *
+ * The transitions of each state are kept in the order they are added instead
+ * of being sorted by event, and no dispatch table is attached, so fsm_process
+ * scans states and transitions in the order they were added. Suits sparse
+ * machines with their most frequent transitions added first, see
+ * fsm_reorder.h. Overrides fsm_builder_set_packed.
+ *
+ * @param io_this Pointer to the builder, without transitions added
+ * @param i_isLinear true for linear lookups
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if transitions are added already,
+ *         error code otherwise
+ */
+fsm_RC_t fsm_builder_set_linear(fsm_builder_t *const io_this, bool i_isLinear);
+
+/**
+ * @brief Lay out and check the configuration
+ *
+ * Applies the checks of fsm_init and additionally requires every transition
+ * to target an added state. The builder can not be changed afterwards.
+ *
+ * @param io_this Pointer to the builder
+ * @param o_config The configuration, valid until fsm_builder_free
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the
+ *         configuration is invalid, error code otherwise
+ */
+fsm_RC_t fsm_builder_finalize(fsm_builder_t *const io_this, const fsm_cfg_t **const o_config);
+
+#endif /* FSM_BUILDER_H_ */
@@ -0,0 +1,147 @@
+/**
+ * @file       fsm_event.c
+ * @brief      Pooled, reference counted event objects with payload
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_event.h"    /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define HEAD_INDEX(head) ((uint32_t)((head) & UINT32_MAX))             /**< Index + 1 of a free list head */
+#define HEAD_NEXT(head, index) ((((head) >> 32) + 1u) << 32 | (index)) /**< Next tagged head */
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_event_pool_init(fsm_event_pool_t *const o_this,
+                             fsm_event_obj_t *const i_objects,
+                             uint32_t i_objectsCount)
+{
+  if (o_this == NULL || i_objects == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_objectsCount == 0 || i_objectsCount == UINT32_MAX)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  o_this->objects = i_objects;
+  o_this->objectsCount = i_objectsCount;
+  for (uint32_t i = 0; i < i_objectsCount; i++)
+  {
+    i_objects[i].head.retain = fsm_event_retain;
+    i_objects[i].head.release = fsm_event_release;
+    i_objects[i].pool = o_this;
+    i_objects[i].payload = NULL;
+    i_objects[i].length = 0;
+    atomic_init(&i_objects[i].refCount, 0);
+    /* Chain to the next object, the last one ends the list */
+    atomic_init(&i_objects[i].nextFree, (i + 1u < i_objectsCount) ? i + 2u : 0u);
+  }
+  atomic_init(&o_this->freeHead, 1u);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_event_alloc(fsm_event_pool_t *const io_this,
+                         fsm_event_t i_event,
+                         void *const i_payload,
+                         size_t i_length,
+                         fsm_event_obj_t **const o_obj)
+{
+  if (io_this == NULL || o_obj == NULL || io_this->objects == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Pop the first free object */
+  uint_fast64_t head = atomic_load_explicit(&io_this->freeHead, memory_order_acquire);
+  fsm_event_obj_t *obj;
+  do
+  {
+    uint32_t index = HEAD_INDEX(head);
+    if (index == 0)
+    {
+      return FSM_RC_ERROR_POOL_EMPTY;
+    }
+    obj = &io_this->objects[index - 1u];
+    /* May be stale if another thread popped the object, the tag fails the exchange then */
+    uint32_t next = atomic_load_explicit(&obj->nextFree, memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(&io_this->freeHead, &head, HEAD_NEXT(head, next),
+                                              memory_order_acquire, memory_order_acquire))
+    {
+      break;
+    }
+  } while (true);
+
+  obj->event = i_event;
+  obj->payload = i_payload;
+  obj->length = i_length;
+  atomic_store_explicit(&obj->refCount, 1u, memory_order_relaxed);
+  *o_obj = obj;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_event_retain(fsm_event_obj_t *const io_obj)
+{
+  if (io_obj == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  atomic_fetch_add_explicit(&io_obj->refCount, 1u, memory_order_relaxed);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_event_release(fsm_event_obj_t *const io_obj)
+{
+  if (io_obj == NULL || io_obj->pool == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  unsigned int refCount = atomic_fetch_sub_explicit(&io_obj->refCount, 1u, memory_order_release);
+  if (refCount == 0)
+  {
+    /* Released more often than retained, undo */
+    atomic_fetch_add_explicit(&io_obj->refCount, 1u, memory_order_relaxed);
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  if (refCount > 1u)
+  {
+    return FSM_RC_OK;
+  }
+
+  /* Last reference, make all uses happen before the reuse */
+  atomic_thread_fence(memory_order_acquire);
+  fsm_event_pool_t *pool = io_obj->pool;
+  uint32_t index = (uint32_t)(io_obj - pool->objects) + 1u;
+  uint_fast64_t head = atomic_load_explicit(&pool->freeHead, memory_order_relaxed);
+  do
+  {
+    atomic_store_explicit(&io_obj->nextFree, HEAD_INDEX(head), memory_order_relaxed);
+  } while (!atomic_compare_exchange_weak_explicit(&pool->freeHead, &head, HEAD_NEXT(head, index),
+                                                  memory_order_release, memory_order_relaxed));
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_process_event(fsm_t *const io_this, fsm_event_obj_t *const io_obj)
+{
+  if (io_obj == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* The core releases the reference, after processing or once dequeued */
+  return fsm_process_obj(io_this, io_obj->event, io_obj);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file       fsm_event.h
+ * @brief      Pooled, reference counted event objects with payload
+ *
+ *             An event object carries the event and a pointer to its payload,
+ *             which is never copied. Objects come from a fixed size lock-free
+ *             pool and are reference counted; the last fsm_event_release
+ *             returns an object to the pool. Objects are provided by the
+ *             caller, no allocation takes place. Requires C11 atomics.
+ *
+ *             fsm_process_event runs fsm_process with the object. Guards and
+ *             actions set with eventFunc (see fsm_action_t) receive it next to
+ *             the static fsm_arg_t of the configuration, sub fsms and regions
+ *             get it passed on. Processed from an action of the same
+ *             instance, the object is queued with the event like fsm_raise
+ *             and keeps its reference until it is processed. An action which
+ *             needs the payload after processing takes its own reference with
+ *             fsm_event_retain.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_EVENT_H_
+#define FSM_EVENT_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stdatomic.h> /* for atomics */
+#include <stddef.h>    /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_EVENT_CACHE_LINE 64u /**< Separates the free list head */
+
+struct fsm_event_pool; /**< Forward declaration of the event pool */
+
+/**
+ * @brief Event Object
+ */
+struct fsm_event_obj
+{
+  fsm_event_head_t head;       /**< Reference counting for the core, first member */
+  fsm_event_t event;           /**< The event */
+  void *payload;               /**< Payload, owned by the caller */
+  size_t length;               /**< Length of the payload */
+  atomic_uint refCount;        /**< References, the object is free at 0 */
+  atomic_uint nextFree;        /**< Next free object as index + 1, pool internal */
+  struct fsm_event_pool *pool; /**< Pool the object belongs to */
+};
+
+/**
+ * @brief Event Pool Struct
+ *
+ * Free list as a lock-free stack of object indices. The head holds a tag in
+ * its upper 32 bits against ABA.
+ */
+typedef struct fsm_event_pool
+{
+  fsm_event_obj_t *objects;                                     /**< Object storage */
+  uint32_t objectsCount;                                        /**< Number of objects */
+  _Alignas(FSM_EVENT_CACHE_LINE) atomic_uint_fast64_t freeHead; /**< Tag << 32 | index + 1 of the first free object, 0 if empty */
+} fsm_event_pool_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize a pool, all objects are free
+ *
+ * @param o_this Pointer to the pool to initialize
+ * @param i_objects Storage for the objects
+ * @param i_objectsCount Number of objects, less than UINT32_MAX
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_event_pool_init(fsm_event_pool_t *const o_this,
+                             fsm_event_obj_t *const i_objects,
+                             uint32_t i_objectsCount);
+
+/**
+ * @brief Take an object from the pool, from any thread
+ *
+ * @param io_this Pointer to the pool
+ * @param i_event The event
+ * @param i_payload [optional] Payload, referenced and not copied
+ * @param i_length Length of the payload
+ * @param o_obj The object with a reference count of 1
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_POOL_EMPTY if no object is free,
+ *         error code otherwise
+ */
+fsm_RC_t fsm_event_alloc(fsm_event_pool_t *const io_this,
+                         fsm_event_t i_event,
+                         void *const i_payload,
+                         size_t i_length,
+                         fsm_event_obj_t **const o_obj);
+
+/**
+ * @brief Take an additional reference, from any thread
+ *
+ * @param io_obj The object
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_event_retain(fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Drop a reference, the last one returns the object to its pool
+ *
+ * @param io_obj The object
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_event_release(fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Process an event object, consumes the reference of the caller
+ *
+ * Same as fsm_process with the event of the object, which is passed to the
+ * guards and actions set with eventFunc. The reference is released when
+ * processing completes, also on error. Called from an action of the instance,
+ * the object is queued and released once it is processed or dropped.
+ *
+ * @param io_this Pointer to the FSM instance
+ * @param io_obj The event object
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_process_event(fsm_t *const io_this, fsm_event_obj_t *const io_obj);
+
+#endif /* FSM_EVENT_H_ */
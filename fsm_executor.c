@@ -0,0 +1,475 @@
+/**
+ * @file       fsm_executor.c
+ * @brief      Multi-core executor for FSM instances
+ *
+ *             Every worker sweeps over the instances of its shard and
+ *             dispatches at most FSM_EXECUTOR_BATCH pending events per
+ *             instance and sweep. An instance is claimed with an atomic flag
+ *             while its events are dispatched or while it is moved, the shard
+ *             lock only guards adding to and removing from the instances
+ *             array and is never held while events are processed.
+ *             A worker without events steals one instance with pending events
+ *             from another shard, skipping the instances claimed meanwhile.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* nanosleep, pthreads */
+
+#include "fsm_executor.h" /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <pthread.h> /* for threads and mutexes */
+#include <sched.h>   /* for sched_yield */
+#include <stdlib.h>  /* for aligned_alloc, calloc, free */
+#include <string.h>  /* for memset */
+#include <time.h>    /* for nanosleep */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define EXECUTOR_SPIN_ROUNDS 16u      /**< Idle rounds yielding before sleeping */
+#define EXECUTOR_IDLE_SLEEP_NS 50000L /**< Sleep of an idle worker */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Added Instance
+ *
+ * Stays in place while the instance moves between the shards.
+ */
+struct fsm_executor_entry
+{
+  _Alignas(FSM_QUEUE_CACHE_LINE) fsm_queue_t *queue; /**< Event queue of the instance */
+  atomic_uint owner;                                 /**< Index of the worker owning the instance */
+  atomic_bool isClaimed;                             /**< Set while a worker dispatches or moves the instance */
+};
+
+/**
+ * @brief Worker Shard
+ */
+struct fsm_executor_worker
+{
+  _Alignas(FSM_QUEUE_CACHE_LINE) fsm_executor_t *executor; /**< Owning executor */
+  uint32_t index;                                          /**< Index of the worker */
+  pthread_t thread;                                        /**< Worker thread */
+  pthread_mutex_t lock;                                    /**< Guards adding to and removing from the instances */
+  _Atomic(struct fsm_executor_entry *) *instances;         /**< Instances of the shard, maxInstances capacity */
+  atomic_uint instancesCount;                              /**< Number of instances in the shard */
+  atomic_uint_fast64_t events;                             /**< See fsm_executor_stats_t */
+  atomic_uint_fast64_t errors;                             /**< See fsm_executor_stats_t */
+  atomic_uint_fast64_t rounds;                             /**< See fsm_executor_stats_t */
+  atomic_uint_fast64_t idleRounds;                         /**< See fsm_executor_stats_t */
+  atomic_uint_fast64_t steals;                             /**< See fsm_executor_stats_t */
+};
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Worker thread function
+ *
+ * @param i_worker The worker (struct fsm_executor_worker *)
+ *
+ * @return Always null
+ */
+static void *worker_main(void *i_worker);
+
+/**
+ * @brief Dispatch a batch of events of every instance of the shard
+ *
+ * @param io_worker The worker
+ * @param o_events Number of dispatched events
+ * @param o_errors Number of failed events
+ */
+static void worker_sweep(struct fsm_executor_worker *const io_worker, uint64_t *const o_events, uint64_t *const o_errors);
+
+/**
+ * @brief Steal one instance with pending events from another shard
+ *
+ * @param io_worker The idle worker
+ *
+ * @return true if an instance was stolen
+ */
+static bool steal_instance(struct fsm_executor_worker *const io_worker);
+
+/**
+ * @brief Remove a claimed instance with pending events from a shard, takes the shard lock
+ *
+ * @param io_victim The worker owning the shard
+ * @param i_thief Index of the worker taking the instance
+ *
+ * @return The instance, null if the shard has none to give
+ */
+static struct fsm_executor_entry *shard_take(struct fsm_executor_worker *const io_victim, uint32_t i_thief);
+
+/**
+ * @brief Append an instance to a shard, takes the shard lock
+ *
+ * @param io_worker The worker owning the shard
+ * @param i_entry The instance, owner already set
+ */
+static void shard_append(struct fsm_executor_worker *const io_worker, struct fsm_executor_entry *const i_entry);
+
+/**
+ * @brief Allocate zeroed memory aligned to a cache line
+ *
+ * @param i_size Size of the memory, rounded up to cache lines
+ *
+ * @return The memory, null if the allocation failed
+ */
+static void *alloc_aligned(size_t i_size);
+
+/**
+ * @brief Add to a counter which is only written by its worker
+ *
+ * @param io_counter The counter
+ * @param i_value Value to add
+ */
+static void counter_add(atomic_uint_fast64_t *const io_counter, uint64_t i_value);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_executor_init(fsm_executor_t *const io_this, uint32_t i_workersCount, uint32_t i_maxInstances)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_workersCount == 0 || i_maxInstances == 0)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Cache line aligned, calloc only guarantees the alignment of the basic types */
+  io_this->workers = alloc_aligned(i_workersCount * sizeof(struct fsm_executor_worker));
+  io_this->entries = alloc_aligned(i_maxInstances * sizeof(struct fsm_executor_entry));
+  if (io_this->workers == NULL || io_this->entries == NULL)
+  {
+    free(io_this->workers);
+    free(io_this->entries);
+    io_this->workers = NULL;
+    io_this->entries = NULL;
+    return FSM_RC_ERROR;
+  }
+  io_this->workersCount = i_workersCount;
+  io_this->maxInstances = i_maxInstances;
+  io_this->instancesCount = 0;
+  atomic_init(&io_this->isRunning, false);
+
+  for (uint32_t i = 0; i < i_workersCount; i++)
+  {
+    struct fsm_executor_worker *worker = &io_this->workers[i];
+    worker->executor = io_this;
+    worker->index = i;
+    /* Every shard can hold all instances, stealing never runs out of space */
+    worker->instances = calloc(i_maxInstances, sizeof(*worker->instances));
+    if (worker->instances == NULL || pthread_mutex_init(&worker->lock, NULL) != 0)
+    {
+      free(worker->instances);
+      worker->instances = NULL;
+      io_this->workersCount = i;
+      fsm_executor_deinit(io_this);
+      return FSM_RC_ERROR;
+    }
+    atomic_init(&worker->instancesCount, 0);
+    atomic_init(&worker->events, 0);
+    atomic_init(&worker->errors, 0);
+    atomic_init(&worker->rounds, 0);
+    atomic_init(&worker->idleRounds, 0);
+    atomic_init(&worker->steals, 0);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_executor_deinit(fsm_executor_t *const io_this)
+{
+  if (io_this == NULL || io_this->workers == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (atomic_load(&io_this->isRunning) == true)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  for (uint32_t i = 0; i < io_this->workersCount; i++)
+  {
+    pthread_mutex_destroy(&io_this->workers[i].lock);
+    free((void *)io_this->workers[i].instances);
+  }
+  free(io_this->workers);
+  free(io_this->entries);
+  io_this->workers = NULL;
+  io_this->entries = NULL;
+  io_this->workersCount = 0;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_executor_add(fsm_executor_t *const io_this, fsm_queue_t *const i_queue)
+{
+  if (io_this == NULL || io_this->workers == NULL || i_queue == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->instancesCount >= io_this->maxInstances)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Pick the least loaded shard */
+  struct fsm_executor_worker *target = &io_this->workers[0];
+  for (uint32_t i = 1; i < io_this->workersCount; i++)
+  {
+    if (atomic_load_explicit(&io_this->workers[i].instancesCount, memory_order_relaxed) <
+        atomic_load_explicit(&target->instancesCount, memory_order_relaxed))
+    {
+      target = &io_this->workers[i];
+    }
+  }
+
+  struct fsm_executor_entry *entry = &io_this->entries[io_this->instancesCount];
+  entry->queue = i_queue;
+  atomic_init(&entry->owner, target->index);
+  atomic_init(&entry->isClaimed, false);
+  shard_append(target, entry);
+  io_this->instancesCount++;
+  return FSM_RC_OK;
+}
+fsm_RC_t fsm_executor_start(fsm_executor_t *const io_this)
+{
+  if (io_this == NULL || io_this->workers == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (atomic_exchange(&io_this->isRunning, true) == true)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  for (uint32_t i = 0; i < io_this->workersCount; i++)
+  {
+    if (pthread_create(&io_this->workers[i].thread, NULL, worker_main, &io_this->workers[i]) != 0)
+    {
+      /* Stop the already started workers */
+      atomic_store(&io_this->isRunning, false);
+      for (uint32_t j = 0; j < i; j++)
+      {
+        pthread_join(io_this->workers[j].thread, NULL);
+      }
+      return FSM_RC_ERROR;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_executor_stop(fsm_executor_t *const io_this)
+{
+  if (io_this == NULL || io_this->workers == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (atomic_exchange(&io_this->isRunning, false) == false)
+  {
+    return FSM_RC_ERROR;
+  }
+
+  for (uint32_t i = 0; i < io_this->workersCount; i++)
+  {
+    pthread_join(io_this->workers[i].thread, NULL);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_executor_get_stats(const fsm_executor_t *const i_this,
+                                uint32_t i_worker,
+                                fsm_executor_stats_t *const o_stats)
+{
+  if (i_this == NULL || i_this->workers == NULL || o_stats == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_worker >= i_this->workersCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  struct fsm_executor_worker *worker = &i_this->workers[i_worker];
+  o_stats->events = atomic_load_explicit(&worker->events, memory_order_relaxed);
+  o_stats->errors = atomic_load_explicit(&worker->errors, memory_order_relaxed);
+  o_stats->rounds = atomic_load_explicit(&worker->rounds, memory_order_relaxed);
+  o_stats->idleRounds = atomic_load_explicit(&worker->idleRounds, memory_order_relaxed);
+  o_stats->steals = atomic_load_explicit(&worker->steals, memory_order_relaxed);
+  o_stats->instances = atomic_load_explicit(&worker->instancesCount, memory_order_relaxed);
+  return FSM_RC_OK;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void *worker_main(void *i_worker)
+{
+  struct fsm_executor_worker *worker = (struct fsm_executor_worker *)i_worker;
+  fsm_executor_t *executor = worker->executor;
+  uint32_t idleStreak = 0;
+
+  while (atomic_load_explicit(&executor->isRunning, memory_order_acquire) == true)
+  {
+    uint64_t events = 0;
+    uint64_t errors = 0;
+    worker_sweep(worker, &events, &errors);
+
+    counter_add(&worker->rounds, 1);
+    counter_add(&worker->events, events);
+    counter_add(&worker->errors, errors);
+
+    if (events > 0)
+    {
+      idleStreak = 0;
+      continue;
+    }
+
+    /* Shard idle, look for work elsewhere */
+    counter_add(&worker->idleRounds, 1);
+    if (steal_instance(worker) == true)
+    {
+      idleStreak = 0;
+      continue;
+    }
+    if (idleStreak < EXECUTOR_SPIN_ROUNDS)
+    {
+      idleStreak++;
+      sched_yield();
+    }
+    else
+    {
+      struct timespec sleepTime = {0, EXECUTOR_IDLE_SLEEP_NS};
+      nanosleep(&sleepTime, NULL);
+    }
+  }
+  return NULL;
+}
+
+static void worker_sweep(struct fsm_executor_worker *const io_worker, uint64_t *const o_events, uint64_t *const o_errors)
+{
+  /* Instances taken by thieves meanwhile are skipped, appended ones picked up next sweep */
+  uint32_t count = atomic_load_explicit(&io_worker->instancesCount, memory_order_acquire);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    struct fsm_executor_entry *entry = atomic_load_explicit(&io_worker->instances[i], memory_order_relaxed);
+    if (entry == NULL || atomic_exchange_explicit(&entry->isClaimed, true, memory_order_acquire) == true)
+    {
+      continue;
+    }
+
+    /* Still ours once claimed, a thief moves it only while holding the claim */
+    if (atomic_load_explicit(&entry->owner, memory_order_relaxed) == io_worker->index)
+    {
+      size_t dispatched = 0;
+      if (fsm_queue_dispatch(entry->queue, FSM_EXECUTOR_BATCH, &dispatched) != FSM_RC_OK)
+      {
+        (*o_errors)++;
+      }
+      *o_events += dispatched;
+    }
+    atomic_store_explicit(&entry->isClaimed, false, memory_order_release);
+  }
+}
+
+static bool steal_instance(struct fsm_executor_worker *const io_worker)
+{
+  fsm_executor_t *executor = io_worker->executor;
+
+  for (uint32_t k = 1; k < executor->workersCount; k++)
+  {
+    struct fsm_executor_worker *victim = &executor->workers[(io_worker->index + k) % executor->workersCount];
+
+    /* Leave the victim at least one instance */
+    if (atomic_load_explicit(&victim->instancesCount, memory_order_relaxed) < 2)
+    {
+      continue;
+    }
+
+    struct fsm_executor_entry *stolen = shard_take(victim, io_worker->index);
+    if (stolen != NULL)
+    {
+      shard_append(io_worker, stolen);
+      atomic_store_explicit(&stolen->isClaimed, false, memory_order_release);
+      counter_add(&io_worker->steals, 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+static struct fsm_executor_entry *shard_take(struct fsm_executor_worker *const io_victim, uint32_t i_thief)
+{
+  struct fsm_executor_entry *stolen = NULL;
+
+  /* Only held for the scan, the victim sweeps without it */
+  pthread_mutex_lock(&io_victim->lock);
+  uint32_t count = atomic_load_explicit(&io_victim->instancesCount, memory_order_relaxed);
+  for (uint32_t i = 0; i < count && count >= 2; i++)
+  {
+    struct fsm_executor_entry *entry = atomic_load_explicit(&io_victim->instances[i], memory_order_relaxed);
+
+    /* Instances dispatched right now are left to the victim */
+    if (atomic_exchange_explicit(&entry->isClaimed, true, memory_order_acquire) == true)
+    {
+      continue;
+    }
+    if (fsm_queue_has_pending(entry->queue) == false)
+    {
+      atomic_store_explicit(&entry->isClaimed, false, memory_order_release);
+      continue;
+    }
+
+    /* Move it out while claimed, the claim is released by the caller */
+    atomic_store_explicit(&entry->owner, i_thief, memory_order_relaxed);
+    atomic_store_explicit(&io_victim->instances[i],
+                          atomic_load_explicit(&io_victim->instances[count - 1], memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store_explicit(&io_victim->instancesCount, count - 1, memory_order_release);
+    stolen = entry;
+    break;
+  }
+  pthread_mutex_unlock(&io_victim->lock);
+  return stolen;
+}
+
+static void shard_append(struct fsm_executor_worker *const io_worker, struct fsm_executor_entry *const i_entry)
+{
+  pthread_mutex_lock(&io_worker->lock);
+  uint32_t count = atomic_load_explicit(&io_worker->instancesCount, memory_order_relaxed);
+  atomic_store_explicit(&io_worker->instances[count], i_entry, memory_order_relaxed);
+  atomic_store_explicit(&io_worker->instancesCount, count + 1, memory_order_release);
+  pthread_mutex_unlock(&io_worker->lock);
+}
+
+static void *alloc_aligned(size_t i_size)
+{
+  size_t size = (i_size + FSM_QUEUE_CACHE_LINE - 1u) & ~(size_t)(FSM_QUEUE_CACHE_LINE - 1u);
+  void *memory = aligned_alloc(FSM_QUEUE_CACHE_LINE, size);
+  if (memory != NULL)
+  {
+    memset(memory, 0, size);
+  }
+  return memory;
+}
+
+static void counter_add(atomic_uint_fast64_t *const io_counter, uint64_t i_value)
+{
+  /* Single writer, a plain load and store avoids the locked read-modify-write */
+  uint64_t value = atomic_load_explicit(io_counter, memory_order_relaxed);
+  atomic_store_explicit(io_counter, value + i_value, memory_order_relaxed);
+}
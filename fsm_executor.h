@@ -0,0 +1,136 @@
+/**
+ * @file       fsm_executor.h
+ * @brief      Multi-core executor for FSM instances
+ *
+ *             Drives many FSM instances, each behind its own event queue
+ *             (fsm_queue.h), on a set of worker threads. Every instance belongs
+ *             to exactly one worker shard at a time and is claimed atomically
+ *             while its events are dispatched, so it is only touched by one
+ *             thread at a time. Idle workers steal whole instances including
+ *             their pending events from busy shards. Requires POSIX threads.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_EXECUTOR_H_
+#define FSM_EXECUTOR_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"       /* FSM types */
+#include "fsm_queue.h" /* Event queue */
+
+#include <stdatomic.h> /* for atomics */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#ifndef FSM_EXECUTOR_BATCH
+#define FSM_EXECUTOR_BATCH 64u /**< Events dispatched per instance and sweep */
+#endif
+
+struct fsm_executor_worker; /**< Worker shard, defined in fsm_executor.c */
+struct fsm_executor_entry;  /**< Added instance, defined in fsm_executor.c */
+
+/**
+ * @brief Executor Struct
+ */
+typedef struct
+{
+  struct fsm_executor_worker *workers; /**< Array of workers, allocated by fsm_executor_init */
+  struct fsm_executor_entry *entries;  /**< Array of maxInstances entries, allocated by fsm_executor_init */
+  uint32_t workersCount;               /**< Number of workers */
+  uint32_t maxInstances;               /**< Maximum number of instances */
+  uint32_t instancesCount;             /**< Number of added instances */
+  atomic_bool isRunning;               /**< Workers run while set */
+} fsm_executor_t;
+
+/**
+ * @brief Throughput counters of one worker
+ */
+typedef struct
+{
+  uint64_t events;     /**< Events dispatched */
+  uint64_t errors;     /**< Events for which fsm_process returned an error */
+  uint64_t rounds;     /**< Sweeps over the shard, at most FSM_EXECUTOR_BATCH events per instance */
+  uint64_t idleRounds; /**< Sweeps without any event */
+  uint64_t steals;     /**< Instances stolen from other workers */
+  uint32_t instances;  /**< Instances currently owned */
+} fsm_executor_stats_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize the executor, allocates the worker shards
+ *
+ * @param io_this Pointer to the executor to initialize
+ * @param i_workersCount Number of worker threads
+ * @param i_maxInstances Maximum number of instances to be added
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_executor_init(fsm_executor_t *const io_this, uint32_t i_workersCount, uint32_t i_maxInstances);
+
+/**
+ * @brief Free the worker shards, the executor must be stopped
+ *
+ * @param io_this Pointer to the executor
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_executor_deinit(fsm_executor_t *const io_this);
+
+/**
+ * @brief Add an instance, given by its event queue, to the least loaded shard
+ *
+ * Not thread safe against other calls of fsm_executor_add, but may be called
+ * while the executor is running. From now on only the executor may call
+ * fsm_dispatch_pending on the queue.
+ *
+ * @param io_this Pointer to the executor
+ * @param i_queue The initialized event queue of the instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_executor_add(fsm_executor_t *const io_this, fsm_queue_t *const i_queue);
+
+/**
+ * @brief Start the worker threads
+ *
+ * @param io_this Pointer to the executor
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_executor_start(fsm_executor_t *const io_this);
+
+/**
+ * @brief Stop and join the worker threads
+ *
+ * Events still pending in the queues stay there.
+ *
+ * @param io_this Pointer to the executor
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_executor_stop(fsm_executor_t *const io_this);
+
+/**
+ * @brief Get the throughput counters of one worker, callable at any time
+ *
+ * @param i_this Pointer to the executor
+ * @param i_worker Index of the worker
+ * @param o_stats The counters
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_executor_get_stats(const fsm_executor_t *const i_this,
+                                uint32_t i_worker,
+                                fsm_executor_stats_t *const o_stats);
+
+#endif /* FSM_EXECUTOR_H_ */
@@ -0,0 +1,659 @@
+/**
+ * @file       fsm_flat.c
+ * @brief      Flattening of nested FSMs into one dispatch table
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_flat.h"     /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <stdlib.h> /* for malloc, realloc, free */
+#include <string.h> /* for memcpy, memcmp, memset */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define KEY_FIRST_RUN 0x80000000u /**< Key flag: the instance has not run yet */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Compile state
+ */
+typedef struct
+{
+  fsm_flat_t *flat;                    /**< The machine being compiled */
+  uint32_t configsCapacity;            /**< Configurations the keys and cells have room for */
+  uint32_t opsCapacity;                /**< Ops the ops array has room for */
+  uint32_t *hash;                      /**< Configuration index + 1 per slot, 0 if empty */
+  uint32_t hashCapacity;               /**< Number of slots, power of two */
+  uint32_t *work;                      /**< Keys of the configuration being run */
+  fsm_flat_op_t *path;                 /**< Ops of the run */
+  uint32_t pathCount;                  /**< Number of ops of the run */
+  uint32_t pathCapacity;               /**< Ops the path has room for */
+  bool decisions[FSM_FLAT_MAX_GUARDS]; /**< Results of the decided guards */
+  uint32_t decisionsCount;             /**< Number of decided guards */
+  uint32_t guardsSeen;                 /**< Guards evaluated by the run */
+  bool isUndecided;                    /**< The run stopped at an undecided guard */
+} compile_ctx_t;
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Get the index of an instance in the tree
+ *
+ * @param i_flat The flattened machine
+ * @param i_fsm The instance
+ *
+ * @return The index, instancesCount if not part of the tree
+ */
+static uint32_t find_instance(const fsm_flat_t *const i_flat, const fsm_t *const i_fsm);
+
+/**
+ * @brief Collect the sub fsms of the instance and check the tree
+ *
+ * @param io_ctx The compile state, the instance is the only one collected
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the tree can
+ *         not be flattened, FSM_RC_ERROR if an allocation failed
+ */
+static fsm_RC_t collect_instances(compile_ctx_t *const io_ctx);
+
+/**
+ * @brief Get or add the configuration of the work keys
+ *
+ * @param io_ctx The compile state
+ * @param o_index Index of the configuration
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if there are too
+ *         many configurations, FSM_RC_ERROR if an allocation failed
+ */
+static fsm_RC_t find_config(compile_ctx_t *const io_ctx, uint32_t *const o_index);
+
+/**
+ * @brief Append an op to the path of the run, null actions are skipped
+ *
+ * @param io_ctx The compile state
+ * @param i_op The op
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if an allocation failed
+ */
+static fsm_RC_t push_op(compile_ctx_t *const io_ctx, const fsm_flat_op_t *const i_op);
+
+/**
+ * @brief Append an op to the table
+ *
+ * @param io_ctx The compile state
+ * @param i_op The op
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if an allocation failed
+ */
+static fsm_RC_t emit_op(compile_ctx_t *const io_ctx, const fsm_flat_op_t *const i_op);
+
+/**
+ * @brief Run an event through an instance like fsm_process, recording the ops
+ *
+ * Guards take the decided results, the run stops at the first undecided one.
+ *
+ * @param io_ctx The compile state, the work keys are updated
+ * @param i_instance Index of the instance
+ * @param i_event The event
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t run_instance(compile_ctx_t *const io_ctx, uint32_t i_instance, fsm_event_t i_event);
+
+/**
+ * @brief Compile the op list of a configuration and event
+ *
+ * Emits the ops after the last decided guard, then either the end op or the
+ * undecided guard followed by both of its branches.
+ *
+ * @param io_ctx The compile state
+ * @param i_config Index of the configuration
+ * @param i_event The event
+ * @param i_depth Number of decided guards
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t compile_cell(compile_ctx_t *const io_ctx, uint32_t i_config, fsm_event_t i_event, uint32_t i_depth);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_flat_compile(fsm_flat_t *const o_this, fsm_t *const i_fsm)
+{
+  if (o_this == NULL || i_fsm == NULL || i_fsm->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  memset(o_this, 0, sizeof(*o_this));
+  o_this->columns = fsm_event_enum_count(i_fsm->config) + 1u;
+  compile_ctx_t ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.flat = o_this;
+
+  fsm_RC_t res = FSM_RC_ERROR;
+  o_this->instances = malloc(sizeof(fsm_t *));
+  if (o_this->instances != NULL)
+  {
+    o_this->instances[0] = i_fsm;
+    o_this->instancesCount = 1;
+    res = collect_instances(&ctx);
+  }
+
+  /* The current states of the tree are configuration 0 */
+  if (res == FSM_RC_OK)
+  {
+    ctx.work = malloc(sizeof(uint32_t) * o_this->instancesCount);
+    res = (ctx.work != NULL) ? FSM_RC_OK : FSM_RC_ERROR;
+  }
+  for (uint32_t i = 0; i < o_this->instancesCount && res == FSM_RC_OK; i++)
+  {
+    const fsm_t *fsm = o_this->instances[i];
+    const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(fsm->config, fsm->currentState);
+    ctx.work[i] = (uint32_t)(stateCfg - fsm->config->states) | (fsm->isFirstRun ? KEY_FIRST_RUN : 0u);
+  }
+  uint32_t initial = 0;
+  if (res == FSM_RC_OK)
+  {
+    res = find_config(&ctx, &initial);
+  }
+
+  /* Configurations found while compiling are appended and compiled as well */
+  const uint32_t columns = o_this->columns;
+  for (uint32_t c = 0; c < o_this->configsCount && res == FSM_RC_OK; c++)
+  {
+    for (uint32_t e = 0; e < columns && res == FSM_RC_OK; e++)
+    {
+      uint32_t first = o_this->opsCount;
+      res = compile_cell(&ctx, c, (fsm_event_t)e, 0);
+      o_this->cells[c * columns + e] = first;
+    }
+  }
+
+  free(ctx.hash);
+  free(ctx.work);
+  free(ctx.path);
+  if (res != FSM_RC_OK)
+  {
+    fsm_flat_free(o_this);
+  }
+  return res;
+}
+
+fsm_RC_t fsm_flat_free(fsm_flat_t *const io_this)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  free(io_this->instances);
+  free(io_this->keys);
+  free(io_this->cells);
+  free(io_this->ops);
+  memset(io_this, 0, sizeof(*io_this));
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_flat_process(const fsm_flat_t *const i_this, uint32_t *const io_cursor, fsm_event_t i_event)
+{
+  if (i_this == NULL || i_this->cells == NULL || io_cursor == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (*io_cursor >= i_this->configsCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  const uint32_t lastColumn = i_this->columns - 1u;
+  uint32_t column = ((uint32_t)i_event < lastColumn) ? (uint32_t)i_event : lastColumn;
+  const fsm_flat_op_t *op = &i_this->ops[i_this->cells[*io_cursor * (lastColumn + 1u) + column]];
+  for (;;)
+  {
+    if (op->action != NULL)
+    {
+      op->action(op->arg);
+      op++;
+    }
+    else if (op->guard != NULL)
+    {
+      op = (op->guard(op->arg) == true) ? op + 1 : &i_this->ops[op->next];
+    }
+    else
+    {
+      *io_cursor = op->next;
+      return FSM_RC_OK;
+    }
+  }
+}
+
+fsm_RC_t fsm_flat_get_state(const fsm_flat_t *const i_this,
+                            uint32_t i_cursor,
+                            const fsm_t *const i_fsm,
+                            fsm_state_t *const o_state)
+{
+  if (i_this == NULL || i_this->keys == NULL || i_fsm == NULL || o_state == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  uint32_t instance = find_instance(i_this, i_fsm);
+  if (i_cursor >= i_this->configsCount || instance == i_this->instancesCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  uint32_t key = i_this->keys[i_cursor * i_this->instancesCount + instance];
+  *o_state = i_fsm->config->states[key & ~KEY_FIRST_RUN].state;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_flat_store(const fsm_flat_t *const i_this, uint32_t i_cursor)
+{
+  if (i_this == NULL || i_this->keys == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_cursor >= i_this->configsCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  for (uint32_t i = 0; i < i_this->instancesCount; i++)
+  {
+    fsm_t *fsm = i_this->instances[i];
+    uint32_t key = i_this->keys[i_cursor * i_this->instancesCount + i];
+    fsm->currentState = fsm->config->states[key & ~KEY_FIRST_RUN].state;
+    fsm->isFirstRun = (key & KEY_FIRST_RUN) != 0;
+  }
+  return FSM_RC_OK;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static uint32_t find_instance(const fsm_flat_t *const i_flat, const fsm_t *const i_fsm)
+{
+  uint32_t i = 0;
+  while (i < i_flat->instancesCount && i_flat->instances[i] != i_fsm)
+  {
+    i++;
+  }
+  return i;
+}
+
+static fsm_RC_t collect_instances(compile_ctx_t *const io_ctx)
+{
+  fsm_flat_t *flat = io_ctx->flat;
+  uint32_t capacity = 1;
+
+  /* Breadth first over the sub fsm links, every instance once */
+  for (uint32_t i = 0; i < flat->instancesCount; i++)
+  {
+    const fsm_t *fsm = flat->instances[i];
+    const fsm_cfg_t *cfg = fsm->config;
+    if (cfg == NULL)
+    {
+      return FSM_RC_ERROR_NULLPTR;
+    }
+    if (fsm->hooks != NULL || fsm_get_state_cfg(cfg, fsm->currentState) == NULL)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+
+    for (uint32_t s = 0; s < cfg->statesCount; s++)
+    {
+      const fsm_state_cfg_t *stateCfg = &cfg->states[s];
+      if (stateCfg->subCfg != NULL || stateCfg->regions != NULL || fsm_state_uses_event_obj(stateCfg) == true)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+      for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+      {
+        const fsm_transition_cfg_t *transitionCfg = &stateCfg->transitions[t];
+        if ((uint32_t)transitionCfg->event >= flat->columns - 1u || transitionCfg->after != 0 ||
+            transitionCfg->every != 0 || fsm_get_state_cfg(cfg, transitionCfg->toState) == NULL)
+        {
+          return FSM_RC_ERROR_INVALID_CONFIG;
+        }
+      }
+
+      fsm_t *subFsm = (fsm_t *)stateCfg->subFsm;
+      if (subFsm == NULL || find_instance(flat, subFsm) < flat->instancesCount)
+      {
+        continue;
+      }
+      if (flat->instancesCount == capacity)
+      {
+        fsm_t **instances = realloc(flat->instances, sizeof(fsm_t *) * capacity * 2u);
+        if (instances == NULL)
+        {
+          return FSM_RC_ERROR;
+        }
+        flat->instances = instances;
+        capacity *= 2u;
+      }
+      flat->instances[flat->instancesCount++] = subFsm;
+    }
+  }
+
+  /* Longest nesting per instance, exceeds the instance count only in a cycle */
+  uint32_t *depth = calloc(flat->instancesCount, sizeof(uint32_t));
+  if (depth == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  fsm_RC_t res = FSM_RC_OK;
+  for (bool isChanged = true; isChanged == true && res == FSM_RC_OK;)
+  {
+    isChanged = false;
+    for (uint32_t i = 0; i < flat->instancesCount && res == FSM_RC_OK; i++)
+    {
+      const fsm_cfg_t *cfg = flat->instances[i]->config;
+      for (uint32_t s = 0; s < cfg->statesCount; s++)
+      {
+        if (cfg->states[s].subFsm == NULL)
+        {
+          continue;
+        }
+        uint32_t sub = find_instance(flat, cfg->states[s].subFsm);
+        if (depth[sub] <= depth[i])
+        {
+          depth[sub] = depth[i] + 1u;
+          isChanged = true;
+          if (depth[sub] >= flat->instancesCount)
+          {
+            res = FSM_RC_ERROR_INVALID_CONFIG;
+            break;
+          }
+        }
+      }
+    }
+  }
+  free(depth);
+  return res;
+}
+
+static fsm_RC_t find_config(compile_ctx_t *const io_ctx, uint32_t *const o_index)
+{
+  fsm_flat_t *flat = io_ctx->flat;
+  const uint32_t keySize = flat->instancesCount;
+
+  uint32_t hash = 2166136261u;
+  for (uint32_t i = 0; i < keySize; i++)
+  {
+    hash = (hash ^ io_ctx->work[i]) * 16777619u;
+  }
+
+  /* Open addressing, linear probing */
+  uint32_t mask = io_ctx->hashCapacity - 1u;
+  for (uint32_t slot = hash & mask; io_ctx->hashCapacity > 0; slot = (slot + 1u) & mask)
+  {
+    uint32_t entry = io_ctx->hash[slot];
+    if (entry == 0)
+    {
+      break;
+    }
+    if (memcmp(&flat->keys[(entry - 1u) * keySize], io_ctx->work, sizeof(uint32_t) * keySize) == 0)
+    {
+      *o_index = entry - 1u;
+      return FSM_RC_OK;
+    }
+  }
+
+  if (flat->configsCount == FSM_FLAT_MAX_CONFIGS)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* Grow the keys and cells */
+  const uint32_t columns = flat->columns;
+  if (flat->configsCount == io_ctx->configsCapacity)
+  {
+    uint32_t capacity = (io_ctx->configsCapacity == 0) ? 16u : io_ctx->configsCapacity * 2u;
+    uint32_t *keys = realloc(flat->keys, sizeof(uint32_t) * keySize * capacity);
+    if (keys == NULL)
+    {
+      return FSM_RC_ERROR;
+    }
+    flat->keys = keys;
+    uint32_t *cells = realloc(flat->cells, sizeof(uint32_t) * columns * capacity);
+    if (cells == NULL)
+    {
+      return FSM_RC_ERROR;
+    }
+    flat->cells = cells;
+    io_ctx->configsCapacity = capacity;
+  }
+
+  /* Keep the load of the hash below one half */
+  if ((flat->configsCount + 1u) * 2u > io_ctx->hashCapacity)
+  {
+    uint32_t capacity = (io_ctx->hashCapacity == 0) ? 64u : io_ctx->hashCapacity * 2u;
+    uint32_t *table = calloc(capacity, sizeof(uint32_t));
+    if (table == NULL)
+    {
+      return FSM_RC_ERROR;
+    }
+    free(io_ctx->hash);
+    io_ctx->hash = table;
+    io_ctx->hashCapacity = capacity;
+    for (uint32_t c = 0; c < flat->configsCount; c++)
+    {
+      uint32_t h = 2166136261u;
+      for (uint32_t i = 0; i < keySize; i++)
+      {
+        h = (h ^ flat->keys[c * keySize + i]) * 16777619u;
+      }
+      uint32_t slot = h & (capacity - 1u);
+      while (table[slot] != 0)
+      {
+        slot = (slot + 1u) & (capacity - 1u);
+      }
+      table[slot] = c + 1u;
+    }
+  }
+
+  uint32_t slot = hash & (io_ctx->hashCapacity - 1u);
+  while (io_ctx->hash[slot] != 0)
+  {
+    slot = (slot + 1u) & (io_ctx->hashCapacity - 1u);
+  }
+  io_ctx->hash[slot] = flat->configsCount + 1u;
+  memcpy(&flat->keys[flat->configsCount * keySize], io_ctx->work, sizeof(uint32_t) * keySize);
+  *o_index = flat->configsCount++;
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t push_op(compile_ctx_t *const io_ctx, const fsm_flat_op_t *const i_op)
+{
+  if (i_op->action == NULL && i_op->guard == NULL)
+  {
+    return FSM_RC_OK;
+  }
+  if (io_ctx->pathCount == io_ctx->pathCapacity)
+  {
+    uint32_t capacity = (io_ctx->pathCapacity == 0) ? 32u : io_ctx->pathCapacity * 2u;
+    fsm_flat_op_t *path = realloc(io_ctx->path, sizeof(fsm_flat_op_t) * capacity);
+    if (path == NULL)
+    {
+      return FSM_RC_ERROR;
+    }
+    io_ctx->path = path;
+    io_ctx->pathCapacity = capacity;
+  }
+  io_ctx->path[io_ctx->pathCount++] = *i_op;
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t emit_op(compile_ctx_t *const io_ctx, const fsm_flat_op_t *const i_op)
+{
+  fsm_flat_t *flat = io_ctx->flat;
+  if (flat->opsCount == io_ctx->opsCapacity)
+  {
+    uint32_t capacity = (io_ctx->opsCapacity == 0) ? 256u : io_ctx->opsCapacity * 2u;
+    fsm_flat_op_t *ops = realloc(flat->ops, sizeof(fsm_flat_op_t) * capacity);
+    if (ops == NULL)
+    {
+      return FSM_RC_ERROR;
+    }
+    flat->ops = ops;
+    io_ctx->opsCapacity = capacity;
+  }
+  flat->ops[flat->opsCount++] = *i_op;
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t run_instance(compile_ctx_t *const io_ctx, uint32_t i_instance, fsm_event_t i_event)
+{
+  const fsm_cfg_t *cfg = io_ctx->flat->instances[i_instance]->config;
+  const uint32_t key = io_ctx->work[i_instance];
+  const fsm_state_cfg_t *currStateCfg = &cfg->states[key & ~KEY_FIRST_RUN];
+
+  /* Same lookup as fsm_process, the first transition for the event wins */
+  const fsm_transition_cfg_t *transitionCfg = NULL;
+  for (uint32_t t = 0; t < currStateCfg->transitionsCount && transitionCfg == NULL; t++)
+  {
+    if (currStateCfg->transitions[t].event == i_event)
+    {
+      transitionCfg = &currStateCfg->transitions[t];
+    }
+  }
+
+  const fsm_state_cfg_t *nextStateCfg = currStateCfg;
+  const fsm_action_t *actionTransition = NULL;
+  fsm_RC_t res = FSM_RC_OK;
+  if (transitionCfg != NULL)
+  {
+    bool guardCond = true;
+    if (transitionCfg->guard.func != NULL)
+    {
+      const fsm_flat_op_t guardOp = {.guard = transitionCfg->guard.func, .arg = transitionCfg->guard.arg};
+      res = push_op(io_ctx, &guardOp);
+      if (res != FSM_RC_OK)
+      {
+        return res;
+      }
+      if (io_ctx->guardsSeen == io_ctx->decisionsCount)
+      {
+        io_ctx->isUndecided = true;
+        return FSM_RC_OK;
+      }
+      guardCond = io_ctx->decisions[io_ctx->guardsSeen++];
+    }
+    if (guardCond == true)
+    {
+      actionTransition = &transitionCfg->action;
+      nextStateCfg = fsm_get_state_cfg(cfg, transitionCfg->toState);
+    }
+  }
+
+  /* Same action order as fsm_run_state */
+  const fsm_action_t *actions[6] = {NULL};
+  uint32_t actionsCount = 0;
+  if ((key & KEY_FIRST_RUN) != 0)
+  {
+    actions[actionsCount++] = &currStateCfg->entryAction;
+  }
+  actions[actionsCount++] = &currStateCfg->doAction;
+  if (currStateCfg != nextStateCfg)
+  {
+    actions[actionsCount++] = &currStateCfg->exitAction;
+  }
+  actions[actionsCount++] = actionTransition;
+  if (currStateCfg != nextStateCfg)
+  {
+    actions[actionsCount++] = &nextStateCfg->entryAction;
+    actions[actionsCount++] = &nextStateCfg->doAction;
+  }
+  for (uint32_t a = 0; a < actionsCount && res == FSM_RC_OK; a++)
+  {
+    if (actions[a] != NULL)
+    {
+      const fsm_flat_op_t actionOp = {.action = actions[a]->func, .arg = actions[a]->arg};
+      res = push_op(io_ctx, &actionOp);
+    }
+  }
+  io_ctx->work[i_instance] = (uint32_t)(nextStateCfg - cfg->states);
+
+  /* The sub fsm of the remaining or entered state processes the event */
+  if (res == FSM_RC_OK && nextStateCfg->subFsm != NULL)
+  {
+    res = run_instance(io_ctx, find_instance(io_ctx->flat, nextStateCfg->subFsm), i_event);
+  }
+  return res;
+}
+
+static fsm_RC_t compile_cell(compile_ctx_t *const io_ctx, uint32_t i_config, fsm_event_t i_event, uint32_t i_depth)
+{
+  fsm_flat_t *flat = io_ctx->flat;
+  memcpy(io_ctx->work, &flat->keys[i_config * flat->instancesCount], sizeof(uint32_t) * flat->instancesCount);
+  io_ctx->pathCount = 0;
+  io_ctx->decisionsCount = i_depth;
+  io_ctx->guardsSeen = 0;
+  io_ctx->isUndecided = false;
+  fsm_RC_t res = run_instance(io_ctx, 0, i_event);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  /* Ops after the last decided guard, the ops before are already emitted */
+  uint32_t first = 0;
+  for (uint32_t guards = 0; guards < i_depth; first++)
+  {
+    guards += (io_ctx->path[first].guard != NULL) ? 1u : 0u;
+  }
+  uint32_t last = io_ctx->pathCount - (io_ctx->isUndecided ? 1u : 0u);
+  for (uint32_t i = first; i < last && res == FSM_RC_OK; i++)
+  {
+    res = emit_op(io_ctx, &io_ctx->path[i]);
+  }
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  if (io_ctx->isUndecided == false)
+  {
+    fsm_flat_op_t endOp = {.action = NULL};
+    res = find_config(io_ctx, &endOp.next);
+    return (res == FSM_RC_OK) ? emit_op(io_ctx, &endOp) : res;
+  }
+  if (i_depth == FSM_FLAT_MAX_GUARDS)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* Guard true falls through, false jumps behind the true branch */
+  const fsm_flat_op_t guardOp = io_ctx->path[io_ctx->pathCount - 1u];
+  uint32_t guardIndex = flat->opsCount;
+  res = emit_op(io_ctx, &guardOp);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  io_ctx->decisions[i_depth] = true;
+  res = compile_cell(io_ctx, i_config, i_event, i_depth + 1u);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  flat->ops[guardIndex].next = flat->opsCount;
+  io_ctx->decisions[i_depth] = false;
+  return compile_cell(io_ctx, i_config, i_event, i_depth + 1u);
+}
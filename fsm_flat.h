@@ -0,0 +1,143 @@
+/**
+ * @file       fsm_flat.h
+ * @brief      Flattening of nested FSMs into one dispatch table
+ *
+ *             fsm_process handles a sub fsm by processing the event again in
+ *             the sub instance, so every nesting level repeats the lookups
+ *             and adds to the stack depth. fsm_flat_compile explores all
+ *             active configurations of an instance and its sub fsms (the state
+ *             and first run flag of every instance in the tree), reachable from
+ *             their current states, and compiles every configuration and event
+ *             into one op list: the actions in the order fsm_process runs them,
+ *             guards as conditional jumps, and the next configuration.
+ *             Processing an event is one table lookup and a linear run over the
+ *             op list, independent of the nesting depth.
+ *             The flattened machine keeps its configuration in a cursor, the
+ *             instances are only written by fsm_flat_store, e.g. to continue
+ *             with fsm_process. Sub configurations (subCfg), timed
+ *             transitions and tracing are not supported. The table is
+ *             allocated by fsm_flat_compile.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_FLAT_H_
+#define FSM_FLAT_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_FLAT_MAX_CONFIGS 65535u /**< Maximum number of active configurations */
+#define FSM_FLAT_MAX_GUARDS 32u     /**< Maximum number of guards evaluated for one event */
+
+/**
+ * @brief Flattened Op
+ *
+ * Runs action(arg) if action is set, jumps to ops[next] if guard(arg) is false
+ * if guard is set, ends with configuration next otherwise.
+ */
+typedef struct
+{
+  fsm_func_t action;      /**< [optional] Action to run */
+  fsm_guard_func_t guard; /**< [optional] Guard to evaluate */
+  fsm_arg_t arg;          /**< Argument of the action or guard */
+  uint32_t next;          /**< Op if the guard is false, next configuration if both are null */
+} fsm_flat_op_t;
+
+/**
+ * @brief Flattened Machine Struct
+ */
+typedef struct
+{
+  fsm_t **instances;       /**< The instance and its sub fsms, the instance first */
+  uint32_t instancesCount; /**< Number of instances */
+  uint32_t *keys;          /**< State index and first run flag of every instance per configuration */
+  uint32_t configsCount;   /**< Number of configurations */
+  uint32_t columns;        /**< Size of the event enum of the instance + 1 */
+  uint32_t *cells;         /**< First op per configuration and event, columns per configuration */
+  fsm_flat_op_t *ops;      /**< Op lists of all cells */
+  uint32_t opsCount;       /**< Number of ops */
+} fsm_flat_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Compile an initialized instance and its sub fsms
+ *
+ * Configuration 0 is the one at compile time. Events out of range share the
+ * last column. The instances must not change their configuration.
+ *
+ * @param o_this Pointer to the flattened machine
+ * @param i_fsm The initialized instance
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the tree has
+ *         sub configurations, regions, timed transitions, actions or guards
+ *         taking the event object, bound modules (timers, recorder, hit
+ *         counters, see fsm_hook_t), undefined states, out of range events,
+ *         cycles, more than FSM_FLAT_MAX_CONFIGS configurations or more than
+ *         FSM_FLAT_MAX_GUARDS guards per event, FSM_RC_ERROR if an allocation
+ *         failed, error code otherwise
+ */
+fsm_RC_t fsm_flat_compile(fsm_flat_t *const o_this, fsm_t *const i_fsm);
+
+/**
+ * @brief Free the table of a flattened machine
+ *
+ * @param io_this Pointer to the flattened machine
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_flat_free(fsm_flat_t *const io_this);
+
+/**
+ * @brief Process an event
+ *
+ * Same actions and guards in the same order as fsm_process on the instance.
+ *
+ * @param i_this Pointer to the flattened machine
+ * @param io_cursor The current configuration
+ * @param i_event The event
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the cursor is out
+ *         of range, error code otherwise
+ */
+fsm_RC_t fsm_flat_process(const fsm_flat_t *const i_this, uint32_t *const io_cursor, fsm_event_t i_event);
+
+/**
+ * @brief Get the state of one instance of the tree in a configuration
+ *
+ * @param i_this Pointer to the flattened machine
+ * @param i_cursor The configuration
+ * @param i_fsm The instance or one of its sub fsms
+ * @param o_state The state
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the cursor is out
+ *         of range or the instance is not part of the tree, error code otherwise
+ */
+fsm_RC_t fsm_flat_get_state(const fsm_flat_t *const i_this,
+                            uint32_t i_cursor,
+                            const fsm_t *const i_fsm,
+                            fsm_state_t *const o_state);
+
+/**
+ * @brief Write a configuration back into the instances
+ *
+ * @param i_this Pointer to the flattened machine
+ * @param i_cursor The configuration
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the cursor is out
+ *         of range, error code otherwise
+ */
+fsm_RC_t fsm_flat_store(const fsm_flat_t *const i_this, uint32_t i_cursor);
+
+#endif /* FSM_FLAT_H_ */
@@ -0,0 +1,271 @@
+/**
+ * @file       fsm_fork.c
+ * @brief      Fork-join pool for orthogonal regions
+ *
+ *             One lock guards the task ring, the joins and the counters. The
+ *             tasks are whole region runs, so the lock is taken a few times
+ *             per region only. A join lives on the stack of the forking
+ *             thread, the tasks point to it and it is left only once all of
+ *             them are finished.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* pthreads */
+
+#include "fsm_fork.h"     /* Own header */
+
+#include <pthread.h> /* for threads, mutexes and conditions */
+#include <stdlib.h>  /* for calloc, free */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Regions set forked on one event, on the stack of the forking thread
+ */
+typedef struct
+{
+  uint32_t pending; /**< Tasks not finished yet */
+} fork_join_t;
+
+/**
+ * @brief Processing of one region
+ */
+typedef struct
+{
+  fsm_region_job_t *job; /**< The region and the event, result written back */
+  fork_join_t *join;     /**< The join waiting for the task */
+} fork_task_t;
+
+/**
+ * @brief Shared Pool State
+ */
+struct fsm_fork_shared
+{
+  pthread_mutex_t lock;   /**< Guards everything below */
+  pthread_cond_t work;    /**< Signalled on queued tasks and on stop */
+  pthread_cond_t done;    /**< Signalled on finished tasks */
+  pthread_t *threads;     /**< Worker threads */
+  uint32_t threadsCount;  /**< Started worker threads */
+  fork_task_t *tasks;     /**< Ring of the queued tasks, maxTasks capacity */
+  uint32_t head;          /**< Position of the oldest task */
+  uint32_t count;         /**< Number of queued tasks */
+  bool isStopping;        /**< Workers leave once set */
+  fsm_fork_stats_t stats; /**< See fsm_fork_stats_t */
+};
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Worker thread function
+ *
+ * @param i_fork The pool (fsm_fork_t *)
+ *
+ * @return Always null
+ */
+static void *worker_main(void *i_fork);
+
+/**
+ * @brief Run the oldest queued task, called and returning with the lock held
+ *
+ * @param io_fork The pool, at least one task queued
+ */
+static void run_task(fsm_fork_t *const io_fork);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_fork_init(fsm_fork_t *const io_this, uint32_t i_threadsCount, uint32_t i_maxTasks)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_threadsCount == 0 || i_maxTasks == 0)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  struct fsm_fork_shared *shared = calloc(1, sizeof(struct fsm_fork_shared));
+  if (shared == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  shared->threads = calloc(i_threadsCount, sizeof(pthread_t));
+  shared->tasks = calloc(i_maxTasks, sizeof(fork_task_t));
+  if (shared->threads == NULL || shared->tasks == NULL || pthread_mutex_init(&shared->lock, NULL) != 0)
+  {
+    free(shared->threads);
+    free(shared->tasks);
+    free(shared);
+    return FSM_RC_ERROR;
+  }
+  pthread_cond_init(&shared->work, NULL);
+  pthread_cond_init(&shared->done, NULL);
+  io_this->shared = shared;
+  io_this->threadsCount = i_threadsCount;
+  io_this->maxTasks = i_maxTasks;
+
+  for (uint32_t i = 0; i < i_threadsCount; i++)
+  {
+    if (pthread_create(&shared->threads[i], NULL, worker_main, io_this) != 0)
+    {
+      fsm_fork_deinit(io_this);
+      return FSM_RC_ERROR;
+    }
+    shared->threadsCount++;
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_fork_deinit(fsm_fork_t *const io_this)
+{
+  if (io_this == NULL || io_this->shared == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  struct fsm_fork_shared *shared = io_this->shared;
+  pthread_mutex_lock(&shared->lock);
+  shared->isStopping = true;
+  pthread_cond_broadcast(&shared->work);
+  pthread_mutex_unlock(&shared->lock);
+  for (uint32_t i = 0; i < shared->threadsCount; i++)
+  {
+    pthread_join(shared->threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&shared->work);
+  pthread_cond_destroy(&shared->done);
+  pthread_mutex_destroy(&shared->lock);
+  free(shared->threads);
+  free(shared->tasks);
+  free(shared);
+  io_this->shared = NULL;
+  io_this->threadsCount = 0;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_fork_get_stats(const fsm_fork_t *const i_this, fsm_fork_stats_t *const o_stats)
+{
+  if (i_this == NULL || i_this->shared == NULL || o_stats == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  pthread_mutex_lock(&i_this->shared->lock);
+  *o_stats = i_this->shared->stats;
+  pthread_mutex_unlock(&i_this->shared->lock);
+  return FSM_RC_OK;
+}
+
+void fsm_fork_run(void *io_fork, fsm_region_job_t *io_jobs, uint32_t i_count)
+{
+  fsm_fork_t *fork = io_fork;
+  struct fsm_fork_shared *shared = (fork != NULL) ? fork->shared : NULL;
+
+  /* Fork all regions but the first one, or run them in order without room */
+  fork_join_t join = {i_count - 1u};
+  bool isForked = false;
+  if (shared != NULL)
+  {
+    pthread_mutex_lock(&shared->lock);
+    isForked = (fork->maxTasks - shared->count >= join.pending);
+    if (isForked == true)
+    {
+      for (uint32_t i = 1; i < i_count; i++)
+      {
+        fork_task_t *task = &shared->tasks[(shared->head + shared->count) % fork->maxTasks];
+        task->job = &io_jobs[i];
+        task->join = &join;
+        shared->count++;
+      }
+      shared->stats.joins++;
+      shared->stats.tasks += i_count;
+      if (join.pending > 0)
+      {
+        pthread_cond_broadcast(&shared->work);
+      }
+    }
+    else
+    {
+      shared->stats.sequential++;
+    }
+    pthread_mutex_unlock(&shared->lock);
+  }
+  if (isForked == false)
+  {
+    for (uint32_t i = 0; i < i_count; i++)
+    {
+      (void)fsm_region_run(&io_jobs[i]);
+    }
+    return;
+  }
+
+  (void)fsm_region_run(&io_jobs[0]);
+
+  /* Barrier, help with queued tasks until the forked regions are done */
+  pthread_mutex_lock(&shared->lock);
+  while (join.pending > 0)
+  {
+    if (shared->count > 0)
+    {
+      run_task(fork);
+    }
+    else
+    {
+      pthread_cond_wait(&shared->done, &shared->lock);
+    }
+  }
+  pthread_mutex_unlock(&shared->lock);
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void *worker_main(void *i_fork)
+{
+  fsm_fork_t *fork = i_fork;
+  struct fsm_fork_shared *shared = fork->shared;
+
+  pthread_mutex_lock(&shared->lock);
+  while (shared->isStopping == false)
+  {
+    if (shared->count > 0)
+    {
+      shared->stats.workerTasks++;
+      run_task(fork);
+    }
+    else
+    {
+      pthread_cond_wait(&shared->work, &shared->lock);
+    }
+  }
+  pthread_mutex_unlock(&shared->lock);
+  return NULL;
+}
+
+static void run_task(fsm_fork_t *const io_fork)
+{
+  struct fsm_fork_shared *shared = io_fork->shared;
+  fork_task_t task = shared->tasks[shared->head];
+  shared->head = (shared->head + 1u) % io_fork->maxTasks;
+  shared->count--;
+  pthread_mutex_unlock(&shared->lock);
+
+  (void)fsm_region_run(task.job);
+
+  pthread_mutex_lock(&shared->lock);
+  task.join->pending--;
+  pthread_cond_broadcast(&shared->done);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file       fsm_fork.h
+ * @brief      Fork-join pool for orthogonal regions
+ *
+ *             Opt-in concurrent processing of the orthogonal regions of a
+ *             state (fsm_regions_t) for large composite machines. A regions
+ *             set with fsm_fork_run as runner forks all but its first region
+ *             as tasks, the processing thread runs the first one itself and
+ *             then helps with queued tasks until every region is done. This
+ *             join is the barrier: the state step of the parent, and with it
+ *             its state change, only completes once all regions have
+ *             processed the event. Regions of sub fsms fork into the same
+ *             pool, a joining thread never blocks while tasks are queued.
+ *             The regions must be independent: their actions run on different
+ *             threads and must not touch the parent, the other regions or
+ *             shared data. Actions of the parent and its other states are not
+ *             affected. If the queue has no room for the tasks the regions are
+ *             processed in order by the calling thread, with the same result.
+ *             With FSM_TRACE or FSM_PROF compiled in the core does not call
+ *             the runner, the regions are processed in order by the thread
+ *             owning the trace ring and the profiler tree.
+ *             Requires POSIX threads.
+ *
+ *             fsm_fork_init(&forkPool, 3, 64);
+ *             .regions = &(const fsm_regions_t){regionCfgs, 4, fsm_fork_run, &forkPool},
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_FORK_H_
+#define FSM_FORK_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+struct fsm_fork_shared; /**< Task queue and threads, defined in fsm_fork.c */
+
+/**
+ * @brief Fork-Join Pool Struct
+ */
+typedef struct fsm_fork
+{
+  struct fsm_fork_shared *shared; /**< Task queue and threads, allocated by fsm_fork_init */
+  uint32_t threadsCount;          /**< Number of worker threads */
+  uint32_t maxTasks;              /**< Capacity of the task queue */
+} fsm_fork_t;
+
+/**
+ * @brief Counters of a fork-join pool
+ */
+typedef struct
+{
+  uint64_t joins;       /**< Events processed concurrently in a regions set */
+  uint64_t tasks;       /**< Regions processed concurrently */
+  uint64_t workerTasks; /**< Regions processed by a worker thread instead of a joining one */
+  uint64_t sequential;  /**< Events processed in order, task queue full */
+} fsm_fork_stats_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize the pool and start its worker threads
+ *
+ * @param io_this Pointer to the pool to initialize
+ * @param i_threadsCount Number of worker threads, the joining threads help in
+ *                       addition
+ * @param i_maxTasks Capacity of the task queue, regions forked at the same time
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_fork_init(fsm_fork_t *const io_this, uint32_t i_threadsCount, uint32_t i_maxTasks);
+
+/**
+ * @brief Stop and join the worker threads and free the pool
+ *
+ * No event may be processed in a regions set of the pool meanwhile.
+ *
+ * @param io_this Pointer to the pool
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_fork_deinit(fsm_fork_t *const io_this);
+
+/**
+ * @brief Get the counters of the pool, callable at any time
+ *
+ * @param i_this Pointer to the pool
+ * @param o_stats The counters
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_fork_get_stats(const fsm_fork_t *const i_this, fsm_fork_stats_t *const o_stats);
+
+/**
+ * @brief Runner of a regions set processing the regions on the pool
+ *
+ * See fsm_regions_run_t, returns once every region is done.
+ *
+ * @param io_fork The pool (fsm_fork_t *)
+ * @param io_jobs The regions and the event, results written back
+ * @param i_count Number of jobs, at least one
+ */
+void fsm_fork_run(void *io_fork, fsm_region_job_t *io_jobs, uint32_t i_count);
+
+#endif /* FSM_FORK_H_ */
@@ -0,0 +1,295 @@
+/**
+ * @file       fsm_gen.h
+ * @brief      Generator for specialized switch based FSM dispatchers
+ *
+ *             X-macro DSL which turns one state/transition description into
+ *             - the configuration fsm_cfg_<name> for the interpreted path and
+ *             - the dispatcher fsm_process_<name>() with nested switch
+ *               statements and direct, inlinable action and guard calls.
+ *             Both behave the same and share the fsm_t instance, which is
+ *             initialized with fsm_init(&fsm, &fsm_cfg_<name>).
+ *
+ *             Description of a machine:
+ *
+ *               #define MAIN_STATES(STATE)                                    \
+ *                 STATE(FSM_STATE_MAIN_1, NULL,                               \
+ *                       (myLog, "ENTRY"), (myLog, "DO"), (myLog, "EXIT"),     \
+ *                       MAIN_1_TRANSITIONS)                                   \
+ *                 STATE(FSM_STATE_MAIN_2, &fsmSub,                            \
+ *                       FSM_GEN_NONE, FSM_GEN_NONE, FSM_GEN_NONE,             \
+ *                       MAIN_2_TRANSITIONS)
+ *
+ *               #define MAIN_1_TRANSITIONS(T, S)                              \
+ *                 T(S, FSM_EVENT_2, FSM_STATE_MAIN_2,                         \
+ *                   FSM_GEN_NONE, (myLog, "EVENT2"))
+ *
+ *             STATE(state, subFsm, entry, do, exit, transitions) and
+ *             T(S, event, toState, guard, action), where actions and guards
+ *             are (function, argument) pairs or FSM_GEN_NONE. Every transition
+ *             list passes S on as first argument of T.
+ *
+ *             Generating the machine "main" (multiple machines per file are
+ *             possible, the parameters are undefined after each include):
+ *
+ *               #define FSM_GEN_NAME main
+ *               #define FSM_GEN_INITIAL FSM_STATE_MAIN_1
+ *               #define FSM_GEN_STATES MAIN_STATES
+ *               #include "fsm_gen.h"
+ *
+ *             A machine with its own enums (see FSM_ENUM) additionally
+ *             defines their sizes, the dispatch table is sized to them:
+ *
+ *               #define FSM_GEN_STATE_COUNT DOOR_STATE_COUNT
+ *               #define FSM_GEN_EVENT_COUNT DOOR_EVENT_COUNT
+ *
+ *             Differences to the interpreted path are compile time errors:
+ *             a second transition for the same event in a state, or a
+ *             toState which is not part of the machine.
+ *             The description has no sub configurations, regions, timed
+ *             transitions or functions taking the event object, machines
+ *             needing them use fsm_process. So do instances with modules
+ *             bound (timers, recorder, hit counters), the dispatcher rejects
+ *             them. Events raised by the actions are processed like in
+ *             fsm_process, see fsm_drain_raised.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Common part, included once                                               */
+/******************************************************************************/
+#ifndef FSM_GEN_H_
+#define FSM_GEN_H_
+
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for NULL */
+
+#define FSM_GEN_NONE (NULL, NULL) /**< No action or no guard */
+
+#define FSM_GEN_FUNC_(func, arg) func              /**< Function of a pair */
+#define FSM_GEN_ARG_(func, arg) (fsm_arg_t)(arg)   /**< Argument of a pair */
+#define FSM_GEN_FUNC(pair) FSM_GEN_FUNC_ pair      /**< Function of a (function, argument) pair */
+#define FSM_GEN_ARG(pair) FSM_GEN_ARG_ pair        /**< Argument of a (function, argument) pair */
+#define FSM_GEN_CAT_(a, b, c) fsm_gen_##a##b##c    /**< Pasting helper */
+#define FSM_GEN_CAT(a, b, c) FSM_GEN_CAT_(a, b, c) /**< Pasting after expansion */
+#define FSM_GEN_PASTE_(a, b) a##b                  /**< Pasting helper */
+#define FSM_GEN_PASTE(a, b) FSM_GEN_PASTE_(a, b)   /**< Pasting after expansion */
+
+/** Name of a per-state helper of the current machine */
+#define FSM_GEN_HELPER(kind, state) FSM_GEN_CAT(FSM_GEN_NAME, _##kind##_, state)
+
+/**
+ * @brief Call an action, folds to a direct call for constant functions
+ */
+static inline void fsm_gen_call(fsm_func_t i_func, fsm_arg_t i_arg)
+{
+  if (i_func != NULL)
+  {
+    i_func(i_arg);
+  }
+}
+
+/**
+ * @brief Check a guard, folds to a direct call for constant functions
+ */
+static inline bool fsm_gen_guard(fsm_guard_func_t i_func, fsm_arg_t i_arg)
+{
+  return (i_func == NULL) || i_func(i_arg);
+}
+
+/*** Expansions for the configuration ***/
+#define FSM_GEN_COUNT(...) +1 /**< Counts list entries */
+
+#define FSM_GEN_CFG_TRANSITION(S, event_, toState_, guard_, action_) \
+  {                                                                  \
+      .event = (fsm_event_t)(event_),                                \
+      .toState = (fsm_state_t)(toState_),                            \
+      .guard = {FSM_GEN_FUNC(guard_), FSM_GEN_ARG(guard_)},          \
+      .action = {FSM_GEN_FUNC(action_), FSM_GEN_ARG(action_)},       \
+  },
+
+#define FSM_GEN_CFG_STATE(state_, subFsm_, entry_, do_, exit_, transitions_) \
+  {                                                                          \
+      .state = (fsm_state_t)(state_),                                        \
+      .subFsm = (subFsm_),                                                   \
+      .entryAction = {FSM_GEN_FUNC(entry_), FSM_GEN_ARG(entry_)},            \
+      .doAction = {FSM_GEN_FUNC(do_), FSM_GEN_ARG(do_)},                     \
+      .exitAction = {FSM_GEN_FUNC(exit_), FSM_GEN_ARG(exit_)},               \
+      .transitionsCount = 0 transitions_(FSM_GEN_COUNT, state_),             \
+      .transitions = (const fsm_transition_cfg_t[]){                         \
+          transitions_(FSM_GEN_CFG_TRANSITION, state_)},                     \
+  },
+
+/*** Expansions for the dispatcher ***/
+#define FSM_GEN_STATE_HELPERS(state_, subFsm_, entry_, do_, exit_, transitions_) \
+  static inline void FSM_GEN_HELPER(entry, state_)(void)                         \
+  {                                                                              \
+    fsm_gen_call(FSM_GEN_FUNC(entry_), FSM_GEN_ARG(entry_));                     \
+  }                                                                              \
+  static inline void FSM_GEN_HELPER(do, state_)(void)                            \
+  {                                                                              \
+    fsm_gen_call(FSM_GEN_FUNC(do_), FSM_GEN_ARG(do_));                           \
+  }                                                                              \
+  static inline void FSM_GEN_HELPER(exit, state_)(void)                          \
+  {                                                                              \
+    fsm_gen_call(FSM_GEN_FUNC(exit_), FSM_GEN_ARG(exit_));                       \
+  }                                                                              \
+  static inline fsm_RC_t FSM_GEN_HELPER(sub, state_)(fsm_event_t i_event,       \
+                                                     fsm_event_obj_t *io_obj)    \
+  {                                                                              \
+    const fsm_t *const subFsm = (subFsm_);                                       \
+    return (subFsm == NULL) ? FSM_RC_OK                                          \
+                            : fsm_process_sub((fsm_t *)subFsm, i_event, io_obj); \
+  }
+
+#define FSM_GEN_TRANSITION_CASE(S, event_, toState_, guard_, action_) \
+  case (event_):                                                      \
+    if (fsm_gen_guard(FSM_GEN_FUNC(guard_), FSM_GEN_ARG(guard_)))     \
+    {                                                                 \
+      fsm_RC_t res = FSM_RC_OK;                                       \
+      if (io_this->isFirstRun == true)                                \
+      {                                                               \
+        FSM_GEN_HELPER(entry, S)();                                   \
+        io_this->isFirstRun = false;                                  \
+      }                                                               \
+      if ((toState_) == (S))                                          \
+      {                                                               \
+        FSM_GEN_HELPER(do, S)();                                      \
+        fsm_gen_call(FSM_GEN_FUNC(action_), FSM_GEN_ARG(action_));    \
+        res = FSM_GEN_HELPER(sub, S)(i_event, io_obj);                \
+      }                                                               \
+      else                                                            \
+      {                                                               \
+        FSM_GEN_HELPER(do, S)();                                      \
+        FSM_GEN_HELPER(exit, S)();                                    \
+        fsm_gen_call(FSM_GEN_FUNC(action_), FSM_GEN_ARG(action_));    \
+        FSM_GEN_HELPER(entry, toState_)();                            \
+        FSM_GEN_HELPER(do, toState_)();                               \
+        res = FSM_GEN_HELPER(sub, toState_)(i_event, io_obj);         \
+      }                                                               \
+      if (res != FSM_RC_OK)                                           \
+      {                                                               \
+        return res;                                                   \
+      }                                                               \
+      io_this->currentState = (fsm_state_t)(toState_);                \
+      return FSM_RC_OK;                                               \
+    }                                                                 \
+    break;
+
+#define FSM_GEN_STATE_CASE(state_, subFsm_, entry_, do_, exit_, transitions_) \
+  case (state_):                                                              \
+    switch ((uint32_t)i_event)                                                \
+    {                                                                         \
+      transitions_(FSM_GEN_TRANSITION_CASE, state_)                           \
+    default:                                                                  \
+      break;                                                                  \
+    }                                                                         \
+    /* No transition taken, stay in the state */                              \
+    if (io_this->isFirstRun == true)                                          \
+    {                                                                         \
+      FSM_GEN_HELPER(entry, state_)();                                        \
+      io_this->isFirstRun = false;                                            \
+    }                                                                         \
+    FSM_GEN_HELPER(do, state_)();                                             \
+    return FSM_GEN_HELPER(sub, state_)(i_event, io_obj);
+
+#endif /* FSM_GEN_H_ */
+
+/******************************************************************************/
+/*** Machine part, included once per machine                                  */
+/******************************************************************************/
+#if defined(FSM_GEN_NAME) && defined(FSM_GEN_INITIAL) && defined(FSM_GEN_STATES)
+
+#ifndef FSM_GEN_STATE_COUNT
+#define FSM_GEN_STATE_COUNT FSM_STATE_COUNT /**< Enums of fsm_events_states.h by default */
+#endif
+#ifndef FSM_GEN_EVENT_COUNT
+#define FSM_GEN_EVENT_COUNT FSM_EVENT_COUNT /**< Enums of fsm_events_states.h by default */
+#endif
+
+/*** Configuration for the interpreted path ***/
+static const fsm_cfg_t FSM_GEN_PASTE(fsm_cfg_, FSM_GEN_NAME) = {
+    .initialState = (fsm_state_t)(FSM_GEN_INITIAL),
+    .dispatch = FSM_DISPATCH_TABLE_FOR(0 FSM_GEN_STATES(FSM_GEN_COUNT), FSM_GEN_STATE_COUNT, FSM_GEN_EVENT_COUNT),
+    .stateEnumCount = FSM_GEN_STATE_COUNT,
+    .eventEnumCount = FSM_GEN_EVENT_COUNT,
+    .statesCount = 0 FSM_GEN_STATES(FSM_GEN_COUNT),
+    .states = (const fsm_state_cfg_t[0 FSM_GEN_STATES(FSM_GEN_COUNT)]){
+        FSM_GEN_STATES(FSM_GEN_CFG_STATE)},
+};
+
+/*** Per-state helpers ***/
+FSM_GEN_STATES(FSM_GEN_STATE_HELPERS)
+
+/**
+ * @brief Step of this machine, one event without the raised events
+ */
+static inline fsm_RC_t FSM_GEN_PASTE(fsm_gen_step_, FSM_GEN_NAME)(fsm_t *io_this,
+                                                                 fsm_event_t i_event,
+                                                                 fsm_event_obj_t *io_obj)
+{
+  switch ((uint32_t)io_this->currentState)
+  {
+    FSM_GEN_STATES(FSM_GEN_STATE_CASE)
+  default:
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+}
+
+/**
+ * @brief Specialized fsm_process for this machine
+ *
+ * Same run to completion as fsm_process: called from an action the event is
+ * raised, the events raised by the actions are processed before returning.
+ *
+ * @param io_this FSM instance initialized with fsm_cfg_<name>
+ * @param i_event The event to process
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the instance runs
+ *         another configuration or modules are bound to it (see fsm_hook_t),
+ *         error code otherwise
+ */
+static inline fsm_RC_t FSM_GEN_PASTE(fsm_process_, FSM_GEN_NAME)(fsm_t *const io_this, fsm_event_t i_event)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  /* Other configurations and bound modules (timers, recorder, hit counters) need fsm_process */
+  if (io_this->config != &FSM_GEN_PASTE(fsm_cfg_, FSM_GEN_NAME) || io_this->hooks != NULL)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Called from an action, the event runs after the current one */
+  if (io_this->isProcessing == true)
+  {
+    return fsm_raise(io_this, i_event);
+  }
+
+  io_this->isProcessing = true;
+  fsm_RC_t res = FSM_GEN_PASTE(fsm_gen_step_, FSM_GEN_NAME)(io_this, i_event, NULL);
+  if (res != FSM_RC_OK || io_this->raisedCount > 0)
+  {
+    res = fsm_drain_raised(io_this, res, FSM_GEN_PASTE(fsm_gen_step_, FSM_GEN_NAME));
+  }
+  io_this->isProcessing = false;
+  return res;
+}
+
+#undef FSM_GEN_NAME
+#undef FSM_GEN_INITIAL
+#undef FSM_GEN_STATES
+#undef FSM_GEN_STATE_COUNT
+#undef FSM_GEN_EVENT_COUNT
+
+#endif /* FSM_GEN_NAME && FSM_GEN_INITIAL && FSM_GEN_STATES */
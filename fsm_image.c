@@ -0,0 +1,490 @@
+/**
+ * @file       fsm_image.c
+ * @brief      Relocatable binary image of an FSM configuration
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_image.h"    /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+#include "fsm_trace.h"    /* Trace hooks */
+
+#include <string.h> /* for memset */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define AT(image, offset) ((const void *)((image)->base + (offset))) /**< Record at an offset */
+#define STATE_INDEX(image, offset) \
+  (((offset) - (image)->header->statesOffset) / (uint32_t)sizeof(fsm_image_state_t)) /**< Index of a state record */
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Find an action or a guard in the action table
+ *
+ * @param i_symbols The action table
+ * @param i_symbolsCount Number of entries in the action table
+ * @param i_action The action function, null when looking up a guard
+ * @param i_guard The guard function, null when looking up an action
+ * @param i_arg The argument
+ * @param io_maxSymbol Raised to the found index + 1
+ * @param o_index Index of the entry, FSM_IMAGE_NO_SYMBOL for no function
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if not found
+ */
+static fsm_RC_t find_symbol(const fsm_image_symbol_t *const i_symbols,
+                            uint32_t i_symbolsCount,
+                            fsm_func_t i_action,
+                            fsm_guard_func_t i_guard,
+                            fsm_arg_t i_arg,
+                            uint32_t *const io_maxSymbol,
+                            uint32_t *const o_index);
+
+/**
+ * @brief Perform an action of the action table
+ *
+ * @param i_image The loaded image
+ * @param i_symbol Action table index or FSM_IMAGE_NO_SYMBOL
+ */
+static inline void perform_symbol(const fsm_image_t *const i_image, uint32_t i_symbol);
+
+/**
+ * @brief Check if an offset points to a record of an array
+ *
+ * @param i_offset The offset
+ * @param i_arrayOffset Offset of the array
+ * @param i_count Number of records in the array
+ * @param i_recordSize Size of one record
+ *
+ * @return true if the offset is the start of a record
+ */
+static bool is_record(uint32_t i_offset, uint32_t i_arrayOffset, uint32_t i_count, size_t i_recordSize);
+
+/**
+ * @brief Check if a symbol is valid
+ *
+ * @param i_header Header of the image
+ * @param i_symbol Action table index or FSM_IMAGE_NO_SYMBOL
+ *
+ * @return true if valid
+ */
+static bool is_symbol(const fsm_image_header_t *const i_header, uint32_t i_symbol);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_image_write(const fsm_cfg_t *const i_config,
+                         const fsm_image_symbol_t *const i_symbols,
+                         uint32_t i_symbolsCount,
+                         void *const o_image,
+                         size_t i_imageSize,
+                         size_t *const o_size)
+{
+  if (i_config == NULL || o_size == NULL || (i_symbols == NULL && i_symbolsCount > 0))
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_RC_t res = fsm_cfg_prepare(i_config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  const fsm_state_cfg_t *initialStateCfg = fsm_get_state_cfg(i_config, i_config->initialState);
+  if (initialStateCfg == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* The rows are sized by the event enum of the machine */
+  const uint32_t eventCount = fsm_event_enum_count(i_config);
+
+  /* Size of the image, sub fsms and timers are not representable */
+  uint64_t transitionsCount = 0;
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    if (stateCfg->subFsm != NULL || stateCfg->subCfg != NULL || stateCfg->regions != NULL ||
+        fsm_state_uses_event_obj(stateCfg) == true)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      if (stateCfg->transitions[t].after != 0 || stateCfg->transitions[t].every != 0)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+    }
+    transitionsCount += stateCfg->transitionsCount;
+  }
+
+  /* The offsets are stored in 32 bit, sum them up in 64 bit to detect an overflow */
+  const uint64_t statesEnd = sizeof(fsm_image_header_t) + sizeof(fsm_image_state_t) * (uint64_t)i_config->statesCount;
+  const uint64_t transitionsEnd = statesEnd + sizeof(fsm_image_transition_t) * transitionsCount;
+  const uint64_t imageSize = transitionsEnd + sizeof(uint32_t) * (uint64_t)i_config->statesCount * eventCount;
+  if (imageSize > UINT32_MAX)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+  uint32_t statesOffset = (uint32_t)sizeof(fsm_image_header_t);
+  uint32_t transitionsOffset = (uint32_t)statesEnd;
+  uint32_t dispatchOffset = (uint32_t)transitionsEnd;
+  *o_size = (size_t)imageSize;
+  if (o_image == NULL)
+  {
+    return FSM_RC_OK;
+  }
+  if (i_imageSize < *o_size || ((uintptr_t)o_image & 3u) != 0)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  uint8_t *base = (uint8_t *)o_image;
+  memset(base, 0, *o_size);
+  fsm_image_state_t *states = (fsm_image_state_t *)(base + statesOffset);
+  fsm_image_transition_t *transitions = (fsm_image_transition_t *)(base + transitionsOffset);
+  uint32_t *dispatch = (uint32_t *)(base + dispatchOffset);
+  uint32_t maxSymbol = 0;
+
+  uint32_t transitionIndex = 0;
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    fsm_image_state_t *state = &states[i];
+    uint32_t *row = &dispatch[i * eventCount];
+
+    state->state = (uint32_t)stateCfg->state;
+    state->transitions = transitionsOffset + (uint32_t)sizeof(fsm_image_transition_t) * transitionIndex;
+    state->transitionsCount = stateCfg->transitionsCount;
+    state->dispatch = dispatchOffset + (uint32_t)sizeof(uint32_t) * i * eventCount;
+    res = find_symbol(i_symbols, i_symbolsCount, stateCfg->entryAction.func, NULL, stateCfg->entryAction.arg,
+                      &maxSymbol, &state->entryAction);
+    if (res == FSM_RC_OK)
+    {
+      res = find_symbol(i_symbols, i_symbolsCount, stateCfg->doAction.func, NULL, stateCfg->doAction.arg,
+                        &maxSymbol, &state->doAction);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = find_symbol(i_symbols, i_symbolsCount, stateCfg->exitAction.func, NULL, stateCfg->exitAction.arg,
+                        &maxSymbol, &state->exitAction);
+    }
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++, transitionIndex++)
+    {
+      const fsm_transition_cfg_t *transitionCfg = &stateCfg->transitions[t];
+      fsm_image_transition_t *transition = &transitions[transitionIndex];
+      const fsm_state_cfg_t *toStateCfg = fsm_get_state_cfg(i_config, transitionCfg->toState);
+      if (toStateCfg == NULL)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+
+      transition->event = (uint32_t)transitionCfg->event;
+      transition->toState = statesOffset + (uint32_t)sizeof(fsm_image_state_t) * (uint32_t)(toStateCfg - i_config->states);
+      res = find_symbol(i_symbols, i_symbolsCount, NULL, transitionCfg->guard.func, transitionCfg->guard.arg,
+                        &maxSymbol, &transition->guard);
+      if (res == FSM_RC_OK)
+      {
+        res = find_symbol(i_symbols, i_symbolsCount, transitionCfg->action.func, NULL, transitionCfg->action.arg,
+                          &maxSymbol, &transition->action);
+      }
+      if (res != FSM_RC_OK)
+      {
+        return res;
+      }
+
+      /* The first transition defined for an event wins */
+      if (transition->event < eventCount && row[transition->event] == 0)
+      {
+        row[transition->event] = transitionsOffset + (uint32_t)sizeof(fsm_image_transition_t) * transitionIndex;
+      }
+    }
+  }
+
+  fsm_image_header_t *header = (fsm_image_header_t *)base;
+  header->magic = FSM_IMAGE_MAGIC;
+  header->version = FSM_IMAGE_VERSION;
+  header->headerSize = (uint16_t)sizeof(fsm_image_header_t);
+  header->imageSize = (uint32_t)*o_size;
+  header->eventCount = eventCount;
+  header->stateCount = fsm_state_enum_count(i_config);
+  header->symbolsCount = maxSymbol;
+  header->initialState = statesOffset + (uint32_t)sizeof(fsm_image_state_t) * (uint32_t)(initialStateCfg - i_config->states);
+  header->statesOffset = statesOffset;
+  header->statesCount = i_config->statesCount;
+  header->transitionsOffset = transitionsOffset;
+  header->transitionsCount = (uint32_t)transitionsCount;
+  header->dispatchOffset = dispatchOffset;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_image_load(fsm_image_t *const o_this,
+                        const void *const i_image,
+                        size_t i_imageSize,
+                        const fsm_image_symbol_t *const i_symbols,
+                        uint32_t i_symbolsCount)
+{
+  if (o_this == NULL || i_image == NULL || (i_symbols == NULL && i_symbolsCount > 0))
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  const fsm_image_header_t *header = (const fsm_image_header_t *)i_image;
+  if (((uintptr_t)i_image & 3u) != 0 ||
+      i_imageSize < sizeof(fsm_image_header_t) ||
+      header->magic != FSM_IMAGE_MAGIC ||
+      header->version != FSM_IMAGE_VERSION ||
+      header->headerSize != sizeof(fsm_image_header_t) ||
+      header->imageSize > i_imageSize ||
+      header->symbolsCount > i_symbolsCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Check that the arrays are inside the image, the records are trusted */
+  uint64_t statesEnd = (uint64_t)header->statesOffset + sizeof(fsm_image_state_t) * (uint64_t)header->statesCount;
+  uint64_t transitionsEnd = (uint64_t)header->transitionsOffset +
+                            sizeof(fsm_image_transition_t) * (uint64_t)header->transitionsCount;
+  uint64_t dispatchEnd = (uint64_t)header->dispatchOffset +
+                         sizeof(uint32_t) * (uint64_t)header->statesCount * header->eventCount;
+  if (statesEnd > header->imageSize || transitionsEnd > header->imageSize || dispatchEnd > header->imageSize ||
+      !is_record(header->initialState, header->statesOffset, header->statesCount, sizeof(fsm_image_state_t)))
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  o_this->base = (const uint8_t *)i_image;
+  o_this->header = header;
+  o_this->symbols = i_symbols;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_image_verify(const fsm_image_t *const i_this)
+{
+  if (i_this == NULL || i_this->header == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  const fsm_image_header_t *header = i_this->header;
+  for (uint32_t i = 0; i < header->statesCount; i++)
+  {
+    const fsm_image_state_t *state = AT(i_this, header->statesOffset + sizeof(fsm_image_state_t) * i);
+    if (!is_symbol(header, state->entryAction) || !is_symbol(header, state->doAction) ||
+        !is_symbol(header, state->exitAction) ||
+        state->dispatch != header->dispatchOffset + sizeof(uint32_t) * i * header->eventCount ||
+        (state->transitionsCount > 0 &&
+         (!is_record(state->transitions, header->transitionsOffset, header->transitionsCount,
+                     sizeof(fsm_image_transition_t)) ||
+          (state->transitions - header->transitionsOffset) / sizeof(fsm_image_transition_t) +
+                  state->transitionsCount >
+              header->transitionsCount)))
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+
+    /* The dispatch row may only point to transitions of this state */
+    const uint32_t *row = AT(i_this, state->dispatch);
+    for (uint32_t e = 0; e < header->eventCount; e++)
+    {
+      if (row[e] != 0 &&
+          !is_record(row[e], state->transitions, state->transitionsCount, sizeof(fsm_image_transition_t)))
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+    }
+  }
+
+  for (uint32_t t = 0; t < header->transitionsCount; t++)
+  {
+    const fsm_image_transition_t *transition = AT(i_this, header->transitionsOffset + sizeof(fsm_image_transition_t) * t);
+    if (!is_symbol(header, transition->guard) || !is_symbol(header, transition->action) ||
+        !is_record(transition->toState, header->statesOffset, header->statesCount, sizeof(fsm_image_state_t)))
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_image_fsm_init(fsm_image_fsm_t *const io_this, const fsm_image_t *const i_image)
+{
+  if (io_this == NULL || i_image == NULL || i_image->header == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  io_this->image = i_image;
+  return fsm_image_fsm_reset(io_this);
+}
+
+fsm_RC_t fsm_image_fsm_reset(fsm_image_fsm_t *const io_this)
+{
+  if (io_this == NULL || io_this->image == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  io_this->currentState = io_this->image->header->initialState;
+  io_this->isFirstRun = true;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_image_fsm_process(fsm_image_fsm_t *const io_this, fsm_event_t i_event)
+{
+  if (io_this == NULL || io_this->image == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  const fsm_image_t *image = io_this->image;
+  FSM_TRACE_INSTANCE(io_this);
+
+  /* Get the matching transition from the dispatch row */
+  const fsm_image_state_t *currState = AT(image, io_this->currentState);
+  const fsm_image_state_t *nextState = currState;
+  uint32_t action = FSM_IMAGE_NO_SYMBOL;
+  uint32_t transitionOffset = 0;
+  if ((uint32_t)i_event < image->header->eventCount)
+  {
+    transitionOffset = ((const uint32_t *)AT(image, currState->dispatch))[i_event];
+  }
+
+  if (transitionOffset != 0)
+  {
+    /* Transition defined for event, check guard condition */
+    const fsm_image_transition_t *transition = AT(image, transitionOffset);
+    bool guardCond = true;
+    if (transition->guard != FSM_IMAGE_NO_SYMBOL)
+    {
+      const fsm_image_symbol_t *guard = &image->symbols[transition->guard];
+      guardCond = (guard->guard == NULL) || guard->guard(guard->arg);
+    }
+
+    if (guardCond == true)
+    {
+      nextState = AT(image, transition->toState);
+      action = transition->action;
+      FSM_TRACE_EVENT(image->header, STATE_INDEX(image, io_this->currentState), (fsm_state_t)currState->state,
+                      i_event, (fsm_state_t)nextState->state,
+                      (transition->guard != FSM_IMAGE_NO_SYMBOL) ? FSM_TRACE_GUARD_PASSED : FSM_TRACE_NO_GUARD);
+    }
+    else
+    {
+      FSM_TRACE_EVENT(image->header, STATE_INDEX(image, io_this->currentState), (fsm_state_t)currState->state,
+                      i_event, (fsm_state_t)currState->state, FSM_TRACE_GUARD_REJECTED);
+    }
+  }
+  else
+  {
+    FSM_TRACE_EVENT(image->header, STATE_INDEX(image, io_this->currentState), (fsm_state_t)currState->state,
+                    i_event, (fsm_state_t)currState->state, FSM_TRACE_NO_TRANSITION);
+  }
+
+  /* First run, perform entry action of initial state */
+  if (io_this->isFirstRun == true)
+  {
+    perform_symbol(image, currState->entryAction);
+    io_this->isFirstRun = false;
+  }
+
+  /* Same action order as fsm_process */
+  perform_symbol(image, currState->doAction);
+  if (currState != nextState)
+  {
+    perform_symbol(image, currState->exitAction);
+    perform_symbol(image, action);
+    perform_symbol(image, nextState->entryAction);
+    perform_symbol(image, nextState->doAction);
+    io_this->currentState = (uint32_t)((const uint8_t *)nextState - image->base);
+  }
+  else
+  {
+    perform_symbol(image, action);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_image_fsm_get_state(const fsm_image_fsm_t *const i_this, fsm_state_t *const o_state)
+{
+  if (i_this == NULL || i_this->image == NULL || o_state == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  const fsm_image_state_t *state = AT(i_this->image, i_this->currentState);
+  *o_state = (fsm_state_t)state->state;
+  return FSM_RC_OK;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static fsm_RC_t find_symbol(const fsm_image_symbol_t *const i_symbols,
+                            uint32_t i_symbolsCount,
+                            fsm_func_t i_action,
+                            fsm_guard_func_t i_guard,
+                            fsm_arg_t i_arg,
+                            uint32_t *const io_maxSymbol,
+                            uint32_t *const o_index)
+{
+  *o_index = FSM_IMAGE_NO_SYMBOL;
+  if (i_action == NULL && i_guard == NULL)
+  {
+    return FSM_RC_OK;
+  }
+
+  for (uint32_t i = 0; i < i_symbolsCount; i++)
+  {
+    const fsm_image_symbol_t *symbol = &i_symbols[i];
+    if (symbol->action == i_action && symbol->guard == i_guard && symbol->arg == i_arg)
+    {
+      *o_index = i;
+      if (i + 1u > *io_maxSymbol)
+      {
+        *io_maxSymbol = i + 1u;
+      }
+      return FSM_RC_OK;
+    }
+  }
+  return FSM_RC_ERROR_INVALID_ARG;
+}
+
+static inline void perform_symbol(const fsm_image_t *const i_image, uint32_t i_symbol)
+{
+  if (i_symbol != FSM_IMAGE_NO_SYMBOL)
+  {
+    const fsm_image_symbol_t *symbol = &i_image->symbols[i_symbol];
+    if (symbol->action != NULL)
+    {
+      symbol->action(symbol->arg);
+    }
+  }
+}
+
+static bool is_record(uint32_t i_offset, uint32_t i_arrayOffset, uint32_t i_count, size_t i_recordSize)
+{
+  return i_offset >= i_arrayOffset &&
+         (i_offset - i_arrayOffset) % i_recordSize == 0 &&
+         (i_offset - i_arrayOffset) / i_recordSize < i_count;
+}
+
+static bool is_symbol(const fsm_image_header_t *const i_header, uint32_t i_symbol)
+{
+  return i_symbol == FSM_IMAGE_NO_SYMBOL || i_symbol < i_header->symbolsCount;
+}
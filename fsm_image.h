@@ -0,0 +1,229 @@
+/**
+ * @file       fsm_image.h
+ * @brief      Relocatable binary image of an FSM configuration
+ *
+ *             Serializes a fsm_cfg_t into a position independent image:
+ *             states and transitions refer to each other by byte offsets from
+ *             the image start, actions and guards by index into an action
+ *             table which is registered when loading. The image can be
+ *             written once at build time and mapped read only (mmap) by any
+ *             number of processes. Loading only checks the header, the image
+ *             is used in place without any per state setup.
+ *             Layout (native byte order, all records 4 byte aligned):
+ *               header       fsm_image_header_t
+ *               states       fsm_image_state_t[statesCount]
+ *               transitions  fsm_image_transition_t[transitionsCount]
+ *               dispatch     per state one row of eventCount uint32_t,
+ *                            offset of the transition taken on the event,
+ *                            0 if none
+ *             Sub fsms, sub configurations, regions, timed transitions and
+ *             actions or guards taking the event object are not part of an
+ *             image. Image instances take no modules (recorder, hit counters),
+ *             record and profile the configuration with fsm_t instead.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_IMAGE_H_
+#define FSM_IMAGE_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_IMAGE_MAGIC 0x494D5346u    /**< "FSMI" */
+#define FSM_IMAGE_VERSION 1u           /**< Current image version */
+#define FSM_IMAGE_NO_SYMBOL UINT32_MAX /**< No action or guard */
+
+/**
+ * @brief Entry of the action table
+ *
+ * Actions use action and arg, guards use guard and arg.
+ */
+typedef struct
+{
+  fsm_func_t action;      /**< Action function, null for a guard */
+  fsm_guard_func_t guard; /**< Guard function, null for an action */
+  fsm_arg_t arg;          /**< Argument for the function */
+} fsm_image_symbol_t;
+
+/** Action table entry of an action */
+#define FSM_IMAGE_ACTION(func, arg_) {.action = (func), .arg = (fsm_arg_t)(arg_)}
+
+/** Action table entry of a guard */
+#define FSM_IMAGE_GUARD(func, arg_) {.guard = (func), .arg = (fsm_arg_t)(arg_)}
+
+/**
+ * @brief Image Header
+ */
+typedef struct
+{
+  uint32_t magic;             /**< FSM_IMAGE_MAGIC */
+  uint16_t version;           /**< FSM_IMAGE_VERSION */
+  uint16_t headerSize;        /**< sizeof(fsm_image_header_t) */
+  uint32_t imageSize;         /**< Size of the whole image */
+  uint32_t eventCount;        /**< Size of the event enum of the machine, cells per dispatch row */
+  uint32_t stateCount;        /**< Size of the state enum of the machine */
+  uint32_t symbolsCount;      /**< Minimum number of entries of the action table */
+  uint32_t initialState;      /**< Offset of the initial state */
+  uint32_t statesOffset;      /**< Offset of the states */
+  uint32_t statesCount;       /**< Number of states */
+  uint32_t transitionsOffset; /**< Offset of the transitions */
+  uint32_t transitionsCount;  /**< Number of transitions */
+  uint32_t dispatchOffset;    /**< Offset of the dispatch rows */
+} fsm_image_header_t;
+
+/**
+ * @brief State Record
+ */
+typedef struct
+{
+  uint32_t state;            /**< The Enum entry for this state */
+  uint32_t entryAction;      /**< Action table index or FSM_IMAGE_NO_SYMBOL */
+  uint32_t doAction;         /**< Action table index or FSM_IMAGE_NO_SYMBOL */
+  uint32_t exitAction;       /**< Action table index or FSM_IMAGE_NO_SYMBOL */
+  uint32_t transitions;      /**< Offset of the first transition of this state */
+  uint32_t transitionsCount; /**< Number of transitions of this state */
+  uint32_t dispatch;         /**< Offset of the dispatch row of this state */
+} fsm_image_state_t;
+
+/**
+ * @brief Transition Record
+ */
+typedef struct
+{
+  uint32_t event;   /**< Event triggering the transition */
+  uint32_t toState; /**< Offset of the next state */
+  uint32_t guard;   /**< Action table index or FSM_IMAGE_NO_SYMBOL */
+  uint32_t action;  /**< Action table index or FSM_IMAGE_NO_SYMBOL */
+} fsm_image_transition_t;
+
+/**
+ * @brief Loaded Image
+ */
+typedef struct
+{
+  const uint8_t *base;               /**< Start of the image */
+  const fsm_image_header_t *header;  /**< Header at the start of the image */
+  const fsm_image_symbol_t *symbols; /**< Registered action table */
+} fsm_image_t;
+
+/**
+ * @brief Instance running on an image
+ */
+typedef struct
+{
+  const fsm_image_t *image; /**< The loaded image */
+  uint32_t currentState;    /**< Offset of the current state */
+  bool isFirstRun;          /**< Flag indicating if the FSM has been run yet */
+} fsm_image_fsm_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Write the image of a configuration
+ *
+ * Every action and guard of the configuration must be an entry of the action
+ * table, matched by function and argument.
+ *
+ * @param i_config The configuration, without sub fsms, sub configurations,
+ *                 regions, timed transitions and event object functions
+ * @param i_symbols The action table
+ * @param i_symbolsCount Number of entries in the action table
+ * @param o_image Buffer for the image, 4 byte aligned, null to only get the size
+ * @param i_imageSize Size of the buffer
+ * @param o_size Size of the image
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the buffer is too
+ *         small or a function is missing in the action table,
+ *         FSM_RC_ERROR_INVALID_CONFIG if the configuration is not representable
+ *         or the image would exceed 4 GiB, error code otherwise
+ */
+fsm_RC_t fsm_image_write(const fsm_cfg_t *const i_config,
+                         const fsm_image_symbol_t *const i_symbols,
+                         uint32_t i_symbolsCount,
+                         void *const o_image,
+                         size_t i_imageSize,
+                         size_t *const o_size);
+
+/**
+ * @brief Load an image and bind it to an action table
+ *
+ * Only the header is checked, see fsm_image_verify for untrusted images.
+ *
+ * @param o_this The loaded image
+ * @param i_image The image, 4 byte aligned, e.g. mmap'd read only
+ * @param i_imageSize Size of the image
+ * @param i_symbols The action table, same order as when writing
+ * @param i_symbolsCount Number of entries in the action table
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the image does not
+ *         match, error code otherwise
+ */
+fsm_RC_t fsm_image_load(fsm_image_t *const o_this,
+                        const void *const i_image,
+                        size_t i_imageSize,
+                        const fsm_image_symbol_t *const i_symbols,
+                        uint32_t i_symbolsCount);
+
+/**
+ * @brief Check every record of a loaded image
+ *
+ * @param i_this The loaded image
+ *
+ * @return FSM_RC_OK if all offsets and indices are valid,
+ *         FSM_RC_ERROR_INVALID_CONFIG otherwise
+ */
+fsm_RC_t fsm_image_verify(const fsm_image_t *const i_this);
+
+/**
+ * @brief Initialize an instance on a loaded image
+ *
+ * @param io_this Pointer to the instance to initialize
+ * @param i_image The loaded image
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_image_fsm_init(fsm_image_fsm_t *const io_this, const fsm_image_t *const i_image);
+
+/**
+ * @brief Reset an instance to its initial state
+ *
+ * @param io_this Pointer to the instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_image_fsm_reset(fsm_image_fsm_t *const io_this);
+
+/**
+ * @brief Process an event, same semantics as fsm_process
+ *
+ * @param io_this Pointer to the instance
+ * @param i_event The event to process
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_image_fsm_process(fsm_image_fsm_t *const io_this, fsm_event_t i_event);
+
+/**
+ * @brief Get the current state of an instance
+ *
+ * @param i_this Pointer to the instance
+ * @param o_state The current state
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_image_fsm_get_state(const fsm_image_fsm_t *const i_this, fsm_state_t *const o_state);
+
+#endif /* FSM_IMAGE_H_ */
@@ -0,0 +1,229 @@
+/**
+ * @file       fsm_internal.h
+ * @brief      Internal interface of the FSM
+ *
+ *             Functions shared between the FSM modules. Not part of the API,
+ *             do not include from application code.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_INTERNAL_H_
+#define FSM_INTERNAL_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+struct fsm_queue; /**< Forward declaration of the event queue, see fsm_queue.h */
+struct fsm_pool;  /**< Forward declaration of the instance pool, see fsm_pool.h */
+
+/******************************************************************************/
+/*** Internal Functions                                                       */
+/******************************************************************************/
+
+/**
+ * @brief Size of the state enum of a configuration
+ *
+ * @param i_config The fsm configuration
+ *
+ * @return stateEnumCount, FSM_STATE_COUNT if not set
+ */
+uint32_t fsm_state_enum_count(const fsm_cfg_t *const i_config);
+
+/**
+ * @brief Size of the event enum of a configuration
+ *
+ * @param i_config The fsm configuration
+ *
+ * @return eventEnumCount, FSM_EVENT_COUNT if not set
+ */
+uint32_t fsm_event_enum_count(const fsm_cfg_t *const i_config);
+
+/**
+ * @brief Process an event with its event object, see fsm_process_event
+ *
+ * Called from an action of the instance the event and the object are queued
+ * like fsm_raise.
+ *
+ * @param io_this Pointer to the FSM instance
+ * @param i_event The event to process
+ * @param io_obj The event object, the reference of the caller is consumed
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_process_obj(fsm_t *const io_this, fsm_event_t i_event, fsm_event_obj_t *const io_obj);
+
+/**
+ * @brief Check if an action is set, with or without the event object
+ *
+ * @param i_action The action
+ *
+ * @return true if func or eventFunc is set
+ */
+bool fsm_action_is_set(const fsm_action_t *const i_action);
+
+/**
+ * @brief Check if a guard is set, with or without the event object
+ *
+ * @param i_guard The guard
+ *
+ * @return true if func or eventFunc is set
+ */
+bool fsm_guard_is_set(const fsm_guard_t *const i_guard);
+
+/**
+ * @brief Check if an action or guard of a state or its transitions takes the event object
+ *
+ * For the paths storing plain function pointers only.
+ *
+ * @param i_stateCfg The state
+ *
+ * @return true if an eventFunc is set
+ */
+bool fsm_state_uses_event_obj(const fsm_state_cfg_t *const i_stateCfg);
+
+/**
+ * @brief Getting State Configuration from state
+ *
+ * Uses the dispatch table if built, otherwise searches the states array.
+ *
+ * @param i_config The fsm configuration
+ * @param i_state State to get the config struct from
+ *
+ * @return The State configuration or null if not defined in the fsm config
+ */
+fsm_state_cfg_t const *fsm_get_state_cfg(const fsm_cfg_t *const i_config, fsm_state_t i_state);
+
+/**
+ * @brief Process an event in a state
+ *
+ * Runs the transition lookup, guard and the entry, do, exit and transition
+ * actions, and forwards the event to the sub fsm, sub configuration and regions.
+ * Storage of the current state is up to the caller.
+ *
+ * @param i_config The fsm configuration
+ * @param i_currStateCfg The current state configuration
+ * @param io_isFirstRun First run flag of the instance, cleared on first run
+ * @param i_event The event to process
+ * @param io_obj [optional] Event object of the event, referenced by the caller
+ * @param o_nextStateCfg Set to the state configuration after the event
+ * @param io_subStates Inline states of the sub configurations, null if the
+ *                     caller has none
+ * @param i_subDepth Number of inline states
+ * @param io_regions Inline states of the regions, null if the caller has none
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if a sub
+ *         configuration or a region has no inline state, error code otherwise
+ */
+fsm_RC_t fsm_run_state(const fsm_cfg_t *const i_config,
+                       const fsm_state_cfg_t *const i_currStateCfg,
+                       bool *const io_isFirstRun,
+                       fsm_event_t i_event,
+                       fsm_event_obj_t *const io_obj,
+                       fsm_state_cfg_t const **const o_nextStateCfg,
+                       fsm_state_t *const io_subStates,
+                       uint32_t i_subDepth,
+                       fsm_region_state_t *const io_regions);
+
+/**
+ * @brief Check a configuration for pool instances and build its dispatch table
+ *
+ * @param i_config The fsm configuration
+ * @param o_initialIndex Index of the initial state in the states array
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the pool can
+ *         not run the configuration, error code otherwise
+ */
+fsm_RC_t fsm_pool_prepare_config(const fsm_cfg_t *const i_config, fsm_index_t *const o_initialIndex);
+
+/**
+ * @brief Sort the instances of a pool into the route buckets again
+ *
+ * @param io_this Pointer to the pool with a routing index, checked by the caller
+ */
+void fsm_pool_route_sort(struct fsm_pool *const io_this);
+
+/**
+ * @brief Take the oldest event from a queue, only from the owner thread
+ *
+ * @param io_this Pointer to the queue, checked by the caller
+ * @param o_event The taken event
+ *
+ * @return true if an event was taken, false if the queue is empty
+ */
+bool fsm_queue_pop(struct fsm_queue *const io_this, fsm_event_t *const o_event);
+
+/**
+ * @brief Process at most i_max pending events, only from the owner thread
+ *
+ * Like fsm_dispatch_pending, but returns after i_max events, e.g. to give
+ * the other instances of a worker their turn.
+ *
+ * @param io_this Pointer to the queue, checked by the caller
+ * @param i_max Maximum number of events to take
+ * @param o_dispatched Number of events taken from the queue
+ *
+ * @return FSM_RC_OK on success, error code of the failed event otherwise
+ */
+fsm_RC_t fsm_queue_dispatch(struct fsm_queue *const io_this, size_t i_max, size_t *const o_dispatched);
+
+/**
+ * @brief Check if a queue holds events, only by the thread owning the queue
+ *
+ * @param i_this Pointer to the queue, checked by the caller
+ *
+ * @return true if at least one event is pending
+ */
+bool fsm_queue_has_pending(struct fsm_queue *const i_this);
+
+/**
+ * @brief Bind a hook to an instance
+ *
+ * A hook with the same operations is replaced, without calling its reset.
+ *
+ * @param io_fsm The FSM instance
+ * @param io_hook The hook, ops set by the caller, must stay valid
+ */
+void fsm_hook_add(fsm_t *const io_fsm, fsm_hook_t *const io_hook);
+
+/**
+ * @brief Unbind the hook with the given operations from an instance
+ *
+ * @param io_fsm The FSM instance
+ * @param i_ops Operations of the hook
+ *
+ * @return The removed hook, null if none was bound
+ */
+fsm_hook_t *fsm_hook_remove(fsm_t *const io_fsm, const fsm_hook_ops_t *const i_ops);
+
+/**
+ * @brief Find the hook with the given operations bound to an instance
+ *
+ * @param i_fsm The FSM instance
+ * @param i_ops Operations of the hook
+ *
+ * @return The hook, null if none is bound
+ */
+fsm_hook_t *fsm_hook_find(const fsm_t *const i_fsm, const fsm_hook_ops_t *const i_ops);
+
+/**
+ * @brief Report an entered state to the hooks of an instance
+ *
+ * @param io_fsm The FSM instance
+ * @param i_stateCfg The entered state
+ */
+void fsm_hooks_enter(fsm_t *const io_fsm, const fsm_state_cfg_t *const i_stateCfg);
+
+/**
+ * @brief Report a reset, the state left without exit action, to the hooks
+ *
+ * @param io_fsm The FSM instance
+ */
+void fsm_hooks_reset(fsm_t *const io_fsm);
+
+#endif /* FSM_INTERNAL_H_ */
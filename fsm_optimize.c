@@ -0,0 +1,465 @@
+/**
+ * @file       fsm_optimize.c
+ * @brief      State minimization and dispatch table compression
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_optimize.h" /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <stdlib.h> /* for malloc, free */
+#include <string.h> /* for memcmp, memcpy */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define TARGET_SELF UINT32_MAX /**< Refinement key of a self transition */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Refinement state
+ */
+typedef struct
+{
+  const fsm_cfg_t *config;     /**< The input configuration */
+  const uint32_t *targets;     /**< Target state index per transition, all states back to back */
+  const uint32_t *firstTarget; /**< Offset of the targets of each state */
+  uint32_t *classes;           /**< Class per state */
+  bool *isPinned;              /**< State must not be merged */
+} optimize_ctx_t;
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Compare the refinement keys of two states
+ *
+ * @param i_ctx The refinement state
+ * @param i_a Index of the first state
+ * @param i_b Index of the second state
+ *
+ * @return <0, 0 or >0 like memcmp, 0 if the states stay in one class
+ */
+static int compare_states(const optimize_ctx_t *const i_ctx, uint32_t i_a, uint32_t i_b);
+
+/**
+ * @brief Stable merge sort of state indices by their refinement keys
+ *
+ * @param i_ctx The refinement state
+ * @param io_order The state indices
+ * @param io_tmp Scratch space of the same size
+ * @param i_count Number of state indices
+ */
+static void sort_states(const optimize_ctx_t *const i_ctx, uint32_t *io_order, uint32_t *io_tmp, uint32_t i_count);
+
+/**
+ * @brief Refine the classes until no class splits anymore
+ *
+ * @param io_ctx The refinement state
+ * @param io_order Scratch space for statesCount indices
+ * @param io_tmp Scratch space for statesCount indices
+ * @param io_newClasses Scratch space for statesCount classes
+ */
+static void refine(optimize_ctx_t *const io_ctx, uint32_t *io_order, uint32_t *io_tmp, uint32_t *io_newClasses);
+
+/**
+ * @brief Get the memory used by a configuration
+ *
+ * @param i_config The configuration
+ * @param o_tableBytes Memory of the dispatch table
+ *
+ * @return Memory of the states, transitions and dispatch table
+ */
+static size_t config_bytes(const fsm_cfg_t *const i_config, size_t *const o_tableBytes);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_optimize(const fsm_cfg_t *const i_config,
+                      uint32_t i_flags,
+                      fsm_builder_t *const io_builder,
+                      const fsm_cfg_t **const o_config,
+                      fsm_optimize_report_t *const io_report)
+{
+  if (i_config == NULL || io_builder == NULL || o_config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_builder->statesCount != 0 || io_builder->config != NULL)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_RC_t res = fsm_cfg_prepare(i_config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  /* The optimized configuration keeps the enums, the map covers the state enum */
+  const uint32_t stateEnumCount = fsm_state_enum_count(i_config);
+  if (io_report != NULL && io_report->stateMap != NULL && io_report->stateMapCount < stateEnumCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  res = fsm_builder_set_enums(io_builder, stateEnumCount, fsm_event_enum_count(i_config));
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  const uint32_t statesCount = i_config->statesCount;
+  uint32_t transitionsCount = 0;
+  for (uint32_t i = 0; i < statesCount; i++)
+  {
+    transitionsCount += i_config->states[i].transitionsCount;
+  }
+  const fsm_state_cfg_t *initialStateCfg = fsm_get_state_cfg(i_config, i_config->initialState);
+  if (initialStateCfg == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  uint32_t *targets = malloc(sizeof(uint32_t) * (transitionsCount + 1u));
+  uint32_t *scratch = malloc(sizeof(uint32_t) * statesCount * 5u);
+  bool *isPinned = calloc(statesCount, sizeof(bool));
+  if (targets == NULL || scratch == NULL || isPinned == NULL)
+  {
+    free(targets);
+    free(scratch);
+    free(isPinned);
+    return FSM_RC_ERROR;
+  }
+  uint32_t *firstTarget = &scratch[0];
+  uint32_t *classes = &scratch[statesCount];
+  uint32_t *order = &scratch[statesCount * 2u];
+  uint32_t *tmp = &scratch[statesCount * 3u];
+  uint32_t *newClasses = &scratch[statesCount * 4u];
+
+  /* Resolve the targets once */
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < statesCount && res == FSM_RC_OK; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    firstTarget[i] = offset;
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      const fsm_state_cfg_t *toStateCfg = fsm_get_state_cfg(i_config, stateCfg->transitions[t].toState);
+      if (toStateCfg == NULL)
+      {
+        res = FSM_RC_ERROR_INVALID_CONFIG;
+        break;
+      }
+      targets[offset++] = (uint32_t)(toStateCfg - i_config->states);
+    }
+  }
+
+  optimize_ctx_t ctx = {
+      .config = i_config,
+      .targets = targets,
+      .firstTarget = firstTarget,
+      .classes = classes,
+      .isPinned = isPinned,
+  };
+  for (uint32_t i = 0; i < statesCount; i++)
+  {
+    classes[i] = ((i_flags & FSM_OPTIMIZE_MINIMIZE) != 0) ? 0u : i;
+  }
+
+  /* Refine, then keep states apart whose state change would become a */
+  /* self transition, until the classes are stable */
+  bool isChanged = (res == FSM_RC_OK) && ((i_flags & FSM_OPTIMIZE_MINIMIZE) != 0);
+  while (isChanged == true)
+  {
+    refine(&ctx, order, tmp, newClasses);
+    isChanged = false;
+    for (uint32_t i = 0; i < statesCount; i++)
+    {
+      for (uint32_t t = 0; t < i_config->states[i].transitionsCount && isPinned[i] == false; t++)
+      {
+        uint32_t target = targets[firstTarget[i] + t];
+        if (target != i && classes[target] == classes[i])
+        {
+          isPinned[i] = true;
+          isChanged = true;
+        }
+      }
+    }
+  }
+
+  /* The lowest member of a class represents it */
+  uint32_t *representative = newClasses;
+  for (uint32_t i = 0; i < statesCount; i++)
+  {
+    representative[i] = UINT32_MAX;
+  }
+  for (uint32_t i = 0; i < statesCount; i++)
+  {
+    if (representative[classes[i]] == UINT32_MAX)
+    {
+      representative[classes[i]] = i;
+    }
+  }
+
+  /* Stage the representatives */
+  for (uint32_t i = 0; i < statesCount && res == FSM_RC_OK; i++)
+  {
+    if (representative[classes[i]] != i)
+    {
+      continue;
+    }
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    res = fsm_builder_add_state(io_builder, stateCfg->state);
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_actions(io_builder, stateCfg->state, stateCfg->entryAction, stateCfg->doAction,
+                                    stateCfg->exitAction);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_sub_fsm(io_builder, stateCfg->state, stateCfg->subFsm);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_sub_cfg(io_builder, stateCfg->state, stateCfg->subCfg);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_regions(io_builder, stateCfg->state, stateCfg->regions);
+    }
+    for (uint32_t t = 0; t < stateCfg->transitionsCount && res == FSM_RC_OK; t++)
+    {
+      const fsm_transition_cfg_t *transitionCfg = &stateCfg->transitions[t];
+      uint32_t target = representative[classes[targets[firstTarget[i] + t]]];
+      const fsm_transition_cfg_t transition = {
+          .event = transitionCfg->event,
+          .toState = i_config->states[target].state,
+          .guard = transitionCfg->guard,
+          .action = transitionCfg->action,
+          .after = transitionCfg->after,
+          .every = transitionCfg->every,
+      };
+      res = fsm_builder_add_transition(io_builder, stateCfg->state, &transition);
+    }
+  }
+  if (res == FSM_RC_OK)
+  {
+    uint32_t initial = representative[classes[initialStateCfg - i_config->states]];
+    res = fsm_builder_set_initial(io_builder, i_config->states[initial].state);
+  }
+  if (res == FSM_RC_OK)
+  {
+    res = fsm_builder_set_packed(io_builder, (i_flags & FSM_OPTIMIZE_PACK) != 0);
+  }
+  if (res == FSM_RC_OK)
+  {
+    res = fsm_builder_finalize(io_builder, o_config);
+  }
+
+  if (res == FSM_RC_OK && io_report != NULL)
+  {
+    if (io_report->stateMap != NULL)
+    {
+      for (uint32_t s = 0; s < stateEnumCount; s++)
+      {
+        io_report->stateMap[s] = (fsm_state_t)s;
+      }
+      for (uint32_t i = 0; i < statesCount; i++)
+      {
+        if ((uint32_t)i_config->states[i].state < stateEnumCount)
+        {
+          io_report->stateMap[i_config->states[i].state] = i_config->states[representative[classes[i]]].state;
+        }
+      }
+    }
+    io_report->statesBefore = statesCount;
+    io_report->statesAfter = io_builder->statesCount;
+    io_report->transitionsBefore = transitionsCount;
+    io_report->transitionsAfter = io_builder->transitionsCount;
+    io_report->bytesBefore = config_bytes(i_config, &io_report->tableBytesBefore);
+    io_report->bytesAfter = config_bytes(*o_config, &io_report->tableBytesAfter);
+  }
+
+  free(targets);
+  free(scratch);
+  free(isPinned);
+  return res;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static int compare_states(const optimize_ctx_t *const i_ctx, uint32_t i_a, uint32_t i_b)
+{
+  if (i_ctx->classes[i_a] != i_ctx->classes[i_b])
+  {
+    return (i_ctx->classes[i_a] < i_ctx->classes[i_b]) ? -1 : 1;
+  }
+  if ((i_ctx->isPinned[i_a] == true || i_ctx->isPinned[i_b] == true) && i_a != i_b)
+  {
+    return (i_a < i_b) ? -1 : 1;
+  }
+
+  const fsm_state_cfg_t *a = &i_ctx->config->states[i_a];
+  const fsm_state_cfg_t *b = &i_ctx->config->states[i_b];
+  int res = memcmp(&a->subFsm, &b->subFsm, sizeof(a->subFsm));
+  res = (res != 0) ? res : memcmp(&a->subCfg, &b->subCfg, sizeof(a->subCfg));
+  res = (res != 0) ? res : memcmp(&a->regions, &b->regions, sizeof(a->regions));
+  const fsm_action_t *actionsA[3] = {&a->entryAction, &a->doAction, &a->exitAction};
+  const fsm_action_t *actionsB[3] = {&b->entryAction, &b->doAction, &b->exitAction};
+  for (uint32_t i = 0; i < 3u && res == 0; i++)
+  {
+    res = memcmp(&actionsA[i]->func, &actionsB[i]->func, sizeof(fsm_func_t));
+    res = (res != 0) ? res : memcmp(&actionsA[i]->arg, &actionsB[i]->arg, sizeof(fsm_arg_t));
+    res = (res != 0) ? res : memcmp(&actionsA[i]->eventFunc, &actionsB[i]->eventFunc, sizeof(fsm_event_func_t));
+  }
+  if (res != 0)
+  {
+    return res;
+  }
+  if (a->transitionsCount != b->transitionsCount)
+  {
+    return (a->transitionsCount < b->transitionsCount) ? -1 : 1;
+  }
+
+  /* Same transitions in the same order, targets by class */
+  for (uint32_t t = 0; t < a->transitionsCount; t++)
+  {
+    const fsm_transition_cfg_t *ta = &a->transitions[t];
+    const fsm_transition_cfg_t *tb = &b->transitions[t];
+    if (ta->event != tb->event)
+    {
+      return (ta->event < tb->event) ? -1 : 1;
+    }
+    if (ta->after != tb->after)
+    {
+      return (ta->after < tb->after) ? -1 : 1;
+    }
+    if (ta->every != tb->every)
+    {
+      return (ta->every < tb->every) ? -1 : 1;
+    }
+    res = memcmp(&ta->guard.func, &tb->guard.func, sizeof(fsm_guard_func_t));
+    res = (res != 0) ? res : memcmp(&ta->guard.arg, &tb->guard.arg, sizeof(fsm_arg_t));
+    res = (res != 0) ? res : memcmp(&ta->action.func, &tb->action.func, sizeof(fsm_func_t));
+    res = (res != 0) ? res : memcmp(&ta->action.arg, &tb->action.arg, sizeof(fsm_arg_t));
+    res = (res != 0) ? res : memcmp(&ta->guard.eventFunc, &tb->guard.eventFunc, sizeof(fsm_event_guard_func_t));
+    res = (res != 0) ? res : memcmp(&ta->action.eventFunc, &tb->action.eventFunc, sizeof(fsm_event_func_t));
+    if (res != 0)
+    {
+      return res;
+    }
+
+    uint32_t targetA = i_ctx->targets[i_ctx->firstTarget[i_a] + t];
+    uint32_t targetB = i_ctx->targets[i_ctx->firstTarget[i_b] + t];
+    uint32_t keyA = (targetA == i_a) ? TARGET_SELF : i_ctx->classes[targetA];
+    uint32_t keyB = (targetB == i_b) ? TARGET_SELF : i_ctx->classes[targetB];
+    if (keyA != keyB)
+    {
+      return (keyA < keyB) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+static void sort_states(const optimize_ctx_t *const i_ctx, uint32_t *io_order, uint32_t *io_tmp, uint32_t i_count)
+{
+  uint32_t *from = io_order;
+  uint32_t *to = io_tmp;
+  for (uint32_t width = 1; width < i_count; width *= 2u)
+  {
+    for (uint32_t lo = 0; lo < i_count; lo += 2u * width)
+    {
+      uint32_t mid = (lo + width < i_count) ? lo + width : i_count;
+      uint32_t hi = (mid + width < i_count) ? mid + width : i_count;
+      uint32_t l = lo;
+      uint32_t r = mid;
+      for (uint32_t k = lo; k < hi; k++)
+      {
+        if (l < mid && (r >= hi || compare_states(i_ctx, from[l], from[r]) <= 0))
+        {
+          to[k] = from[l++];
+        }
+        else
+        {
+          to[k] = from[r++];
+        }
+      }
+    }
+    uint32_t *swap = from;
+    from = to;
+    to = swap;
+  }
+  if (from != io_order)
+  {
+    memcpy(io_order, from, sizeof(uint32_t) * i_count);
+  }
+}
+
+static void refine(optimize_ctx_t *const io_ctx, uint32_t *io_order, uint32_t *io_tmp, uint32_t *io_newClasses)
+{
+  const uint32_t statesCount = io_ctx->config->statesCount;
+  uint32_t classesCount = 0;
+  for (;;)
+  {
+    for (uint32_t i = 0; i < statesCount; i++)
+    {
+      io_order[i] = i;
+    }
+    sort_states(io_ctx, io_order, io_tmp, statesCount);
+
+    /* Equal keys share the new class */
+    uint32_t count = 1;
+    io_newClasses[io_order[0]] = 0;
+    for (uint32_t k = 1; k < statesCount; k++)
+    {
+      if (compare_states(io_ctx, io_order[k - 1u], io_order[k]) != 0)
+      {
+        count++;
+      }
+      io_newClasses[io_order[k]] = count - 1u;
+    }
+    memcpy(io_ctx->classes, io_newClasses, sizeof(uint32_t) * statesCount);
+
+    /* Classes only split, the same count means stable */
+    if (count == classesCount)
+    {
+      break;
+    }
+    classesCount = count;
+  }
+}
+
+static size_t config_bytes(const fsm_cfg_t *const i_config, size_t *const o_tableBytes)
+{
+  size_t bytes = sizeof(fsm_cfg_t) + sizeof(fsm_state_cfg_t) * i_config->statesCount;
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    bytes += sizeof(fsm_transition_cfg_t) * i_config->states[i].transitionsCount;
+  }
+
+  size_t tableBytes = 0;
+  if (i_config->dispatch != NULL)
+  {
+    tableBytes = sizeof(fsm_dispatch_t) + sizeof(fsm_index_t) * i_config->dispatch->stateIndexCount +
+                 sizeof(fsm_dispatch_cell_t) * i_config->dispatch->cellsCount;
+  }
+  else if (i_config->packed != NULL)
+  {
+    tableBytes = sizeof(fsm_packed_t) + sizeof(fsm_index_t) * i_config->packed->stateIndexCount +
+                 sizeof(uint32_t) * i_config->statesCount + sizeof(fsm_packed_cell_t) * i_config->packed->cellsCount;
+  }
+  *o_tableBytes = tableBytes;
+  return bytes + tableBytes;
+}
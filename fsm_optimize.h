@@ -0,0 +1,100 @@
+/**
+ * @file       fsm_optimize.h
+ * @brief      State minimization and dispatch table compression
+ *
+ *             One shot pass at init which turns a configuration into an
+ *             equivalent, smaller one built with a fsm_builder_t.
+ *             Minimization merges states which can not be told apart by the
+ *             actions they run: same entry, do and exit action, same sub fsm
+ *             or sub configuration and the same transitions (event, guard,
+ *             action, timing) into equivalent states. Equivalence is found by
+ *             partition refinement (Moore), a state keeps its own class if a
+ *             merge would turn one of its state changes into a self
+ *             transition, since only a state change runs the exit and entry
+ *             actions.
+ *             Compression attaches the row displaced dispatch table
+ *             (fsm_packed_t) instead of the dense one.
+ *             The optimized configuration reports the representative of a
+ *             merged state, e.g. as currentState and in traces, the report maps
+ *             every state to its representative.
+ *
+ *             fsm_builder_init(&builder, 0);
+ *             fsm_optimize(&config, FSM_OPTIMIZE_MINIMIZE | FSM_OPTIMIZE_PACK,
+ *                          &builder, &optimized, &report);
+ *
+ *             with report.stateMap/stateMapCount set to storage for one entry
+ *             per value of the state enum, or null.
+ *             fsm_init(&fsm, optimized);
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_OPTIMIZE_H_
+#define FSM_OPTIMIZE_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"         /* FSM types */
+#include "fsm_builder.h" /* fsm_builder_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_OPTIMIZE_MINIMIZE 0x1u /**< Merge equivalent states */
+#define FSM_OPTIMIZE_PACK 0x2u     /**< Attach the row displaced dispatch table */
+
+/**
+ * @brief Optimization Report
+ *
+ * The state map is provided by the caller, sized by the state enum of the
+ * machine (stateEnumCount of the configuration).
+ */
+typedef struct
+{
+  uint32_t statesBefore;      /**< States of the input configuration */
+  uint32_t statesAfter;       /**< States of the optimized configuration */
+  uint32_t transitionsBefore; /**< Transitions of the input configuration */
+  uint32_t transitionsAfter;  /**< Transitions of the optimized configuration */
+  size_t tableBytesBefore;    /**< Dispatch table of the input configuration */
+  size_t tableBytesAfter;     /**< Dispatch table of the optimized configuration */
+  size_t bytesBefore;         /**< States, transitions and dispatch table before */
+  size_t bytesAfter;          /**< States, transitions and dispatch table after */
+  fsm_state_t *stateMap;      /**< [optional] Representative of every state, itself if not merged, set by the caller */
+  uint32_t stateMapCount;     /**< Entries of stateMap, at least the size of the state enum, set by the caller */
+} fsm_optimize_report_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Build an optimized copy of a configuration
+ *
+ * Every transition must target a state of the configuration. The input
+ * configuration is left unchanged apart from its dispatch table being built.
+ * The optimized configuration uses the same state and event enums.
+ *
+ * @param i_config The configuration
+ * @param i_flags FSM_OPTIMIZE_MINIMIZE and/or FSM_OPTIMIZE_PACK
+ * @param io_builder Initialized, empty builder holding the optimized
+ *                   configuration
+ * @param o_config The optimized configuration, valid until fsm_builder_free
+ * @param io_report [optional] Sizes before and after and the state mapping,
+ *                  FSM_RC_ERROR_INVALID_ARG if the stateMap provided is
+ *                  smaller than the state enum (stateEnumCount)
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the
+ *         configuration is invalid, FSM_RC_ERROR if an allocation failed,
+ *         error code otherwise
+ */
+fsm_RC_t fsm_optimize(const fsm_cfg_t *const i_config,
+                      uint32_t i_flags,
+                      fsm_builder_t *const io_builder,
+                      const fsm_cfg_t **const o_config,
+                      fsm_optimize_report_t *const io_report);
+
+#endif /* FSM_OPTIMIZE_H_ */
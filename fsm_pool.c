@@ -0,0 +1,670 @@
+/**
+ * @file       fsm_pool.c
+ * @brief      Pool of FSM instances sharing one configuration
+ *
+ *             Stores the instances as struct of arrays: one state index per
+ *             instance plus a bitset of first run flags. Storage is provided by
+ *             the caller, see FSM_POOL_FIRST_RUN_WORDS.
+ *             Sub fsms linked in the configuration are shared by all instances.
+ *             The routing index keeps every instance in a circular, doubly
+ *             linked list per state (route bucket) and the states reacting to
+ *             each event in one list per event, built once from the
+ *             configuration. A broadcast detaches the buckets of the states
+ *             listed for the event and sorts every processed instance back
+ *             into the bucket of its new state.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_pool.h"     /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+#include "fsm_trace.h"    /* Tracing hooks, compiled out by default */
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Process an event in one instance without argument checks
+ *
+ * @param io_this Pointer to the pool, checked by the caller
+ * @param i_instance Index of the instance, checked by the caller
+ * @param i_event The event to process
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t process_instance(fsm_pool_t *const io_this, uint32_t i_instance, fsm_event_t i_event);
+
+/**
+ * @brief Process an event in one instance and update its route bucket
+ *
+ * @param io_this Pointer to the pool, checked by the caller
+ * @param i_instance Index of the instance, checked by the caller
+ * @param i_event The event to process
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t process_routed(fsm_pool_t *const io_this, uint32_t i_instance, fsm_event_t i_event);
+
+/**
+ * @brief Get the route bucket of an instance
+ *
+ * @param i_this Pointer to the pool
+ * @param i_instance Index of the instance
+ *
+ * @return The state index, statesCount in the first run
+ */
+static uint32_t route_bucket(const fsm_pool_t *const i_this, uint32_t i_instance);
+
+/**
+ * @brief Append an instance to a circular list
+ *
+ * @param io_this Pointer to the pool
+ * @param io_head Head of the list
+ * @param i_instance Index of the instance, not part of any list
+ */
+static void route_link(fsm_pool_t *const io_this, uint32_t *const io_head, uint32_t i_instance);
+
+/**
+ * @brief Remove an instance from a circular list
+ *
+ * @param io_this Pointer to the pool
+ * @param io_head Head of the list
+ * @param i_instance Index of the instance, part of the list
+ */
+static void route_unlink(fsm_pool_t *const io_this, uint32_t *const io_head, uint32_t i_instance);
+
+/**
+ * @brief Append a circular list to another one
+ *
+ * @param io_this Pointer to the pool
+ * @param io_head Head of the list to append to
+ * @param io_other Head of the appended list, emptied
+ */
+static void route_splice(fsm_pool_t *const io_this, uint32_t *const io_head, uint32_t *const io_other);
+
+/**
+ * @brief Sort every instance into the route bucket of its state
+ *
+ * @param io_this Pointer to the pool with a routing index
+ */
+static void route_sort(fsm_pool_t *const io_this);
+
+/**
+ * @brief List the reacting states per event
+ *
+ * Offset k of the list is the first entry of event k, followed by the offsets
+ * of the events out of range, of the states reacting to every event and the
+ * end of the entries. A state is listed at most once per list.
+ *
+ * @param i_config The configuration
+ * @param o_reacts Storage for the offsets and the entries
+ * @param i_reactsSize Number of words in the storage
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the storage is too
+ *         small
+ */
+static fsm_RC_t route_list_reacts(const fsm_cfg_t *const i_config, uint32_t *const o_reacts, uint32_t i_reactsSize);
+
+/**
+ * @brief Get the list of a state in the reacting states
+ *
+ * @param i_stateCfg The state
+ * @param i_eventEnumCount Size of the event enum of the configuration
+ * @param i_transition Index of a transition of the state
+ *
+ * @return The event of the transition, i_eventEnumCount for events out of
+ *         range, i_eventEnumCount + 1 for the states reacting to every event
+ */
+static uint32_t route_list(const fsm_state_cfg_t *const i_stateCfg,
+                           uint32_t i_eventEnumCount,
+                           uint32_t i_transition);
+
+/**
+ * @brief Check if a transition is the first one of its state in its list
+ *
+ * @param i_stateCfg The state
+ * @param i_eventEnumCount Size of the event enum of the configuration
+ * @param i_transition Index of the transition
+ *
+ * @return true if no earlier transition of the state is in the same list
+ */
+static bool route_is_first(const fsm_state_cfg_t *const i_stateCfg,
+                           uint32_t i_eventEnumCount,
+                           uint32_t i_transition);
+
+/**
+ * @brief Check if processing an event in a state runs any action
+ *
+ * Instances in their first run always react, they run the entry action.
+ *
+ * @param i_stateCfg The state
+ * @param i_event The event
+ *
+ * @return true if the state has a transition for the event, a do action or a
+ *         sub fsm
+ */
+static bool route_reacts(const fsm_state_cfg_t *const i_stateCfg, fsm_event_t i_event);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_pool_init(fsm_pool_t *const io_this,
+                       const fsm_cfg_t *const i_config,
+                       fsm_index_t *const i_stateIndex,
+                       uint32_t *const i_firstRunBits,
+                       uint32_t i_instancesCount)
+{
+  if (io_this == NULL || i_config == NULL || i_stateIndex == NULL || i_firstRunBits == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_index_t initialIndex = 0;
+  fsm_RC_t res = fsm_pool_prepare_config(i_config, &initialIndex);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  io_this->config = i_config;
+  io_this->stateIndex = i_stateIndex;
+  io_this->firstRunBits = i_firstRunBits;
+  io_this->instancesCount = i_instancesCount;
+  io_this->initialIndex = initialIndex;
+  io_this->routeNext = NULL;
+  io_this->routePrev = NULL;
+  io_this->routeHeads = NULL;
+  io_this->routeReacts = NULL;
+
+  /* Reset all instances */
+  for (uint32_t i = 0; i < i_instancesCount; i++)
+  {
+    i_stateIndex[i] = io_this->initialIndex;
+  }
+  for (uint32_t i = 0; i < FSM_POOL_FIRST_RUN_WORDS(i_instancesCount); i++)
+  {
+    i_firstRunBits[i] = UINT32_MAX;
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_pool_reset(fsm_pool_t *const io_this, uint32_t i_instance)
+{
+  if (io_this == NULL || io_this->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_instance >= io_this->instancesCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  uint32_t bucket = route_bucket(io_this, i_instance);
+  io_this->stateIndex[i_instance] = io_this->initialIndex;
+  io_this->firstRunBits[i_instance / 32u] |= (1u << (i_instance % 32u));
+  if (io_this->routeHeads != NULL && bucket != io_this->config->statesCount)
+  {
+    route_unlink(io_this, &io_this->routeHeads[bucket], i_instance);
+    route_link(io_this, &io_this->routeHeads[io_this->config->statesCount], i_instance);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_pool_process(fsm_pool_t *const io_this, uint32_t i_instance, fsm_event_t i_event)
+{
+  if (io_this == NULL || io_this->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_instance >= io_this->instancesCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  return process_routed(io_this, i_instance, i_event);
+}
+
+fsm_RC_t fsm_pool_process_batch(fsm_pool_t *const io_this,
+                                const fsm_pool_event_t *const i_events,
+                                size_t i_eventsCount,
+                                size_t *const o_processed)
+{
+  if (o_processed != NULL)
+  {
+    *o_processed = 0;
+  }
+  if (io_this == NULL || io_this->config == NULL || i_events == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  for (size_t i = 0; i < i_eventsCount; i++)
+  {
+    fsm_RC_t res = FSM_RC_ERROR_INVALID_ARG;
+    if (i_events[i].instance < io_this->instancesCount)
+    {
+      res = process_routed(io_this, i_events[i].instance, i_events[i].event);
+    }
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+    if (o_processed != NULL)
+    {
+      *o_processed = i + 1;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_pool_get_state(const fsm_pool_t *const i_this, uint32_t i_instance, fsm_state_t *const o_state)
+{
+  if (i_this == NULL || i_this->config == NULL || o_state == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_instance >= i_this->instancesCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  *o_state = i_this->config->states[i_this->stateIndex[i_instance]].state;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_pool_route(fsm_pool_t *const io_this,
+                        uint32_t *const i_next,
+                        uint32_t *const i_prev,
+                        uint32_t *const i_heads,
+                        uint32_t *const i_reacts,
+                        uint32_t i_reactsSize)
+{
+  if (io_this == NULL || io_this->config == NULL || i_next == NULL || i_prev == NULL || i_heads == NULL ||
+      i_reacts == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->instancesCount == FSM_POOL_ROUTE_NONE)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_RC_t res = route_list_reacts(io_this->config, i_reacts, i_reactsSize);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  io_this->routeNext = i_next;
+  io_this->routePrev = i_prev;
+  io_this->routeHeads = i_heads;
+  io_this->routeReacts = i_reacts;
+  route_sort(io_this);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_pool_broadcast(fsm_pool_t *const io_this, fsm_event_t i_event, uint32_t *const o_processed)
+{
+  if (o_processed != NULL)
+  {
+    *o_processed = 0;
+  }
+  if (io_this == NULL || io_this->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Without routing index, sweep all instances */
+  if (io_this->routeHeads == NULL)
+  {
+    for (uint32_t i = 0; i < io_this->instancesCount; i++)
+    {
+      fsm_RC_t res = process_instance(io_this, i, i_event);
+      if (res != FSM_RC_OK)
+      {
+        return res;
+      }
+      if (o_processed != NULL)
+      {
+        *o_processed = i + 1u;
+      }
+    }
+    return FSM_RC_OK;
+  }
+
+  /* Detach the buckets of the reacting states and the first run bucket, */
+  /* so every instance is processed once, whatever bucket it moves to */
+  const fsm_cfg_t *cfg = io_this->config;
+  const uint32_t *reacts = io_this->routeReacts;
+  const uint32_t eventEnumCount = fsm_event_enum_count(cfg);
+  uint32_t list = ((uint32_t)i_event < eventEnumCount) ? (uint32_t)i_event : eventEnumCount;
+  uint32_t pending = FSM_POOL_ROUTE_NONE;
+  for (uint32_t i = reacts[list]; i < reacts[list + 1u]; i++)
+  {
+    /* The events out of range share a list, only their own transitions count */
+    uint32_t state = reacts[i];
+    if (list != eventEnumCount || route_reacts(&cfg->states[state], i_event) == true)
+    {
+      route_splice(io_this, &pending, &io_this->routeHeads[state]);
+    }
+  }
+  for (uint32_t i = reacts[eventEnumCount + 1u]; i < reacts[eventEnumCount + 2u]; i++)
+  {
+    route_splice(io_this, &pending, &io_this->routeHeads[reacts[i]]);
+  }
+  route_splice(io_this, &pending, &io_this->routeHeads[cfg->statesCount]);
+
+  fsm_RC_t res = FSM_RC_OK;
+  uint32_t processed = 0;
+  while (pending != FSM_POOL_ROUTE_NONE)
+  {
+    uint32_t instance = pending;
+    route_unlink(io_this, &pending, instance);
+    if (res == FSM_RC_OK)
+    {
+      res = process_instance(io_this, instance, i_event);
+      processed += (res == FSM_RC_OK) ? 1u : 0u;
+    }
+
+    /* Sort back, also the unprocessed rest after an error */
+    route_link(io_this, &io_this->routeHeads[route_bucket(io_this, instance)], instance);
+  }
+  if (o_processed != NULL)
+  {
+    *o_processed = processed;
+  }
+  return res;
+}
+
+/******************************************************************************/
+/*** Internal function implementation                                         */
+/******************************************************************************/
+fsm_RC_t fsm_pool_prepare_config(const fsm_cfg_t *const i_config, fsm_index_t *const o_initialIndex)
+{
+  fsm_RC_t res = fsm_cfg_prepare(i_config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  if (i_config->statesCount >= FSM_INDEX_NONE)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* The instances have no storage for the states of sub configurations and regions */
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    if (stateCfg->subCfg != NULL || stateCfg->regions != NULL)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    /* Nor timers, a timed transition would never fire */
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      if (stateCfg->transitions[t].after != 0 || stateCfg->transitions[t].every != 0)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+    }
+  }
+
+  const fsm_state_cfg_t *initialStateCfg = fsm_get_state_cfg(i_config, i_config->initialState);
+  if (initialStateCfg == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+  *o_initialIndex = (fsm_index_t)(initialStateCfg - i_config->states);
+  return FSM_RC_OK;
+}
+
+void fsm_pool_route_sort(struct fsm_pool *const io_this)
+{
+  route_sort(io_this);
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static fsm_RC_t process_instance(fsm_pool_t *const io_this, uint32_t i_instance, fsm_event_t i_event)
+{
+  const fsm_cfg_t *cfg = io_this->config;
+  const fsm_state_cfg_t *currStateCfg = &cfg->states[io_this->stateIndex[i_instance]];
+  uint32_t *firstRunWord = &io_this->firstRunBits[i_instance / 32u];
+  uint32_t firstRunMask = 1u << (i_instance % 32u);
+  bool isFirstRun = (*firstRunWord & firstRunMask) != 0;
+  FSM_TRACE_INSTANCE(i_instance);
+
+  const fsm_state_cfg_t *nextStateCfg = NULL;
+  fsm_RC_t res = fsm_run_state(cfg, currStateCfg, &isFirstRun, i_event, NULL, &nextStateCfg, NULL, 0, NULL);
+  if (isFirstRun == false)
+  {
+    *firstRunWord &= ~firstRunMask;
+  }
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  /* Save the state change (if happened) */
+  io_this->stateIndex[i_instance] = (fsm_index_t)(nextStateCfg - cfg->states);
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t process_routed(fsm_pool_t *const io_this, uint32_t i_instance, fsm_event_t i_event)
+{
+  if (io_this->routeHeads == NULL)
+  {
+    return process_instance(io_this, i_instance, i_event);
+  }
+
+  uint32_t bucket = route_bucket(io_this, i_instance);
+  fsm_RC_t res = process_instance(io_this, i_instance, i_event);
+  uint32_t nextBucket = route_bucket(io_this, i_instance);
+  if (nextBucket != bucket)
+  {
+    route_unlink(io_this, &io_this->routeHeads[bucket], i_instance);
+    route_link(io_this, &io_this->routeHeads[nextBucket], i_instance);
+  }
+  return res;
+}
+
+static uint32_t route_bucket(const fsm_pool_t *const i_this, uint32_t i_instance)
+{
+  if ((i_this->firstRunBits[i_instance / 32u] & (1u << (i_instance % 32u))) != 0)
+  {
+    return i_this->config->statesCount;
+  }
+  return i_this->stateIndex[i_instance];
+}
+
+static void route_sort(fsm_pool_t *const io_this)
+{
+  for (uint32_t i = 0; i < FSM_POOL_ROUTE_BUCKETS(io_this->config->statesCount); i++)
+  {
+    io_this->routeHeads[i] = FSM_POOL_ROUTE_NONE;
+  }
+  for (uint32_t i = 0; i < io_this->instancesCount; i++)
+  {
+    route_link(io_this, &io_this->routeHeads[route_bucket(io_this, i)], i);
+  }
+}
+
+static void route_link(fsm_pool_t *const io_this, uint32_t *const io_head, uint32_t i_instance)
+{
+  uint32_t *next = io_this->routeNext;
+  uint32_t *prev = io_this->routePrev;
+  if (*io_head == FSM_POOL_ROUTE_NONE)
+  {
+    next[i_instance] = i_instance;
+    prev[i_instance] = i_instance;
+    *io_head = i_instance;
+    return;
+  }
+
+  /* Insert before the head, at the end of the list */
+  uint32_t head = *io_head;
+  uint32_t tail = prev[head];
+  next[tail] = i_instance;
+  prev[i_instance] = tail;
+  next[i_instance] = head;
+  prev[head] = i_instance;
+}
+
+static void route_unlink(fsm_pool_t *const io_this, uint32_t *const io_head, uint32_t i_instance)
+{
+  uint32_t *next = io_this->routeNext;
+  uint32_t *prev = io_this->routePrev;
+  if (next[i_instance] == i_instance)
+  {
+    *io_head = FSM_POOL_ROUTE_NONE;
+    return;
+  }
+
+  next[prev[i_instance]] = next[i_instance];
+  prev[next[i_instance]] = prev[i_instance];
+  if (*io_head == i_instance)
+  {
+    *io_head = next[i_instance];
+  }
+}
+
+static void route_splice(fsm_pool_t *const io_this, uint32_t *const io_head, uint32_t *const io_other)
+{
+  uint32_t *next = io_this->routeNext;
+  uint32_t *prev = io_this->routePrev;
+  uint32_t other = *io_other;
+  if (other == FSM_POOL_ROUTE_NONE)
+  {
+    return;
+  }
+  *io_other = FSM_POOL_ROUTE_NONE;
+  if (*io_head == FSM_POOL_ROUTE_NONE)
+  {
+    *io_head = other;
+    return;
+  }
+
+  /* Join the two rings: tail of the list -> other head, other tail -> head */
+  uint32_t head = *io_head;
+  uint32_t tail = prev[head];
+  uint32_t otherTail = prev[other];
+  next[tail] = other;
+  prev[other] = tail;
+  next[otherTail] = head;
+  prev[head] = otherTail;
+}
+
+static fsm_RC_t route_list_reacts(const fsm_cfg_t *const i_config, uint32_t *const o_reacts, uint32_t i_reactsSize)
+{
+  /* Offsets of the events, the events out of range and the states reacting to every event, plus the end */
+  const uint32_t eventEnumCount = fsm_event_enum_count(i_config);
+  const uint64_t offsetsCount = (uint64_t)eventEnumCount + 3u;
+  if (i_reactsSize < offsetsCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Count the entries per list, shifted by one */
+  for (uint32_t i = 0; i < (uint32_t)offsetsCount; i++)
+  {
+    o_reacts[i] = 0;
+  }
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      if (route_is_first(stateCfg, eventEnumCount, t) == true)
+      {
+        o_reacts[route_list(stateCfg, eventEnumCount, t) + 1u]++;
+      }
+    }
+  }
+
+  /* Start of every list, the entries follow the offsets */
+  o_reacts[0] = (uint32_t)offsetsCount;
+  for (uint32_t i = 1; i < (uint32_t)offsetsCount; i++)
+  {
+    if ((uint64_t)o_reacts[i] + o_reacts[i - 1u] > i_reactsSize)
+    {
+      return FSM_RC_ERROR_INVALID_ARG;
+    }
+    o_reacts[i] += o_reacts[i - 1u];
+  }
+
+  /* Fill in state order, the start of a list moves to its end meanwhile */
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      if (route_is_first(stateCfg, eventEnumCount, t) == true)
+      {
+        o_reacts[o_reacts[route_list(stateCfg, eventEnumCount, t)]++] = i;
+      }
+    }
+  }
+  for (uint32_t i = eventEnumCount + 1u; i > 0; i--)
+  {
+    o_reacts[i] = o_reacts[i - 1u];
+  }
+  o_reacts[0] = (uint32_t)offsetsCount;
+  return FSM_RC_OK;
+}
+
+static uint32_t route_list(const fsm_state_cfg_t *const i_stateCfg,
+                           uint32_t i_eventEnumCount,
+                           uint32_t i_transition)
+{
+  if (fsm_action_is_set(&i_stateCfg->doAction) == true || i_stateCfg->subFsm != NULL || i_stateCfg->regions != NULL)
+  {
+    return i_eventEnumCount + 1u;
+  }
+  uint32_t event = (uint32_t)i_stateCfg->transitions[i_transition].event;
+  return (event < i_eventEnumCount) ? event : i_eventEnumCount;
+}
+
+static bool route_is_first(const fsm_state_cfg_t *const i_stateCfg,
+                           uint32_t i_eventEnumCount,
+                           uint32_t i_transition)
+{
+  uint32_t list = route_list(i_stateCfg, i_eventEnumCount, i_transition);
+  if (list == i_eventEnumCount + 1u)
+  {
+    return i_transition == 0;
+  }
+  for (uint32_t i = 0; i < i_transition; i++)
+  {
+    if (route_list(i_stateCfg, i_eventEnumCount, i) == list)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool route_reacts(const fsm_state_cfg_t *const i_stateCfg, fsm_event_t i_event)
+{
+  if (fsm_action_is_set(&i_stateCfg->doAction) == true || i_stateCfg->subFsm != NULL || i_stateCfg->regions != NULL)
+  {
+    return true;
+  }
+
+  /* Superset of the dispatch tables, they are built from the same transitions */
+  for (uint32_t i = 0; i < i_stateCfg->transitionsCount; i++)
+  {
+    if (i_stateCfg->transitions[i].event == i_event)
+    {
+      return true;
+    }
+  }
+  return false;
+}
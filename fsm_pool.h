@@ -0,0 +1,214 @@
+/**
+ * @file       fsm_pool.h
+ * @brief      Pool of FSM instances sharing one configuration
+ *
+ *             Stores the instances as struct of arrays: one state index per
+ *             instance plus a bitset of first run flags. Storage is provided by
+ *             the caller, see FSM_POOL_FIRST_RUN_WORDS.
+ *             Sub fsms linked in the configuration are shared by all instances,
+ *             sub configurations (subCfg), regions and timed transitions are
+ *             not supported. Pool instances take no modules (timers, recorder,
+ *             hit counters), only the shared sub fsms do.
+ *             An optional routing index groups the instances by state and
+ *             lists the reacting states per event, so a broadcast only touches
+ *             the instances which react to the event.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_POOL_H_
+#define FSM_POOL_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Number of uint32_t words for the first run bitset of n instances
+ */
+#define FSM_POOL_FIRST_RUN_WORDS(n) (((n) + 31u) / 32u)
+
+/**
+ * @brief Number of route buckets of a configuration with n states
+ *
+ * One bucket per state index plus one for the instances in their first run.
+ */
+#define FSM_POOL_ROUTE_BUCKETS(n) ((n) + 1u)
+
+#define FSM_POOL_ROUTE_NONE UINT32_MAX /**< Marks an empty route bucket */
+
+/**
+ * @brief Number of words listing the reacting states of a configuration with
+ *        t transitions in total
+ */
+#define FSM_POOL_ROUTE_REACTS(t) FSM_POOL_ROUTE_REACTS_FOR((t), FSM_EVENT_COUNT)
+
+/**
+ * @brief Number of words listing the reacting states of a configuration with
+ *        its own event enum
+ *
+ * One offset per event, one for the events out of range and one for the
+ * states reacting to every event plus the end, at most one entry per
+ * transition.
+ */
+#define FSM_POOL_ROUTE_REACTS_FOR(t, eventEnumCount) ((uint32_t)(eventEnumCount) + 3u + (t))
+
+/**
+ * @brief Pool Struct
+ *
+ * Represents instancesCount instances of one FSM configuration.
+ */
+typedef struct fsm_pool
+{
+  const fsm_cfg_t *config;  /**< Pointer to the shared FSM configuration */
+  fsm_index_t *stateIndex;  /**< Current state per instance as index in the states array */
+  uint32_t *firstRunBits;   /**< First run flag per instance, bit i of word i / 32 */
+  uint32_t instancesCount;  /**< Number of instances in the pool */
+  fsm_index_t initialIndex; /**< Index of the initial state in the states array */
+  uint32_t *routeNext;      /**< [optional] Next instance in the same route bucket, circular */
+  uint32_t *routePrev;      /**< [optional] Previous instance in the same route bucket, circular */
+  uint32_t *routeHeads;     /**< [optional] First instance per route bucket, FSM_POOL_ROUTE_NONE if empty */
+  uint32_t *routeReacts;    /**< [optional] Reacting states per event, see FSM_POOL_ROUTE_REACTS */
+} fsm_pool_t;
+
+/**
+ * @brief Event addressed to one instance, used for batched processing
+ */
+typedef struct
+{
+  uint32_t instance; /**< Index of the instance in the pool */
+  fsm_event_t event; /**< The event to process */
+} fsm_pool_event_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize the pool and reset all instances
+ *
+ * @param io_this Pointer to the pool to initialize
+ * @param i_config Pointer to the FSM configuration shared by all instances
+ * @param i_stateIndex Storage for instancesCount state indices
+ * @param i_firstRunBits Storage for FSM_POOL_FIRST_RUN_WORDS(instancesCount) words
+ * @param i_instancesCount Number of instances
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG for configurations
+ *         with sub configurations, regions or timed transitions, error code
+ *         otherwise
+ */
+fsm_RC_t fsm_pool_init(fsm_pool_t *const io_this,
+                       const fsm_cfg_t *const i_config,
+                       fsm_index_t *const i_stateIndex,
+                       uint32_t *const i_firstRunBits,
+                       uint32_t i_instancesCount);
+
+/**
+ * @brief Reset one instance to its initial state
+ *
+ * @param io_this Pointer to the pool
+ * @param i_instance Index of the instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_pool_reset(fsm_pool_t *const io_this, uint32_t i_instance);
+
+/**
+ * @brief Process an event in one instance, same semantics as fsm_process
+ *
+ * @param io_this Pointer to the pool
+ * @param i_instance Index of the instance
+ * @param i_event The event to process
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_pool_process(fsm_pool_t *const io_this, uint32_t i_instance, fsm_event_t i_event);
+
+/**
+ * @brief Process a batch of events, each addressed to one instance
+ *
+ * The events are processed in order. Processing stops at the first error.
+ *
+ * @param io_this Pointer to the pool
+ * @param i_events Array of (instance, event) pairs
+ * @param i_eventsCount Number of entries in the events array
+ * @param o_processed [optional] Number of successfully processed events
+ *
+ * @return FSM_RC_OK on success, error code of the failed event otherwise
+ */
+fsm_RC_t fsm_pool_process_batch(fsm_pool_t *const io_this,
+                                const fsm_pool_event_t *const i_events,
+                                size_t i_eventsCount,
+                                size_t *const o_processed);
+
+/**
+ * @brief Get the current state of one instance
+ *
+ * @param i_this Pointer to the pool
+ * @param i_instance Index of the instance
+ * @param o_state The current state
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_pool_get_state(const fsm_pool_t *const i_this, uint32_t i_instance, fsm_state_t *const o_state);
+
+/**
+ * @brief Attach the routing index for fsm_pool_broadcast
+ *
+ * Sorts the instances into one bucket per state, instances in their first run
+ * into a bucket of their own. The buckets are kept up to date on every state
+ * change by the pool functions and fsm_pool_restore. Call again after the
+ * instances were written otherwise. Lists the states reacting to each event
+ * once, they only depend on the configuration.
+ *
+ * @param io_this Pointer to the initialized pool
+ * @param i_next Storage for instancesCount links
+ * @param i_prev Storage for instancesCount links
+ * @param i_heads Storage for FSM_POOL_ROUTE_BUCKETS(statesCount) heads
+ * @param i_reacts Storage for FSM_POOL_ROUTE_REACTS(transitionsCount) words,
+ *                 FSM_POOL_ROUTE_REACTS_FOR for a machine with its own event
+ *                 enum
+ * @param i_reactsSize Number of words in the storage
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the storage for
+ *         the reacting states is too small, error code otherwise
+ */
+fsm_RC_t fsm_pool_route(fsm_pool_t *const io_this,
+                        uint32_t *const i_next,
+                        uint32_t *const i_prev,
+                        uint32_t *const i_heads,
+                        uint32_t *const i_reacts,
+                        uint32_t i_reactsSize);
+
+/**
+ * @brief Process an event in every instance of the pool which reacts to it
+ *
+ * Same result as fsm_pool_process on every instance, but with the routing
+ * index only the instances are processed whose state has a transition for
+ * the event, a do action or a sub fsm, or which are in their first run. The
+ * work is proportional to the number of these instances and the number of
+ * reacting states, the other states are not visited. The other instances
+ * would not run any action, they are skipped (and not traced). Without the
+ * routing index every instance is processed. The instances are processed in
+ * no particular order, actions must not process events in the same pool.
+ * Processing stops at the first error.
+ *
+ * @param io_this Pointer to the pool
+ * @param i_event The event to process
+ * @param o_processed [optional] Number of successfully processed instances
+ *
+ * @return FSM_RC_OK on success, error code of the failed instance otherwise
+ */
+fsm_RC_t fsm_pool_broadcast(fsm_pool_t *const io_this, fsm_event_t i_event, uint32_t *const o_processed);
+
+#endif /* FSM_POOL_H_ */
@@ -0,0 +1,493 @@
+/**
+ * @file       fsm_prof.c
+ * @brief      Optional action and guard profiler with folded stack export
+ *
+ *             The call tree of a thread is an array of nodes in insertion
+ *             order plus an open addressing hash index over
+ *             (parent, machine, state, slot). Lookups happen outside the
+ *             measured window. The names are shared, see fsm_prof.h.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include "fsm_prof.h" /* Own header */
+
+#if FSM_PROF
+
+#include <time.h> /* for clock_gettime */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#ifndef FSM_PROF_TIMESTAMP
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FSM_PROF_TIMESTAMP() __builtin_ia32_rdtsc() /**< Cycle counter */
+#else
+#define FSM_PROF_TIMESTAMP() monotonic_ns() /**< Portable fallback */
+#endif
+#endif
+
+#define PROF_INDEX_SIZE (2u * FSM_PROF_MAX_NODES) /**< Hash index slots, at most half used */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Open run frame
+ */
+typedef struct
+{
+  uint32_t node;  /**< Node of the frame, FSM_PROF_NONE if dropped */
+  uint64_t start; /**< Timestamp at the start of the run */
+} prof_frame_t;
+
+/**
+ * @brief Call tree of one thread
+ */
+typedef struct
+{
+  fsm_prof_node_t nodes[FSM_PROF_MAX_NODES]; /**< The nodes, in insertion order */
+  uint32_t nodesCount;                       /**< Number of nodes */
+  uint32_t index[PROF_INDEX_SIZE];           /**< Node + 1 per hash slot, 0 if empty */
+  prof_frame_t frames[FSM_PROF_MAX_DEPTH];   /**< Open run frames */
+  uint32_t depth;                            /**< Number of open run frames, may exceed FSM_PROF_MAX_DEPTH */
+  uint64_t dropped;                          /**< Measurements without a free node */
+} prof_tree_t;
+
+/**
+ * @brief Names of one machine
+ */
+typedef struct
+{
+  const fsm_cfg_t *config;       /**< The machine */
+  const char *name;              /**< Name of the machine */
+  const char *const *stateNames; /**< [optional] Names indexed by the state enum */
+  uint32_t stateNamesCount;      /**< Number of state names */
+} prof_names_t;
+
+/**
+ * @brief Output position of fsm_prof_write_folded
+ */
+typedef struct
+{
+  char *buffer;  /**< The buffer */
+  size_t size;   /**< Size of the buffer */
+  size_t length; /**< Length of the complete output */
+} prof_writer_t;
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Get the node of a call, inserted if new
+ *
+ * @param i_parent Index of the parent node, FSM_PROF_NONE for a root
+ * @param i_config The machine
+ * @param i_state The state
+ * @param i_slot The slot
+ *
+ * @return Index of the node, FSM_PROF_NONE if the tree is full
+ */
+static uint32_t get_node(uint32_t i_parent, const fsm_cfg_t *const i_config, fsm_state_t i_state, fsm_prof_slot_t i_slot);
+
+/**
+ * @brief Add a measurement to a node
+ *
+ * @param io_node The node
+ * @param i_duration The duration
+ */
+static void add_sample(fsm_prof_node_t *const io_node, uint64_t i_duration);
+
+/**
+ * @brief Get the innermost open run frame node
+ *
+ * @return Index of the node, FSM_PROF_NONE outside of a run
+ */
+static uint32_t current_node(void);
+
+/**
+ * @brief Get the names of a machine
+ *
+ * @param i_config The machine
+ *
+ * @return The names, null if unnamed
+ */
+static const prof_names_t *find_names(const fsm_cfg_t *const i_config);
+
+/**
+ * @brief Write the label of a node
+ *
+ * @param io_writer The output
+ * @param i_node The node
+ */
+static void write_label(prof_writer_t *const io_writer, const fsm_prof_node_t *const i_node);
+
+/**
+ * @brief Write the name of a state
+ *
+ * @param io_writer The output
+ * @param i_names [optional] Names of the machine
+ * @param i_state The state
+ */
+static void write_state(prof_writer_t *const io_writer, const prof_names_t *const i_names, fsm_state_t i_state);
+
+/**
+ * @brief Append a string to the output
+ *
+ * @param io_writer The output
+ * @param i_string The string
+ */
+static void write_string(prof_writer_t *const io_writer, const char *i_string);
+
+/**
+ * @brief Append a number to the output
+ *
+ * @param io_writer The output
+ * @param i_value The number
+ * @param i_base 10 or 16
+ */
+static void write_number(prof_writer_t *const io_writer, uint64_t i_value, uint32_t i_base);
+
+/**
+ * @brief Monotonic time in ns
+ *
+ * @return The current time
+ */
+static inline uint64_t monotonic_ns(void);
+
+/******************************************************************************/
+/*** Private static variables                                                 */
+/******************************************************************************/
+static _Thread_local prof_tree_t tree;         /**< Call tree of the thread */
+static prof_names_t names[FSM_PROF_MAX_NAMES]; /**< Named machines */
+static uint32_t namesCount;                    /**< Number of named machines */
+
+/** Labels per fsm_prof_slot_t */
+static const char *const slotNames[] = {"run", "entry", "do", "exit", "transition", "guard"};
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_prof_set_names(const fsm_cfg_t *const i_config,
+                            const char *const i_name,
+                            const char *const *const i_stateNames,
+                            uint32_t i_stateNamesCount)
+{
+  if (i_config == NULL || i_name == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  prof_names_t *entry = (prof_names_t *)find_names(i_config);
+  if (entry == NULL)
+  {
+    if (namesCount >= FSM_PROF_MAX_NAMES)
+    {
+      return FSM_RC_ERROR;
+    }
+    entry = &names[namesCount++];
+  }
+  entry->config = i_config;
+  entry->name = i_name;
+  entry->stateNames = i_stateNames;
+  entry->stateNamesCount = (i_stateNames != NULL) ? i_stateNamesCount : 0;
+  return FSM_RC_OK;
+}
+
+size_t fsm_prof_copy_nodes(fsm_prof_node_t *const o_nodes, size_t i_maxNodes)
+{
+  if (o_nodes == NULL)
+  {
+    return 0;
+  }
+
+  size_t count = tree.nodesCount;
+  if (count > i_maxNodes)
+  {
+    count = i_maxNodes;
+  }
+  for (size_t i = 0; i < count; i++)
+  {
+    o_nodes[i] = tree.nodes[i];
+  }
+  return count;
+}
+
+uint64_t fsm_prof_dropped(void)
+{
+  return tree.dropped;
+}
+
+void fsm_prof_reset(void)
+{
+  for (uint32_t i = 0; i < PROF_INDEX_SIZE; i++)
+  {
+    tree.index[i] = 0;
+  }
+  tree.nodesCount = 0;
+  tree.depth = 0;
+  tree.dropped = 0;
+}
+
+size_t fsm_prof_write_folded(char *const o_buffer, size_t i_size)
+{
+  prof_writer_t writer = {o_buffer, (o_buffer != NULL) ? i_size : 0, 0};
+
+  for (uint32_t i = 0; i < tree.nodesCount; i++)
+  {
+    const fsm_prof_node_t *node = &tree.nodes[i];
+
+    /* Self time: total minus the children, they follow their parent */
+    uint64_t children = 0;
+    for (uint32_t c = i + 1u; c < tree.nodesCount; c++)
+    {
+      if (tree.nodes[c].parent == i)
+      {
+        children += tree.nodes[c].total;
+      }
+    }
+    uint64_t self = (node->total > children) ? node->total - children : 0;
+
+    /* Path from the root, bounded by the frame nesting */
+    uint32_t path[FSM_PROF_MAX_DEPTH + 1u];
+    uint32_t pathLength = 0;
+    for (uint32_t n = i; n != FSM_PROF_NONE && pathLength <= FSM_PROF_MAX_DEPTH; n = tree.nodes[n].parent)
+    {
+      path[pathLength++] = n;
+    }
+    while (pathLength > 0)
+    {
+      write_label(&writer, &tree.nodes[path[--pathLength]]);
+      write_string(&writer, (pathLength > 0) ? ";" : " ");
+    }
+    write_number(&writer, self, 10);
+    write_string(&writer, "\n");
+  }
+
+  if (writer.size > 0)
+  {
+    writer.buffer[(writer.length < writer.size) ? writer.length : writer.size - 1u] = '\0';
+  }
+  return writer.length;
+}
+
+/******************************************************************************/
+/*** Hook implementation                                                      */
+/******************************************************************************/
+void fsm_prof_enter(const fsm_cfg_t *const i_config, fsm_state_t i_state)
+{
+  uint32_t parent = current_node();
+  uint32_t depth = tree.depth++;
+  if (depth >= FSM_PROF_MAX_DEPTH)
+  {
+    return;
+  }
+  prof_frame_t *frame = &tree.frames[depth];
+  frame->node = get_node(parent, i_config, i_state, FSM_PROF_RUN);
+  frame->start = FSM_PROF_TIMESTAMP();
+}
+
+void fsm_prof_leave(void)
+{
+  uint64_t end = FSM_PROF_TIMESTAMP();
+  if (tree.depth == 0)
+  {
+    return;
+  }
+  uint32_t depth = --tree.depth;
+  if (depth >= FSM_PROF_MAX_DEPTH)
+  {
+    return;
+  }
+  const prof_frame_t *frame = &tree.frames[depth];
+  if (frame->node != FSM_PROF_NONE)
+  {
+    add_sample(&tree.nodes[frame->node], end - frame->start);
+  }
+}
+
+uint64_t fsm_prof_now(void)
+{
+  return FSM_PROF_TIMESTAMP();
+}
+
+void fsm_prof_record(fsm_state_t i_state, fsm_prof_slot_t i_slot, uint64_t i_start)
+{
+  uint64_t end = FSM_PROF_TIMESTAMP();
+  uint32_t parent = current_node();
+  if (parent == FSM_PROF_NONE)
+  {
+    tree.dropped++;
+    return;
+  }
+  uint32_t node = get_node(parent, tree.nodes[parent].config, i_state, i_slot);
+  if (node != FSM_PROF_NONE)
+  {
+    add_sample(&tree.nodes[node], end - i_start);
+  }
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static uint32_t get_node(uint32_t i_parent, const fsm_cfg_t *const i_config, fsm_state_t i_state, fsm_prof_slot_t i_slot)
+{
+  uint64_t hash = (uint64_t)(uintptr_t)i_config;
+  hash = (hash ^ i_parent) * 0x9E3779B97F4A7C15ull;
+  hash = (hash ^ (((uint64_t)(uint32_t)i_state << 8) | (uint64_t)i_slot)) * 0x9E3779B97F4A7C15ull;
+
+  for (uint32_t slot = (uint32_t)(hash >> 32) & (PROF_INDEX_SIZE - 1u);; slot = (slot + 1u) & (PROF_INDEX_SIZE - 1u))
+  {
+    uint32_t entry = tree.index[slot];
+    if (entry == 0)
+    {
+      /* New node */
+      if (tree.nodesCount >= FSM_PROF_MAX_NODES)
+      {
+        tree.dropped++;
+        return FSM_PROF_NONE;
+      }
+      uint32_t node = tree.nodesCount++;
+      fsm_prof_node_t *newNode = &tree.nodes[node];
+      *newNode = (fsm_prof_node_t){0};
+      newNode->parent = i_parent;
+      newNode->config = i_config;
+      newNode->state = i_state;
+      newNode->slot = i_slot;
+      newNode->min = UINT64_MAX;
+      tree.index[slot] = node + 1u;
+      return node;
+    }
+
+    const fsm_prof_node_t *node = &tree.nodes[entry - 1u];
+    if (node->parent == i_parent && node->config == i_config && node->state == i_state && node->slot == i_slot)
+    {
+      return entry - 1u;
+    }
+  }
+}
+
+static void add_sample(fsm_prof_node_t *const io_node, uint64_t i_duration)
+{
+  io_node->count++;
+  io_node->total += i_duration;
+  if (i_duration < io_node->min)
+  {
+    io_node->min = i_duration;
+  }
+  if (i_duration > io_node->max)
+  {
+    io_node->max = i_duration;
+  }
+
+  /* Bucket by bit length */
+  uint32_t bucket = 0;
+  while (i_duration != 0 && bucket < FSM_PROF_HIST_BUCKETS - 1u)
+  {
+    i_duration >>= 1;
+    bucket++;
+  }
+  io_node->histogram[bucket]++;
+}
+
+static uint32_t current_node(void)
+{
+  if (tree.depth == 0)
+  {
+    return FSM_PROF_NONE;
+  }
+  uint32_t depth = (tree.depth <= FSM_PROF_MAX_DEPTH) ? tree.depth : FSM_PROF_MAX_DEPTH;
+  return tree.frames[depth - 1u].node;
+}
+
+static const prof_names_t *find_names(const fsm_cfg_t *const i_config)
+{
+  for (uint32_t i = 0; i < namesCount; i++)
+  {
+    if (names[i].config == i_config)
+    {
+      return &names[i];
+    }
+  }
+  return NULL;
+}
+
+static void write_label(prof_writer_t *const io_writer, const fsm_prof_node_t *const i_node)
+{
+  const prof_names_t *machine = find_names(i_node->config);
+  if (i_node->slot == FSM_PROF_RUN)
+  {
+    /* machine:state */
+    if (machine != NULL)
+    {
+      write_string(io_writer, machine->name);
+    }
+    else
+    {
+      write_string(io_writer, "cfg_");
+      write_number(io_writer, (uint64_t)(uintptr_t)i_node->config, 16);
+    }
+    write_string(io_writer, ":");
+    write_state(io_writer, machine, i_node->state);
+    return;
+  }
+
+  /* state.slot */
+  write_state(io_writer, machine, i_node->state);
+  write_string(io_writer, ".");
+  write_string(io_writer, slotNames[i_node->slot]);
+}
+
+static void write_state(prof_writer_t *const io_writer, const prof_names_t *const i_names, fsm_state_t i_state)
+{
+  if (i_names != NULL && (uint32_t)i_state < i_names->stateNamesCount && i_names->stateNames[i_state] != NULL)
+  {
+    write_string(io_writer, i_names->stateNames[i_state]);
+    return;
+  }
+  write_number(io_writer, (uint64_t)(uint32_t)i_state, 10);
+}
+
+static void write_string(prof_writer_t *const io_writer, const char *i_string)
+{
+  for (; *i_string != '\0'; i_string++)
+  {
+    if (io_writer->length + 1u < io_writer->size)
+    {
+      io_writer->buffer[io_writer->length] = *i_string;
+    }
+    io_writer->length++;
+  }
+}
+
+static void write_number(prof_writer_t *const io_writer, uint64_t i_value, uint32_t i_base)
+{
+  char digits[21];
+  size_t pos = sizeof(digits) - 1u;
+  digits[pos] = '\0';
+  do
+  {
+    digits[--pos] = "0123456789abcdef"[i_value % i_base];
+    i_value /= i_base;
+  } while (i_value != 0);
+  write_string(io_writer, &digits[pos]);
+}
+
+static inline uint64_t monotonic_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif /* FSM_PROF */
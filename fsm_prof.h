@@ -0,0 +1,219 @@
+/**
+ * @file       fsm_prof.h
+ * @brief      Optional action and guard profiler with folded stack export
+ *
+ *             Compiled in with -DFSM_PROF=1, otherwise all hooks expand to
+ *             the plain calls. When enabled every action and guard run by
+ *             fsm_run_state (fsm_process, pools, executor) is timed and
+ *             attributed to (machine, state, slot), and every run of a
+ *             machine on an event is timed as a frame around them. A sub fsm
+ *             or sub configuration processed during a run becomes a child
+ *             frame, so the profile is a call tree:
+ *               main:MAIN_SUB                  run of the machine
+ *                 MAIN_SUB.do                  action of the machine
+ *                 sub:SUB_1                    run of the nested machine
+ *                   SUB_1.transition           action of the nested machine
+ *             The self time of a run frame is the time spent in the library.
+ *             Every node aggregates count, total, min, max and a log2
+ *             histogram of the durations. fsm_prof_write_folded exports the
+ *             tree as folded stacks, one line per node with its self time,
+ *             ready for flame graph tools (e.g. flamegraph.pl).
+ *             The tree is thread local and only written and read by its own
+ *             thread. Actions of the configuration images, the flattened
+ *             machines and the generated dispatchers are not profiled.
+ *             Requires C11 when enabled.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_PROF_H_
+#define FSM_PROF_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Configuration                                                            */
+/******************************************************************************/
+#ifndef FSM_PROF
+#define FSM_PROF 0 /**< Profiling compiled out by default */
+#endif
+
+#ifndef FSM_PROF_MAX_NODES
+#define FSM_PROF_MAX_NODES 256u /**< Nodes of the call tree per thread, power of 2 */
+#endif
+
+#ifndef FSM_PROF_MAX_DEPTH
+#define FSM_PROF_MAX_DEPTH 16u /**< Nesting of run frames, deeper runs count to their parent */
+#endif
+
+#ifndef FSM_PROF_MAX_NAMES
+#define FSM_PROF_MAX_NAMES 16u /**< Named machines */
+#endif
+
+#define FSM_PROF_HIST_BUCKETS 32u /**< Bucket b counts durations of bit length b, the last one the rest */
+#define FSM_PROF_NONE UINT32_MAX  /**< No parent node */
+
+/**
+ * @brief Measured Slot
+ */
+typedef enum
+{
+  FSM_PROF_RUN,        /**< Run of a machine on an event, frame of the other slots */
+  FSM_PROF_ENTRY,      /**< Entry action */
+  FSM_PROF_DO,         /**< Do action */
+  FSM_PROF_EXIT,       /**< Exit action */
+  FSM_PROF_TRANSITION, /**< Transition action */
+  FSM_PROF_GUARD,      /**< Guard */
+} fsm_prof_slot_t;
+
+#if FSM_PROF
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Node of the call tree
+ */
+typedef struct
+{
+  uint32_t parent;                           /**< Index of the run frame, FSM_PROF_NONE for a root */
+  const fsm_cfg_t *config;                   /**< The machine */
+  fsm_state_t state;                         /**< State of the run or of the action */
+  fsm_prof_slot_t slot;                      /**< What was measured */
+  uint64_t count;                            /**< Number of measurements */
+  uint64_t total;                            /**< Sum of the durations, see FSM_PROF_TIMESTAMP */
+  uint64_t min;                              /**< Shortest duration */
+  uint64_t max;                              /**< Longest duration */
+  uint32_t histogram[FSM_PROF_HIST_BUCKETS]; /**< Measurements per duration bucket */
+} fsm_prof_node_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Name a machine and its states for the folded stacks
+ *
+ * Unnamed machines are written as cfg_<address>, unnamed states as their enum
+ * value. Call before profiling, the names are shared by all threads.
+ *
+ * @param i_config The configuration
+ * @param i_name Name of the machine, must stay valid
+ * @param i_stateNames [optional] Names indexed by the state enum, must stay valid
+ * @param i_stateNamesCount Number of state names
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if FSM_PROF_MAX_NAMES machines are
+ *         named already, error code otherwise
+ */
+fsm_RC_t fsm_prof_set_names(const fsm_cfg_t *const i_config,
+                            const char *const i_name,
+                            const char *const *const i_stateNames,
+                            uint32_t i_stateNamesCount);
+
+/**
+ * @brief Copy the nodes of the calling thread
+ *
+ * The parent of a node has a lower index.
+ *
+ * @param o_nodes Array receiving the nodes
+ * @param i_maxNodes Size of the array
+ *
+ * @return Number of copied nodes
+ */
+size_t fsm_prof_copy_nodes(fsm_prof_node_t *const o_nodes, size_t i_maxNodes);
+
+/**
+ * @brief Number of measurements of the calling thread dropped, tree full
+ *
+ * @return The number of dropped measurements since the last reset
+ */
+uint64_t fsm_prof_dropped(void);
+
+/**
+ * @brief Clear the tree of the calling thread
+ *
+ * Must not be called from an action.
+ */
+void fsm_prof_reset(void);
+
+/**
+ * @brief Write the tree of the calling thread as folded stacks
+ *
+ * One line per node: the frames from the root separated by ';', a space and
+ * the self time (total minus the total of the children). Like snprintf the
+ * output is cut to the buffer and always terminated.
+ *
+ * @param o_buffer The buffer, may be null if i_size is 0
+ * @param i_size Size of the buffer
+ *
+ * @return Length of the complete output without terminator
+ */
+size_t fsm_prof_write_folded(char *const o_buffer, size_t i_size);
+
+/******************************************************************************/
+/*** Hooks, used by the FSM modules                                           */
+/******************************************************************************/
+
+/**
+ * @brief Open a run frame of a machine
+ *
+ * @param i_config The machine
+ * @param i_state The state processing the event
+ */
+void fsm_prof_enter(const fsm_cfg_t *const i_config, fsm_state_t i_state);
+
+/**
+ * @brief Close the innermost run frame
+ */
+void fsm_prof_leave(void);
+
+/**
+ * @brief Read the time stamp counter
+ *
+ * @return TSC on x86, monotonic ns otherwise, see FSM_PROF_TIMESTAMP
+ */
+uint64_t fsm_prof_now(void);
+
+/**
+ * @brief Record a measured call in the innermost run frame
+ *
+ * @param i_state State of the call
+ * @param i_slot The slot
+ * @param i_start Timestamp before the call
+ */
+void fsm_prof_record(fsm_state_t i_state, fsm_prof_slot_t i_slot, uint64_t i_start);
+
+#define FSM_PROF_ENTER(config, state) fsm_prof_enter((config), (state))
+#define FSM_PROF_LEAVE() fsm_prof_leave()
+#define FSM_PROF_CALL(state, slot, call)          \
+  do                                              \
+  {                                               \
+    uint64_t profStart_ = fsm_prof_now();         \
+    call;                                         \
+    fsm_prof_record((state), (slot), profStart_); \
+  } while (0)
+
+#else /* FSM_PROF */
+
+#define FSM_PROF_ENTER(config, state) ((void)0)
+#define FSM_PROF_LEAVE() ((void)0)
+#define FSM_PROF_CALL(state, slot, call) \
+  do                                     \
+  {                                      \
+    (void)(state);                       \
+    (void)(slot);                        \
+    call;                                \
+  } while (0)
+
+#endif /* FSM_PROF */
+
+#endif /* FSM_PROF_H_ */
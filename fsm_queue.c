@@ -0,0 +1,170 @@
+/**
+ * @file       fsm_queue.c
+ * @brief      Lock-free event queue for a FSM instance
+ *
+ *             Bounded multi-producer/single-consumer ring buffer. Every slot
+ *             carries a sequence number which tells producers and the consumer
+ *             whether the slot is free or filled for the current lap.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_queue.h"    /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <stdint.h> /* for intptr_t, SIZE_MAX */
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_queue_init(fsm_queue_t *const io_this,
+                        fsm_t *const i_fsm,
+                        fsm_queue_slot_t *const i_slots,
+                        size_t i_capacity)
+{
+  if (io_this == NULL || i_fsm == NULL || i_slots == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  /* Capacity must be a power of 2 */
+  if (i_capacity < 2 || (i_capacity & (i_capacity - 1)) != 0)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  io_this->fsm = i_fsm;
+  io_this->slots = i_slots;
+  io_this->mask = i_capacity - 1;
+  io_this->tail = 0;
+  atomic_init(&io_this->head, 0);
+  atomic_init(&io_this->overflows, 0);
+
+  /* Slot i is free for the producer of position i */
+  for (size_t i = 0; i < i_capacity; i++)
+  {
+    atomic_init(&i_slots[i].sequence, i);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_post(fsm_queue_t *const io_this, fsm_event_t i_event)
+{
+  if (io_this == NULL || io_this->slots == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  /* Claim a position */
+  fsm_queue_slot_t *slot = NULL;
+  size_t pos = atomic_load_explicit(&io_this->head, memory_order_relaxed);
+  for (;;)
+  {
+    slot = &io_this->slots[pos & io_this->mask];
+    size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+    if (diff == 0)
+    {
+      /* Slot free, try to take the position */
+      if (atomic_compare_exchange_weak_explicit(&io_this->head, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      /* Slot still filled from the previous lap, queue full */
+      atomic_fetch_add_explicit(&io_this->overflows, 1, memory_order_relaxed);
+      return FSM_RC_ERROR_QUEUE_FULL;
+    }
+    else
+    {
+      /* Another producer took the position, retry */
+      pos = atomic_load_explicit(&io_this->head, memory_order_relaxed);
+    }
+  }
+
+  /* Fill the slot and publish it to the consumer */
+  slot->event = i_event;
+  atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_dispatch_pending(fsm_queue_t *const io_this, size_t *const o_dispatched)
+{
+  if (o_dispatched != NULL)
+  {
+    *o_dispatched = 0;
+  }
+  if (io_this == NULL || io_this->slots == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  size_t dispatched = 0;
+  fsm_RC_t res = fsm_queue_dispatch(io_this, SIZE_MAX, &dispatched);
+  if (o_dispatched != NULL)
+  {
+    *o_dispatched = dispatched;
+  }
+  return res;
+}
+
+size_t fsm_queue_take_overflows(fsm_queue_t *const io_this)
+{
+  if (io_this == NULL)
+  {
+    return 0;
+  }
+  return atomic_exchange_explicit(&io_this->overflows, 0, memory_order_relaxed);
+}
+
+/******************************************************************************/
+/*** Internal function implementation                                         */
+/******************************************************************************/
+bool fsm_queue_pop(struct fsm_queue *const io_this, fsm_event_t *const o_event)
+{
+  size_t pos = io_this->tail;
+  fsm_queue_slot_t *slot = &io_this->slots[pos & io_this->mask];
+  size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+  if (sequence != pos + 1)
+  {
+    /* Not yet published, queue empty */
+    return false;
+  }
+
+  *o_event = slot->event;
+  /* Free the slot for the producer of the next lap */
+  atomic_store_explicit(&slot->sequence, pos + io_this->mask + 1, memory_order_release);
+  io_this->tail = pos + 1;
+  return true;
+}
+
+fsm_RC_t fsm_queue_dispatch(struct fsm_queue *const io_this, size_t i_max, size_t *const o_dispatched)
+{
+  *o_dispatched = 0;
+  fsm_event_t event;
+  while (*o_dispatched < i_max && fsm_queue_pop(io_this, &event) == true)
+  {
+    (*o_dispatched)++;
+    fsm_RC_t res = fsm_process(io_this->fsm, event);
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+bool fsm_queue_has_pending(struct fsm_queue *const i_this)
+{
+  size_t pos = i_this->tail;
+  const fsm_queue_slot_t *slot = &i_this->slots[pos & i_this->mask];
+  return atomic_load_explicit(&slot->sequence, memory_order_acquire) == pos + 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file       fsm_queue.h
+ * @brief      Lock-free event queue for a FSM instance
+ *
+ *             Bounded multi-producer/single-consumer ring buffer. Events are
+ *             posted from any thread with fsm_post and processed with run to
+ *             completion semantics on the owner thread with
+ *             fsm_dispatch_pending. The slots are provided by the caller, no
+ *             allocation takes place. Requires C11 atomics.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_QUEUE_H_
+#define FSM_QUEUE_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stdatomic.h> /* for atomics */
+#include <stddef.h>    /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_QUEUE_CACHE_LINE 64u /**< Separates producer and consumer data */
+
+/**
+ * @brief Queue Slot
+ */
+typedef struct
+{
+  atomic_size_t sequence; /**< Ticket telling whether the slot is free or filled */
+  fsm_event_t event;      /**< The posted event */
+} fsm_queue_slot_t;
+
+/**
+ * @brief Event Queue Struct
+ *
+ * Queue in front of one FSM instance. Producer and consumer positions live in
+ * separate cache lines.
+ */
+typedef struct fsm_queue
+{
+  fsm_t *fsm;                                        /**< The FSM instance the events are dispatched to */
+  fsm_queue_slot_t *slots;                           /**< Ring buffer storage, capacity is a power of 2 */
+  size_t mask;                                       /**< capacity - 1 */
+  atomic_size_t overflows;                           /**< Number of events dropped because the queue was full */
+  _Alignas(FSM_QUEUE_CACHE_LINE) atomic_size_t head; /**< Next position to post to */
+  _Alignas(FSM_QUEUE_CACHE_LINE) size_t tail;        /**< Next position to dispatch, owner thread only */
+} fsm_queue_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize an event queue for a FSM instance
+ *
+ * @param io_this Pointer to the queue to initialize
+ * @param i_fsm The initialized FSM instance the events are dispatched to
+ * @param i_slots Storage for the ring buffer
+ * @param i_capacity Number of slots, must be a power of 2 and at least 2
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_queue_init(fsm_queue_t *const io_this,
+                        fsm_t *const i_fsm,
+                        fsm_queue_slot_t *const i_slots,
+                        size_t i_capacity);
+
+/**
+ * @brief Post an event to the queue, callable from any thread
+ *
+ * Lock-free, never blocks. A full queue drops the event and counts it as
+ * overflow.
+ *
+ * @param io_this Pointer to the queue
+ * @param i_event The event to post
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_QUEUE_FULL if dropped
+ */
+fsm_RC_t fsm_post(fsm_queue_t *const io_this, fsm_event_t i_event);
+
+/**
+ * @brief Process all pending events, only from the owner thread
+ *
+ * Each event runs to completion in fsm_process before the next one is taken.
+ * Events posted meanwhile, also from actions, are processed in the same call.
+ * Processing stops at the first error, the failed event is consumed.
+ *
+ * @param io_this Pointer to the queue
+ * @param o_dispatched [optional] Number of events taken from the queue
+ *
+ * @return FSM_RC_OK on success, error code of the failed event otherwise
+ */
+fsm_RC_t fsm_dispatch_pending(fsm_queue_t *const io_this, size_t *const o_dispatched);
+
+/**
+ * @brief Get and reset the number of dropped events
+ *
+ * @param io_this Pointer to the queue
+ *
+ * @return Number of events dropped since the last call
+ */
+size_t fsm_queue_take_overflows(fsm_queue_t *const io_this);
+
+#endif /* FSM_QUEUE_H_ */
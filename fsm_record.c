@@ -0,0 +1,323 @@
+/**
+ * @file       fsm_record.c
+ * @brief      Event log recorder and replay
+ *
+ *             A record is only appended with room for FSM_RECORD_MAX_SIZE
+ *             bytes left, so encoding never checks sizes per varint. The
+ *             replay decodes with bounds checks and keeps the delta state in
+ *             registers.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include "fsm_record.h"   /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <string.h> /* for memcpy */
+#include <time.h>   /* for clock_gettime */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#ifndef FSM_RECORD_TIMESTAMP
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FSM_RECORD_TIMESTAMP() __builtin_ia32_rdtsc() /**< Cycle counter */
+#define FSM_RECORD_TICKS FSM_RECORD_TICKS_TSC         /**< Unit of the timestamps */
+#else
+#define FSM_RECORD_TIMESTAMP() monotonic_ns() /**< Portable fallback */
+#define FSM_RECORD_TICKS FSM_RECORD_TICKS_NS  /**< Unit of the timestamps */
+#endif
+#endif
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Encode an unsigned LEB128 varint
+ *
+ * @param o_pos Position to write to, room for 10 bytes
+ * @param i_value The value
+ *
+ * @return Position after the varint
+ */
+static uint8_t *put_varint(uint8_t *o_pos, uint64_t i_value);
+
+/**
+ * @brief Decode an unsigned LEB128 varint
+ *
+ * @param io_pos Position to read from, advanced
+ * @param i_end End of the data
+ * @param o_value The value
+ *
+ * @return true on success, false if truncated or longer than 64 bit
+ */
+static bool get_varint(const uint8_t **const io_pos, const uint8_t *const i_end, uint64_t *const o_value);
+
+/**
+ * @brief Monotonic time in ns
+ *
+ * @return The current time
+ */
+static inline uint64_t monotonic_ns(void);
+
+/**
+ * @brief Append a processed event to the log, hook operation processed
+ *
+ * @param io_hook The binding of the instance
+ * @param i_fsm The FSM instance after processing
+ * @param i_event The processed event
+ * @param i_res Result of processing the event
+ */
+static void record_event(fsm_hook_t *io_hook, const fsm_t *i_fsm, fsm_event_t i_event, fsm_RC_t i_res);
+
+/******************************************************************************/
+/*** Private static variables                                                 */
+/******************************************************************************/
+static const fsm_hook_ops_t recordOps = {.processed = record_event}; /**< Hook of the recorder */
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_recorder_init(fsm_recorder_t *const o_this,
+                           uint8_t *const i_buffer,
+                           size_t i_size,
+                           fsm_recorder_flush_t i_flush,
+                           void *i_flushArg)
+{
+  if (o_this == NULL || i_buffer == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_size < sizeof(fsm_record_header_t) + FSM_RECORD_MAX_SIZE)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_record_header_t header = {FSM_RECORD_MAGIC, FSM_RECORD_VERSION, FSM_RECORD_TICKS};
+  memcpy(i_buffer, &header, sizeof(header));
+  o_this->buffer = i_buffer;
+  o_this->size = i_size;
+  o_this->used = sizeof(header);
+  o_this->flush = i_flush;
+  o_this->flushArg = i_flushArg;
+  o_this->lastTimestamp = FSM_RECORD_TIMESTAMP();
+  o_this->lastInstance = 0;
+  o_this->recordsCount = 0;
+  o_this->dropped = 0;
+  o_this->flushError = FSM_RC_OK;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_recorder_flush(fsm_recorder_t *const io_this)
+{
+  if (io_this == NULL || io_this->buffer == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->flush == NULL || io_this->flushError != FSM_RC_OK || io_this->used == 0)
+  {
+    return io_this->flushError;
+  }
+
+  size_t used = io_this->used;
+  io_this->used = 0;
+  io_this->flushError = io_this->flush(io_this->flushArg, io_this->buffer, used);
+  return io_this->flushError;
+}
+
+fsm_RC_t fsm_record_bind(fsm_t *const io_fsm,
+                         fsm_record_t *const io_record,
+                         fsm_recorder_t *const i_recorder,
+                         uint32_t i_instance)
+{
+  if (io_fsm == NULL || io_record == NULL || i_recorder == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  io_record->hook.ops = &recordOps;
+  io_record->recorder = i_recorder;
+  io_record->instance = i_instance;
+  fsm_hook_add(io_fsm, &io_record->hook);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_record_unbind(fsm_t *const io_fsm)
+{
+  if (io_fsm == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  (void)fsm_hook_remove(io_fsm, &recordOps);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_replay(const void *const i_log,
+                    size_t i_logSize,
+                    fsm_t *const *const i_instances,
+                    uint32_t i_instancesCount,
+                    fsm_replay_report_t *const o_report)
+{
+  if (i_log == NULL || i_instances == NULL || o_report == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  memset(o_report, 0, sizeof(*o_report));
+  o_report->firstMismatch = UINT64_MAX;
+
+  fsm_record_header_t header;
+  if (i_logSize < sizeof(header))
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  memcpy(&header, i_log, sizeof(header));
+  if (header.magic != FSM_RECORD_MAGIC || header.version != FSM_RECORD_VERSION)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  const uint8_t *pos = (const uint8_t *)i_log + sizeof(header);
+  const uint8_t *end = (const uint8_t *)i_log + i_logSize;
+  uint64_t ticks = 0;
+  uint32_t instance = 0;
+  uint64_t events = 0;
+  fsm_RC_t res = FSM_RC_OK;
+  uint64_t start = monotonic_ns();
+
+  while (pos < end)
+  {
+    uint64_t delta;
+    uint64_t instanceDelta;
+    uint64_t event;
+    uint64_t state;
+    uint64_t result;
+    if (get_varint(&pos, end, &delta) == false || get_varint(&pos, end, &instanceDelta) == false ||
+        get_varint(&pos, end, &event) == false || get_varint(&pos, end, &state) == false ||
+        get_varint(&pos, end, &result) == false)
+    {
+      res = FSM_RC_ERROR_INVALID_ARG;
+      break;
+    }
+    ticks += delta;
+
+    /* Zigzag decode, wraps like the encoder */
+    uint32_t zigzag = (uint32_t)instanceDelta;
+    instance += (zigzag >> 1) ^ (0u - (zigzag & 1u));
+
+    /* Failed events are recorded as well, they may have changed the state */
+    fsm_t *fsm = (instance < i_instancesCount) ? i_instances[instance] : NULL;
+    fsm_RC_t processRes = (fsm != NULL) ? fsm_process(fsm, (fsm_event_t)event) : FSM_RC_ERROR_INVALID_ARG;
+    if (processRes != FSM_RC_OK)
+    {
+      o_report->errors++;
+    }
+    if (fsm != NULL && ((uint64_t)fsm->currentState != state || (uint64_t)(uint32_t)processRes != result))
+    {
+      if (o_report->mismatches++ == 0)
+      {
+        o_report->firstMismatch = events;
+      }
+    }
+    events++;
+  }
+
+  o_report->elapsedNs = monotonic_ns() - start;
+  o_report->events = events;
+  o_report->recordedTicks = ticks;
+  if (o_report->elapsedNs > 0)
+  {
+    o_report->eventsPerSec = (uint64_t)((double)events * 1e9 / (double)o_report->elapsedNs);
+  }
+  return res;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void record_event(fsm_hook_t *io_hook, const fsm_t *i_fsm, fsm_event_t i_event, fsm_RC_t i_res)
+{
+  const fsm_record_t *record = (const fsm_record_t *)io_hook;
+  fsm_recorder_t *recorder = record->recorder;
+  uint64_t now = FSM_RECORD_TIMESTAMP();
+
+  /* Make room for the record, hand out the full buffer or drop it */
+  if (recorder->size - recorder->used < FSM_RECORD_MAX_SIZE)
+  {
+    if (recorder->flush == NULL || recorder->flushError != FSM_RC_OK)
+    {
+      recorder->dropped++;
+      return;
+    }
+    size_t used = recorder->used;
+    recorder->used = 0;
+    recorder->flushError = recorder->flush(recorder->flushArg, recorder->buffer, used);
+    if (recorder->flushError != FSM_RC_OK)
+    {
+      recorder->dropped++;
+      return;
+    }
+  }
+
+  uint32_t instanceDelta = record->instance - recorder->lastInstance;
+  uint32_t zigzag = (instanceDelta << 1) ^ (0u - (instanceDelta >> 31));
+  uint8_t *pos = &recorder->buffer[recorder->used];
+  pos = put_varint(pos, now - recorder->lastTimestamp);
+  pos = put_varint(pos, zigzag);
+  pos = put_varint(pos, (uint64_t)(uint32_t)i_event);
+  pos = put_varint(pos, (uint64_t)(uint32_t)i_fsm->currentState);
+  pos = put_varint(pos, (uint64_t)(uint32_t)i_res);
+  recorder->used = (size_t)(pos - recorder->buffer);
+  recorder->lastTimestamp = now;
+  recorder->lastInstance = record->instance;
+  recorder->recordsCount++;
+}
+
+static uint8_t *put_varint(uint8_t *o_pos, uint64_t i_value)
+{
+  while (i_value >= 0x80u)
+  {
+    *o_pos++ = (uint8_t)(i_value | 0x80u);
+    i_value >>= 7;
+  }
+  *o_pos++ = (uint8_t)i_value;
+  return o_pos;
+}
+
+static bool get_varint(const uint8_t **const io_pos, const uint8_t *const i_end, uint64_t *const o_value)
+{
+  const uint8_t *pos = *io_pos;
+  uint64_t value = 0;
+  for (uint32_t shift = 0; shift < 64u; shift += 7u)
+  {
+    if (pos >= i_end)
+    {
+      return false;
+    }
+    uint8_t byte = *pos++;
+    value |= (uint64_t)(byte & 0x7Fu) << shift;
+    if ((byte & 0x80u) == 0)
+    {
+      *io_pos = pos;
+      *o_value = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline uint64_t monotonic_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file       fsm_record.h
+ * @brief      Event log recorder and replay
+ *
+ *             A recorder bound to an instance logs every event processed by
+ *             fsm_process (including the events raised by timers and the
+ *             failed ones) as (instance id, event, timestamp, resulting
+ *             state, result) into a caller provided buffer. Full buffers are handed to a
+ *             flush function, e.g. writing to a file, so the log is one
+ *             continuous stream.
+ *             Layout (native byte order):
+ *               header       fsm_record_header_t
+ *               records      per event five unsigned LEB128 varints:
+ *                              timestamp delta to the previous record,
+ *                              instance id delta (zigzag),
+ *                              event,
+ *                              resulting state,
+ *                              fsm_RC_t of fsm_process
+ *             A record usually takes 5 to 7 bytes, recording it is a
+ *             timestamp read and a few stores. A recorder is not thread safe,
+ *             use one per processing thread. Sub fsms are driven by their
+ *             parent, bind only the instances events are sent to.
+ *             fsm_replay runs a complete log (e.g. mmap'd) back through
+ *             fsm_process as fast as possible, checks the resulting states
+ *             and results against the recorded ones and reports the
+ *             throughput. The instances must start in the states they had
+ *             when recording started, e.g. freshly initialized or restored
+ *             from a snapshot, and should have no timers bound, the timer
+ *             events are part of the log.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_RECORD_H_
+#define FSM_RECORD_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_RECORD_MAGIC 0x524D5346u /**< "FSMR" in little endian */
+#define FSM_RECORD_VERSION 2u        /**< Layout version, 2: result per record */
+#define FSM_RECORD_MAX_SIZE 30u      /**< Maximum size of one record */
+
+/**
+ * @brief Unit of the recorded timestamps
+ */
+typedef enum
+{
+  FSM_RECORD_TICKS_TSC = 1, /**< Cycle counter */
+  FSM_RECORD_TICKS_NS = 2,  /**< Monotonic ns */
+} fsm_record_ticks_t;
+
+/**
+ * @brief Log Header
+ */
+typedef struct
+{
+  uint32_t magic;   /**< FSM_RECORD_MAGIC */
+  uint16_t version; /**< FSM_RECORD_VERSION */
+  uint16_t ticks;   /**< fsm_record_ticks_t */
+} fsm_record_header_t;
+
+/**
+ * @brief Function receiving the filled part of the buffer
+ *
+ * @param i_arg Argument given to fsm_recorder_init
+ * @param i_data The data, only valid during the call
+ * @param i_size Size of the data
+ *
+ * @return FSM_RC_OK on success, error code otherwise, recording stops then
+ */
+typedef fsm_RC_t (*fsm_recorder_flush_t)(void *i_arg, const uint8_t *i_data, size_t i_size);
+
+/**
+ * @brief Recorder Struct
+ */
+typedef struct fsm_recorder
+{
+  uint8_t *buffer;            /**< Buffer for the encoded records */
+  size_t size;                /**< Size of the buffer */
+  size_t used;                /**< Bytes in the buffer */
+  fsm_recorder_flush_t flush; /**< [optional] Receives full buffers, drop if null */
+  void *flushArg;             /**< Argument of the flush function */
+  uint64_t lastTimestamp;     /**< Timestamp of the previous record */
+  uint32_t lastInstance;      /**< Instance id of the previous record */
+  uint64_t recordsCount;      /**< Number of recorded events */
+  uint64_t dropped;           /**< Events dropped, buffer full and no flush */
+  fsm_RC_t flushError;        /**< Failed flush, stops recording */
+} fsm_recorder_t;
+
+/**
+ * @brief Binding of an instance to a recorder
+ */
+typedef struct fsm_record
+{
+  fsm_hook_t hook;          /**< Binding to the instance, first member */
+  fsm_recorder_t *recorder; /**< The recorder */
+  uint32_t instance;        /**< Id of the instance in the log */
+} fsm_record_t;
+
+/**
+ * @brief Replay Report
+ */
+typedef struct
+{
+  uint64_t events;        /**< Number of replayed events */
+  uint64_t errors;        /**< Events fsm_process failed on */
+  uint64_t mismatches;    /**< Events resulting in another state or result than recorded */
+  uint64_t firstMismatch; /**< Index of the first mismatching event, UINT64_MAX if none */
+  uint64_t recordedTicks; /**< Time span of the log, see fsm_record_header_t */
+  uint64_t elapsedNs;     /**< Duration of the replay */
+  uint64_t eventsPerSec;  /**< Replay throughput */
+} fsm_replay_report_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize a recorder and write the log header
+ *
+ * @param o_this Pointer to the recorder
+ * @param i_buffer Buffer for the encoded records
+ * @param i_size Size of the buffer, at least
+ *               sizeof(fsm_record_header_t) + FSM_RECORD_MAX_SIZE
+ * @param i_flush [optional] Receives the buffer whenever it is full and on
+ *                fsm_recorder_flush, events are dropped on a full buffer if null
+ * @param i_flushArg Argument of the flush function
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_recorder_init(fsm_recorder_t *const o_this,
+                           uint8_t *const i_buffer,
+                           size_t i_size,
+                           fsm_recorder_flush_t i_flush,
+                           void *i_flushArg);
+
+/**
+ * @brief Hand the buffered records to the flush function
+ *
+ * @param io_this Pointer to the recorder
+ *
+ * @return FSM_RC_OK on success, error code of a failed flush otherwise
+ */
+fsm_RC_t fsm_recorder_flush(fsm_recorder_t *const io_this);
+
+/**
+ * @brief Record the events processed by an initialized FSM instance
+ *
+ * Unbind before calling fsm_init on the instance again.
+ *
+ * @param io_fsm The FSM instance
+ * @param io_record Pointer to the binding, must stay valid
+ * @param i_recorder The recorder
+ * @param i_instance Id of the instance in the log, index into the instances of
+ *                   fsm_replay
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_record_bind(fsm_t *const io_fsm,
+                         fsm_record_t *const io_record,
+                         fsm_recorder_t *const i_recorder,
+                         uint32_t i_instance);
+
+/**
+ * @brief Stop recording an instance
+ *
+ * @param io_fsm The FSM instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_record_unbind(fsm_t *const io_fsm);
+
+/**
+ * @brief Replay a log through fsm_process
+ *
+ * Events addressed to an id without instance are skipped and counted as
+ * errors. Recorded failures fail again and count as errors, not as
+ * mismatches.
+ *
+ * @param i_log The complete log, e.g. mmap'd read only
+ * @param i_logSize Size of the log
+ * @param i_instances Instances by id
+ * @param i_instancesCount Number of instances
+ * @param o_report The report
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the log is
+ *         corrupt (the report covers the events before), error code otherwise
+ */
+fsm_RC_t fsm_replay(const void *const i_log,
+                    size_t i_logSize,
+                    fsm_t *const *const i_instances,
+                    uint32_t i_instancesCount,
+                    fsm_replay_report_t *const o_report);
+
+#endif /* FSM_RECORD_H_ */
@@ -0,0 +1,411 @@
+/**
+ * @file       fsm_reorder.c
+ * @brief      Profile guided transition reordering and hot/cold layout
+ *
+ *             The transitions of a state are permuted in their array and the
+ *             cells of the dispatch table, which point into it by index, are
+ *             remapped. A reordered copy is built in profile order first and
+ *             permuted the same way, as a builder attaching a table sorts the
+ *             transitions by event.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_reorder.h"  /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <stdlib.h> /* for malloc, calloc, free */
+#include <string.h> /* for memcpy, memset */
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Stable merge sort of indices by descending keys
+ *
+ * @param i_keys Key per index
+ * @param io_order The indices
+ * @param io_tmp Scratch space of the same size
+ * @param i_count Number of indices
+ */
+static void sort_by_hits(const uint64_t *i_keys, uint32_t *io_order, uint32_t *io_tmp, uint32_t i_count);
+
+/**
+ * @brief Sort the transitions of every state by their lookups and remap the
+ *        dispatch table
+ *
+ * @param i_config The finalized builder configuration
+ * @param i_hits Counters of the profiled configuration
+ * @param i_rows [optional] Row in the counters per state of the configuration,
+ *               the same index if null
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR if an allocation failed
+ */
+static fsm_RC_t reorder_transitions(const fsm_cfg_t *const i_config,
+                                    const fsm_hits_t *const i_hits,
+                                    const uint32_t *const i_rows);
+
+/**
+ * @brief Count the lookup of an event in a state, hook operation lookup
+ *
+ * @param io_hook The binding of the instance
+ * @param i_fsm The FSM instance
+ * @param i_stateIndex Index of the current state in the states array
+ * @param i_event The event
+ */
+static void hits_count(fsm_hook_t *io_hook, const fsm_t *i_fsm, uint32_t i_stateIndex, fsm_event_t i_event);
+
+/******************************************************************************/
+/*** Private static variables                                                 */
+/******************************************************************************/
+static const fsm_hook_ops_t hitsOps = {.lookup = hits_count}; /**< Hook of the hit counters */
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_hits_init(fsm_hits_t *const o_this,
+                       const fsm_cfg_t *const i_config,
+                       uint32_t *const i_counts,
+                       size_t i_countsCount)
+{
+  if (o_this == NULL || i_config == NULL || i_counts == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  uint32_t rowSize = fsm_event_enum_count(i_config);
+  size_t countsCount = (size_t)i_config->statesCount * rowSize;
+  if (i_countsCount < countsCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  memset(i_counts, 0, sizeof(uint32_t) * countsCount);
+  o_this->config = i_config;
+  o_this->counts = i_counts;
+  o_this->rowSize = rowSize;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_hits_bind(fsm_t *const io_fsm, fsm_hits_binding_t *const io_binding, fsm_hits_t *const io_hits)
+{
+  if (io_fsm == NULL || io_binding == NULL || io_hits == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_fsm->config != io_hits->config)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  io_binding->hook.ops = &hitsOps;
+  io_binding->hits = io_hits;
+  fsm_hook_add(io_fsm, &io_binding->hook);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_hits_unbind(fsm_t *const io_fsm)
+{
+  if (io_fsm == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  (void)fsm_hook_remove(io_fsm, &hitsOps);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_hits_merge(fsm_hits_t *const io_this, const fsm_hits_t *const i_other)
+{
+  if (io_this == NULL || i_other == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_this->config != i_other->config)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  size_t countsCount = (size_t)io_this->config->statesCount * io_this->rowSize;
+  for (size_t i = 0; i < countsCount; i++)
+  {
+    uint32_t room = UINT32_MAX - io_this->counts[i];
+    io_this->counts[i] += (i_other->counts[i] < room) ? i_other->counts[i] : room;
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_reorder(const fsm_cfg_t *const i_config,
+                     const fsm_hits_t *const i_hits,
+                     fsm_builder_t *const io_builder,
+                     const fsm_cfg_t **const o_config)
+{
+  if (i_config == NULL || i_hits == NULL || io_builder == NULL || o_config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_hits->config != i_config || io_builder->statesCount != 0 || io_builder->config != NULL)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_RC_t res = fsm_cfg_prepare(i_config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  res = fsm_builder_set_enums(io_builder, fsm_state_enum_count(i_config), fsm_event_enum_count(i_config));
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  /* Keep the lookup of the input configuration */
+  res = fsm_builder_set_linear(io_builder, i_config->dispatch == NULL && i_config->packed == NULL);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  const uint32_t statesCount = i_config->statesCount;
+  uint64_t *totals = calloc(statesCount, sizeof(uint64_t));
+  uint32_t *scratch = malloc(sizeof(uint32_t) * statesCount * 3u);
+  if (totals == NULL || scratch == NULL)
+  {
+    free(totals);
+    free(scratch);
+    return FSM_RC_ERROR;
+  }
+  uint32_t *order = &scratch[0];
+  uint32_t *tmp = &scratch[statesCount];
+  uint32_t *rows = &scratch[statesCount * 2u];
+
+  /* Hottest states first */
+  for (uint32_t i = 0; i < statesCount; i++)
+  {
+    for (uint32_t e = 0; e < i_hits->rowSize; e++)
+    {
+      totals[i] += i_hits->counts[i * i_hits->rowSize + e];
+    }
+    order[i] = i;
+  }
+  sort_by_hits(totals, order, tmp, statesCount);
+
+  /* Stage the states in profile order, skip redefinitions never looked up */
+  uint32_t stagedCount = 0;
+  for (uint32_t i = 0; i < statesCount && res == FSM_RC_OK; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[order[i]];
+    if (fsm_get_state_cfg(i_config, stateCfg->state) != stateCfg)
+    {
+      continue;
+    }
+    rows[stagedCount++] = order[i];
+    res = fsm_builder_add_state(io_builder, stateCfg->state);
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_actions(io_builder, stateCfg->state, stateCfg->entryAction, stateCfg->doAction,
+                                    stateCfg->exitAction);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_sub_fsm(io_builder, stateCfg->state, stateCfg->subFsm);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_sub_cfg(io_builder, stateCfg->state, stateCfg->subCfg);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = fsm_builder_set_regions(io_builder, stateCfg->state, stateCfg->regions);
+    }
+    for (uint32_t t = 0; t < stateCfg->transitionsCount && res == FSM_RC_OK; t++)
+    {
+      res = fsm_builder_add_transition(io_builder, stateCfg->state, &stateCfg->transitions[t]);
+    }
+  }
+  if (res == FSM_RC_OK)
+  {
+    res = fsm_builder_set_initial(io_builder, i_config->initialState);
+  }
+  if (res == FSM_RC_OK)
+  {
+    res = fsm_builder_set_packed(io_builder, i_config->dispatch == NULL && i_config->packed != NULL);
+  }
+  if (res == FSM_RC_OK)
+  {
+    res = fsm_builder_finalize(io_builder, o_config);
+  }
+  if (res == FSM_RC_OK)
+  {
+    res = reorder_transitions(*o_config, i_hits, rows);
+  }
+
+  free(totals);
+  free(scratch);
+  return res;
+}
+
+fsm_RC_t fsm_reorder_in_place(fsm_builder_t *const io_builder, const fsm_hits_t *const i_hits)
+{
+  if (io_builder == NULL || i_hits == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_builder->config == NULL)
+  {
+    return FSM_RC_ERROR;
+  }
+  if (i_hits->config != io_builder->config)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  return reorder_transitions(io_builder->config, i_hits, NULL);
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void hits_count(fsm_hook_t *io_hook, const fsm_t *i_fsm, uint32_t i_stateIndex, fsm_event_t i_event)
+{
+  fsm_hits_t *hits = ((fsm_hits_binding_t *)io_hook)->hits;
+  (void)i_fsm;
+  if ((uint32_t)i_event >= hits->rowSize)
+  {
+    return;
+  }
+  uint32_t *count = &hits->counts[i_stateIndex * hits->rowSize + (uint32_t)i_event];
+  if (*count != UINT32_MAX)
+  {
+    (*count)++;
+  }
+}
+
+static void sort_by_hits(const uint64_t *i_keys, uint32_t *io_order, uint32_t *io_tmp, uint32_t i_count)
+{
+  uint32_t *from = io_order;
+  uint32_t *to = io_tmp;
+  for (uint32_t width = 1; width < i_count; width *= 2u)
+  {
+    for (uint32_t lo = 0; lo < i_count; lo += 2u * width)
+    {
+      uint32_t mid = (lo + width < i_count) ? lo + width : i_count;
+      uint32_t hi = (mid + width < i_count) ? mid + width : i_count;
+      uint32_t l = lo;
+      uint32_t r = mid;
+      for (uint32_t k = lo; k < hi; k++)
+      {
+        if (l < mid && (r >= hi || i_keys[from[l]] >= i_keys[from[r]]))
+        {
+          to[k] = from[l++];
+        }
+        else
+        {
+          to[k] = from[r++];
+        }
+      }
+    }
+    uint32_t *swap = from;
+    from = to;
+    to = swap;
+  }
+  if (from != io_order)
+  {
+    memcpy(io_order, from, sizeof(uint32_t) * i_count);
+  }
+}
+
+static fsm_RC_t reorder_transitions(const fsm_cfg_t *const i_config,
+                                    const fsm_hits_t *const i_hits,
+                                    const uint32_t *const i_rows)
+{
+  uint32_t maxCount = 0;
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    maxCount = (i_config->states[i].transitionsCount > maxCount) ? i_config->states[i].transitionsCount : maxCount;
+  }
+  if (maxCount < 2u)
+  {
+    return FSM_RC_OK;
+  }
+
+  uint64_t *keys = malloc(sizeof(uint64_t) * maxCount);
+  uint32_t *scratch = malloc(sizeof(uint32_t) * maxCount * 3u);
+  fsm_transition_cfg_t *sorted = malloc(sizeof(fsm_transition_cfg_t) * maxCount);
+  if (keys == NULL || scratch == NULL || sorted == NULL)
+  {
+    free(keys);
+    free(scratch);
+    free(sorted);
+    return FSM_RC_ERROR;
+  }
+  uint32_t *order = &scratch[0];
+  uint32_t *tmp = &scratch[maxCount];
+  uint32_t *newIndex = &scratch[maxCount * 2u];
+
+  /* The builder owns the arrays, they are only const for the instances */
+  fsm_dispatch_t *dispatch = i_config->dispatch;
+  const fsm_packed_t *packed = i_config->packed;
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    const uint32_t count = stateCfg->transitionsCount;
+    if (count < 2u)
+    {
+      continue;
+    }
+
+    /* Equal keys keep their order, the first transition for an event wins */
+    const uint32_t *row = &i_hits->counts[((i_rows != NULL) ? i_rows[i] : i) * i_hits->rowSize];
+    for (uint32_t t = 0; t < count; t++)
+    {
+      uint32_t event = (uint32_t)stateCfg->transitions[t].event;
+      keys[t] = (event < i_hits->rowSize) ? row[event] : 0u;
+      order[t] = t;
+    }
+    sort_by_hits(keys, order, tmp, count);
+    for (uint32_t t = 0; t < count; t++)
+    {
+      memcpy(&sorted[t], &stateCfg->transitions[order[t]], sizeof(fsm_transition_cfg_t));
+      newIndex[order[t]] = t;
+    }
+    memcpy((fsm_transition_cfg_t *)stateCfg->transitions, sorted, sizeof(fsm_transition_cfg_t) * count);
+
+    /* Remap the cells of the state */
+    if (dispatch != NULL && dispatch->isBuilt == true)
+    {
+      fsm_dispatch_cell_t *cells = &dispatch->cells[i * dispatch->rowSize];
+      for (uint32_t e = 0; e < dispatch->rowSize; e++)
+      {
+        if (cells[e].transition != FSM_INDEX_NONE)
+        {
+          cells[e].transition = (fsm_index_t)newIndex[cells[e].transition];
+        }
+      }
+    }
+    else if (dispatch == NULL && packed != NULL)
+    {
+      fsm_packed_cell_t *cells = (fsm_packed_cell_t *)&packed->cells[packed->rowBase[i]];
+      for (uint32_t e = 0; e < packed->rowSize; e++)
+      {
+        if (cells[e].state == (fsm_index_t)i)
+        {
+          cells[e].transition = (fsm_index_t)newIndex[cells[e].transition];
+        }
+      }
+    }
+  }
+
+  free(keys);
+  free(scratch);
+  free(sorted);
+  return FSM_RC_OK;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file       fsm_reorder.h
+ * @brief      Profile guided transition reordering and hot/cold layout
+ *
+ *             Without a dispatch table fsm_process searches the states and
+ *             the transitions of the current state in declaration order. For
+ *             machines with sparse event sets this linear search beats even a
+ *             compressed table once the most frequent entries come first.
+ *             Hit counters bound to instances count the lookups of every
+ *             (state, event) of a configuration at runtime, the event log of
+ *             fsm_record.h can be replayed to collect them offline.
+ *             fsm_reorder turns the profile into an equivalent configuration
+ *             built with a fsm_builder_t: the states sorted by their lookups,
+ *             hottest first, and the transitions of each state sorted the same
+ *             way, so the hot states and their transitions are packed into
+ *             contiguous cache lines at the start of the arrays and the cold
+ *             ones follow behind them.
+ *             The action and guard metadata is not split off the hot data:
+ *             fsm_state_cfg_t and fsm_transition_cfg_t are the public
+ *             configuration layout shared by all paths, so it stays inline
+ *             and only moves with its cold state or transition.
+ *             Written with fsm_image_write it becomes a reordered image.
+ *             fsm_reorder_in_place reorders the transitions of a builder made
+ *             configuration without copying it. States are not moved then, as
+ *             pools address them by index.
+ *             Transitions sharing an event keep their order, so the first one
+ *             defined still wins. Only the configuration of the instances is
+ *             profiled, not the sub configurations or sub fsms.
+ *
+ *             fsm_hits_init(&hits, config, counts, FSM_HITS_COUNT(3, FSM_EVENT_COUNT));
+ *             fsm_hits_bind(&fsm, &binding, &hits);
+ *             ... process events ...
+ *             fsm_builder_init(&builder, 0);
+ *             fsm_reorder(config, &hits, &builder, &reordered);
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_REORDER_H_
+#define FSM_REORDER_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"         /* FSM types */
+#include "fsm_builder.h" /* fsm_builder_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Number of counters for a configuration, see fsm_hits_init
+ */
+#define FSM_HITS_COUNT(statesCount, eventEnumCount) ((statesCount) * (eventEnumCount))
+
+/**
+ * @brief Hit Counters of a configuration
+ *
+ * One counter per (index in the states array, event), saturating at
+ * UINT32_MAX. Not thread safe, bind the instances of one thread and add the
+ * counters of several threads up with fsm_hits_merge.
+ */
+typedef struct fsm_hits
+{
+  const fsm_cfg_t *config; /**< The profiled configuration */
+  uint32_t *counts;        /**< statesCount * rowSize counters, row per state */
+  uint32_t rowSize;        /**< Counters per state, size of the event enum */
+} fsm_hits_t;
+
+/**
+ * @brief Binding of an instance to hit counters
+ */
+typedef struct fsm_hits_binding
+{
+  fsm_hook_t hook;  /**< Binding to the instance, first member */
+  fsm_hits_t *hits; /**< The counters */
+} fsm_hits_binding_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize cleared hit counters for a configuration
+ *
+ * @param o_this Pointer to the counters
+ * @param i_config The initialized configuration
+ * @param i_counts Storage for the counters, must stay valid
+ * @param i_countsCount Number of counters, at least
+ *                      FSM_HITS_COUNT(statesCount, size of the event enum)
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_hits_init(fsm_hits_t *const o_this,
+                       const fsm_cfg_t *const i_config,
+                       uint32_t *const i_counts,
+                       size_t i_countsCount);
+
+/**
+ * @brief Count the lookups of an initialized FSM instance
+ *
+ * Unbind before calling fsm_init on the instance again.
+ *
+ * @param io_fsm The FSM instance, running the profiled configuration
+ * @param io_binding Pointer to the binding, must stay valid
+ * @param io_hits The counters, must stay valid
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the instance runs
+ *         another configuration, error code otherwise
+ */
+fsm_RC_t fsm_hits_bind(fsm_t *const io_fsm, fsm_hits_binding_t *const io_binding, fsm_hits_t *const io_hits);
+
+/**
+ * @brief Stop counting the lookups of an instance
+ *
+ * @param io_fsm The FSM instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_hits_unbind(fsm_t *const io_fsm);
+
+/**
+ * @brief Add the counters of another thread
+ *
+ * @param io_this The counters to add to
+ * @param i_other Counters of the same configuration
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the
+ *         configurations differ, error code otherwise
+ */
+fsm_RC_t fsm_hits_merge(fsm_hits_t *const io_this, const fsm_hits_t *const i_other);
+
+/**
+ * @brief Build a copy of a configuration laid out by a profile
+ *
+ * The copy uses the same lookup as the configuration: linear without a
+ * dispatch table (see fsm_builder_set_linear), otherwise a dense or row
+ * displaced table. Sub fsms, sub configurations, regions and actions are
+ * referenced, not copied.
+ *
+ * @param i_config The initialized configuration
+ * @param i_hits Counters of the configuration
+ * @param io_builder Initialized, empty builder holding the copy
+ * @param o_config The reordered configuration, valid until fsm_builder_free
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the counters
+ *         belong to another configuration, FSM_RC_ERROR_INVALID_CONFIG if a
+ *         transition targets an undefined state, FSM_RC_ERROR if an allocation
+ *         failed, error code otherwise
+ */
+fsm_RC_t fsm_reorder(const fsm_cfg_t *const i_config,
+                     const fsm_hits_t *const i_hits,
+                     fsm_builder_t *const io_builder,
+                     const fsm_cfg_t **const o_config);
+
+/**
+ * @brief Reorder the transitions of a finalized builder configuration in place
+ *
+ * The transitions of every state are sorted by their lookups, hottest first,
+ * and the dispatch table is rebuilt. No event may be processed on the
+ * configuration meanwhile.
+ *
+ * @param io_builder The builder owning the configuration
+ * @param i_hits Counters of the configuration
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the counters
+ *         belong to another configuration, FSM_RC_ERROR if the builder is not
+ *         finalized or an allocation failed, error code otherwise
+ */
+fsm_RC_t fsm_reorder_in_place(fsm_builder_t *const io_builder, const fsm_hits_t *const i_hits);
+
+#endif /* FSM_REORDER_H_ */
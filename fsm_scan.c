@@ -0,0 +1,228 @@
+/**
+ * @file       fsm_scan.c
+ * @brief      Byte stream scanning with a FSM instance
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_scan.h"     /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+#include "fsm_trace.h"    /* FSM_TRACE */
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Check if a state has timed transitions
+ *
+ * @param i_stateCfg The state configuration
+ *
+ * @return true if entering or leaving the state arms or cancels timers
+ */
+static bool has_timers(const fsm_state_cfg_t *const i_stateCfg);
+
+/**
+ * @brief Compute the cell of a state and an event
+ *
+ * @param i_config The configuration
+ * @param i_stateCfg The state configuration
+ * @param i_event The event
+ *
+ * @return Index of the next state, FSM_SCAN_SLOW if processing runs anything
+ */
+static fsm_index_t build_cell(const fsm_cfg_t *const i_config,
+                              const fsm_state_cfg_t *const i_stateCfg,
+                              fsm_event_t i_event);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_scanner_init(fsm_scanner_t *const o_this,
+                          fsm_t *const i_fsm,
+                          const fsm_event_t *const i_byteClass,
+                          fsm_index_t *const i_table,
+                          uint32_t i_tableSize)
+{
+  if (o_this == NULL || i_fsm == NULL || i_fsm->config == NULL || i_table == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  const fsm_cfg_t *cfg = i_fsm->config;
+  if (cfg->statesCount >= FSM_SCAN_SLOW)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+  if (i_tableSize < FSM_SCAN_TABLE_SIZE(cfg->statesCount))
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  for (uint32_t i = 0; i < cfg->statesCount; i++)
+  {
+    fsm_index_t *row = &i_table[i * 256u];
+    for (uint32_t byte = 0; byte < 256u; byte++)
+    {
+      fsm_event_t event = (i_byteClass != NULL) ? i_byteClass[byte] : (fsm_event_t)byte;
+      row[byte] = build_cell(cfg, &cfg->states[i], event);
+    }
+  }
+
+  o_this->fsm = i_fsm;
+  o_this->byteClass = i_byteClass;
+  o_this->table = i_table;
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_scan(fsm_scanner_t *const io_this,
+                  const uint8_t *const i_buf,
+                  size_t i_len,
+                  size_t *const o_consumed)
+{
+  if (io_this == NULL || io_this->fsm == NULL || io_this->table == NULL || (i_buf == NULL && i_len > 0))
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_t *fsm = io_this->fsm;
+  const fsm_cfg_t *cfg = fsm->config;
+  const fsm_index_t *table = io_this->table;
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(cfg, fsm->currentState);
+  if (stateCfg == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  /* Bound modules see every event, so every cell is slow then */
+  bool isFast = (fsm->hooks == NULL);
+
+  /* Without an entry action the first run has nothing to do */
+  if (isFast == true && fsm->isFirstRun == true && fsm_action_is_set(&stateCfg->entryAction) == false &&
+      stateCfg->subCfg == NULL && stateCfg->regions == NULL && !has_timers(stateCfg))
+  {
+    fsm->isFirstRun = false;
+  }
+
+  uint32_t state = (uint32_t)(stateCfg - cfg->states);
+  fsm_RC_t res = FSM_RC_OK;
+  size_t i = 0;
+  while (i < i_len)
+  {
+    /* Fast path, only table lookups */
+    uint32_t cell = 0;
+    if (isFast == true && fsm->isFirstRun == false)
+    {
+      while (i < i_len && ((cell = table[(state << 8) | i_buf[i]]) & FSM_SCAN_SLOW) == 0)
+      {
+        state = cell;
+        i++;
+      }
+      if (i == i_len)
+      {
+        break;
+      }
+    }
+
+    /* Slow path, the byte runs actions */
+    fsm->currentState = cfg->states[state].state;
+    fsm_event_t event = (io_this->byteClass != NULL) ? io_this->byteClass[i_buf[i]] : (fsm_event_t)i_buf[i];
+    res = fsm_process(fsm, event);
+    if (res != FSM_RC_OK)
+    {
+      break;
+    }
+    stateCfg = fsm_get_state_cfg(cfg, fsm->currentState);
+    if (stateCfg == NULL)
+    {
+      res = FSM_RC_ERROR_INVALID_CONFIG;
+      break;
+    }
+    state = (uint32_t)(stateCfg - cfg->states);
+    i++;
+  }
+
+  if (res == FSM_RC_OK)
+  {
+    fsm->currentState = cfg->states[state].state;
+  }
+  if (o_consumed != NULL)
+  {
+    *o_consumed = i;
+  }
+  return res;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static bool has_timers(const fsm_state_cfg_t *const i_stateCfg)
+{
+  for (uint32_t t = 0; t < i_stateCfg->transitionsCount; t++)
+  {
+    if (i_stateCfg->transitions[t].after != 0 || i_stateCfg->transitions[t].every != 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static fsm_index_t build_cell(const fsm_cfg_t *const i_config,
+                              const fsm_state_cfg_t *const i_stateCfg,
+                              fsm_event_t i_event)
+{
+#if FSM_TRACE
+  (void)i_config;
+  (void)i_stateCfg;
+  (void)i_event;
+  return FSM_SCAN_SLOW;
+#else
+  /* Every event runs the do action and the sub fsm of the state */
+  if (fsm_action_is_set(&i_stateCfg->doAction) == true || i_stateCfg->subFsm != NULL || i_stateCfg->subCfg != NULL ||
+      i_stateCfg->regions != NULL)
+  {
+    return FSM_SCAN_SLOW;
+  }
+
+  /* Same lookup as fsm_process, the first transition for the event wins */
+  const fsm_transition_cfg_t *transitionCfg = NULL;
+  for (uint32_t t = 0; t < i_stateCfg->transitionsCount; t++)
+  {
+    if (i_stateCfg->transitions[t].event == i_event)
+    {
+      transitionCfg = &i_stateCfg->transitions[t];
+      break;
+    }
+  }
+  if (transitionCfg == NULL)
+  {
+    return (fsm_index_t)(i_stateCfg - i_config->states);
+  }
+  if (fsm_guard_is_set(&transitionCfg->guard) == true || fsm_action_is_set(&transitionCfg->action) == true)
+  {
+    return FSM_SCAN_SLOW;
+  }
+
+  /* Undefined targets are reported by fsm_process */
+  const fsm_state_cfg_t *toStateCfg = fsm_get_state_cfg(i_config, transitionCfg->toState);
+  if (toStateCfg == NULL)
+  {
+    return FSM_SCAN_SLOW;
+  }
+  if (toStateCfg != i_stateCfg &&
+      (fsm_action_is_set(&i_stateCfg->exitAction) == true || fsm_action_is_set(&toStateCfg->entryAction) == true ||
+       fsm_action_is_set(&toStateCfg->doAction) == true || toStateCfg->subFsm != NULL || toStateCfg->subCfg != NULL ||
+       toStateCfg->regions != NULL || has_timers(i_stateCfg) || has_timers(toStateCfg)))
+  {
+    return FSM_SCAN_SLOW;
+  }
+  return (fsm_index_t)(toStateCfg - i_config->states);
+#endif
+}
@@ -0,0 +1,101 @@
+/**
+ * @file       fsm_scan.h
+ * @brief      Byte stream scanning with a FSM instance
+ *
+ *             Feeds a buffer byte by byte into a FSM instance, e.g. a protocol
+ *             parser. Each byte is mapped to an event through an optional
+ *             256 entry class table (the byte value is the event otherwise).
+ *             fsm_scanner_init folds the class table into one row of 256
+ *             cells per state. A cell either holds the next state, when taking
+ *             it would run nothing (no actions, guards, sub fsms or timers
+ *             involved), or is marked slow. The inner loop is a single load
+ *             per byte and leaves it only for slow cells, which are processed
+ *             with fsm_process. The state lives in the instance, so input can
+ *             come in chunks (e.g. from a mmap'd file) and fsm_process calls
+ *             can be mixed in. Storage for the table is provided by the caller.
+ *             With FSM_TRACE enabled, or while modules are bound to the
+ *             instance (recorder, hit counters, timers, see fsm_hook_t), every
+ *             cell is slow to keep the trace and the modules complete.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_SCAN_H_
+#define FSM_SCAN_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_SCAN_SLOW 0x8000u /**< Cell flag: process the byte with fsm_process */
+
+/**
+ * @brief Number of table cells for a configuration with n states
+ */
+#define FSM_SCAN_TABLE_SIZE(n) ((n) * 256u)
+
+/**
+ * @brief Scanner Struct
+ */
+typedef struct
+{
+  fsm_t *fsm;                   /**< The FSM instance fed with the bytes */
+  const fsm_event_t *byteClass; /**< [optional] Event per byte value, 256 entries */
+  fsm_index_t *table;           /**< Next state index or FSM_SCAN_SLOW per state and byte */
+} fsm_scanner_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Build the scan table for an initialized instance
+ *
+ * The configuration, including the sub fsm links, must not change while the
+ * scanner is used.
+ *
+ * @param o_this Pointer to the scanner to initialize
+ * @param i_fsm The initialized FSM instance
+ * @param i_byteClass [optional] Event per byte value, 256 entries, kept
+ *                    referenced; null to use the byte value as event
+ * @param i_table Storage for FSM_SCAN_TABLE_SIZE(statesCount) cells
+ * @param i_tableSize Number of cells in the storage
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the
+ *         configuration has FSM_SCAN_SLOW or more states, error code otherwise
+ */
+fsm_RC_t fsm_scanner_init(fsm_scanner_t *const o_this,
+                          fsm_t *const i_fsm,
+                          const fsm_event_t *const i_byteClass,
+                          fsm_index_t *const i_table,
+                          uint32_t i_tableSize);
+
+/**
+ * @brief Feed a buffer into the instance
+ *
+ * Same result as calling fsm_process for the event of every byte.
+ * Processing stops at the first error.
+ *
+ * @param io_this Pointer to the scanner
+ * @param i_buf The bytes
+ * @param i_len Number of bytes
+ * @param o_consumed [optional] Number of successfully processed bytes, which
+ *                   is the index of the failed byte on error
+ *
+ * @return FSM_RC_OK on success, error code of the failed byte otherwise
+ */
+fsm_RC_t fsm_scan(fsm_scanner_t *const io_this,
+                  const uint8_t *const i_buf,
+                  size_t i_len,
+                  size_t *const o_consumed);
+
+#endif /* FSM_SCAN_H_ */
@@ -0,0 +1,296 @@
+/**
+ * @file       fsm_simd.c
+ * @brief      Lockstep kernel for action free FSMs over many instances
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_simd.h"     /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FSM_SIMD_X86 1 /**< Vector kernels available */
+#include <immintrin.h> /* for AVX2 and AVX-512 intrinsics */
+#else
+#define FSM_SIMD_X86 0 /**< Scalar kernel only */
+#endif
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Scalar kernel, also processes the tails of the vector kernels
+ *
+ * @param i_this Pointer to the kernel
+ * @param io_cursors Cursors of the instances
+ * @param i_begin First instance
+ * @param i_end End of the instances
+ * @param i_count Number of instances, stride of the events
+ * @param i_events The events
+ * @param i_steps Number of events per instance
+ */
+static void run_scalar(const fsm_simd_t *const i_this,
+                       int32_t *const io_cursors,
+                       size_t i_begin,
+                       size_t i_end,
+                       size_t i_count,
+                       const fsm_event_t *const i_events,
+                       size_t i_steps);
+
+#if FSM_SIMD_X86
+/**
+ * @brief AVX2 kernel, 8 instances per gather, see run_scalar
+ *
+ * @return Number of instances processed, the rest is left for the scalar kernel
+ */
+__attribute__((target("avx2"))) static size_t run_avx2(const fsm_simd_t *const i_this,
+                                                        int32_t *const io_cursors,
+                                                        size_t i_count,
+                                                        const fsm_event_t *const i_events,
+                                                        size_t i_steps);
+
+/**
+ * @brief AVX-512 kernel, 16 instances per gather, see run_scalar
+ *
+ * @return Number of instances processed, the rest is left for the scalar kernel
+ */
+__attribute__((target("avx512f"))) static size_t run_avx512(const fsm_simd_t *const i_this,
+                                                            int32_t *const io_cursors,
+                                                            size_t i_count,
+                                                            const fsm_event_t *const i_events,
+                                                            size_t i_steps);
+#endif
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_simd_init(fsm_simd_t *const o_this,
+                       const fsm_cfg_t *const i_config,
+                       int32_t *const i_table,
+                       uint32_t i_tableSize)
+{
+  if (o_this == NULL || i_config == NULL || i_table == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_RC_t res = fsm_cfg_prepare(i_config);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  const uint32_t rowSize = fsm_event_enum_count(i_config) + 1u;
+  if ((uint64_t)i_config->statesCount * rowSize > (uint64_t)INT32_MAX)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+  if ((uint64_t)i_tableSize < (uint64_t)i_config->statesCount * rowSize)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Check that the configuration qualifies */
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    if (stateCfg->subFsm != NULL || stateCfg->subCfg != NULL || stateCfg->regions != NULL ||
+        fsm_action_is_set(&stateCfg->entryAction) == true || fsm_action_is_set(&stateCfg->doAction) == true ||
+        fsm_action_is_set(&stateCfg->exitAction) == true)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+    {
+      const fsm_transition_cfg_t *transitionCfg = &stateCfg->transitions[t];
+      if (fsm_guard_is_set(&transitionCfg->guard) == true || fsm_action_is_set(&transitionCfg->action) == true ||
+          transitionCfg->after != 0 || transitionCfg->every != 0 ||
+          fsm_get_state_cfg(i_config, transitionCfg->toState) == NULL)
+      {
+        return FSM_RC_ERROR_INVALID_CONFIG;
+      }
+    }
+  }
+
+  /* Flatten, every cell stays in its state unless a transition is defined, */
+  /* the first transition defined for an event wins */
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    int32_t *row = &i_table[i * rowSize];
+    for (uint32_t e = 0; e < rowSize; e++)
+    {
+      row[e] = (int32_t)(i * rowSize);
+    }
+    for (uint32_t t = stateCfg->transitionsCount; t-- > 0;)
+    {
+      const fsm_transition_cfg_t *transitionCfg = &stateCfg->transitions[t];
+      if ((uint32_t)transitionCfg->event < rowSize - 1u)
+      {
+        const fsm_state_cfg_t *toStateCfg = fsm_get_state_cfg(i_config, transitionCfg->toState);
+        row[transitionCfg->event] = (int32_t)((uint32_t)(toStateCfg - i_config->states) * rowSize);
+      }
+    }
+  }
+
+  o_this->config = i_config;
+  o_this->table = i_table;
+  o_this->rowSize = rowSize;
+  o_this->initialRow = (uint32_t)(fsm_get_state_cfg(i_config, i_config->initialState) - i_config->states) * rowSize;
+  o_this->isa = FSM_SIMD_ISA_SCALAR;
+#if FSM_SIMD_X86
+  /* The vector kernels load the events as 32 bit lanes */
+  if (sizeof(fsm_event_t) == sizeof(int32_t))
+  {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+      o_this->isa = FSM_SIMD_ISA_AVX512;
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+      o_this->isa = FSM_SIMD_ISA_AVX2;
+    }
+  }
+#endif
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_simd_reset(const fsm_simd_t *const i_this, int32_t *const o_cursors, size_t i_count)
+{
+  if (i_this == NULL || i_this->table == NULL || o_cursors == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  for (size_t i = 0; i < i_count; i++)
+  {
+    o_cursors[i] = (int32_t)i_this->initialRow;
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_simd_run(const fsm_simd_t *const i_this,
+                      int32_t *const io_cursors,
+                      size_t i_count,
+                      const fsm_event_t *const i_events,
+                      size_t i_steps)
+{
+  if (i_this == NULL || i_this->table == NULL || io_cursors == NULL || i_events == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  size_t done = 0;
+#if FSM_SIMD_X86
+  if (i_this->isa == FSM_SIMD_ISA_AVX512)
+  {
+    done = run_avx512(i_this, io_cursors, i_count, i_events, i_steps);
+  }
+  else if (i_this->isa == FSM_SIMD_ISA_AVX2)
+  {
+    done = run_avx2(i_this, io_cursors, i_count, i_events, i_steps);
+  }
+#endif
+  run_scalar(i_this, io_cursors, done, i_count, i_count, i_events, i_steps);
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_simd_get_state(const fsm_simd_t *const i_this, int32_t i_cursor, fsm_state_t *const o_state)
+{
+  if (i_this == NULL || i_this->config == NULL || o_state == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_cursor < 0 || (uint32_t)i_cursor % i_this->rowSize != 0 ||
+      (uint32_t)i_cursor / i_this->rowSize >= i_this->config->statesCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  *o_state = i_this->config->states[(uint32_t)i_cursor / i_this->rowSize].state;
+  return FSM_RC_OK;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void run_scalar(const fsm_simd_t *const i_this,
+                       int32_t *const io_cursors,
+                       size_t i_begin,
+                       size_t i_end,
+                       size_t i_count,
+                       const fsm_event_t *const i_events,
+                       size_t i_steps)
+{
+  const int32_t *table = i_this->table;
+  const uint32_t lastColumn = i_this->rowSize - 1u;
+  for (size_t i = i_begin; i < i_end; i++)
+  {
+    int32_t cursor = io_cursors[i];
+    for (size_t s = 0; s < i_steps; s++)
+    {
+      uint32_t event = (uint32_t)i_events[s * i_count + i];
+      cursor = table[cursor + (int32_t)((event < lastColumn) ? event : lastColumn)];
+    }
+    io_cursors[i] = cursor;
+  }
+}
+
+#if FSM_SIMD_X86
+__attribute__((target("avx2"))) static size_t run_avx2(const fsm_simd_t *const i_this,
+                                                        int32_t *const io_cursors,
+                                                        size_t i_count,
+                                                        const fsm_event_t *const i_events,
+                                                        size_t i_steps)
+{
+  const size_t vectors = i_count / 8u;
+  const __m256i lastColumn = _mm256_set1_epi32((int32_t)(i_this->rowSize - 1u));
+
+  /* Step by step over all vectors, independent gathers overlap */
+  for (size_t s = 0; s < i_steps; s++)
+  {
+    const fsm_event_t *events = &i_events[s * i_count];
+    for (size_t v = 0; v < vectors; v++)
+    {
+      __m256i cursor = _mm256_loadu_si256((const __m256i *)&io_cursors[v * 8u]);
+      __m256i event = _mm256_loadu_si256((const __m256i *)&events[v * 8u]);
+      event = _mm256_min_epu32(event, lastColumn);
+      cursor = _mm256_i32gather_epi32(i_this->table, _mm256_add_epi32(cursor, event), 4);
+      _mm256_storeu_si256((__m256i *)&io_cursors[v * 8u], cursor);
+    }
+  }
+  return vectors * 8u;
+}
+
+__attribute__((target("avx512f"))) static size_t run_avx512(const fsm_simd_t *const i_this,
+                                                            int32_t *const io_cursors,
+                                                            size_t i_count,
+                                                            const fsm_event_t *const i_events,
+                                                            size_t i_steps)
+{
+  const size_t vectors = i_count / 16u;
+  const __m512i lastColumn = _mm512_set1_epi32((int32_t)(i_this->rowSize - 1u));
+
+  /* Step by step over all vectors, independent gathers overlap */
+  for (size_t s = 0; s < i_steps; s++)
+  {
+    const fsm_event_t *events = &i_events[s * i_count];
+    for (size_t v = 0; v < vectors; v++)
+    {
+      __m512i cursor = _mm512_loadu_si512((const void *)&io_cursors[v * 16u]);
+      __m512i event = _mm512_loadu_si512((const void *)&events[v * 16u]);
+      event = _mm512_min_epu32(event, lastColumn);
+      cursor = _mm512_i32gather_epi32(_mm512_add_epi32(cursor, event), (const void *)i_this->table, 4);
+      _mm512_storeu_si512((void *)&io_cursors[v * 16u], cursor);
+    }
+  }
+  return vectors * 16u;
+}
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file       fsm_simd.h
+ * @brief      Lockstep kernel for action free FSMs over many instances
+ *
+ *             Advances many instances of one configuration at once, each with
+ *             its own event stream, for machines which only classify: no
+ *             actions, no guards, no sub fsms or regions and no timed
+ *             transitions, only the reached state matters. fsm_simd_init
+ *             checks that the configuration qualifies and flattens it into a
+ *             dense table of (event enum size + 1) cells per state, the last
+ *             column catches out of range events. A step is one gather per
+ *             vector of instances: AVX-512 or AVX2 where the CPU supports it
+ *             (GCC/Clang on x86), scalar otherwise.
+ *             The cursor per instance is the row offset of its state in the
+ *             table, use fsm_simd_get_state to read the state.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_SIMD_H_
+#define FSM_SIMD_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#include <stddef.h> /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Number of int32_t table cells for a configuration with n states
+ */
+#define FSM_SIMD_TABLE_SIZE(n) FSM_SIMD_TABLE_SIZE_FOR((n), FSM_EVENT_COUNT)
+
+/**
+ * @brief Number of table cells for n states of a machine with its own event enum
+ */
+#define FSM_SIMD_TABLE_SIZE_FOR(n, eventEnumCount) ((n) * ((uint32_t)(eventEnumCount) + 1u))
+
+/**
+ * @brief Instruction set used by the kernel
+ */
+typedef enum
+{
+  FSM_SIMD_ISA_SCALAR, /**< Portable scalar loop */
+  FSM_SIMD_ISA_AVX2,   /**< 8 instances per gather */
+  FSM_SIMD_ISA_AVX512, /**< 16 instances per gather */
+} fsm_simd_isa_t;
+
+/**
+ * @brief Kernel Struct
+ */
+typedef struct
+{
+  const fsm_cfg_t *config; /**< The flattened configuration */
+  int32_t *table;          /**< Row offset of the next state per state and event */
+  uint32_t rowSize;        /**< Size of the event enum + 1 */
+  uint32_t initialRow;     /**< Row offset of the initial state */
+  fsm_simd_isa_t isa;      /**< Best supported instruction set, may be lowered */
+} fsm_simd_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Check a configuration and flatten it into the table
+ *
+ * @param o_this Pointer to the kernel to initialize
+ * @param i_config The configuration
+ * @param i_table Storage for FSM_SIMD_TABLE_SIZE(statesCount) cells,
+ *                FSM_SIMD_TABLE_SIZE_FOR for a machine with its own enums
+ * @param i_tableSize Number of cells in the storage
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_CONFIG if the
+ *         configuration has actions, guards, sub fsms, regions, timed
+ *         transitions or undefined target states, error code otherwise
+ */
+fsm_RC_t fsm_simd_init(fsm_simd_t *const o_this,
+                       const fsm_cfg_t *const i_config,
+                       int32_t *const i_table,
+                       uint32_t i_tableSize);
+
+/**
+ * @brief Reset instances to the initial state
+ *
+ * @param i_this Pointer to the kernel
+ * @param o_cursors Cursors of the instances
+ * @param i_count Number of instances
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_simd_reset(const fsm_simd_t *const i_this, int32_t *const o_cursors, size_t i_count);
+
+/**
+ * @brief Process event streams, one event per instance and step
+ *
+ * The events are stored step by step: event s of instance i is
+ * i_events[s * i_count + i].
+ *
+ * @param i_this Pointer to the kernel
+ * @param io_cursors Cursors of the instances
+ * @param i_count Number of instances
+ * @param i_events The events
+ * @param i_steps Number of events per instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_simd_run(const fsm_simd_t *const i_this,
+                      int32_t *const io_cursors,
+                      size_t i_count,
+                      const fsm_event_t *const i_events,
+                      size_t i_steps);
+
+/**
+ * @brief Get the state of an instance
+ *
+ * @param i_this Pointer to the kernel
+ * @param i_cursor Cursor of the instance
+ * @param o_state The state
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the cursor is not
+ *         a row offset, error code otherwise
+ */
+fsm_RC_t fsm_simd_get_state(const fsm_simd_t *const i_this, int32_t i_cursor, fsm_state_t *const o_state);
+
+#endif /* FSM_SIMD_H_ */
@@ -0,0 +1,727 @@
+/**
+ * @file       fsm_snapshot.c
+ * @brief      Binary snapshot and restore of FSM instance states
+ *
+ *             Restoring validates the whole image before changing any
+ *             instance, so a mismatching image leaves the instances untouched.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_snapshot.h" /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+#include <string.h> /* for memcpy */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define RECORD_FIRST_RUN 0x8000u                   /**< First run flag of a record */
+#define RECORD_INDEX_MASK 0x7FFFu                  /**< State index of a record */
+#define ALIGN4(size) (((size) + 3u) & ~(size_t)3u) /**< Round up to 4 bytes */
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Count the sub fsm records of a configuration, depth first
+ *
+ * @param i_config The configuration
+ * @param i_depth Current nesting depth
+ * @param o_count Incremented by the number of records
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t count_sub_fsms(const fsm_cfg_t *const i_config, uint32_t i_depth, uint32_t *const o_count);
+
+/**
+ * @brief Encode the record of an instance
+ *
+ * @param i_fsm The instance
+ * @param o_record The record
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t encode_record(const fsm_t *const i_fsm, uint16_t *const o_record);
+
+/**
+ * @brief Count the levels of the active sub configurations of an instance
+ *
+ * @param i_fsm The instance
+ * @param o_count Number of levels
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t count_levels(const fsm_t *const i_fsm, uint32_t *const o_count);
+
+/**
+ * @brief Check or apply the level records of an instance
+ *
+ * The levels follow the state of the instance record.
+ *
+ * @param io_fsm The instance
+ * @param i_record The record of the instance
+ * @param io_records Position to read from, advanced
+ * @param i_available Number of records available for the levels
+ * @param i_apply false to only check the records, true to restore them
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t read_levels(fsm_t *const io_fsm,
+                            uint16_t i_record,
+                            const uint16_t **const io_records,
+                            size_t i_available,
+                            bool i_apply);
+
+/**
+ * @brief Write the sub fsm records of a configuration, depth first
+ *
+ * @param i_config The configuration
+ * @param io_records Position to write to, advanced
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t write_sub_fsms(const fsm_cfg_t *const i_config, uint16_t **const io_records);
+
+/**
+ * @brief Check or apply the sub fsm records of a configuration, depth first
+ *
+ * @param i_config The configuration
+ * @param io_records Position to read from, advanced
+ * @param i_apply false to only check the records, true to restore them
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t read_sub_fsms(const fsm_cfg_t *const i_config, const uint16_t **const io_records, bool i_apply);
+
+/**
+ * @brief Number of orthogonal regions of a state
+ *
+ * @param i_stateCfg The state
+ *
+ * @return Number of regions, 0 if none
+ */
+static uint32_t regions_count(const fsm_state_cfg_t *const i_stateCfg);
+
+/**
+ * @brief Write the region records of the current state of an instance
+ *
+ * @param i_fsm The instance
+ * @param i_stateCfg The current state
+ * @param io_records Position to write to, advanced
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t write_regions(const fsm_t *const i_fsm, const fsm_state_cfg_t *const i_stateCfg, uint16_t **const io_records);
+
+/**
+ * @brief Check or apply the region records of an instance
+ *
+ * The region records follow the level records.
+ *
+ * @param io_fsm The instance
+ * @param i_record The record of the instance
+ * @param io_records Position to read from, advanced
+ * @param i_available Number of records available for the regions
+ * @param i_apply false to only check the records, true to restore them
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t read_regions(fsm_t *const io_fsm,
+                             uint16_t i_record,
+                             const uint16_t **const io_records,
+                             size_t i_available,
+                             bool i_apply);
+
+/**
+ * @brief Check or apply the record of an instance
+ *
+ * @param io_fsm The instance
+ * @param i_record The record
+ * @param i_apply false to only check the record, true to restore it
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t read_record(fsm_t *const io_fsm, uint16_t i_record, bool i_apply);
+
+/**
+ * @brief Check the header of an image
+ *
+ * @param i_image The image
+ * @param i_imageSize Size of the image
+ * @param i_kind Expected kind
+ * @param i_config Configuration to count the sub fsms of
+ * @param o_header Copy of the header
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t check_header(const void *const i_image, size_t i_imageSize, fsm_snapshot_kind_t i_kind,
+                             const fsm_cfg_t *const i_config, fsm_snapshot_header_t *const o_header);
+
+/**
+ * @brief Size of the instance part of a pool image
+ *
+ * @param i_instanceCount Number of instances
+ *
+ * @return Size in bytes, multiple of 4
+ */
+static size_t pool_instances_size(uint32_t i_instanceCount);
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_snapshot(const fsm_t *const i_fsm, void *const o_image, size_t i_imageSize, size_t *const o_size)
+{
+  if (i_fsm == NULL || o_size == NULL || i_fsm->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  uint32_t subFsmCount = 0;
+  uint32_t levelsCount = 0;
+  fsm_RC_t res = count_sub_fsms(i_fsm->config, 0, &subFsmCount);
+  if (res == FSM_RC_OK)
+  {
+    res = count_levels(i_fsm, &levelsCount);
+  }
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  const fsm_state_cfg_t *currStateCfg = fsm_get_state_cfg(i_fsm->config, i_fsm->currentState);
+  uint32_t regionsCount = regions_count(currStateCfg);
+  *o_size = sizeof(fsm_snapshot_header_t) + sizeof(uint16_t) * (1u + levelsCount + regionsCount + subFsmCount);
+  if (o_image == NULL)
+  {
+    return FSM_RC_OK;
+  }
+  if (i_imageSize < *o_size)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_snapshot_header_t header = {FSM_SNAPSHOT_MAGIC, FSM_SNAPSHOT_VERSION, FSM_SNAPSHOT_KIND_FSM, 1, subFsmCount};
+  memcpy(o_image, &header, sizeof(header));
+  uint16_t *records = (uint16_t *)((uint8_t *)o_image + sizeof(header));
+  res = encode_record(i_fsm, records++);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  /* Level records, count_levels checked the states */
+  const fsm_state_cfg_t *stateCfg = currStateCfg;
+  for (uint32_t level = 0; level < levelsCount; level++)
+  {
+    const fsm_cfg_t *subCfg = stateCfg->subCfg;
+    stateCfg = fsm_get_state_cfg(subCfg, i_fsm->subStates[level]);
+    uint16_t record = (uint16_t)(stateCfg - subCfg->states);
+    memcpy(records++, &record, sizeof(record));
+  }
+  res = write_regions(i_fsm, currStateCfg, &records);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  return write_sub_fsms(i_fsm->config, &records);
+}
+
+fsm_RC_t fsm_restore(fsm_t *const io_fsm, const void *const i_image, size_t i_imageSize)
+{
+  if (io_fsm == NULL || i_image == NULL || io_fsm->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_snapshot_header_t header;
+  fsm_RC_t res = check_header(i_image, i_imageSize, FSM_SNAPSHOT_KIND_FSM, io_fsm->config, &header);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  if (header.instanceCount != 1 ||
+      i_imageSize < sizeof(header) + sizeof(uint16_t) * (1u + header.subFsmCount))
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Check everything first, then apply */
+  for (int pass = 0; pass < 2; pass++)
+  {
+    bool apply = (pass == 1);
+    const uint16_t *start = (const uint16_t *)((const uint8_t *)i_image + sizeof(header));
+    const uint16_t *records = start;
+    size_t available = (i_imageSize - sizeof(header)) / sizeof(uint16_t) - 1u - header.subFsmCount;
+    uint16_t record;
+    memcpy(&record, records++, sizeof(record));
+    res = read_record(io_fsm, record, apply);
+    if (res == FSM_RC_OK)
+    {
+      res = read_levels(io_fsm, record, &records, available, apply);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = read_regions(io_fsm, record, &records, available - (size_t)(records - start - 1), apply);
+    }
+    if (res == FSM_RC_OK)
+    {
+      res = read_sub_fsms(io_fsm->config, &records, apply);
+    }
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_pool_snapshot(const fsm_pool_t *const i_pool, void *const o_image, size_t i_imageSize, size_t *const o_size)
+{
+  if (i_pool == NULL || o_size == NULL || i_pool->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  uint32_t subFsmCount = 0;
+  fsm_RC_t res = count_sub_fsms(i_pool->config, 0, &subFsmCount);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  size_t instancesSize = pool_instances_size(i_pool->instancesCount);
+  *o_size = sizeof(fsm_snapshot_header_t) + instancesSize + sizeof(uint16_t) * subFsmCount;
+  if (o_image == NULL)
+  {
+    return FSM_RC_OK;
+  }
+  if (i_imageSize < *o_size)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_snapshot_header_t header = {FSM_SNAPSHOT_MAGIC, FSM_SNAPSHOT_VERSION, FSM_SNAPSHOT_KIND_POOL,
+                                  i_pool->instancesCount, subFsmCount};
+  uint8_t *pos = (uint8_t *)o_image;
+  memcpy(pos, &header, sizeof(header));
+  pos += sizeof(header);
+
+  /* The instance arrays in the same layout as the pool storage */
+  size_t stateSize = sizeof(fsm_index_t) * i_pool->instancesCount;
+  memcpy(pos, i_pool->stateIndex, stateSize);
+  memset(pos + stateSize, 0, ALIGN4(stateSize) - stateSize);
+  memcpy(pos + ALIGN4(stateSize), i_pool->firstRunBits,
+         sizeof(uint32_t) * FSM_POOL_FIRST_RUN_WORDS(i_pool->instancesCount));
+  pos += instancesSize;
+
+  uint16_t *records = (uint16_t *)pos;
+  return write_sub_fsms(i_pool->config, &records);
+}
+
+fsm_RC_t fsm_pool_restore(fsm_pool_t *const io_pool, const void *const i_image, size_t i_imageSize)
+{
+  if (io_pool == NULL || i_image == NULL || io_pool->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_snapshot_header_t header;
+  fsm_RC_t res = check_header(i_image, i_imageSize, FSM_SNAPSHOT_KIND_POOL, io_pool->config, &header);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  size_t instancesSize = pool_instances_size(header.instanceCount);
+  if (header.instanceCount != io_pool->instancesCount ||
+      i_imageSize < sizeof(header) + instancesSize + sizeof(uint16_t) * header.subFsmCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  const uint8_t *pos = (const uint8_t *)i_image + sizeof(header);
+  size_t stateSize = sizeof(fsm_index_t) * header.instanceCount;
+
+  /* Check everything first, then apply */
+  for (uint32_t i = 0; i < header.instanceCount; i++)
+  {
+    fsm_index_t index;
+    memcpy(&index, pos + sizeof(fsm_index_t) * i, sizeof(index));
+    if (index >= io_pool->config->statesCount)
+    {
+      return FSM_RC_ERROR_INVALID_ARG;
+    }
+  }
+  const uint16_t *records = (const uint16_t *)(pos + instancesSize);
+  res = read_sub_fsms(io_pool->config, &records, false);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  memcpy(io_pool->stateIndex, pos, stateSize);
+  memcpy(io_pool->firstRunBits, pos + ALIGN4(stateSize),
+         sizeof(uint32_t) * FSM_POOL_FIRST_RUN_WORDS(header.instanceCount));
+  if (io_pool->routeHeads != NULL)
+  {
+    /* Sort the restored instances into the route buckets again */
+    fsm_pool_route_sort(io_pool);
+  }
+  records = (const uint16_t *)(pos + instancesSize);
+  return read_sub_fsms(io_pool->config, &records, true);
+}
+
+fsm_RC_t fsm_pool_restore_in_place(fsm_pool_t *const o_pool,
+                                   const fsm_cfg_t *const i_config,
+                                   void *const io_image,
+                                   size_t i_imageSize)
+{
+  if (o_pool == NULL || i_config == NULL || io_image == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (((uintptr_t)io_image & 3u) != 0)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Same checks as fsm_pool_init */
+  fsm_index_t initialIndex = 0;
+  fsm_RC_t res = fsm_pool_prepare_config(i_config, &initialIndex);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  fsm_snapshot_header_t header;
+  res = check_header(io_image, i_imageSize, FSM_SNAPSHOT_KIND_POOL, i_config, &header);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  size_t instancesSize = pool_instances_size(header.instanceCount);
+  if (i_imageSize < sizeof(header) + instancesSize + sizeof(uint16_t) * header.subFsmCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* Check everything first, then apply */
+  uint8_t *pos = (uint8_t *)io_image + sizeof(header);
+  fsm_index_t *stateIndex = (fsm_index_t *)pos;
+  for (uint32_t i = 0; i < header.instanceCount; i++)
+  {
+    if (stateIndex[i] >= i_config->statesCount)
+    {
+      return FSM_RC_ERROR_INVALID_ARG;
+    }
+  }
+  const uint16_t *records = (const uint16_t *)(pos + instancesSize);
+  res = read_sub_fsms(i_config, &records, false);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+
+  o_pool->config = i_config;
+  o_pool->stateIndex = stateIndex;
+  o_pool->firstRunBits = (uint32_t *)(pos + ALIGN4(sizeof(fsm_index_t) * header.instanceCount));
+  o_pool->instancesCount = header.instanceCount;
+  o_pool->initialIndex = initialIndex;
+  o_pool->routeNext = NULL;
+  o_pool->routePrev = NULL;
+  o_pool->routeHeads = NULL;
+  records = (const uint16_t *)(pos + instancesSize);
+  return read_sub_fsms(i_config, &records, true);
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static fsm_RC_t count_sub_fsms(const fsm_cfg_t *const i_config, uint32_t i_depth, uint32_t *const o_count)
+{
+  if (i_depth >= FSM_SNAPSHOT_MAX_DEPTH)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    fsm_RC_t res = FSM_RC_OK;
+    if (stateCfg->subFsm != NULL)
+    {
+      if (stateCfg->subFsm->config == NULL)
+      {
+        return FSM_RC_ERROR_NULLPTR;
+      }
+      (*o_count)++;
+      res = count_sub_fsms(stateCfg->subFsm->config, i_depth + 1u, o_count);
+    }
+    /* The region states are part of the instance, only their sub fsms have records */
+    for (uint32_t r = 0; res == FSM_RC_OK && r < regions_count(stateCfg); r++)
+    {
+      res = count_sub_fsms(stateCfg->regions->configs[r], i_depth + 1u, o_count);
+    }
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t encode_record(const fsm_t *const i_fsm, uint16_t *const o_record)
+{
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(i_fsm->config, i_fsm->currentState);
+  if (stateCfg == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+  uint32_t index = (uint32_t)(stateCfg - i_fsm->config->states);
+  if (index > RECORD_INDEX_MASK)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  uint16_t record = (uint16_t)index;
+  if (i_fsm->isFirstRun == true)
+  {
+    record |= RECORD_FIRST_RUN;
+  }
+  memcpy(o_record, &record, sizeof(record));
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t count_levels(const fsm_t *const i_fsm, uint32_t *const o_count)
+{
+  const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(i_fsm->config, i_fsm->currentState);
+  uint32_t level = 0;
+  while (stateCfg != NULL && stateCfg->subCfg != NULL && level < FSM_MAX_DEPTH)
+  {
+    const fsm_cfg_t *subCfg = stateCfg->subCfg;
+    stateCfg = fsm_get_state_cfg(subCfg, i_fsm->subStates[level++]);
+    if (stateCfg != NULL && (uint32_t)(stateCfg - subCfg->states) > RECORD_INDEX_MASK)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+  }
+  if (stateCfg == NULL)
+  {
+    return FSM_RC_ERROR_INVALID_CONFIG;
+  }
+
+  *o_count = level;
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t read_levels(fsm_t *const io_fsm,
+                            uint16_t i_record,
+                            const uint16_t **const io_records,
+                            size_t i_available,
+                            bool i_apply)
+{
+  const fsm_state_cfg_t *stateCfg = &io_fsm->config->states[i_record & RECORD_INDEX_MASK];
+  for (uint32_t level = 0; level < FSM_MAX_DEPTH && stateCfg->subCfg != NULL; level++)
+  {
+    const fsm_cfg_t *subCfg = stateCfg->subCfg;
+    uint16_t record;
+    if (level >= i_available)
+    {
+      return FSM_RC_ERROR_INVALID_ARG;
+    }
+    memcpy(&record, (*io_records)++, sizeof(record));
+    if (record >= subCfg->statesCount)
+    {
+      return FSM_RC_ERROR_INVALID_ARG;
+    }
+    stateCfg = &subCfg->states[record];
+    if (i_apply == true)
+    {
+      io_fsm->subStates[level] = stateCfg->state;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t write_sub_fsms(const fsm_cfg_t *const i_config, uint16_t **const io_records)
+{
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    fsm_RC_t res = FSM_RC_OK;
+    if (stateCfg->subFsm != NULL)
+    {
+      res = encode_record(stateCfg->subFsm, (*io_records)++);
+      if (res == FSM_RC_OK)
+      {
+        res = write_sub_fsms(stateCfg->subFsm->config, io_records);
+      }
+    }
+    for (uint32_t r = 0; res == FSM_RC_OK && r < regions_count(stateCfg); r++)
+    {
+      res = write_sub_fsms(stateCfg->regions->configs[r], io_records);
+    }
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t read_sub_fsms(const fsm_cfg_t *const i_config, const uint16_t **const io_records, bool i_apply)
+{
+  for (uint32_t i = 0; i < i_config->statesCount; i++)
+  {
+    const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+    fsm_RC_t res = FSM_RC_OK;
+    if (stateCfg->subFsm != NULL)
+    {
+      uint16_t record;
+      memcpy(&record, (*io_records)++, sizeof(record));
+      res = read_record((fsm_t *)stateCfg->subFsm, record, i_apply);
+      if (res == FSM_RC_OK)
+      {
+        res = read_sub_fsms(stateCfg->subFsm->config, io_records, i_apply);
+      }
+    }
+    for (uint32_t r = 0; res == FSM_RC_OK && r < regions_count(stateCfg); r++)
+    {
+      res = read_sub_fsms(stateCfg->regions->configs[r], io_records, i_apply);
+    }
+    if (res != FSM_RC_OK)
+    {
+      return res;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static uint32_t regions_count(const fsm_state_cfg_t *const i_stateCfg)
+{
+  return (i_stateCfg->regions != NULL) ? i_stateCfg->regions->count : 0u;
+}
+
+static fsm_RC_t write_regions(const fsm_t *const i_fsm, const fsm_state_cfg_t *const i_stateCfg, uint16_t **const io_records)
+{
+  for (uint32_t r = 0; r < regions_count(i_stateCfg); r++)
+  {
+    const fsm_cfg_t *regionCfg = i_stateCfg->regions->configs[r];
+    const fsm_state_cfg_t *regionStateCfg = fsm_get_state_cfg(regionCfg, i_fsm->regionStates[r].state);
+    if (regionStateCfg == NULL || (uint32_t)(regionStateCfg - regionCfg->states) > RECORD_INDEX_MASK)
+    {
+      return FSM_RC_ERROR_INVALID_CONFIG;
+    }
+    uint16_t record = (uint16_t)(regionStateCfg - regionCfg->states);
+    if (i_fsm->regionStates[r].isFirstRun == true)
+    {
+      record |= RECORD_FIRST_RUN;
+    }
+    memcpy((*io_records)++, &record, sizeof(record));
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t read_regions(fsm_t *const io_fsm,
+                             uint16_t i_record,
+                             const uint16_t **const io_records,
+                             size_t i_available,
+                             bool i_apply)
+{
+  const fsm_state_cfg_t *stateCfg = &io_fsm->config->states[i_record & RECORD_INDEX_MASK];
+  if (regions_count(stateCfg) > i_available)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  for (uint32_t r = 0; r < regions_count(stateCfg); r++)
+  {
+    const fsm_cfg_t *regionCfg = stateCfg->regions->configs[r];
+    uint16_t record;
+    memcpy(&record, (*io_records)++, sizeof(record));
+    if ((record & RECORD_INDEX_MASK) >= regionCfg->statesCount)
+    {
+      return FSM_RC_ERROR_INVALID_ARG;
+    }
+    if (i_apply == true)
+    {
+      io_fsm->regionStates[r].state = regionCfg->states[record & RECORD_INDEX_MASK].state;
+      io_fsm->regionStates[r].isFirstRun = (record & RECORD_FIRST_RUN) != 0;
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t read_record(fsm_t *const io_fsm, uint16_t i_record, bool i_apply)
+{
+  uint32_t index = i_record & RECORD_INDEX_MASK;
+  if (io_fsm->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (index >= io_fsm->config->statesCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  if (i_apply == false)
+  {
+    return FSM_RC_OK;
+  }
+
+  const fsm_state_cfg_t *stateCfg = &io_fsm->config->states[index];
+  io_fsm->currentState = stateCfg->state;
+  io_fsm->isFirstRun = (i_record & RECORD_FIRST_RUN) != 0;
+
+  /* E.g. restart the timers of the restored state */
+  if (io_fsm->hooks != NULL)
+  {
+    if (io_fsm->isFirstRun == true)
+    {
+      fsm_hooks_reset(io_fsm);
+    }
+    else
+    {
+      fsm_hooks_enter(io_fsm, stateCfg);
+    }
+  }
+  return FSM_RC_OK;
+}
+
+static fsm_RC_t check_header(const void *const i_image, size_t i_imageSize, fsm_snapshot_kind_t i_kind,
+                             const fsm_cfg_t *const i_config, fsm_snapshot_header_t *const o_header)
+{
+  if (i_imageSize < sizeof(fsm_snapshot_header_t))
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  memcpy(o_header, i_image, sizeof(*o_header));
+  if (o_header->magic != FSM_SNAPSHOT_MAGIC ||
+      o_header->version != FSM_SNAPSHOT_VERSION ||
+      o_header->kind != (uint16_t)i_kind)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  /* The sub fsm structure must match the configuration */
+  uint32_t subFsmCount = 0;
+  fsm_RC_t res = count_sub_fsms(i_config, 0, &subFsmCount);
+  if (res != FSM_RC_OK)
+  {
+    return res;
+  }
+  if (subFsmCount != o_header->subFsmCount)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  return FSM_RC_OK;
+}
+
+static size_t pool_instances_size(uint32_t i_instanceCount)
+{
+  return ALIGN4(sizeof(fsm_index_t) * i_instanceCount) +
+         sizeof(uint32_t) * FSM_POOL_FIRST_RUN_WORDS((size_t)i_instanceCount);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file       fsm_snapshot.h
+ * @brief      Binary snapshot and restore of FSM instance states
+ *
+ *             Writes the current state, the first run flag and the states of
+ *             the nested sub configurations, sub fsms and regions into a
+ *             compact, versioned image in a caller provided buffer, ready for
+ *             a single sequential write.
+ *             Layout (native byte order, all offsets aligned):
+ *               header       fsm_snapshot_header_t
+ *               instance     pool: uint16_t stateIndex[count], padding to 4,
+ *                                  uint32_t firstRunBits[(count + 31) / 32]
+ *                            fsm:  one record, followed by one record per
+ *                                  active sub configuration level and one
+ *                                  per region of the current state
+ *               sub fsms     one record per sub fsm, depth first in
+ *                            configuration order, the sub fsms of the
+ *                            regions of a state after its own
+ *             A record is an uint16_t: bit 15 first run flag, bits 0..14 the
+ *             index of the current state in the states array.
+ *             A pool can use a writable (e.g. MAP_PRIVATE mmap'd) image in
+ *             place, without copying, see fsm_pool_restore_in_place.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_SNAPSHOT_H_
+#define FSM_SNAPSHOT_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_pool.h" /* Pool types */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_SNAPSHOT_MAGIC 0x534D5346u /**< "FSMS" */
+#define FSM_SNAPSHOT_VERSION 3u        /**< Current image version, 2: sub configuration records, 3: region records */
+#define FSM_SNAPSHOT_MAX_DEPTH 8u      /**< Maximum sub fsm nesting depth */
+
+/**
+ * @brief Kind of snapshot image
+ */
+typedef enum
+{
+  FSM_SNAPSHOT_KIND_FSM = 1,  /**< Image of one fsm_t */
+  FSM_SNAPSHOT_KIND_POOL = 2, /**< Image of a fsm_pool_t */
+} fsm_snapshot_kind_t;
+
+/**
+ * @brief Snapshot Image Header
+ */
+typedef struct
+{
+  uint32_t magic;         /**< FSM_SNAPSHOT_MAGIC */
+  uint16_t version;       /**< FSM_SNAPSHOT_VERSION */
+  uint16_t kind;          /**< fsm_snapshot_kind_t */
+  uint32_t instanceCount; /**< Instances in the image, 1 for a fsm_t */
+  uint32_t subFsmCount;   /**< Number of sub fsm records */
+} fsm_snapshot_header_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Write the snapshot of an instance and its sub fsms
+ *
+ * @param i_fsm The initialized FSM instance
+ * @param o_image Buffer for the image, null to only get the size
+ * @param i_imageSize Size of the buffer
+ * @param o_size Size of the image
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the buffer is too
+ *         small, error code otherwise
+ */
+fsm_RC_t fsm_snapshot(const fsm_t *const i_fsm, void *const o_image, size_t i_imageSize, size_t *const o_size);
+
+/**
+ * @brief Restore an instance and its sub fsms from a snapshot
+ *
+ * The instance and its sub fsms must be initialized with the configurations
+ * the snapshot was taken with. Bound timers of the restored state restart.
+ *
+ * @param io_fsm The initialized FSM instance
+ * @param i_image The image, e.g. mmap'd read only
+ * @param i_imageSize Size of the image
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the image does not
+ *         match, error code otherwise
+ */
+fsm_RC_t fsm_restore(fsm_t *const io_fsm, const void *const i_image, size_t i_imageSize);
+
+/**
+ * @brief Write the snapshot of a pool and the sub fsms of its configuration
+ *
+ * @param i_pool The initialized pool
+ * @param o_image Buffer for the image, null to only get the size
+ * @param i_imageSize Size of the buffer
+ * @param o_size Size of the image
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the buffer is too
+ *         small, error code otherwise
+ */
+fsm_RC_t fsm_pool_snapshot(const fsm_pool_t *const i_pool, void *const o_image, size_t i_imageSize, size_t *const o_size);
+
+/**
+ * @brief Restore a pool by copying from a snapshot into its storage
+ *
+ * An attached routing index is rebuilt.
+ *
+ * @param io_pool The initialized pool with the same instance count
+ * @param i_image The image
+ * @param i_imageSize Size of the image
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the image does not
+ *         match, error code otherwise
+ */
+fsm_RC_t fsm_pool_restore(fsm_pool_t *const io_pool, const void *const i_image, size_t i_imageSize);
+
+/**
+ * @brief Initialize a pool whose storage is the snapshot image itself
+ *
+ * The instance arrays of the pool point into the image, nothing is copied.
+ * The image must stay mapped and writable (e.g. MAP_PRIVATE) and be aligned
+ * to 4 bytes. The sub fsms of the configuration are restored by copying. The
+ * pool has no routing index, see fsm_pool_route.
+ *
+ * @param o_pool The pool to initialize
+ * @param i_config The configuration the snapshot was taken with
+ * @param io_image The image
+ * @param i_imageSize Size of the image
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the image does not
+ *         match, FSM_RC_ERROR_INVALID_CONFIG if fsm_pool_init would reject the
+ *         configuration, error code otherwise
+ */
+fsm_RC_t fsm_pool_restore_in_place(fsm_pool_t *const o_pool,
+                                   const fsm_cfg_t *const i_config,
+                                   void *const io_image,
+                                   size_t i_imageSize);
+
+#endif /* FSM_SNAPSHOT_H_ */
@@ -0,0 +1,415 @@
+/**
+ * @file       fsm_timer.c
+ * @brief      Timed transitions driven by a hierarchical timing wheel
+ *
+ *             FSM_TIMER_WHEEL_LEVELS levels of FSM_TIMER_WHEEL_SLOTS slots.
+ *             Level n holds the timers expiring within 2^(6(n+1)) ticks and
+ *             is cascaded into the lower levels when level n-1 wraps around.
+ *             Every slot is a circular doubly linked list, so a timer can be
+ *             unlinked in O(1) without knowing its slot.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm_timer.h"    /* Own header */
+#include "fsm_internal.h" /* Internal interface */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define SLOT_MASK ((uint64_t)FSM_TIMER_WHEEL_SLOTS - 1u) /**< Mask of a slot index */
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Initialize an empty list
+ *
+ * @param o_head The list head
+ */
+static void list_init(fsm_timer_t *const o_head);
+
+/**
+ * @brief Append a timer to a list
+ *
+ * @param io_head The list head
+ * @param io_timer The timer
+ */
+static void list_append(fsm_timer_t *const io_head, fsm_timer_t *const io_timer);
+
+/**
+ * @brief Remove a timer from the list it is in
+ *
+ * @param io_timer The timer
+ */
+static void list_unlink(fsm_timer_t *const io_timer);
+
+/**
+ * @brief Move all timers of a list to another, empty list
+ *
+ * @param io_from The source list, empty afterwards
+ * @param o_to The destination list head
+ */
+static void list_move(fsm_timer_t *const io_from, fsm_timer_t *const o_to);
+
+/**
+ * @brief Put a timer into the slot matching its expiry
+ *
+ * @param io_wheel The wheel
+ * @param io_timer The timer, expires set
+ */
+static void wheel_insert(fsm_timer_wheel_t *const io_wheel, fsm_timer_t *const io_timer);
+
+/**
+ * @brief Get the next tick visiting a non-empty slot
+ *
+ * Level n visits its slots every 2^(6n) ticks, a non-empty slot is due at its
+ * first visit after now. The ticks in between only visit empty slots.
+ *
+ * @param i_wheel The wheel
+ *
+ * @return The tick, UINT64_MAX if all slots are empty
+ */
+static uint64_t wheel_next_tick(const fsm_timer_wheel_t *const i_wheel);
+
+/**
+ * @brief Get the maximum number of timed transitions of a state
+ *
+ * @param i_config The fsm configuration
+ *
+ * @return The number of timers an instance needs
+ */
+static uint32_t timers_needed(const fsm_cfg_t *const i_config);
+
+/**
+ * @brief Arm the timers of the timed transitions of an entered state
+ *
+ * Cancels the timers of the previous state first. Hook operation enter.
+ *
+ * @param io_hook The timers of the instance
+ * @param io_fsm The FSM instance
+ * @param i_stateCfg The entered state
+ */
+static void timers_enter_state(fsm_hook_t *io_hook, fsm_t *io_fsm, const fsm_state_cfg_t *i_stateCfg);
+
+/**
+ * @brief Cancel all armed timers of an instance, hook operation reset
+ *
+ * @param io_hook The timers of the instance
+ * @param io_fsm The FSM instance
+ */
+static void timers_cancel(fsm_hook_t *io_hook, fsm_t *io_fsm);
+
+/******************************************************************************/
+/*** Private static variables                                                 */
+/******************************************************************************/
+static const fsm_hook_ops_t timersOps = {.enter = timers_enter_state, .reset = timers_cancel}; /**< Hook of the timers */
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+fsm_RC_t fsm_timer_wheel_init(fsm_timer_wheel_t *const io_this, uint64_t i_now)
+{
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  io_this->now = i_now;
+  io_this->armedCount = 0;
+  for (uint32_t level = 0; level < FSM_TIMER_WHEEL_LEVELS; level++)
+  {
+    for (uint32_t slot = 0; slot < FSM_TIMER_WHEEL_SLOTS; slot++)
+    {
+      list_init(&io_this->slots[level][slot]);
+    }
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_timers_bind(fsm_t *const io_fsm,
+                         fsm_timers_t *const io_timers,
+                         fsm_timer_wheel_t *const i_wheel,
+                         fsm_timer_t *const i_timers,
+                         uint32_t i_timersCount)
+{
+  if (io_fsm == NULL || io_timers == NULL || i_wheel == NULL || i_timers == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (io_fsm->config == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_timersCount < timers_needed(io_fsm->config))
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  fsm_hook_t *bound = fsm_hook_remove(io_fsm, &timersOps);
+  if (bound != NULL)
+  {
+    timers_cancel(bound, io_fsm);
+  }
+
+  io_timers->hook.ops = &timersOps;
+  io_timers->wheel = i_wheel;
+  io_timers->timers = i_timers;
+  io_timers->timersCount = i_timersCount;
+  for (uint32_t i = 0; i < i_timersCount; i++)
+  {
+    i_timers[i].next = NULL;
+    i_timers[i].prev = NULL;
+  }
+  fsm_hook_add(io_fsm, &io_timers->hook);
+
+  /* The initial state is entered with the first event, otherwise arm now */
+  if (io_fsm->isFirstRun == false)
+  {
+    const fsm_state_cfg_t *stateCfg = fsm_get_state_cfg(io_fsm->config, io_fsm->currentState);
+    if (stateCfg != NULL)
+    {
+      timers_enter_state(&io_timers->hook, io_fsm, stateCfg);
+    }
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_timers_unbind(fsm_t *const io_fsm)
+{
+  if (io_fsm == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_hook_t *bound = fsm_hook_remove(io_fsm, &timersOps);
+  if (bound != NULL)
+  {
+    timers_cancel(bound, io_fsm);
+  }
+  return FSM_RC_OK;
+}
+
+fsm_RC_t fsm_advance_time(fsm_timer_wheel_t *const io_this, uint64_t i_now, size_t *const o_fired)
+{
+  if (o_fired != NULL)
+  {
+    *o_fired = 0;
+  }
+  if (io_this == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  fsm_RC_t result = FSM_RC_OK;
+  while (io_this->now < i_now)
+  {
+    /* Nothing armed, skip ahead */
+    if (io_this->armedCount == 0)
+    {
+      io_this->now = i_now;
+      break;
+    }
+
+    /* Jump over the ticks visiting only empty slots */
+    uint64_t next = wheel_next_tick(io_this);
+    if (next > i_now)
+    {
+      io_this->now = i_now;
+      break;
+    }
+
+    io_this->now = next;
+    uint64_t now = io_this->now;
+
+    /* Cascade the upper levels when the level below wraps around */
+    for (uint32_t level = 1; level < FSM_TIMER_WHEEL_LEVELS; level++)
+    {
+      if (((now >> (FSM_TIMER_WHEEL_BITS * (level - 1u))) & SLOT_MASK) != 0)
+      {
+        break;
+      }
+      fsm_timer_t cascade;
+      list_move(&io_this->slots[level][(now >> (FSM_TIMER_WHEEL_BITS * level)) & SLOT_MASK], &cascade);
+      while (cascade.next != &cascade)
+      {
+        fsm_timer_t *timer = cascade.next;
+        list_unlink(timer);
+        wheel_insert(io_this, timer);
+      }
+    }
+
+    /* Collect the expired timers and fire them as a batch. Processing an */
+    /* event may cancel timers of the batch, which unlinks them from it.   */
+    fsm_timer_t expired;
+    list_move(&io_this->slots[0][now & SLOT_MASK], &expired);
+    while (expired.next != &expired)
+    {
+      fsm_timer_t *timer = expired.next;
+      list_unlink(timer);
+      io_this->armedCount--;
+
+      if (timer->period > 0)
+      {
+        timer->expires = now + timer->period;
+        wheel_insert(io_this, timer);
+        io_this->armedCount++;
+      }
+
+      fsm_RC_t res = fsm_process(timer->fsm, timer->event);
+      if (res != FSM_RC_OK && result == FSM_RC_OK)
+      {
+        result = res;
+      }
+      if (o_fired != NULL)
+      {
+        (*o_fired)++;
+      }
+    }
+  }
+  return result;
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static void timers_enter_state(fsm_hook_t *io_hook, fsm_t *io_fsm, const fsm_state_cfg_t *i_stateCfg)
+{
+  fsm_timers_t *timers = (fsm_timers_t *)io_hook;
+  timers_cancel(io_hook, io_fsm);
+
+  uint32_t used = 0;
+  for (uint32_t i = 0; i < i_stateCfg->transitionsCount && used < timers->timersCount; i++)
+  {
+    const fsm_transition_cfg_t *transitionCfg = &i_stateCfg->transitions[i];
+    if (transitionCfg->after == 0 && transitionCfg->every == 0)
+    {
+      continue;
+    }
+
+    fsm_timer_t *timer = &timers->timers[used++];
+    timer->fsm = io_fsm;
+    timer->event = transitionCfg->event;
+    timer->period = transitionCfg->every;
+    timer->expires = timers->wheel->now + ((transitionCfg->after > 0) ? transitionCfg->after : transitionCfg->every);
+    wheel_insert(timers->wheel, timer);
+    timers->wheel->armedCount++;
+  }
+}
+
+static void timers_cancel(fsm_hook_t *io_hook, fsm_t *io_fsm)
+{
+  fsm_timers_t *timers = (fsm_timers_t *)io_hook;
+  (void)io_fsm;
+  for (uint32_t i = 0; i < timers->timersCount; i++)
+  {
+    if (timers->timers[i].next != NULL)
+    {
+      list_unlink(&timers->timers[i]);
+      timers->wheel->armedCount--;
+    }
+  }
+}
+
+static void list_init(fsm_timer_t *const o_head)
+{
+  o_head->next = o_head;
+  o_head->prev = o_head;
+}
+
+static void list_append(fsm_timer_t *const io_head, fsm_timer_t *const io_timer)
+{
+  io_timer->prev = io_head->prev;
+  io_timer->next = io_head;
+  io_head->prev->next = io_timer;
+  io_head->prev = io_timer;
+}
+
+static void list_unlink(fsm_timer_t *const io_timer)
+{
+  io_timer->prev->next = io_timer->next;
+  io_timer->next->prev = io_timer->prev;
+  io_timer->next = NULL;
+  io_timer->prev = NULL;
+}
+
+static void list_move(fsm_timer_t *const io_from, fsm_timer_t *const o_to)
+{
+  if (io_from->next == io_from)
+  {
+    list_init(o_to);
+    return;
+  }
+  o_to->next = io_from->next;
+  o_to->prev = io_from->prev;
+  o_to->next->prev = o_to;
+  o_to->prev->next = o_to;
+  list_init(io_from);
+}
+
+static void wheel_insert(fsm_timer_wheel_t *const io_wheel, fsm_timer_t *const io_timer)
+{
+  uint64_t delta = (io_timer->expires > io_wheel->now) ? io_timer->expires - io_wheel->now : 0;
+  /* Beyond the range, park in the last level and re-insert on cascade */
+  if (delta >= FSM_TIMER_WHEEL_RANGE)
+  {
+    delta = FSM_TIMER_WHEEL_RANGE - 1u;
+  }
+
+  uint32_t level = 0;
+  while (level + 1u < FSM_TIMER_WHEEL_LEVELS && delta >= (1ull << (FSM_TIMER_WHEEL_BITS * (level + 1u))))
+  {
+    level++;
+  }
+  uint64_t at = io_wheel->now + delta;
+  list_append(&io_wheel->slots[level][(at >> (FSM_TIMER_WHEEL_BITS * level)) & SLOT_MASK], io_timer);
+}
+
+static uint64_t wheel_next_tick(const fsm_timer_wheel_t *const i_wheel)
+{
+  uint64_t next = UINT64_MAX;
+  for (uint32_t level = 0; level < FSM_TIMER_WHEEL_LEVELS; level++)
+  {
+    /* The next FSM_TIMER_WHEEL_SLOTS visits cover every slot of the level once */
+    const uint32_t shift = FSM_TIMER_WHEEL_BITS * level;
+    uint64_t tick = ((i_wheel->now >> shift) + 1u) << shift;
+    for (uint32_t i = 0; i < FSM_TIMER_WHEEL_SLOTS && tick < next; i++, tick += 1ull << shift)
+    {
+      const fsm_timer_t *head = &i_wheel->slots[level][(tick >> shift) & SLOT_MASK];
+      if (head->next != head)
+      {
+        next = tick;
+        break;
+      }
+    }
+  }
+  return next;
+}
+
+static uint32_t timers_needed(const fsm_cfg_t *const i_config)
+{
+  uint32_t needed = 0;
+  for (uint32_t s = 0; s < i_config->statesCount; s++)
+  {
+    uint32_t count = 0;
+    for (uint32_t t = 0; t < i_config->states[s].transitionsCount; t++)
+    {
+      if (i_config->states[s].transitions[t].after > 0 || i_config->states[s].transitions[t].every > 0)
+      {
+        count++;
+      }
+    }
+    if (count > needed)
+    {
+      needed = count;
+    }
+  }
+  return needed;
+}
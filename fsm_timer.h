@@ -0,0 +1,136 @@
+/**
+ * @file       fsm_timer.h
+ * @brief      Timed transitions driven by a hierarchical timing wheel
+ *
+ *             A transition with after and/or every set gets its event raised
+ *             by the wheel while its state is active:
+ *             once after "after" ticks, then every "every" ticks
+ *             (starting after "every" ticks if after is 0).
+ *             Timers are armed when the state is entered (for the initial
+ *             state on the first processed event, together with its entry
+ *             action) and cancelled when the state is left or the FSM is
+ *             reset. Arm and cancel are O(1). The unit of a tick is up to the
+ *             caller of fsm_advance_time, e.g. ms.
+ *             The wheel must be advanced on the thread processing the bound
+ *             instances. Instances of a fsm_pool_t and the dispatchers
+ *             generated by fsm_gen.h do not arm timers.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_TIMER_H_
+#define FSM_TIMER_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+#define FSM_TIMER_WHEEL_BITS 6u                               /**< log2 of the slots per level */
+#define FSM_TIMER_WHEEL_SLOTS (1u << FSM_TIMER_WHEEL_BITS)    /**< Slots per level */
+#define FSM_TIMER_WHEEL_LEVELS 4u                             /**< Levels, range 2^24 ticks */
+#define FSM_TIMER_WHEEL_RANGE (1ull << (FSM_TIMER_WHEEL_BITS * FSM_TIMER_WHEEL_LEVELS))
+
+/**
+ * @brief Timer, one per armed timed transition
+ *
+ * Also used as list head of the wheel slots.
+ */
+typedef struct fsm_timer
+{
+  struct fsm_timer *next; /**< Next timer in the slot list */
+  struct fsm_timer *prev; /**< Previous timer in the slot list */
+  uint64_t expires;       /**< Tick the timer fires */
+  fsm_t *fsm;             /**< Instance the event is raised in */
+  fsm_event_t event;      /**< Event raised on expiry */
+  uint32_t period;        /**< Ticks until re-firing, 0 for one shot */
+} fsm_timer_t;
+
+/**
+ * @brief Hierarchical Timing Wheel
+ */
+typedef struct fsm_timer_wheel
+{
+  uint64_t now;                                                    /**< Current tick */
+  uint32_t armedCount;                                             /**< Number of armed timers */
+  fsm_timer_t slots[FSM_TIMER_WHEEL_LEVELS][FSM_TIMER_WHEEL_SLOTS]; /**< List heads */
+} fsm_timer_wheel_t;
+
+/**
+ * @brief Timers of one instance
+ */
+typedef struct fsm_timers
+{
+  fsm_hook_t hook;          /**< Binding to the instance, first member */
+  fsm_timer_wheel_t *wheel; /**< The wheel driving the timers */
+  fsm_timer_t *timers;      /**< Storage, one timer per timed transition of a state */
+  uint32_t timersCount;     /**< Number of timers in the storage */
+} fsm_timers_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Initialize a timing wheel
+ *
+ * @param io_this Pointer to the wheel
+ * @param i_now The current tick
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_timer_wheel_init(fsm_timer_wheel_t *const io_this, uint64_t i_now);
+
+/**
+ * @brief Bind timers to an initialized FSM instance
+ *
+ * The storage must hold at least as many timers as the state with the most
+ * timed transitions. If the instance already ran, the timers of its current
+ * state are armed. Unbind before calling fsm_init on the instance again.
+ *
+ * @param io_fsm The FSM instance
+ * @param io_timers Pointer to the binding, must stay valid
+ * @param i_wheel The wheel driving the timers
+ * @param i_timers Timer storage
+ * @param i_timersCount Number of timers in the storage
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_timers_bind(fsm_t *const io_fsm,
+                         fsm_timers_t *const io_timers,
+                         fsm_timer_wheel_t *const i_wheel,
+                         fsm_timer_t *const i_timers,
+                         uint32_t i_timersCount);
+
+/**
+ * @brief Cancel the timers of an instance and remove the binding
+ *
+ * @param io_fsm The FSM instance
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+fsm_RC_t fsm_timers_unbind(fsm_t *const io_fsm);
+
+/**
+ * @brief Advance the wheel and raise the events of all expired timers
+ *
+ * Expired timers are collected per tick and fired as a batch through
+ * fsm_process. An error of fsm_process does not stop the other timers.
+ * Ticks visiting only empty slots are skipped, the cost depends on the
+ * number of due slots, not on the number of elapsed ticks.
+ *
+ * @param io_this Pointer to the wheel
+ * @param i_now The current tick, must not go backwards
+ * @param o_fired [optional] Number of fired timers
+ *
+ * @return FSM_RC_OK on success, first error of fsm_process otherwise
+ */
+fsm_RC_t fsm_advance_time(fsm_timer_wheel_t *const io_this, uint64_t i_now, size_t *const o_fired);
+
+#endif /* FSM_TIMER_H_ */
@@ -0,0 +1,278 @@
+/**
+ * @file       fsm_trace.c
+ * @brief      Optional transition tracing and counters for the FSM
+ *
+ *             Ring buffers are thread local and only written and read by their
+ *             own thread. Counter blocks are shared, see fsm_trace.h, and
+ *             found by their configuration in a list which is only prepended
+ *             to, so processing threads walk it without a lock.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include "fsm_trace.h" /* Own header */
+
+#if FSM_TRACE
+
+#include "fsm_internal.h" /* Internal interface */
+
+#include <stdatomic.h> /* for atomics */
+#include <time.h>      /* for clock_gettime */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#ifndef FSM_TRACE_TIMESTAMP
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FSM_TRACE_TIMESTAMP() __builtin_ia32_rdtsc() /**< Cycle counter */
+#else
+#define FSM_TRACE_TIMESTAMP() monotonic_ns() /**< Portable fallback */
+#endif
+#endif
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Ring buffer of one thread
+ */
+typedef struct
+{
+  size_t written;                                  /**< Number of records written since reset */
+  uintptr_t instance;                              /**< Instance currently processed */
+  fsm_trace_record_t records[FSM_TRACE_RING_SIZE]; /**< The records */
+} trace_ring_t;
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Clear and register a counter block
+ *
+ * @param io_this The counters, config, counts, statesCount and rowSize set
+ * @param i_countsCount Number of counters in the storage
+ *
+ * @return FSM_RC_OK on success, error code otherwise
+ */
+static fsm_RC_t counters_register(fsm_trace_counters_t *const io_this, size_t i_countsCount);
+
+/**
+ * @brief Increment a counter without a locked read-modify-write
+ *
+ * @param io_counter The counter
+ */
+static void counter_inc(atomic_uint *const io_counter);
+
+/**
+ * @brief Monotonic time in ns
+ *
+ * @return The current time
+ */
+static inline uint64_t monotonic_ns(void);
+
+/******************************************************************************/
+/*** Private static variables                                                 */
+/******************************************************************************/
+static _Thread_local trace_ring_t ring;           /**< Ring of the thread */
+static _Atomic(fsm_trace_counters_t *) counters; /**< Registered counter blocks, newest first */
+
+/******************************************************************************/
+/*** API function implementation                                              */
+/******************************************************************************/
+size_t fsm_trace_copy_ring(fsm_trace_record_t *const o_records, size_t i_maxRecords)
+{
+  if (o_records == NULL)
+  {
+    return 0;
+  }
+
+  size_t count = ring.written;
+  if (count > FSM_TRACE_RING_SIZE)
+  {
+    count = FSM_TRACE_RING_SIZE;
+  }
+  if (count > i_maxRecords)
+  {
+    count = i_maxRecords;
+  }
+
+  size_t first = ring.written - count;
+  for (size_t i = 0; i < count; i++)
+  {
+    o_records[i] = ring.records[(first + i) & (FSM_TRACE_RING_SIZE - 1u)];
+  }
+  return count;
+}
+
+void fsm_trace_reset_ring(void)
+{
+  ring.written = 0;
+}
+
+fsm_RC_t fsm_trace_counters_register(fsm_trace_counters_t *const o_this,
+                                     const fsm_cfg_t *const i_config,
+                                     atomic_uint *const i_counts,
+                                     size_t i_countsCount)
+{
+  if (o_this == NULL || i_config == NULL || i_counts == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  o_this->config = i_config;
+  o_this->counts = i_counts;
+  o_this->statesCount = i_config->statesCount;
+  o_this->rowSize = fsm_event_enum_count(i_config);
+  return counters_register(o_this, i_countsCount);
+}
+
+fsm_RC_t fsm_trace_counters_register_image(fsm_trace_counters_t *const o_this,
+                                           const fsm_image_t *const i_image,
+                                           atomic_uint *const i_counts,
+                                           size_t i_countsCount)
+{
+  if (o_this == NULL || i_image == NULL || i_image->header == NULL || i_counts == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+
+  o_this->config = i_image->header;
+  o_this->counts = i_counts;
+  o_this->statesCount = i_image->header->statesCount;
+  o_this->rowSize = i_image->header->eventCount;
+  return counters_register(o_this, i_countsCount);
+}
+
+fsm_RC_t fsm_trace_get_count(const fsm_trace_counters_t *const i_this,
+                             uint32_t i_stateIndex,
+                             fsm_event_t i_event,
+                             fsm_trace_count_t *const o_count)
+{
+  if (i_this == NULL || i_this->counts == NULL || o_count == NULL)
+  {
+    return FSM_RC_ERROR_NULLPTR;
+  }
+  if (i_stateIndex >= i_this->statesCount || (uint32_t)i_event >= i_this->rowSize)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+
+  const atomic_uint *row = &i_this->counts[(size_t)i_stateIndex * (1u + 2u * i_this->rowSize)];
+  o_count->stateHits = atomic_load_explicit(&row[0], memory_order_relaxed);
+  o_count->transitionHits = atomic_load_explicit(&row[1u + (uint32_t)i_event], memory_order_relaxed);
+  o_count->guardRejects = atomic_load_explicit(&row[1u + i_this->rowSize + (uint32_t)i_event], memory_order_relaxed);
+  return FSM_RC_OK;
+}
+
+void fsm_trace_reset_counters(void)
+{
+  for (fsm_trace_counters_t *block = atomic_load_explicit(&counters, memory_order_acquire); block != NULL;
+       block = block->next)
+  {
+    size_t count = FSM_TRACE_COUNTERS_SIZE((size_t)block->statesCount, (size_t)block->rowSize);
+    for (size_t i = 0; i < count; i++)
+    {
+      atomic_store_explicit(&block->counts[i], 0, memory_order_relaxed);
+    }
+  }
+}
+
+void fsm_trace_counters_clear(void)
+{
+  atomic_store_explicit(&counters, NULL, memory_order_release);
+}
+
+void fsm_trace_set_instance(uintptr_t i_instance)
+{
+  ring.instance = i_instance;
+}
+
+void fsm_trace_event(const void *i_config,
+                     uint32_t i_stateIndex,
+                     fsm_state_t i_fromState,
+                     fsm_event_t i_event,
+                     fsm_state_t i_toState,
+                     fsm_trace_guard_t i_guard)
+{
+  fsm_trace_record_t *record = &ring.records[ring.written & (FSM_TRACE_RING_SIZE - 1u)];
+  record->timestamp = FSM_TRACE_TIMESTAMP();
+  record->instance = ring.instance;
+  record->fromState = i_fromState;
+  record->event = i_event;
+  record->toState = i_toState;
+  record->guard = i_guard;
+  ring.written++;
+
+  /* Counted only with a block registered for the configuration */
+  fsm_trace_counters_t *block = atomic_load_explicit(&counters, memory_order_acquire);
+  while (block != NULL && block->config != i_config)
+  {
+    block = block->next;
+  }
+  uint32_t event = (uint32_t)i_event;
+  if (block == NULL || i_stateIndex >= block->statesCount || event >= block->rowSize)
+  {
+    return;
+  }
+
+  atomic_uint *row = &block->counts[(size_t)i_stateIndex * (1u + 2u * block->rowSize)];
+  counter_inc(&row[0]);
+  if (i_guard == FSM_TRACE_NO_GUARD || i_guard == FSM_TRACE_GUARD_PASSED)
+  {
+    counter_inc(&row[1u + event]);
+  }
+  else if (i_guard == FSM_TRACE_GUARD_REJECTED)
+  {
+    counter_inc(&row[1u + block->rowSize + event]);
+  }
+}
+
+/******************************************************************************/
+/*** Local function implementation                                            */
+/******************************************************************************/
+static fsm_RC_t counters_register(fsm_trace_counters_t *const io_this, size_t i_countsCount)
+{
+  size_t count = FSM_TRACE_COUNTERS_SIZE((size_t)io_this->statesCount, (size_t)io_this->rowSize);
+  if (i_countsCount < count)
+  {
+    return FSM_RC_ERROR_INVALID_ARG;
+  }
+  for (size_t i = 0; i < count; i++)
+  {
+    atomic_init(&io_this->counts[i], 0);
+  }
+
+  /* Publish the cleared block, walkers only follow completed links */
+  fsm_trace_counters_t *head = atomic_load_explicit(&counters, memory_order_relaxed);
+  do
+  {
+    io_this->next = head;
+  } while (atomic_compare_exchange_weak_explicit(&counters, &head, io_this, memory_order_release,
+                                                 memory_order_relaxed) == false);
+  return FSM_RC_OK;
+}
+
+static void counter_inc(atomic_uint *const io_counter)
+{
+  unsigned value = atomic_load_explicit(io_counter, memory_order_relaxed);
+  atomic_store_explicit(io_counter, value + 1u, memory_order_relaxed);
+}
+
+static inline uint64_t monotonic_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif /* FSM_TRACE */
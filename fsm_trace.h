@@ -0,0 +1,232 @@
+/**
+ * @file       fsm_trace.h
+ * @brief      Optional transition tracing and counters for the FSM
+ *
+ *             Compiled in with -DFSM_TRACE=1, otherwise all hooks expand to
+ *             nothing. When enabled every processed event is recorded as
+ *             (timestamp, instance, fromState, event, toState, guard result)
+ *             in a ring buffer of the processing thread, and counted in
+ *             per-state, per-transition and guard rejection counters.
+ *             The counters live in caller provided blocks, one per
+ *             configuration (or image), registered with
+ *             fsm_trace_counters_register and indexed like the hit counters of
+ *             fsm_reorder.h by (index in the states array, event), so machines
+ *             with their own enums are counted as well. Events of
+ *             configurations without a block are only recorded in the ring.
+ *             Transitions are identified by (state, event) as only the first
+ *             transition for an event is ever taken.
+ *             Counters use relaxed, non locked increments: cheap, but
+ *             concurrent updates of the same counter may get lost.
+ *             Requires C11 when enabled.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+#ifndef FSM_TRACE_H_
+#define FSM_TRACE_H_
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+/******************************************************************************/
+/*** Configuration                                                            */
+/******************************************************************************/
+#ifndef FSM_TRACE
+#define FSM_TRACE 0 /**< Tracing compiled out by default */
+#endif
+
+#ifndef FSM_TRACE_RING_SIZE
+#define FSM_TRACE_RING_SIZE 1024u /**< Records per thread, power of 2 */
+#endif
+
+#if FSM_TRACE
+
+#include "fsm_image.h" /* fsm_image_t */
+
+#include <stdatomic.h> /* for atomics */
+#include <stddef.h>    /* for size_t */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+
+/**
+ * @brief Number of counters of a block, see fsm_trace_counters_register
+ */
+#define FSM_TRACE_COUNTERS_SIZE(statesCount, eventEnumCount) ((statesCount) * (1u + 2u * (eventEnumCount)))
+
+/**
+ * @brief Outcome of the transition lookup for a traced event
+ */
+typedef enum
+{
+  FSM_TRACE_NO_TRANSITION,  /**< No transition defined for the event */
+  FSM_TRACE_NO_GUARD,       /**< Transition without guard taken */
+  FSM_TRACE_GUARD_PASSED,   /**< Guard true, transition taken */
+  FSM_TRACE_GUARD_REJECTED, /**< Guard false, stayed in the state */
+} fsm_trace_guard_t;
+
+/**
+ * @brief Trace Record of one processed event
+ */
+typedef struct
+{
+  uint64_t timestamp;      /**< TSC on x86, monotonic ns otherwise, see FSM_TRACE_TIMESTAMP */
+  uintptr_t instance;      /**< Address of the fsm_t, instance index for pools */
+  fsm_state_t fromState;   /**< State the event was processed in */
+  fsm_event_t event;       /**< The processed event */
+  fsm_state_t toState;     /**< State after the event */
+  fsm_trace_guard_t guard; /**< Outcome of the transition lookup */
+} fsm_trace_record_t;
+
+/**
+ * @brief Counters of one configuration
+ *
+ * Per state one row: the events processed in the state, then rowSize
+ * transitions taken and rowSize guard rejections by event.
+ */
+typedef struct fsm_trace_counters
+{
+  const void *config;              /**< The counted fsm_cfg_t, or the header of the counted image */
+  atomic_uint *counts;             /**< statesCount rows of 1 + 2 * rowSize counters */
+  uint32_t statesCount;            /**< Number of states */
+  uint32_t rowSize;                /**< Size of the event enum */
+  struct fsm_trace_counters *next; /**< Next registered block */
+} fsm_trace_counters_t;
+
+/**
+ * @brief Counters of one (state, event)
+ */
+typedef struct
+{
+  uint32_t stateHits;      /**< Events processed in the state */
+  uint32_t transitionHits; /**< Transitions taken on the event */
+  uint32_t guardRejects;   /**< Guard rejections on the event */
+} fsm_trace_count_t;
+
+/******************************************************************************/
+/*** API Functions                                                            */
+/******************************************************************************/
+
+/**
+ * @brief Copy the newest records of the calling thread, oldest first
+ *
+ * @param o_records Array receiving the records
+ * @param i_maxRecords Size of the array
+ *
+ * @return Number of copied records
+ */
+size_t fsm_trace_copy_ring(fsm_trace_record_t *const o_records, size_t i_maxRecords);
+
+/**
+ * @brief Clear the ring buffer of the calling thread
+ */
+void fsm_trace_reset_ring(void);
+
+/**
+ * @brief Count the events of a configuration
+ *
+ * Register before processing events on the configuration.
+ *
+ * @param o_this The counters, must stay valid
+ * @param i_config The initialized configuration
+ * @param i_counts Storage for the counters, must stay valid
+ * @param i_countsCount Number of counters, at least
+ *                      FSM_TRACE_COUNTERS_SIZE(statesCount, size of the event enum)
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the storage is too
+ *         small, error code otherwise
+ */
+fsm_RC_t fsm_trace_counters_register(fsm_trace_counters_t *const o_this,
+                                     const fsm_cfg_t *const i_config,
+                                     atomic_uint *const i_counts,
+                                     size_t i_countsCount);
+
+/**
+ * @brief Count the events of a loaded image
+ *
+ * @param o_this The counters, must stay valid
+ * @param i_image The loaded image
+ * @param i_counts Storage for the counters, must stay valid
+ * @param i_countsCount Number of counters, at least
+ *                      FSM_TRACE_COUNTERS_SIZE(statesCount, eventCount)
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if the storage is too
+ *         small, error code otherwise
+ */
+fsm_RC_t fsm_trace_counters_register_image(fsm_trace_counters_t *const o_this,
+                                           const fsm_image_t *const i_image,
+                                           atomic_uint *const i_counts,
+                                           size_t i_countsCount);
+
+/**
+ * @brief Read the counters of a (state, event)
+ *
+ * @param i_this The counters
+ * @param i_stateIndex Index of the state in the states array
+ * @param i_event The event
+ * @param o_count The counters
+ *
+ * @return FSM_RC_OK on success, FSM_RC_ERROR_INVALID_ARG if out of range,
+ *         error code otherwise
+ */
+fsm_RC_t fsm_trace_get_count(const fsm_trace_counters_t *const i_this,
+                             uint32_t i_stateIndex,
+                             fsm_event_t i_event,
+                             fsm_trace_count_t *const o_count);
+
+/**
+ * @brief Set the counters of all registered blocks to zero
+ */
+void fsm_trace_reset_counters(void);
+
+/**
+ * @brief Unregister all blocks, no events may be processed meanwhile
+ */
+void fsm_trace_counters_clear(void);
+
+/******************************************************************************/
+/*** Hooks, used by the FSM modules                                           */
+/******************************************************************************/
+
+/**
+ * @brief Set the instance the calling thread is processing
+ *
+ * @param i_instance Address of the fsm_t or instance index
+ */
+void fsm_trace_set_instance(uintptr_t i_instance);
+
+/**
+ * @brief Record a processed event and update the counters
+ *
+ * @param i_config The fsm_cfg_t, or the header of the image
+ * @param i_stateIndex Index of the state the event was processed in
+ * @param i_fromState State the event was processed in
+ * @param i_event The processed event
+ * @param i_toState State after the event
+ * @param i_guard Outcome of the transition lookup
+ */
+void fsm_trace_event(const void *i_config,
+                     uint32_t i_stateIndex,
+                     fsm_state_t i_fromState,
+                     fsm_event_t i_event,
+                     fsm_state_t i_toState,
+                     fsm_trace_guard_t i_guard);
+
+#define FSM_TRACE_INSTANCE(instance) fsm_trace_set_instance((uintptr_t)(instance))
+#define FSM_TRACE_EVENT(config, stateIndex, fromState, event, toState, guard) \
+  fsm_trace_event((config), (stateIndex), (fromState), (event), (toState), (guard))
+
+#else /* FSM_TRACE */
+
+#define FSM_TRACE_INSTANCE(instance) ((void)0)
+#define FSM_TRACE_EVENT(config, stateIndex, fromState, event, toState, guard) ((void)0)
+
+#endif /* FSM_TRACE */
+
+#endif /* FSM_TRACE_H_ */
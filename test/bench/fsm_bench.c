@@ -0,0 +1,704 @@
+/**
+ * @file       fsm_bench.c
+ * @brief      Benchmark Suite for the FSM
+ *
+ *             Generates synthetic configurations (state count, transitions per
+ *             state, guard density, nesting depth) and measures them with and
+ *             without dispatch table for sequential and random event streams,
+ *             on every processing path: fsm_process, an instance pool
+ *             (fsm_pool_process_batch), an event queue (fsm_post and
+ *             fsm_dispatch_pending), the byte scanner (fsm_scan) and the
+ *             lockstep kernel (fsm_simd_run). The scanner and the kernel run
+ *             the configurations without actions, the kernel only the ones
+ *             without guards and nesting. Results are printed as CSV (default)
+ *             or JSON.
+ *
+ *             Usage: fsm_bench [--json] [--events N]
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include "fsm.h"
+#include "fsm_pool.h"
+#include "fsm_queue.h"
+#include "fsm_scan.h"
+#include "fsm_simd.h"
+
+#include <stdio.h>  /* printf */
+#include <stdlib.h> /* malloc, qsort */
+#include <string.h> /* memcpy, strcmp */
+#include <time.h>   /* clock_gettime */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define BENCH_EVENTS_USED 60u         /**< Events used by the generated configs */
+#define BENCH_MAX_DEPTH 4u            /**< Maximum nesting depth */
+#define BENCH_BATCH 256u              /**< Events per timed batch */
+#define BENCH_STREAM_LEN 4096u        /**< Length of the event stream, power of 2 */
+#define BENCH_DEFAULT_EVENTS 1000000u /**< Default events per case */
+#define BENCH_POOL_INSTANCES 1024u    /**< Instances of the pool */
+#define BENCH_QUEUE_CAPACITY 512u     /**< Slots of the queue, at least BENCH_BATCH */
+
+/******************************************************************************/
+/*** Types                                                                    */
+/******************************************************************************/
+/**
+ * @brief Kind of event stream fed to the machine
+ */
+typedef enum
+{
+  BENCH_STREAM_SEQUENTIAL, /**< Events in ascending order, wrapping around */
+  BENCH_STREAM_RANDOM,     /**< Uniformly distributed random events */
+} bench_stream_t;
+
+/**
+ * @brief Processing path measured
+ */
+typedef enum
+{
+  BENCH_PATH_PROCESS, /**< fsm_process on one instance */
+  BENCH_PATH_POOL,    /**< fsm_pool_process_batch, events spread over the instances */
+  BENCH_PATH_QUEUE,   /**< fsm_post of a batch, then fsm_dispatch_pending */
+  BENCH_PATH_SCAN,    /**< fsm_scan of a batch, actions removed */
+  BENCH_PATH_SIMD,    /**< fsm_simd_run, one event per instance, actions removed */
+  BENCH_PATH_COUNT,   /**< Number of paths, keep as last entry */
+} bench_path_t;
+
+/**
+ * @brief One benchmark case
+ */
+typedef struct
+{
+  uint32_t statesCount;         /**< States per (sub) machine */
+  uint32_t transitionsPerState; /**< Transitions per state */
+  uint32_t guardPercent;        /**< Percentage of transitions with a guard */
+  uint32_t depth;               /**< Nesting depth, 1 = no sub fsm */
+} bench_case_t;
+
+/**
+ * @brief Generated machine including all nesting levels
+ */
+typedef struct
+{
+  fsm_cfg_t *configs[BENCH_MAX_DEPTH]; /**< Config per nesting level */
+  fsm_t instances[BENCH_MAX_DEPTH];    /**< Instance per nesting level */
+  uint32_t depth;                      /**< Number of used levels */
+} bench_machine_t;
+
+/**
+ * @brief Path specific state of a run
+ */
+typedef struct
+{
+  bench_path_t path;        /**< The measured path */
+  bench_machine_t *machine; /**< The machine */
+  fsm_pool_t pool;          /**< BENCH_PATH_POOL: the pool */
+  fsm_index_t *poolStates;  /**< BENCH_PATH_POOL: state per instance */
+  uint32_t *poolFirstRun;   /**< BENCH_PATH_POOL: first run flags */
+  fsm_queue_t queue;        /**< BENCH_PATH_QUEUE: the queue */
+  fsm_queue_slot_t *slots;  /**< BENCH_PATH_QUEUE: slots of the queue */
+  fsm_scanner_t scanner;    /**< BENCH_PATH_SCAN: the scanner */
+  fsm_index_t *scanTable;   /**< BENCH_PATH_SCAN: table of the scanner */
+  fsm_simd_t kernel;        /**< BENCH_PATH_SIMD: the kernel */
+  int32_t *simdTable;       /**< BENCH_PATH_SIMD: table of the kernel */
+  int32_t *cursors;         /**< BENCH_PATH_SIMD: cursor per instance, BENCH_BATCH instances */
+} bench_runner_t;
+
+/**
+ * @brief Measurement of one run
+ */
+typedef struct
+{
+  uint64_t events;     /**< Number of processed events */
+  double eventsPerSec; /**< Throughput */
+  double nsP50;        /**< Median ns per event (per batch) */
+  double nsP99;        /**< 99th percentile ns per event (per batch) */
+} bench_result_t;
+
+/******************************************************************************/
+/*** Local function prototypes                                                */
+/******************************************************************************/
+
+/**
+ * @brief Benchmark action, counts the calls
+ *
+ * @param i_arg unused
+ */
+static void benchAction(fsm_arg_t i_arg);
+
+/**
+ * @brief Benchmark guard, alternates between true and false
+ *
+ * @param i_arg unused
+ *
+ * @return Alternating guard result
+ */
+static bool benchGuard(fsm_arg_t i_arg);
+
+/**
+ * @brief Generate the config of one nesting level
+ *
+ * @param i_case The benchmark case
+ * @param i_subFsm Sub fsm linked to the first state, can be null
+ * @param i_dispatch Provide storage for a dispatch table
+ * @param i_actions Attach actions to the states and transitions
+ *
+ * @return The allocated config, null on allocation failure
+ */
+static fsm_cfg_t *createConfig(const bench_case_t *i_case, const fsm_t *i_subFsm, bool i_dispatch, bool i_actions);
+
+/**
+ * @brief Free a config created by createConfig
+ *
+ * @param io_config The config to free, can be null
+ */
+static void freeConfig(fsm_cfg_t *io_config);
+
+/**
+ * @brief Generate and initialize all levels of a machine
+ *
+ * @param o_machine The machine to set up
+ * @param i_case The benchmark case
+ * @param i_dispatch Use the dispatch table
+ * @param i_actions Attach actions to the states and transitions
+ *
+ * @return true on success
+ */
+static bool createMachine(bench_machine_t *o_machine, const bench_case_t *i_case, bool i_dispatch, bool i_actions);
+
+/**
+ * @brief Free all configs of a machine
+ *
+ * @param io_machine The machine to free
+ */
+static void freeMachine(bench_machine_t *io_machine);
+
+/**
+ * @brief Set up a path on a machine
+ *
+ * @param o_runner The runner to set up
+ * @param io_machine The initialized machine
+ * @param i_path The path
+ *
+ * @return true on success
+ */
+static bool createRunner(bench_runner_t *o_runner, bench_machine_t *io_machine, bench_path_t i_path);
+
+/**
+ * @brief Free the storage of a runner
+ *
+ * @param io_runner The runner to free
+ */
+static void freeRunner(bench_runner_t *io_runner);
+
+/**
+ * @brief Process BENCH_BATCH events of a stream on the path of a runner
+ *
+ * @param io_runner The runner
+ * @param i_stream The event stream
+ * @param i_pos Position of the first event, a multiple of BENCH_BATCH
+ *
+ * @return true on success
+ */
+static bool runBatch(bench_runner_t *io_runner, bench_stream_t i_stream, uint32_t i_pos);
+
+/**
+ * @brief Run one measurement
+ *
+ * @param io_runner The runner
+ * @param i_stream The event stream
+ * @param i_events Number of events to process
+ * @param o_result The measurement
+ *
+ * @return true on success
+ */
+static bool runCase(bench_runner_t *io_runner, bench_stream_t i_stream, uint64_t i_events, bench_result_t *o_result);
+
+/**
+ * @brief Monotonic time in ns
+ *
+ * @return The current time
+ */
+static uint64_t nowNs(void);
+
+/**
+ * @brief qsort comparison for doubles
+ */
+static int compareDouble(const void *i_a, const void *i_b);
+
+/******************************************************************************/
+/*** Private static variables                                                 */
+/******************************************************************************/
+static volatile uint32_t actionCounter = 0;               /**< Incremented by benchAction */
+static uint32_t guardCounter = 0;                         /**< Toggled by benchGuard */
+static fsm_event_t streams[2][BENCH_STREAM_LEN];          /**< Event streams by bench_stream_t */
+static uint8_t byteStreams[2][BENCH_STREAM_LEN];          /**< The streams as bytes, for the scanner */
+static fsm_pool_event_t poolStreams[2][BENCH_STREAM_LEN]; /**< The streams spread over the pool instances */
+
+/**
+ * @brief Names of the paths by bench_path_t
+ */
+static const char *const pathNames[BENCH_PATH_COUNT] = {"process", "pool", "queue", "scan", "simd"};
+
+/**
+ * @brief Benchmark cases, each is run on every path for both streams with and
+ *        without dispatch table
+ */
+static const bench_case_t benchCases[] = {
+    {8, 2, 0, 1},
+    {64, 8, 0, 1},
+    {256, 8, 0, 1},
+    {1000, 8, 0, 1},
+    {256, 32, 0, 1},
+    {256, 8, 50, 1},
+    {256, 8, 0, 3},
+    {64, 4, 25, 4},
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+int main(int argc, char *argv[])
+{
+  bool json = false;
+  uint64_t events = BENCH_DEFAULT_EVENTS;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--json") == 0)
+    {
+      json = true;
+    }
+    else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc)
+    {
+      events = strtoull(argv[++i], NULL, 10);
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--json] [--events N]\n", argv[0]);
+      return -1;
+    }
+  }
+  if (events < BENCH_BATCH)
+  {
+    events = BENCH_BATCH;
+  }
+
+  /* Generate the event streams */
+  uint32_t seed = 0x12345678u;
+  for (uint32_t i = 0; i < BENCH_STREAM_LEN; i++)
+  {
+    /* xorshift32 */
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    streams[BENCH_STREAM_SEQUENTIAL][i] = (fsm_event_t)(i % BENCH_EVENTS_USED);
+    streams[BENCH_STREAM_RANDOM][i] = (fsm_event_t)(seed % BENCH_EVENTS_USED);
+  }
+  for (uint32_t stream = 0; stream < 2; stream++)
+  {
+    for (uint32_t i = 0; i < BENCH_STREAM_LEN; i++)
+    {
+      byteStreams[stream][i] = (uint8_t)streams[stream][i];
+      /* Consecutive events go to distant instances */
+      poolStreams[stream][i].instance = (i * 97u) % BENCH_POOL_INSTANCES;
+      poolStreams[stream][i].event = streams[stream][i];
+    }
+  }
+
+  if (json)
+  {
+    printf("[\n");
+  }
+  else
+  {
+    printf("states,transitions,guard_percent,depth,path,stream,dispatch,events,events_per_sec,ns_p50,ns_p99\n");
+  }
+
+  bool first = true;
+  for (size_t c = 0; c < sizeof(benchCases) / sizeof(benchCases[0]); c++)
+  {
+    const bench_case_t *benchCase = &benchCases[c];
+    for (uint32_t path = 0; path < BENCH_PATH_COUNT; path++)
+    {
+      /* The kernel takes flat, guard free machines and has its own table */
+      bool isSimd = (path == BENCH_PATH_SIMD);
+      if (isSimd == true && (benchCase->guardPercent != 0 || benchCase->depth > 1))
+      {
+        continue;
+      }
+      bool withActions = (path != BENCH_PATH_SCAN && isSimd == false);
+
+      for (uint32_t dispatch = 0; dispatch < (isSimd ? 1u : 2u); dispatch++)
+      {
+        for (uint32_t stream = 0; stream < 2; stream++)
+        {
+          bench_machine_t machine;
+          bench_runner_t runner = {0};
+          bench_result_t result;
+          if (createMachine(&machine, benchCase, dispatch != 0, withActions) == false ||
+              createRunner(&runner, &machine, (bench_path_t)path) == false)
+          {
+            fprintf(stderr, "ERROR: main: could not create %s machine\n", pathNames[path]);
+            freeRunner(&runner);
+            freeMachine(&machine);
+            return -1;
+          }
+          if (runCase(&runner, (bench_stream_t)stream, events, &result) == false)
+          {
+            fprintf(stderr, "ERROR: main: %s failed\n", pathNames[path]);
+            freeRunner(&runner);
+            freeMachine(&machine);
+            return -1;
+          }
+          freeRunner(&runner);
+          freeMachine(&machine);
+
+          const char *streamName = (stream == BENCH_STREAM_SEQUENTIAL) ? "sequential" : "random";
+          const char *dispatchName = isSimd ? "kernel" : ((dispatch != 0) ? "table" : "linear");
+          if (json)
+          {
+            printf("%s  {\"states\": %u, \"transitions\": %u, \"guard_percent\": %u, \"depth\": %u, "
+                   "\"path\": \"%s\", \"stream\": \"%s\", \"dispatch\": \"%s\", \"events\": %llu, "
+                   "\"events_per_sec\": %.0f, \"ns_p50\": %.2f, \"ns_p99\": %.2f}",
+                   first ? "" : ",\n",
+                   benchCase->statesCount, benchCase->transitionsPerState, benchCase->guardPercent,
+                   benchCase->depth, pathNames[path], streamName, dispatchName,
+                   (unsigned long long)result.events, result.eventsPerSec, result.nsP50, result.nsP99);
+          }
+          else
+          {
+            printf("%u,%u,%u,%u,%s,%s,%s,%llu,%.0f,%.2f,%.2f\n",
+                   benchCase->statesCount, benchCase->transitionsPerState, benchCase->guardPercent,
+                   benchCase->depth, pathNames[path], streamName, dispatchName,
+                   (unsigned long long)result.events, result.eventsPerSec, result.nsP50, result.nsP99);
+          }
+          first = false;
+        }
+      }
+    }
+  }
+
+  if (json)
+  {
+    printf("\n]\n");
+  }
+  return 0;
+}
+
+static void benchAction(fsm_arg_t i_arg)
+{
+  (void)i_arg;
+  actionCounter++;
+}
+
+static bool benchGuard(fsm_arg_t i_arg)
+{
+  (void)i_arg;
+  guardCounter++;
+  return (guardCounter & 1u) != 0;
+}
+
+static fsm_cfg_t *createConfig(const bench_case_t *i_case, const fsm_t *i_subFsm, bool i_dispatch, bool i_actions)
+{
+  uint32_t statesCount = i_case->statesCount;
+  uint32_t transitionsCount = i_case->transitionsPerState;
+  if (transitionsCount > BENCH_EVENTS_USED)
+  {
+    transitionsCount = BENCH_EVENTS_USED;
+  }
+  uint32_t eventStep = BENCH_EVENTS_USED / transitionsCount;
+
+  fsm_cfg_t *config = malloc(sizeof(fsm_cfg_t));
+  fsm_state_cfg_t *states = calloc(statesCount, sizeof(fsm_state_cfg_t));
+  fsm_transition_cfg_t *transitions = calloc((size_t)statesCount * transitionsCount, sizeof(fsm_transition_cfg_t));
+  fsm_dispatch_t *dispatch = NULL;
+  fsm_index_t *stateIndex = NULL;
+  fsm_dispatch_cell_t *cells = NULL;
+  if (i_dispatch)
+  {
+    dispatch = malloc(sizeof(fsm_dispatch_t));
+    stateIndex = calloc(FSM_STATE_COUNT, sizeof(fsm_index_t));
+    cells = calloc((size_t)statesCount * FSM_EVENT_COUNT, sizeof(fsm_dispatch_cell_t));
+  }
+  if (config == NULL || states == NULL || transitions == NULL ||
+      (i_dispatch && (dispatch == NULL || stateIndex == NULL || cells == NULL)))
+  {
+    free(config);
+    free(states);
+    free(transitions);
+    free(dispatch);
+    free(stateIndex);
+    free(cells);
+    return NULL;
+  }
+
+  /* The config structs have const members, build them on the stack and copy */
+  const fsm_action_t action = {.func = i_actions ? benchAction : NULL};
+  const fsm_guard_t guard = {.func = benchGuard};
+  for (uint32_t s = 0; s < statesCount; s++)
+  {
+    fsm_transition_cfg_t *stateTransitions = &transitions[s * transitionsCount];
+    for (uint32_t t = 0; t < transitionsCount; t++)
+    {
+      /* Spread the guards deterministically over the transitions */
+      bool guarded = ((s * 31u + t * 17u) % 100u) < i_case->guardPercent;
+      const fsm_transition_cfg_t transition = {
+          .event = (fsm_event_t)((s + t * eventStep) % BENCH_EVENTS_USED),
+          .toState = (fsm_state_t)((s + t + 1u) % statesCount),
+          .guard = guarded ? guard : (fsm_guard_t){0},
+          .action = action,
+      };
+      memcpy(&stateTransitions[t], &transition, sizeof(transition));
+    }
+
+    const fsm_state_cfg_t state = {
+        .state = (fsm_state_t)s,
+        .subFsm = (s == 0) ? i_subFsm : NULL,
+        .entryAction = action,
+        .doAction = action,
+        .exitAction = action,
+        .transitions = stateTransitions,
+        .transitionsCount = transitionsCount,
+    };
+    memcpy(&states[s], &state, sizeof(state));
+  }
+
+  if (dispatch != NULL)
+  {
+    const fsm_dispatch_t dispatchInit = {
+        .stateIndex = stateIndex,
+        .stateIndexCount = FSM_STATE_COUNT,
+        .cells = cells,
+        .cellsCount = statesCount * FSM_EVENT_COUNT,
+    };
+    memcpy(dispatch, &dispatchInit, sizeof(dispatchInit));
+  }
+
+  const fsm_cfg_t configInit = {
+      .initialState = (fsm_state_t)0,
+      .states = states,
+      .statesCount = statesCount,
+      .dispatch = dispatch,
+  };
+  memcpy(config, &configInit, sizeof(configInit));
+  return config;
+}
+
+static void freeConfig(fsm_cfg_t *io_config)
+{
+  if (io_config == NULL)
+  {
+    return;
+  }
+  if (io_config->dispatch != NULL)
+  {
+    free(io_config->dispatch->stateIndex);
+    free(io_config->dispatch->cells);
+    free(io_config->dispatch);
+  }
+  free((void *)io_config->states[0].transitions);
+  free((void *)io_config->states);
+  free(io_config);
+}
+
+static bool createMachine(bench_machine_t *o_machine, const bench_case_t *i_case, bool i_dispatch, bool i_actions)
+{
+  memset(o_machine, 0, sizeof(*o_machine));
+  o_machine->depth = (i_case->depth > BENCH_MAX_DEPTH) ? BENCH_MAX_DEPTH : i_case->depth;
+
+  /* Create from the innermost level outwards to link the sub fsms */
+  for (uint32_t level = o_machine->depth; level-- > 0;)
+  {
+    const fsm_t *subFsm = (level + 1 < o_machine->depth) ? &o_machine->instances[level + 1] : NULL;
+    o_machine->configs[level] = createConfig(i_case, subFsm, i_dispatch, i_actions);
+    if (o_machine->configs[level] == NULL)
+    {
+      return false;
+    }
+    if (fsm_init(&o_machine->instances[level], o_machine->configs[level]) != FSM_RC_OK)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void freeMachine(bench_machine_t *io_machine)
+{
+  for (uint32_t level = 0; level < BENCH_MAX_DEPTH; level++)
+  {
+    freeConfig(io_machine->configs[level]);
+    io_machine->configs[level] = NULL;
+  }
+}
+
+static bool createRunner(bench_runner_t *o_runner, bench_machine_t *io_machine, bench_path_t i_path)
+{
+  memset(o_runner, 0, sizeof(*o_runner));
+  o_runner->path = i_path;
+  o_runner->machine = io_machine;
+  fsm_t *fsm = &io_machine->instances[0];
+  const fsm_cfg_t *config = io_machine->configs[0];
+
+  switch (i_path)
+  {
+  case BENCH_PATH_PROCESS:
+    return true;
+
+  case BENCH_PATH_POOL:
+    o_runner->poolStates = calloc(BENCH_POOL_INSTANCES, sizeof(fsm_index_t));
+    o_runner->poolFirstRun = calloc(FSM_POOL_FIRST_RUN_WORDS(BENCH_POOL_INSTANCES), sizeof(uint32_t));
+    return o_runner->poolStates != NULL && o_runner->poolFirstRun != NULL &&
+           fsm_pool_init(&o_runner->pool, config, o_runner->poolStates, o_runner->poolFirstRun,
+                         BENCH_POOL_INSTANCES) == FSM_RC_OK;
+
+  case BENCH_PATH_QUEUE:
+    o_runner->slots = calloc(BENCH_QUEUE_CAPACITY, sizeof(fsm_queue_slot_t));
+    return o_runner->slots != NULL &&
+           fsm_queue_init(&o_runner->queue, fsm, o_runner->slots, BENCH_QUEUE_CAPACITY) == FSM_RC_OK;
+
+  case BENCH_PATH_SCAN:
+    o_runner->scanTable = calloc(FSM_SCAN_TABLE_SIZE(config->statesCount), sizeof(fsm_index_t));
+    return o_runner->scanTable != NULL &&
+           fsm_scanner_init(&o_runner->scanner, fsm, NULL, o_runner->scanTable,
+                            FSM_SCAN_TABLE_SIZE(config->statesCount)) == FSM_RC_OK;
+
+  case BENCH_PATH_SIMD:
+    o_runner->simdTable = calloc(FSM_SIMD_TABLE_SIZE(config->statesCount), sizeof(int32_t));
+    o_runner->cursors = calloc(BENCH_BATCH, sizeof(int32_t));
+    return o_runner->simdTable != NULL && o_runner->cursors != NULL &&
+           fsm_simd_init(&o_runner->kernel, config, o_runner->simdTable, FSM_SIMD_TABLE_SIZE(config->statesCount)) ==
+               FSM_RC_OK &&
+           fsm_simd_reset(&o_runner->kernel, o_runner->cursors, BENCH_BATCH) == FSM_RC_OK;
+
+  default:
+    return false;
+  }
+}
+
+static void freeRunner(bench_runner_t *io_runner)
+{
+  free(io_runner->poolStates);
+  free(io_runner->poolFirstRun);
+  free(io_runner->slots);
+  free(io_runner->scanTable);
+  free(io_runner->simdTable);
+  free(io_runner->cursors);
+  memset(io_runner, 0, sizeof(*io_runner));
+}
+
+static bool runBatch(bench_runner_t *io_runner, bench_stream_t i_stream, uint32_t i_pos)
+{
+  const fsm_event_t *events = &streams[i_stream][i_pos];
+
+  switch (io_runner->path)
+  {
+  case BENCH_PATH_PROCESS:
+  {
+    fsm_t *fsm = &io_runner->machine->instances[0];
+    for (uint32_t i = 0; i < BENCH_BATCH; i++)
+    {
+      if (fsm_process(fsm, events[i]) != FSM_RC_OK)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  case BENCH_PATH_POOL:
+    return fsm_pool_process_batch(&io_runner->pool, &poolStreams[i_stream][i_pos], BENCH_BATCH, NULL) == FSM_RC_OK;
+
+  case BENCH_PATH_QUEUE:
+  {
+    size_t dispatched = 0;
+    for (uint32_t i = 0; i < BENCH_BATCH; i++)
+    {
+      if (fsm_post(&io_runner->queue, events[i]) != FSM_RC_OK)
+      {
+        return false;
+      }
+    }
+    return fsm_dispatch_pending(&io_runner->queue, &dispatched) == FSM_RC_OK && dispatched == BENCH_BATCH;
+  }
+
+  case BENCH_PATH_SCAN:
+    return fsm_scan(&io_runner->scanner, &byteStreams[i_stream][i_pos], BENCH_BATCH, NULL) == FSM_RC_OK;
+
+  case BENCH_PATH_SIMD:
+    /* One event per instance */
+    return fsm_simd_run(&io_runner->kernel, io_runner->cursors, BENCH_BATCH, events, 1) == FSM_RC_OK;
+
+  default:
+    return false;
+  }
+}
+
+static bool runCase(bench_runner_t *io_runner, bench_stream_t i_stream, uint64_t i_events, bench_result_t *o_result)
+{
+  uint64_t batches = i_events / BENCH_BATCH;
+  double *samples = malloc((size_t)batches * sizeof(double));
+  if (samples == NULL)
+  {
+    return false;
+  }
+
+  /* Warm up caches and branch predictors */
+  for (uint32_t pos = 0; pos < BENCH_STREAM_LEN; pos += BENCH_BATCH)
+  {
+    if (runBatch(io_runner, i_stream, pos) == false)
+    {
+      free(samples);
+      return false;
+    }
+  }
+
+  uint32_t pos = 0;
+  uint64_t total = 0;
+  for (uint64_t b = 0; b < batches; b++)
+  {
+    uint64_t start = nowNs();
+    if (runBatch(io_runner, i_stream, pos) == false)
+    {
+      free(samples);
+      return false;
+    }
+    pos = (pos + BENCH_BATCH) & (BENCH_STREAM_LEN - 1u);
+    uint64_t elapsed = nowNs() - start;
+    total += elapsed;
+    samples[b] = (double)elapsed / BENCH_BATCH;
+  }
+
+  qsort(samples, (size_t)batches, sizeof(double), compareDouble);
+  o_result->events = batches * BENCH_BATCH;
+  o_result->eventsPerSec = (total > 0) ? (double)o_result->events * 1e9 / (double)total : 0.0;
+  o_result->nsP50 = samples[batches / 2];
+  o_result->nsP99 = samples[(batches * 99) / 100];
+  free(samples);
+  return true;
+}
+
+static uint64_t nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compareDouble(const void *i_a, const void *i_b)
+{
+  double a = *(const double *)i_a;
+  double b = *(const double *)i_b;
+  return (a > b) - (a < b);
+}
@@ -0,0 +1,34 @@
+/**
+ * @file       fsm_events_states.h
+ * @brief      Definition of Statemachine States and Events for the benchmark
+ *
+ *             The benchmark generates its configurations at runtime and uses
+ *             the enum values as plain numbers. Only the sizes are defined.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+#ifndef FSM_EVENTS_STATES_H_
+#define FSM_EVENTS_STATES_H_
+
+/**
+ * @brief Statemachine events
+ */
+typedef enum fsm_event{
+  FSM_EVENT_BENCH_FIRST,
+  FSM_EVENT_COUNT = 64, /**< Number of events, keep as last entry */
+}fsm_event_t;
+
+/**
+ * @brief Statemachine states
+ */
+typedef enum fsm_state{
+  FSM_STATE_BENCH_FIRST,
+  FSM_STATE_COUNT = 1024, /**< Number of states, keep as last entry */
+}fsm_state_t;
+
+#endif /* FSM_EVENTS_STATE_H_ */
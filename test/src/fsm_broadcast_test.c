@@ -0,0 +1,270 @@
+/**
+ * @file       fsm_broadcast_test.c
+ * @brief      Routed broadcasts against broadcasts to every instance
+ *
+ *             Runs the same broadcasts, single events and resets through a
+ *             pool with routing index and through a pool without and asserts
+ *             the same states and action counts. Asserts that a routed
+ *             broadcast only processes the reacting instances, the lists of
+ *             reacting states per event and that every instance stays in the
+ *             route bucket of its state.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_pool.h" /* fsm_pool_broadcast */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* memcmp */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define EVENTS 5u      /**< Size of the event enum of the machine */
+#define STATES 4u      /**< States of the machine */
+#define TRANSITIONS 6u /**< Transitions of the machine */
+#define INSTANCES 200u /**< Instances per pool */
+#define STEPS 2000u    /**< Operations per run */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Count a call of the action
+ *
+ * @param i_counter is casted back to (uint32_t*)
+ */
+static void countAction(fsm_arg_t i_counter);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static uint32_t counts[4]; /**< Calls per action: idle entry, wake, busy, park */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+#define COUNT(i) {countAction, (fsm_arg_t)&counts[i]}
+
+/*** IDLE, BUSY WITH A DO ACTION, DONE AND PARKED, AN EVENT BEYOND THE ENUM ***/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .eventEnumCount = EVENTS,
+    .statesCount = STATES,
+    .states = (const fsm_state_cfg_t[STATES]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = COUNT(0),
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT(0), .toState = FSM_STATE_MAIN_2, .action = COUNT(1)},
+                {.event = FSM_EVENT(0), .toState = FSM_STATE_SUB_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = COUNT(2),
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT(1), .toState = FSM_STATE_SUB_1},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT(2), .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT(7), .toState = FSM_STATE_SUB_2, .action = COUNT(3)},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT(2), .toState = FSM_STATE_SUB_2, .action = COUNT(3)},
+            },
+        },
+    },
+};
+
+/*** BROADCAST EVENTS, 6 AND 7 ARE BEYOND THE ENUM ***/
+static const uint32_t broadcastEvents[] = {0, 1, 2, 3, 6, 7};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Check if an instance reacts to a broadcast
+ *
+ * @param i_pool The pool
+ * @param i_instance Index of the instance
+ * @param i_event The event
+ */
+static bool reacts(const fsm_pool_t *i_pool, uint32_t i_instance, uint32_t i_event)
+{
+    if ((i_pool->firstRunBits[i_instance / 32u] & (1u << (i_instance % 32u))) != 0)
+    {
+        return true;
+    }
+    switch (i_pool->stateIndex[i_instance])
+    {
+    case 0:
+        return i_event == 0;
+    case 1:
+        return true;
+    case 2:
+        return i_event == 2 || i_event == 7;
+    default:
+        return i_event == 2;
+    }
+}
+
+/**
+ * @brief Assert that every instance is listed once, in the bucket of its state
+ *
+ * @param i_pool The pool with routing index
+ */
+static void assertBuckets(const fsm_pool_t *i_pool)
+{
+    bool seen[INSTANCES] = {false};
+    uint32_t listed = 0;
+    for (uint32_t bucket = 0; bucket < FSM_POOL_ROUTE_BUCKETS(STATES); bucket++)
+    {
+        uint32_t head = i_pool->routeHeads[bucket];
+        if (head == FSM_POOL_ROUTE_NONE)
+        {
+            continue;
+        }
+        uint32_t i = head;
+        do
+        {
+            bool isFirstRun = (i_pool->firstRunBits[i / 32u] & (1u << (i % 32u))) != 0;
+            assert(seen[i] == false);
+            assert(bucket == (isFirstRun == true ? STATES : i_pool->stateIndex[i]));
+            assert(i_pool->routePrev[i_pool->routeNext[i]] == i);
+            seen[i] = true;
+            listed++;
+            i = i_pool->routeNext[i];
+        } while (i != head);
+    }
+    assert(listed == INSTANCES);
+}
+
+int main(void)
+{
+    static fsm_index_t routedStates[INSTANCES];
+    static fsm_index_t plainStates[INSTANCES];
+    static uint32_t routedFirstRun[FSM_POOL_FIRST_RUN_WORDS(INSTANCES)];
+    static uint32_t plainFirstRun[FSM_POOL_FIRST_RUN_WORDS(INSTANCES)];
+    static uint32_t next[INSTANCES];
+    static uint32_t prev[INSTANCES];
+    static uint32_t heads[FSM_POOL_ROUTE_BUCKETS(STATES)];
+    static uint32_t reactStates[FSM_POOL_ROUTE_REACTS_FOR(TRANSITIONS, EVENTS)];
+    const uint32_t reactsSize = EVENTS + 3u + 5u;
+    fsm_pool_t routed;
+    fsm_pool_t plain;
+
+    assert(fsm_pool_init(&routed, &fsmCfg, routedStates, routedFirstRun, INSTANCES) == FSM_RC_OK);
+    assert(fsm_pool_init(&plain, &fsmCfg, plainStates, plainFirstRun, INSTANCES) == FSM_RC_OK);
+
+    /* Storage for the offsets and for the entries, the duplicate event of MAIN_1 takes none */
+    assert(fsm_pool_route(&routed, next, prev, heads, reactStates, EVENTS + 2u) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_pool_route(&routed, next, prev, heads, reactStates, reactsSize - 1u) == FSM_RC_ERROR_INVALID_ARG);
+    assert(routed.routeHeads == NULL);
+    assert(fsm_pool_route(&routed, next, prev, heads, NULL, reactsSize) == FSM_RC_ERROR_NULLPTR);
+    assert(fsm_pool_route(&routed, next, prev, heads, reactStates, reactsSize) == FSM_RC_OK);
+    assertBuckets(&routed);
+
+    /* Lists per event, the events out of range and the states with a do action */
+    static const uint32_t expectedCounts[EVENTS + 2u] = {1, 0, 2, 0, 0, 1, 1};
+    static const uint32_t expectedLists[EVENTS + 2u][2] = {{0}, {0}, {2, 3}, {0}, {0}, {2}, {1}};
+    for (uint32_t list = 0; list < EVENTS + 2u; list++)
+    {
+        assert(reactStates[list + 1u] - reactStates[list] == expectedCounts[list]);
+        for (uint32_t i = 0; i < expectedCounts[list]; i++)
+        {
+            assert(reactStates[reactStates[list] + i] == expectedLists[list][i]);
+        }
+    }
+    assert(reactStates[EVENTS + 2u] == reactsSize);
+
+    /* Broadcasts, single events and resets on both pools */
+    uint32_t rand = 1;
+    for (uint32_t step = 0; step < STEPS; step++)
+    {
+        rand = rand * 1103515245u + 12345u;
+        uint32_t op = (rand >> 16) % 10u;
+        uint32_t instance = (rand >> 8) % INSTANCES;
+        uint32_t event = broadcastEvents[(rand >> 20) % (sizeof(broadcastEvents) / sizeof(broadcastEvents[0]))];
+        if (op < 6u)
+        {
+            uint32_t expected = 0;
+            for (uint32_t i = 0; i < INSTANCES; i++)
+            {
+                expected += (reacts(&routed, i, event) == true) ? 1u : 0u;
+            }
+
+            uint32_t before[4];
+            uint32_t processed = 0;
+            memcpy(before, counts, sizeof(counts));
+            assert(fsm_pool_broadcast(&plain, FSM_EVENT(event), &processed) == FSM_RC_OK);
+            assert(processed == INSTANCES);
+            uint32_t plainCounts[4];
+            for (uint32_t c = 0; c < 4u; c++)
+            {
+                plainCounts[c] = counts[c] - before[c];
+            }
+
+            memcpy(before, counts, sizeof(counts));
+            assert(fsm_pool_broadcast(&routed, FSM_EVENT(event), &processed) == FSM_RC_OK);
+            assert(processed == expected);
+            for (uint32_t c = 0; c < 4u; c++)
+            {
+                assert(counts[c] - before[c] == plainCounts[c]);
+            }
+        }
+        else if (op < 9u)
+        {
+            assert(fsm_pool_process(&plain, instance, FSM_EVENT(event)) == FSM_RC_OK);
+            assert(fsm_pool_process(&routed, instance, FSM_EVENT(event)) == FSM_RC_OK);
+        }
+        else
+        {
+            assert(fsm_pool_reset(&plain, instance) == FSM_RC_OK);
+            assert(fsm_pool_reset(&routed, instance) == FSM_RC_OK);
+        }
+
+        assert(memcmp(routedStates, plainStates, sizeof(routedStates)) == 0);
+        assert(memcmp(routedFirstRun, plainFirstRun, sizeof(routedFirstRun)) == 0);
+        assertBuckets(&routed);
+    }
+
+    /* Instances written otherwise are sorted in again */
+    for (uint32_t i = 0; i < INSTANCES; i++)
+    {
+        routedStates[i] = (fsm_index_t)(i % STATES);
+        routedFirstRun[i / 32u] &= ~(1u << (i % 32u));
+    }
+    assert(fsm_pool_route(&routed, next, prev, heads, reactStates, reactsSize) == FSM_RC_OK);
+    assertBuckets(&routed);
+
+    printf("fsm_broadcast_test: passed\n");
+    return 0;
+}
+
+static void countAction(fsm_arg_t i_counter)
+{
+    (*(uint32_t *)i_counter)++;
+}
@@ -0,0 +1,329 @@
+/**
+ * @file       fsm_builder_test.c
+ * @brief      Configurations built at runtime against compound literals
+ *
+ *             Builds the configuration of a compound literal with the
+ *             transitions added out of order, with the dense, the row
+ *             displaced and no dispatch table, and asserts the layout and the
+ *             same action trace and states. Asserts that the builder rejects
+ *             what fsm_init rejects.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"         /* FSM types */
+#include "fsm_builder.h" /* fsm_builder_t */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define STEPS 400u /**< Events processed per run */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};      /**< Sub fsm linked to MAIN_SUB */
+static char trace[16384];       /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1, .action = {logAction, (fsm_arg_t) "s2e1"}},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, THE FIRST OF THE TRANSITIONS ON EVENT_1 OF MAIN_2 WINS ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {logAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e1"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of step i
+ *
+ * @param i_step Index of the step
+ */
+static fsm_event_t eventOf(uint32_t i_step)
+{
+    return (fsm_event_t)((i_step * i_step + i_step / 3u) % 3u);
+}
+
+/**
+ * @brief Run the events through fsm_process on a fresh instance
+ *
+ * @param i_config The main configuration
+ * @param o_states State after each event
+ */
+static void run(const fsm_cfg_t *i_config, fsm_state_t *o_states)
+{
+    fsm_t fsm;
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsm, i_config) == FSM_RC_OK);
+    trace[0] = '\0';
+    guardCalls = 0;
+    for (uint32_t s = 0; s < STEPS; s++)
+    {
+        assert(fsm_process(&fsm, eventOf(s)) == FSM_RC_OK);
+        o_states[s] = fsm.currentState;
+    }
+}
+
+/**
+ * @brief Stage the states of fsmMainCfg, the transitions of each state in reverse
+ *
+ * @param io_builder The builder
+ */
+static void stage(fsm_builder_t *io_builder)
+{
+    for (uint32_t i = 0; i < fsmMainCfg.statesCount; i++)
+    {
+        const fsm_state_cfg_t *stateCfg = &fsmMainCfg.states[i];
+        assert(fsm_builder_add_state(io_builder, stateCfg->state) == FSM_RC_OK);
+        assert(fsm_builder_set_actions(io_builder, stateCfg->state, stateCfg->entryAction, stateCfg->doAction,
+                                       stateCfg->exitAction) == FSM_RC_OK);
+        assert(fsm_builder_set_sub_fsm(io_builder, stateCfg->state, stateCfg->subFsm) == FSM_RC_OK);
+    }
+
+    /* Reverse, except the transitions sharing an event */
+    for (uint32_t i = 0; i < fsmMainCfg.statesCount; i++)
+    {
+        const fsm_state_cfg_t *stateCfg = &fsmMainCfg.states[i];
+        for (uint32_t t = stateCfg->transitionsCount; t > 0; t--)
+        {
+            uint32_t index = t - 1u;
+            if (index > 0 && stateCfg->transitions[index - 1u].event == stateCfg->transitions[index].event)
+            {
+                index--;
+            }
+            else if (index + 1u < stateCfg->transitionsCount &&
+                     stateCfg->transitions[index + 1u].event == stateCfg->transitions[index].event)
+            {
+                index++;
+            }
+            assert(fsm_builder_add_transition(io_builder, stateCfg->state, &stateCfg->transitions[index]) == FSM_RC_OK);
+        }
+    }
+    assert(fsm_builder_set_initial(io_builder, fsmMainCfg.initialState) == FSM_RC_OK);
+}
+
+int main(void)
+{
+    static fsm_state_t expectedStates[STEPS];
+    static char expectedTrace[sizeof(trace)];
+    run(&fsmMainCfg, expectedStates);
+    strcpy(expectedTrace, trace);
+
+    /* Dense, row displaced and no dispatch table, small blocks to span several */
+    for (uint32_t mode = 0; mode < 3u; mode++)
+    {
+        fsm_builder_t builder;
+        const fsm_cfg_t *config = NULL;
+        fsm_state_t states[STEPS];
+
+        assert(fsm_builder_init(&builder, 256u) == FSM_RC_OK);
+        assert(fsm_builder_set_linear(&builder, mode == 2u) == FSM_RC_OK);
+        assert(fsm_builder_set_packed(&builder, mode == 1u) == FSM_RC_OK);
+        stage(&builder);
+        assert(fsm_builder_set_linear(&builder, true) == FSM_RC_ERROR);
+        assert(fsm_builder_finalize(&builder, &config) == FSM_RC_OK);
+        assert((config->dispatch != NULL) == (mode == 0u));
+        assert((config->packed != NULL) == (mode == 1u));
+
+        /* States in the order they were added, transitions contiguous */
+        const fsm_transition_cfg_t *next = config->states[0].transitions;
+        assert(config->statesCount == fsmMainCfg.statesCount);
+        for (uint32_t i = 0; i < config->statesCount; i++)
+        {
+            const fsm_state_cfg_t *stateCfg = &config->states[i];
+            assert(stateCfg->state == fsmMainCfg.states[i].state);
+            assert(stateCfg->transitions == next);
+            assert(stateCfg->transitionsCount == fsmMainCfg.states[i].transitionsCount);
+            next += stateCfg->transitionsCount;
+            for (uint32_t t = 1; t < stateCfg->transitionsCount; t++)
+            {
+                /* Sorted by event, linear ones in the order they were added */
+                fsm_event_t prevEvent = stateCfg->transitions[t - 1u].event;
+                fsm_event_t event = stateCfg->transitions[t].event;
+                assert((prevEvent <= event) == (mode != 2u || prevEvent == event));
+            }
+        }
+
+        run(config, states);
+        assert(strcmp(trace, expectedTrace) == 0);
+        assert(memcmp(states, expectedStates, sizeof(states)) == 0);
+
+        /* Finalized, no changes anymore */
+        const fsm_cfg_t *again = NULL;
+        assert(fsm_builder_finalize(&builder, &again) == FSM_RC_OK);
+        assert(again == config);
+        assert(fsm_builder_add_state(&builder, FSM_STATE_SUB_1) == FSM_RC_ERROR);
+        assert(fsm_builder_add_transition(&builder, FSM_STATE_MAIN_1, &fsmMainCfg.states[0].transitions[0]) ==
+               FSM_RC_ERROR);
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    /* Own enums, sized dispatch table */
+    {
+        fsm_builder_t builder;
+        const fsm_cfg_t *config = NULL;
+        fsm_t fsm;
+        const fsm_transition_cfg_t last = {.event = FSM_EVENT(63), .toState = FSM_STATE(7)};
+        const fsm_transition_cfg_t beyond = {.event = FSM_EVENT(64), .toState = FSM_STATE(7)};
+        const fsm_transition_cfg_t back = {.event = FSM_EVENT(0), .toState = FSM_STATE(0)};
+
+        assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+        assert(fsm_builder_set_enums(&builder, 8u, 64u) == FSM_RC_OK);
+        assert(fsm_builder_add_state(&builder, FSM_STATE(0)) == FSM_RC_OK);
+        assert(fsm_builder_set_enums(&builder, 8u, 64u) == FSM_RC_ERROR);
+        assert(fsm_builder_add_state(&builder, FSM_STATE(7)) == FSM_RC_OK);
+        assert(fsm_builder_add_state(&builder, FSM_STATE(8)) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_builder_add_transition(&builder, FSM_STATE(0), &beyond) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_builder_add_transition(&builder, FSM_STATE(0), &last) == FSM_RC_OK);
+        assert(fsm_builder_add_transition(&builder, FSM_STATE(7), &back) == FSM_RC_OK);
+        assert(fsm_builder_set_initial(&builder, FSM_STATE(0)) == FSM_RC_OK);
+        assert(fsm_builder_finalize(&builder, &config) == FSM_RC_OK);
+        assert(config->stateEnumCount == 8u && config->eventEnumCount == 64u);
+        assert(config->dispatch->cellsCount == 2u * 64u);
+
+        assert(fsm_init(&fsm, config) == FSM_RC_OK);
+        assert(fsm_process(&fsm, FSM_EVENT(63)) == FSM_RC_OK);
+        assert(fsm.currentState == FSM_STATE(7));
+        assert(fsm_process(&fsm, FSM_EVENT(0)) == FSM_RC_OK);
+        assert(fsm.currentState == FSM_STATE(0));
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    /* Rejected like by fsm_init, and transitions to states not added */
+    {
+        const fsm_transition_cfg_t toSub = {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1};
+        const fsm_transition_cfg_t toMain = {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1};
+        for (uint32_t failure = 0; failure < 4u; failure++)
+        {
+            fsm_builder_t builder;
+            const fsm_cfg_t *config = NULL;
+            assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+            if (failure != 0)
+            {
+                assert(fsm_builder_add_state(&builder, FSM_STATE_MAIN_1) == FSM_RC_OK);
+                assert(fsm_builder_add_state(&builder, FSM_STATE_MAIN_1) == FSM_RC_ERROR_INVALID_ARG);
+                assert(fsm_builder_add_transition(&builder, FSM_STATE_MAIN_2, &toMain) == FSM_RC_ERROR_INVALID_ARG);
+            }
+            if (failure != 1)
+            {
+                assert(fsm_builder_set_initial(&builder, FSM_STATE_MAIN_1) == FSM_RC_OK);
+            }
+            if (failure == 1 || failure == 3)
+            {
+                assert(fsm_builder_add_transition(&builder, FSM_STATE_MAIN_1, &toMain) == FSM_RC_OK);
+            }
+            if (failure == 3)
+            {
+                assert(fsm_builder_add_transition(&builder, FSM_STATE_MAIN_1, &toSub) == FSM_RC_OK);
+            }
+
+            /* 0 no states, 1 no initial state, 2 no transitions, 3 target not added */
+            assert(fsm_builder_finalize(&builder, &config) == FSM_RC_ERROR_INVALID_CONFIG);
+            assert(config == NULL);
+            assert(fsm_builder_free(&builder) == FSM_RC_OK);
+        }
+    }
+
+    printf("fsm_builder_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
@@ -0,0 +1,315 @@
+/**
+ * @file       fsm_event_test.c
+ * @brief      Event objects shared between threads
+ *
+ *             Asserts the payload in the guards and actions of an instance,
+ *             the reference of an object processed from an action and that
+ *             surplus releases are rejected. Threads allocate, retain, hand
+ *             over and release the objects of a small pool concurrently and
+ *             assert that no object is handed out twice, that an empty pool
+ *             is reported and that every object returns to the pool.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* pthreads */
+
+#include "fsm.h"       /* FSM types */
+#include "fsm_event.h" /* fsm_event_alloc */
+
+#undef NDEBUG
+#include <assert.h>  /* assert */
+#include <pthread.h> /* for threads */
+#include <stdio.h>   /* printf */
+#include <string.h>  /* strcmp */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define OBJECTS 8u     /**< Objects of the shared pool */
+#define SLOTS 8u       /**< Slots to hand objects over to other threads */
+#define THREADS 4u     /**< Threads sharing the pool */
+#define ROUNDS 100000u /**< Allocations tried by every thread */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Check the payload and keep a reference to the object
+ *
+ * @param i_arg unused
+ * @param i_obj The object of the processed event
+ */
+static void keepAction(fsm_arg_t i_arg, const fsm_event_obj_t *i_obj);
+
+/**
+ * @brief Process a new object from within the action, it is queued
+ *
+ * @param i_arg unused
+ * @param i_obj The object of the processed event, null for a plain event
+ */
+static void raiseAction(fsm_arg_t i_arg, const fsm_event_obj_t *i_obj);
+
+/**
+ * @brief Guard passing objects with a payload
+ *
+ * @param i_arg unused
+ * @param i_obj The object of the processed event
+ */
+static bool payloadGuard(fsm_arg_t i_arg, const fsm_event_obj_t *i_obj);
+
+/**
+ * @brief Allocate, retain, hand over and release objects of the shared pool
+ *
+ * @param i_thread is casted back to the thread number
+ */
+static void *threadMain(void *i_thread);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsm = {0};                  /**< Instance processing the objects */
+static fsm_event_pool_t pool;            /**< The shared pool */
+static fsm_event_obj_t objects[OBJECTS]; /**< Objects of the shared pool */
+static fsm_event_obj_t *kept = NULL;     /**< Object kept by keepAction */
+static char payload[] = "payload";       /**< Payload of the objects */
+static atomic_uintptr_t slots[SLOTS];    /**< Objects handed over, 0 if empty */
+static atomic_uint owners[OBJECTS];      /**< Thread number + 1 of the allocating thread, 0 if free */
+static uint32_t stamps[THREADS];         /**< Payload of the objects of a thread */
+static uint64_t empties[THREADS];        /**< Empty pool returns per thread */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1,
+                 .toState = FSM_STATE_MAIN_2,
+                 .guard = {.eventFunc = payloadGuard},
+                 .action = {.eventFunc = keepAction}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_1, .action = {.eventFunc = raiseAction}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Release the last reference of a handed over object
+ *
+ * @param io_obj The object
+ */
+static void drop(fsm_event_obj_t *io_obj)
+{
+    assert(atomic_exchange(&owners[io_obj - objects], 0u) != 0u);
+    assert(fsm_event_release(io_obj) == FSM_RC_OK);
+}
+
+/**
+ * @brief Assert that every object is free: all of them are allocated once
+ */
+static void assertAllFree(void)
+{
+    fsm_event_obj_t *taken[OBJECTS];
+    fsm_event_obj_t *obj = NULL;
+    for (uint32_t i = 0; i < OBJECTS; i++)
+    {
+        assert(fsm_event_alloc(&pool, FSM_EVENT_1, NULL, 0, &taken[i]) == FSM_RC_OK);
+        for (uint32_t k = 0; k < i; k++)
+        {
+            assert(taken[k] != taken[i]);
+        }
+    }
+    assert(fsm_event_alloc(&pool, FSM_EVENT_1, NULL, 0, &obj) == FSM_RC_ERROR_POOL_EMPTY);
+    for (uint32_t i = 0; i < OBJECTS; i++)
+    {
+        assert(fsm_event_release(taken[i]) == FSM_RC_OK);
+    }
+}
+
+int main(void)
+{
+    fsm_event_obj_t *obj = NULL;
+
+    assert(fsm_event_pool_init(&pool, objects, 0) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_event_pool_init(&pool, NULL, OBJECTS) == FSM_RC_ERROR_NULLPTR);
+    assert(fsm_event_pool_init(&pool, objects, OBJECTS) == FSM_RC_OK);
+    assertAllFree();
+
+    /* Surplus releases leave the object free once */
+    assert(fsm_event_alloc(&pool, FSM_EVENT_1, NULL, 0, &obj) == FSM_RC_OK);
+    assert(fsm_event_retain(obj) == FSM_RC_OK);
+    assert(fsm_event_release(obj) == FSM_RC_OK);
+    assert(fsm_event_release(obj) == FSM_RC_OK);
+    assert(fsm_event_release(obj) == FSM_RC_ERROR_INVALID_ARG);
+    assert(atomic_load(&obj->refCount) == 0u);
+    assertAllFree();
+
+    /* The payload reaches guard and action, the action keeps a reference */
+    assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+    assert(fsm_event_alloc(&pool, FSM_EVENT_1, payload, sizeof(payload), &obj) == FSM_RC_OK);
+    assert(fsm_process_event(&fsm, obj) == FSM_RC_OK);
+    assert(fsm.currentState == FSM_STATE_MAIN_2);
+    assert(kept == obj && atomic_load(&obj->refCount) == 1u);
+    assert(fsm_event_release(kept) == FSM_RC_OK);
+
+    /* Processed from an action, the object is queued with its reference */
+    kept = NULL;
+    assert(fsm_process(&fsm, FSM_EVENT_2) == FSM_RC_OK);
+    assert(fsm.currentState == FSM_STATE_MAIN_2);
+    assert(kept != NULL && atomic_load(&kept->refCount) == 1u);
+    assert(fsm_event_release(kept) == FSM_RC_OK);
+
+    /* Rejected by the guard or not processed at all, the reference is released */
+    assert(fsm_process(&fsm, FSM_EVENT_3) == FSM_RC_OK);
+    kept = NULL;
+    assert(fsm_event_alloc(&pool, FSM_EVENT_1, NULL, 0, &obj) == FSM_RC_OK);
+    assert(fsm_process_event(&fsm, obj) == FSM_RC_OK);
+    assert(fsm.currentState == FSM_STATE_MAIN_1 && kept == NULL);
+    assert(fsm_event_alloc(&pool, FSM_EVENT_1, payload, sizeof(payload), &obj) == FSM_RC_OK);
+    assert(fsm_process_event(NULL, obj) == FSM_RC_ERROR_NULLPTR);
+    assertAllFree();
+
+    /* Threads share the pool, every object handed out to one owner at a time */
+    {
+        pthread_t threads[THREADS];
+        for (uint32_t t = 0; t < THREADS; t++)
+        {
+            assert(pthread_create(&threads[t], NULL, threadMain, (void *)(uintptr_t)t) == 0);
+        }
+        uint64_t emptyReturns = 0;
+        for (uint32_t t = 0; t < THREADS; t++)
+        {
+            assert(pthread_join(threads[t], NULL) == 0);
+            emptyReturns += empties[t];
+        }
+        for (uint32_t s = 0; s < SLOTS; s++)
+        {
+            fsm_event_obj_t *handed = (fsm_event_obj_t *)atomic_exchange(&slots[s], (uintptr_t)0);
+            if (handed != NULL)
+            {
+                drop(handed);
+            }
+        }
+        for (uint32_t i = 0; i < OBJECTS; i++)
+        {
+            assert(atomic_load(&owners[i]) == 0u);
+            assert(atomic_load(&objects[i].refCount) == 0u);
+        }
+        assert(emptyReturns > 0);
+        assertAllFree();
+    }
+
+    printf("fsm_event_test: passed\n");
+    return 0;
+}
+
+static void keepAction(fsm_arg_t i_arg, const fsm_event_obj_t *i_obj)
+{
+    (void)i_arg;
+    assert(i_obj != NULL && i_obj->event == FSM_EVENT_1);
+    assert(strcmp((const char *)i_obj->payload, payload) == 0);
+    kept = (fsm_event_obj_t *)i_obj;
+    assert(fsm_event_retain(kept) == FSM_RC_OK);
+}
+
+static void raiseAction(fsm_arg_t i_arg, const fsm_event_obj_t *i_obj)
+{
+    fsm_event_obj_t *obj = NULL;
+    (void)i_arg;
+    assert(i_obj == NULL);
+    assert(fsm_event_alloc(&pool, FSM_EVENT_1, payload, sizeof(payload), &obj) == FSM_RC_OK);
+    assert(fsm_process_event(&fsm, obj) == FSM_RC_OK);
+    assert(kept == NULL && atomic_load(&obj->refCount) == 1u);
+}
+
+static bool payloadGuard(fsm_arg_t i_arg, const fsm_event_obj_t *i_obj)
+{
+    (void)i_arg;
+    return i_obj->length > 0;
+}
+
+static void *threadMain(void *i_thread)
+{
+    uint32_t thread = (uint32_t)(uintptr_t)i_thread;
+    uint32_t rand = thread + 1u;
+    fsm_event_pool_t own;
+    fsm_event_obj_t ownObject;
+    assert(fsm_event_pool_init(&own, &ownObject, 1) == FSM_RC_OK);
+
+    for (uint32_t round = 0; round < ROUNDS; round++)
+    {
+        rand = rand * 1103515245u + 12345u;
+        fsm_event_obj_t *obj = NULL;
+        fsm_RC_t res = fsm_event_alloc(&pool, FSM_EVENT_1, &stamps[thread], thread, &obj);
+        if (res == FSM_RC_ERROR_POOL_EMPTY)
+        {
+            /* Make room, take a handed over object */
+            empties[thread]++;
+            fsm_event_obj_t *handed = (fsm_event_obj_t *)atomic_exchange(&slots[(rand >> 16) % SLOTS], (uintptr_t)0);
+            if (handed != NULL)
+            {
+                drop(handed);
+            }
+            continue;
+        }
+        assert(res == FSM_RC_OK);
+
+        /* Owned by this thread only, nobody else wrote the payload */
+        assert(atomic_exchange(&owners[obj - objects], thread + 1u) == 0u);
+        uint32_t retains = (rand >> 8) % 3u;
+        for (uint32_t r = 0; r < retains; r++)
+        {
+            assert(fsm_event_retain(obj) == FSM_RC_OK);
+        }
+        assert(atomic_load(&obj->refCount) == 1u + retains);
+        for (uint32_t r = 0; r < retains; r++)
+        {
+            assert(fsm_event_release(obj) == FSM_RC_OK);
+        }
+        assert(obj->payload == &stamps[thread] && obj->length == thread);
+
+        /* Hand over with the reference, the slot taken over is released here */
+        fsm_event_obj_t *handed = (fsm_event_obj_t *)atomic_exchange(&slots[(rand >> 16) % SLOTS], (uintptr_t)obj);
+        if (handed != NULL)
+        {
+            drop(handed);
+        }
+
+        /* Surplus releases of a free object of the own pool, concurrently to the shared pool */
+        if (round % 64u == 0)
+        {
+            assert(fsm_event_alloc(&own, FSM_EVENT_1, NULL, 0, &obj) == FSM_RC_OK);
+            assert(fsm_event_release(obj) == FSM_RC_OK);
+            assert(fsm_event_release(obj) == FSM_RC_ERROR_INVALID_ARG);
+            assert(fsm_event_alloc(&own, FSM_EVENT_1, NULL, 0, &obj) == FSM_RC_OK);
+            assert(fsm_event_alloc(&own, FSM_EVENT_1, NULL, 0, &obj) == FSM_RC_ERROR_POOL_EMPTY);
+            assert(fsm_event_release(obj) == FSM_RC_OK);
+        }
+    }
+    return NULL;
+}
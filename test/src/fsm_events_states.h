@@ -21,6 +21,7 @@ typedef enum fsm_event{
   FSM_EVENT_1,
   FSM_EVENT_2,
   FSM_EVENT_3,
+  FSM_EVENT_COUNT, /**< Number of events, keep as last entry */
 }fsm_event_t;
 
 /**
@@ -32,6 +33,7 @@ typedef enum fsm_state{
   FSM_STATE_MAIN_SUB,
   FSM_STATE_SUB_1,
   FSM_STATE_SUB_2,
+  FSM_STATE_COUNT, /**< Number of states, keep as last entry */
 }fsm_state_t;
 
 #endif /* FSM_EVENTS_STATE_H_ */
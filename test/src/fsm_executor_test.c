@@ -0,0 +1,236 @@
+/**
+ * @file       fsm_executor_test.c
+ * @brief      Executor with several workers and producers
+ *
+ *             Producer threads post to many instances while the workers of an
+ *             executor dispatch them, with an uneven load so idle workers
+ *             steal instances. Asserts that every event is processed exactly
+ *             once, that every instance ends in the expected state and that
+ *             the counters of the workers add up to the posted events.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* nanosleep, pthreads */
+
+#include "fsm.h"          /* FSM types */
+#include "fsm_executor.h" /* fsm_executor_t */
+
+#undef NDEBUG
+#include <assert.h>  /* assert */
+#include <pthread.h> /* for threads */
+#include <sched.h>   /* for sched_yield */
+#include <stdio.h>   /* printf */
+#include <time.h>    /* for nanosleep */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define WORKERS 4u    /**< Worker threads of the executor */
+#define PRODUCERS 4u  /**< Producer threads */
+#define INSTANCES 64u /**< Instances, event i is only posted to instance i */
+#define RING 5u       /**< States of the ring every event advances */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Count the event of an instance
+ *
+ * @param i_instance is casted back to the instance number
+ */
+static void countAction(fsm_arg_t i_instance);
+
+/**
+ * @brief Post the events of one producer to every instance
+ *
+ * @param i_producer unused
+ */
+static void *producerMain(void *i_producer);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t instances[INSTANCES];             /**< Instances driven by the executor */
+static fsm_queue_t queues[INSTANCES];          /**< Queue of each instance */
+static fsm_queue_slot_t slots[INSTANCES][128]; /**< Storage of the queues */
+static uint32_t processed[INSTANCES];          /**< Events processed per instance, by the claiming worker */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+#define T(e, to) {.event = FSM_EVENT(e), .toState = (to), .action = {countAction, (fsm_arg_t)(uintptr_t)(e)}}
+#define T4(e, to) T(e, to), T((e) + 1, to), T((e) + 2, to), T((e) + 3, to)
+#define T16(e, to) T4(e, to), T4((e) + 4, to), T4((e) + 8, to), T4((e) + 12, to)
+#define T64(to) T16(0, to), T16(16, to), T16(32, to), T16(48, to)
+#define S(from, to)                                                                 \
+    {                                                                               \
+        .state = (from), .transitionsCount = INSTANCES,                             \
+        .transitions = (const fsm_transition_cfg_t[INSTANCES]){T64(to)},            \
+    }
+
+/*** EVERY EVENT ADVANCES THE RING BY ONE STATE ***/
+static const fsm_state_t ring[RING] = {
+    FSM_STATE_MAIN_1, FSM_STATE_MAIN_2, FSM_STATE_MAIN_SUB, FSM_STATE_SUB_1, FSM_STATE_SUB_2,
+};
+
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .eventEnumCount = INSTANCES,
+    .dispatch = FSM_DISPATCH_TABLE_FOR(RING, FSM_STATE_COUNT, INSTANCES),
+    .statesCount = RING,
+    .states = (const fsm_state_cfg_t[RING]){
+        S(FSM_STATE_MAIN_1, FSM_STATE_MAIN_2),
+        S(FSM_STATE_MAIN_2, FSM_STATE_MAIN_SUB),
+        S(FSM_STATE_MAIN_SUB, FSM_STATE_SUB_1),
+        S(FSM_STATE_SUB_1, FSM_STATE_SUB_2),
+        S(FSM_STATE_SUB_2, FSM_STATE_MAIN_1),
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Events every producer posts to an instance
+ *
+ * The instances added first to each shard get far more, so the other workers
+ * run idle and steal.
+ *
+ * @param i_instance The instance
+ */
+static uint32_t postsOf(uint32_t i_instance)
+{
+    return ((i_instance % WORKERS) == 0) ? 3000u + i_instance : 100u + i_instance;
+}
+
+int main(void)
+{
+    fsm_executor_t executor;
+    pthread_t producers[PRODUCERS];
+    uint64_t total = 0;
+
+    /* Shared by the workers, prepared before the instances are */
+    assert(fsm_cfg_prepare(&fsmCfg) == FSM_RC_OK);
+    for (uint32_t i = 0; i < INSTANCES; i++)
+    {
+        assert(fsm_init(&instances[i], &fsmCfg) == FSM_RC_OK);
+        assert(fsm_queue_init(&queues[i], &instances[i], slots[i], 128) == FSM_RC_OK);
+        total += (uint64_t)PRODUCERS * postsOf(i);
+    }
+
+    /* Half of the instances are added while the workers run */
+    assert(fsm_executor_init(&executor, WORKERS, INSTANCES) == FSM_RC_OK);
+    for (uint32_t i = 0; i < INSTANCES / 2u; i++)
+    {
+        assert(fsm_executor_add(&executor, &queues[i]) == FSM_RC_OK);
+    }
+    assert(fsm_executor_start(&executor) == FSM_RC_OK);
+    assert(fsm_executor_start(&executor) == FSM_RC_ERROR);
+    for (uint32_t i = INSTANCES / 2u; i < INSTANCES; i++)
+    {
+        assert(fsm_executor_add(&executor, &queues[i]) == FSM_RC_OK);
+    }
+    assert(fsm_executor_add(&executor, &queues[0]) == FSM_RC_ERROR_INVALID_ARG);
+
+    for (uint32_t p = 0; p < PRODUCERS; p++)
+    {
+        assert(pthread_create(&producers[p], NULL, producerMain, NULL) == 0);
+    }
+    for (uint32_t p = 0; p < PRODUCERS; p++)
+    {
+        assert(pthread_join(producers[p], NULL) == 0);
+    }
+
+    /* Wait until the workers counted every event, at most 60 s */
+    fsm_executor_stats_t stats[WORKERS];
+    uint64_t events = 0;
+    for (uint32_t wait = 0; events < total && wait < 60000u; wait++)
+    {
+        struct timespec sleepTime = {0, 1000000L};
+        nanosleep(&sleepTime, NULL);
+        events = 0;
+        for (uint32_t w = 0; w < WORKERS; w++)
+        {
+            assert(fsm_executor_get_stats(&executor, w, &stats[w]) == FSM_RC_OK);
+            events += stats[w].events;
+        }
+    }
+    assert(fsm_executor_stop(&executor) == FSM_RC_OK);
+    assert(fsm_executor_stop(&executor) == FSM_RC_ERROR);
+
+    /* The counters add up to the posted events, every instance is owned once */
+    uint64_t errors = 0;
+    uint64_t steals = 0;
+    uint32_t owned = 0;
+    events = 0;
+    for (uint32_t w = 0; w < WORKERS; w++)
+    {
+        assert(fsm_executor_get_stats(&executor, w, &stats[w]) == FSM_RC_OK);
+        events += stats[w].events;
+        errors += stats[w].errors;
+        steals += stats[w].steals;
+        owned += stats[w].instances;
+        assert(stats[w].idleRounds <= stats[w].rounds);
+    }
+    assert(fsm_executor_get_stats(&executor, WORKERS, &stats[0]) == FSM_RC_ERROR_INVALID_ARG);
+    printf("executor: %llu events, %llu steals\n", (unsigned long long)events, (unsigned long long)steals);
+    assert(events == total);
+    assert(errors == 0);
+    assert(owned == INSTANCES);
+
+    /* No event lost or processed twice */
+    for (uint32_t i = 0; i < INSTANCES; i++)
+    {
+        size_t dispatched = 0;
+        assert(fsm_dispatch_pending(&queues[i], &dispatched) == FSM_RC_OK);
+        assert(dispatched == 0);
+        assert(processed[i] == PRODUCERS * postsOf(i));
+        assert(instances[i].currentState == ring[processed[i] % RING]);
+    }
+
+    assert(fsm_executor_deinit(&executor) == FSM_RC_OK);
+    printf("fsm_executor_test: passed\n");
+    return 0;
+}
+
+static void countAction(fsm_arg_t i_instance)
+{
+    processed[(uintptr_t)i_instance]++;
+}
+
+static void *producerMain(void *i_producer)
+{
+    (void)i_producer;
+    uint32_t maxPosts = 0;
+    for (uint32_t i = 0; i < INSTANCES; i++)
+    {
+        maxPosts = (postsOf(i) > maxPosts) ? postsOf(i) : maxPosts;
+    }
+
+    /* Round robin over the instances, each until its share is posted */
+    for (uint32_t n = 0; n < maxPosts; n++)
+    {
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            if (n >= postsOf(i))
+            {
+                continue;
+            }
+            while (fsm_post(&queues[i], FSM_EVENT(i)) == FSM_RC_ERROR_QUEUE_FULL)
+            {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
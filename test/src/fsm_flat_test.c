@@ -0,0 +1,278 @@
+/**
+ * @file       fsm_flat_test.c
+ * @brief      Flattened machine against fsm_process
+ *
+ *             Runs the same events through fsm_process and through the
+ *             flattened instance tree and asserts the same action trace and
+ *             the states of the instance and its sub fsm. Hands over between
+ *             both ways of processing in the middle of the input and asserts
+ *             that unsupported trees are rejected.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_flat.h" /* fsm_flat_compile */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};      /**< Sub fsm linked to MAIN_SUB */
+static fsm_t fsmMain = {0};     /**< Instance running the events */
+static char trace[4096];        /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .exitAction = {logAction, (fsm_arg_t) "s2ex"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, ACTIONS, GUARDS AND A SUB FSM ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {logAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/*** REJECTED, A TIMED TRANSITION AND A SUB CONFIGURATION ***/
+static const fsm_cfg_t fsmAfterCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .after = 10},
+            },
+        },
+    },
+};
+
+static const fsm_cfg_t fsmNestedCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+            },
+            .subCfg = &fsmSubCfg,
+        },
+    },
+};
+
+/*** EVENTS, 'x' HAS NO EVENT OF ITS OWN ***/
+static const char input[] = "aabcabacbbcccaxbaabcbacbcaaxcbbacaccba";
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of an input character
+ *
+ * @param i_char 'a' to 'c', anything else has no event
+ */
+static fsm_event_t eventOf(char i_char)
+{
+    return (i_char >= 'a' && i_char <= 'c') ? (fsm_event_t)(i_char - 'a') : FSM_EVENT_COUNT;
+}
+
+/**
+ * @brief Initialize the instances and clear the trace
+ */
+static void start(void)
+{
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsmMain, &fsmMainCfg) == FSM_RC_OK);
+    trace[0] = '\0';
+    guardCalls = 0;
+}
+
+int main(void)
+{
+    enum
+    {
+        EVENTS_COUNT = sizeof(input) - 1u
+    };
+    static char expectedTrace[sizeof(trace)];
+    fsm_state_t expectedStates[EVENTS_COUNT];
+    fsm_state_t expectedSubStates[EVENTS_COUNT];
+    fsm_flat_t flat;
+    fsm_state_t state;
+    uint32_t cursor = 0;
+
+    /* Reference run */
+    start();
+    for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+    {
+        assert(fsm_process(&fsmMain, eventOf(input[i])) == FSM_RC_OK);
+        expectedStates[i] = fsmMain.currentState;
+        expectedSubStates[i] = fsmSub.currentState;
+    }
+    strcpy(expectedTrace, trace);
+
+    /* Whole input, the states of both instances after every event */
+    start();
+    assert(fsm_flat_compile(&flat, &fsmMain) == FSM_RC_OK);
+    assert(flat.instancesCount == 2u);
+    for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+    {
+        assert(fsm_flat_process(&flat, &cursor, eventOf(input[i])) == FSM_RC_OK);
+        assert(fsm_flat_get_state(&flat, cursor, &fsmMain, &state) == FSM_RC_OK);
+        assert(state == expectedStates[i]);
+        assert(fsm_flat_get_state(&flat, cursor, &fsmSub, &state) == FSM_RC_OK);
+        assert(state == expectedSubStates[i]);
+    }
+    assert(strcmp(trace, expectedTrace) == 0);
+
+    /* The instances are only written by fsm_flat_store */
+    assert(fsmMain.currentState == FSM_STATE_MAIN_1);
+    assert(fsm_flat_store(&flat, cursor) == FSM_RC_OK);
+    assert(fsmMain.currentState == expectedStates[EVENTS_COUNT - 1u]);
+    assert(fsmSub.currentState == expectedSubStates[EVENTS_COUNT - 1u]);
+
+    /* Cursors out of range and instances outside of the tree */
+    fsm_t other;
+    assert(fsm_init(&other, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_flat_get_state(&flat, cursor, &other, &state) == FSM_RC_ERROR_INVALID_ARG);
+    cursor = flat.configsCount;
+    assert(fsm_flat_process(&flat, &cursor, FSM_EVENT_1) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_flat_get_state(&flat, cursor, &fsmMain, &state) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_flat_store(&flat, cursor) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_flat_free(&flat) == FSM_RC_OK);
+
+    /* Compiled in the middle of the input, continued with fsm_process after the store */
+    for (uint32_t handover = 1; handover < EVENTS_COUNT; handover += 5u)
+    {
+        start();
+        uint32_t i = 0;
+        for (; i < handover; i++)
+        {
+            assert(fsm_process(&fsmMain, eventOf(input[i])) == FSM_RC_OK);
+        }
+        assert(fsm_flat_compile(&flat, &fsmMain) == FSM_RC_OK);
+        cursor = 0;
+        for (; i < handover + (EVENTS_COUNT - handover) / 2u; i++)
+        {
+            assert(fsm_flat_process(&flat, &cursor, eventOf(input[i])) == FSM_RC_OK);
+        }
+        assert(fsm_flat_store(&flat, cursor) == FSM_RC_OK);
+        assert(fsm_flat_free(&flat) == FSM_RC_OK);
+        for (; i < EVENTS_COUNT; i++)
+        {
+            assert(fsm_process(&fsmMain, eventOf(input[i])) == FSM_RC_OK);
+            assert(fsmMain.currentState == expectedStates[i]);
+            assert(fsmSub.currentState == expectedSubStates[i]);
+        }
+        assert(strcmp(trace, expectedTrace) == 0);
+    }
+
+    /* Timed transitions and sub configurations are not supported */
+    fsm_t rejected;
+    assert(fsm_init(&rejected, &fsmAfterCfg) == FSM_RC_OK);
+    assert(fsm_flat_compile(&flat, &rejected) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_init(&rejected, &fsmNestedCfg) == FSM_RC_OK);
+    assert(fsm_flat_compile(&flat, &rejected) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_flat_compile(&flat, NULL) == FSM_RC_ERROR_NULLPTR);
+
+    printf("fsm_flat_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
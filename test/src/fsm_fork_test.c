@@ -0,0 +1,323 @@
+/**
+ * @file       fsm_fork_test.c
+ * @brief      Regions processed on the fork-join pool against in order
+ *
+ *             Runs the same events through a machine with orthogonal regions
+ *             processed in order, on a fork-join pool with room for all tasks
+ *             and on one whose queue is too small, and asserts the same
+ *             results, states, region states and action counts. A region
+ *             processes a nested machine whose regions fork into the same
+ *             pool, two regions fail and the first failing one gives the
+ *             result.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_fork.h" /* fsm_fork_run */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* memcmp */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define VARIANTS 3u /**< In order, on the large pool, on the small pool */
+#define COUNTERS 4u /**< Counting regions: two of the machine, two of the nested one */
+#define STEPS 3000u /**< Events per variant */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Count a call of the action
+ *
+ * @param i_counter is casted back to (uint32_t*)
+ */
+static void countAction(fsm_arg_t i_counter);
+
+/**
+ * @brief Count a call and process an event in the nested machine
+ *
+ * @param i_counter is casted back to (uint32_t*)
+ */
+static void nestAction(fsm_arg_t i_counter);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmUnset = {0};         /**< Never initialized sub fsm, entering its state fails */
+static fsm_t *nested = NULL;         /**< Nested machine of the running variant */
+static uint32_t counts[COUNTERS][4]; /**< Calls per counting region: entry, transition, do, self */
+static fsm_fork_t forkLarge;         /**< Room for every task */
+static fsm_fork_t forkSmall;         /**< Room for one task only */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+#define ARG(r, i) (fsm_arg_t)&counts[r][i]
+#define COUNT(r, i) {countAction, ARG(r, i)}
+
+/*** COUNTING REGION, THE SELF TRANSITION OF SUB_2 CALLS THE GIVEN ACTION ***/
+#define COUNTING(r, selfAction)                                                                            \
+    {                                                                                                      \
+        .initialState = FSM_STATE_SUB_1,                                                                   \
+        .statesCount = 2,                                                                                  \
+        .states = (const fsm_state_cfg_t[2]){                                                              \
+            {                                                                                              \
+                .state = FSM_STATE_SUB_1,                                                                  \
+                .entryAction = COUNT(r, 0),                                                                \
+                .transitionsCount = 1,                                                                     \
+                .transitions = (const fsm_transition_cfg_t[1]){                                            \
+                    {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_2, .action = COUNT(r, 1)},             \
+                },                                                                                         \
+            },                                                                                             \
+            {                                                                                              \
+                .state = FSM_STATE_SUB_2,                                                                  \
+                .doAction = COUNT(r, 2),                                                                   \
+                .transitionsCount = 2,                                                                     \
+                .transitions = (const fsm_transition_cfg_t[2]){                                            \
+                    {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_1},                                    \
+                    {.event = FSM_EVENT_3, .toState = FSM_STATE_SUB_2, .action = {selfAction, ARG(r, 3)}}, \
+                },                                                                                         \
+            },                                                                                             \
+        },                                                                                                 \
+    }
+
+static const fsm_cfg_t fsmCountCfg = COUNTING(0, countAction);
+static const fsm_cfg_t fsmNestCfg = COUNTING(1, nestAction);
+static const fsm_cfg_t fsmInnerCfgs[2] = {COUNTING(2, countAction), COUNTING(3, countAction)};
+
+/*** FAILS ON FSM_EVENT_1 IN SUB_2, ITS TARGET IS NOT A STATE OF THE REGION ***/
+static const fsm_cfg_t fsmMissingCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+/*** FAILS ON FSM_EVENT_1, ENTERING SUB_2 FORWARDS TO THE UNSET SUB FSM ***/
+static const fsm_cfg_t fsmUnsetCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_2},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .subFsm = &fsmUnset,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+static const fsm_cfg_t *const idleRegions[2] = {&fsmCountCfg, &fsmNestCfg};
+static const fsm_cfg_t *const busyRegions[4] = {&fsmCountCfg, &fsmMissingCfg, &fsmUnsetCfg, &fsmNestCfg};
+static const fsm_cfg_t *const innerRegions[2] = {&fsmInnerCfgs[0], &fsmInnerCfgs[1]};
+
+/*** MACHINE, MAIN_1 WITH TWO REGIONS, MAIN_2 WITH FOUR ***/
+#define MACHINE(run, runner)                                                    \
+    {                                                                           \
+        .initialState = FSM_STATE_MAIN_1,                                       \
+        .statesCount = 2,                                                       \
+        .states = (const fsm_state_cfg_t[2]){                                   \
+            {                                                                   \
+                .state = FSM_STATE_MAIN_1,                                      \
+                .regions = &(const fsm_regions_t){idleRegions, 2, run, runner}, \
+                .transitionsCount = 1,                                          \
+                .transitions = (const fsm_transition_cfg_t[1]){                 \
+                    {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2},        \
+                },                                                              \
+            },                                                                  \
+            {                                                                   \
+                .state = FSM_STATE_MAIN_2,                                      \
+                .regions = &(const fsm_regions_t){busyRegions, 4, run, runner}, \
+                .transitionsCount = 2,                                          \
+                .transitions = (const fsm_transition_cfg_t[2]){                 \
+                    {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2},        \
+                    {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},        \
+                },                                                              \
+            },                                                                  \
+        },                                                                      \
+    }
+
+/*** NESTED MACHINE, ONE STATE WITH TWO REGIONS ***/
+#define INNER(run, runner)                                                       \
+    {                                                                            \
+        .initialState = FSM_STATE_MAIN_1,                                        \
+        .statesCount = 1,                                                        \
+        .states = (const fsm_state_cfg_t[1]){                                    \
+            {                                                                    \
+                .state = FSM_STATE_MAIN_1,                                       \
+                .regions = &(const fsm_regions_t){innerRegions, 2, run, runner}, \
+                .transitionsCount = 1,                                           \
+                .transitions = (const fsm_transition_cfg_t[1]){                  \
+                    {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},         \
+                },                                                               \
+            },                                                                   \
+        },                                                                       \
+    }
+
+static const fsm_cfg_t fsmCfgs[VARIANTS] = {
+    MACHINE(NULL, NULL),
+    MACHINE(fsm_fork_run, &forkLarge),
+    MACHINE(fsm_fork_run, &forkSmall),
+};
+
+static const fsm_cfg_t fsmInnerCfgsOf[VARIANTS] = {
+    INNER(NULL, NULL),
+    INNER(fsm_fork_run, &forkLarge),
+    INNER(fsm_fork_run, &forkSmall),
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Assert the same states in every region of both instances
+ *
+ * @param i_fsm The instance
+ * @param i_reference The instance processed in order
+ */
+static void assertRegions(const fsm_t *i_fsm, const fsm_t *i_reference)
+{
+    assert(i_fsm->currentState == i_reference->currentState);
+    for (uint32_t r = 0; r < FSM_MAX_REGIONS; r++)
+    {
+        fsm_state_t state;
+        fsm_state_t expected;
+        fsm_RC_t res = fsm_get_region_state(i_reference, r, &expected);
+        assert(fsm_get_region_state(i_fsm, r, &state) == res);
+        assert(res != FSM_RC_OK || state == expected);
+    }
+}
+
+int main(void)
+{
+    static fsm_t machines[VARIANTS];
+    static fsm_t inners[VARIANTS];
+    uint32_t failures[2] = {0};
+
+    assert(fsm_fork_init(&forkLarge, 0, 16) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_fork_init(&forkLarge, 3, 0) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_fork_init(NULL, 3, 16) == FSM_RC_ERROR_NULLPTR);
+    assert(fsm_fork_init(&forkLarge, 3, 16) == FSM_RC_OK);
+    assert(fsm_fork_init(&forkSmall, 1, 1) == FSM_RC_OK);
+    for (uint32_t v = 0; v < VARIANTS; v++)
+    {
+        assert(fsm_init(&inners[v], &fsmInnerCfgsOf[v]) == FSM_RC_OK);
+        assert(fsm_init(&machines[v], &fsmCfgs[v]) == FSM_RC_OK);
+    }
+
+    /* Every variant processes the event, the first one in order is the reference */
+    uint32_t rand = 1;
+    for (uint32_t step = 0; step < STEPS; step++)
+    {
+        rand = rand * 1103515245u + 12345u;
+        fsm_event_t event = (fsm_event_t)((rand >> 16) % 3u);
+        uint32_t referenceCounts[COUNTERS][4];
+        fsm_RC_t referenceRes = FSM_RC_OK;
+        for (uint32_t v = 0; v < VARIANTS; v++)
+        {
+            uint32_t before[COUNTERS][4];
+            memcpy(before, counts, sizeof(counts));
+            nested = &inners[v];
+            fsm_RC_t res = fsm_process(&machines[v], event);
+            for (uint32_t r = 0; r < COUNTERS; r++)
+            {
+                for (uint32_t i = 0; i < 4u; i++)
+                {
+                    before[r][i] = counts[r][i] - before[r][i];
+                }
+            }
+            if (v == 0)
+            {
+                referenceRes = res;
+                memcpy(referenceCounts, before, sizeof(before));
+                continue;
+            }
+            assert(res == referenceRes);
+            assert(memcmp(before, referenceCounts, sizeof(before)) == 0);
+            assertRegions(&machines[v], &machines[0]);
+            assertRegions(&inners[v], &inners[0]);
+        }
+
+        /* Both failing regions: the one of the missing state comes first */
+        if (referenceRes != FSM_RC_OK)
+        {
+            fsm_state_t missing;
+            assert(event == FSM_EVENT_1 && machines[0].currentState == FSM_STATE_MAIN_2);
+            assert(fsm_get_region_state(&machines[0], 1, &missing) == FSM_RC_OK);
+            assert(referenceRes == (missing == FSM_STATE_SUB_2 ? FSM_RC_ERROR_INVALID_CONFIG : FSM_RC_ERROR_NULLPTR));
+            failures[missing == FSM_STATE_SUB_2 ? 0 : 1]++;
+        }
+    }
+    assert(failures[0] > 0 && failures[1] > 0);
+    assert(counts[1][3] > 0 && counts[2][0] > 0 && counts[3][0] > 0);
+
+    /* Regions out of range of the current state */
+    fsm_state_t state;
+    assert(fsm_get_region_state(&machines[0], FSM_MAX_REGIONS, &state) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_get_region_state(&machines[0], 0, NULL) == FSM_RC_ERROR_NULLPTR);
+
+    /* All forks fit into the large pool, the four regions never into the small one */
+    fsm_fork_stats_t stats;
+    assert(fsm_fork_get_stats(&forkLarge, &stats) == FSM_RC_OK);
+    assert(stats.sequential == 0);
+    assert(stats.joins > 0 && stats.tasks > stats.joins);
+    assert(stats.workerTasks <= stats.tasks - stats.joins);
+    assert(fsm_fork_get_stats(&forkSmall, &stats) == FSM_RC_OK);
+    assert(stats.sequential > 0 && stats.joins > 0);
+
+    assert(fsm_fork_deinit(&forkLarge) == FSM_RC_OK);
+    assert(fsm_fork_deinit(&forkSmall) == FSM_RC_OK);
+    assert(fsm_fork_deinit(&forkSmall) == FSM_RC_ERROR_NULLPTR);
+
+    printf("fsm_fork_test: passed\n");
+    return 0;
+}
+
+static void countAction(fsm_arg_t i_counter)
+{
+    (*(uint32_t *)i_counter)++;
+}
+
+static void nestAction(fsm_arg_t i_counter)
+{
+    countAction(i_counter);
+    assert(fsm_process(nested, FSM_EVENT_1) == FSM_RC_OK);
+}
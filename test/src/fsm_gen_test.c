@@ -0,0 +1,210 @@
+/**
+ * @file       fsm_gen_test.c
+ * @brief      Generated dispatcher against the interpreted path
+ *
+ *             Runs the same event sequence through fsm_process and the
+ *             dispatcher generated by fsm_gen.h and asserts the same action
+ *             trace, states and results, including events raised by actions.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Append the message to the trace and raise FSM_EVENT_3 on the running instance
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void raiseAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};         /**< Sub fsm linked to MAIN_SUB */
+static fsm_t *raiseTarget = NULL;  /**< Instance raiseAction raises on */
+static char trace[2048];           /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0;    /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .doAction = {logAction, (fsm_arg_t) "s1do"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .doAction = {logAction, (fsm_arg_t) "s2do"},
+            .exitAction = {logAction, (fsm_arg_t) "s2ex"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, GENERATED ***/
+#define MAIN_STATES(STATE)                                                                  \
+  STATE(FSM_STATE_MAIN_1, NULL, (logAction, "m1en"), (logAction, "m1do"), (logAction, "m1ex"), \
+        MAIN_1_TRANSITIONS)                                                                 \
+  STATE(FSM_STATE_MAIN_2, NULL, (logAction, "m2en"), (logAction, "m2do"), (logAction, "m2ex"), \
+        MAIN_2_TRANSITIONS)                                                                 \
+  STATE(FSM_STATE_MAIN_SUB, &fsmSub, (logAction, "msen"), (logAction, "msdo"), FSM_GEN_NONE,  \
+        MAIN_SUB_TRANSITIONS)
+
+#define MAIN_1_TRANSITIONS(T, S) T(S, FSM_EVENT_2, FSM_STATE_MAIN_2, FSM_GEN_NONE, (raiseAction, "m1e2"))
+
+#define MAIN_2_TRANSITIONS(T, S)                                                   \
+  T(S, FSM_EVENT_1, FSM_STATE_MAIN_1, (toggleGuard, NULL), (logAction, "m2e1")) \
+  T(S, FSM_EVENT_2, FSM_STATE_MAIN_2, FSM_GEN_NONE, (raiseAction, "m2e2"))      \
+  T(S, FSM_EVENT_3, FSM_STATE_MAIN_SUB, FSM_GEN_NONE, (logAction, "m2e3"))
+
+#define MAIN_SUB_TRANSITIONS(T, S) T(S, FSM_EVENT_3, FSM_STATE_MAIN_2, FSM_GEN_NONE, (logAction, "mse3"))
+
+#define FSM_GEN_NAME main
+#define FSM_GEN_INITIAL FSM_STATE_MAIN_1
+#define FSM_GEN_STATES MAIN_STATES
+#include "fsm_gen.h"
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Run the events on a fresh instance
+ *
+ * @param i_generated Use fsm_process_main instead of fsm_process
+ * @param i_events The events
+ * @param i_eventsCount Number of events
+ * @param o_states State after each event
+ * @param o_results Result of each event
+ */
+static void run(bool i_generated,
+                const fsm_event_t *i_events,
+                uint32_t i_eventsCount,
+                fsm_state_t *o_states,
+                fsm_RC_t *o_results)
+{
+    static fsm_t fsmMain;
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsmMain, &fsm_cfg_main) == FSM_RC_OK);
+    raiseTarget = &fsmMain;
+    trace[0] = '\0';
+    guardCalls = 0;
+
+    for (uint32_t i = 0; i < i_eventsCount; i++)
+    {
+        o_results[i] = (i_generated == true) ? fsm_process_main(&fsmMain, i_events[i])
+                                              : fsm_process(&fsmMain, i_events[i]);
+        o_states[i] = fsmMain.currentState;
+        assert(fsmMain.isProcessing == false);
+        assert(fsmMain.raisedCount == 0);
+    }
+}
+
+int main(void)
+{
+    static const fsm_event_t events[] = {
+        FSM_EVENT_1, FSM_EVENT_2, FSM_EVENT_3, FSM_EVENT_2, FSM_EVENT_1, FSM_EVENT_3, FSM_EVENT_2,
+        FSM_EVENT_1, FSM_EVENT_1, FSM_EVENT_2, FSM_EVENT_3, FSM_EVENT_3, FSM_EVENT_1, FSM_EVENT_2,
+    };
+    enum
+    {
+        EVENTS_COUNT = sizeof(events) / sizeof(events[0])
+    };
+
+    fsm_state_t interpretedStates[EVENTS_COUNT];
+    fsm_RC_t interpretedResults[EVENTS_COUNT];
+    static char interpretedTrace[sizeof(trace)];
+    run(false, events, EVENTS_COUNT, interpretedStates, interpretedResults);
+    strcpy(interpretedTrace, trace);
+
+    fsm_state_t generatedStates[EVENTS_COUNT];
+    fsm_RC_t generatedResults[EVENTS_COUNT];
+    run(true, events, EVENTS_COUNT, generatedStates, generatedResults);
+
+    printf("interpreted: %s\n", interpretedTrace);
+    printf("generated:   %s\n", trace);
+    assert(strcmp(interpretedTrace, trace) == 0);
+    assert(memcmp(interpretedStates, generatedStates, sizeof(interpretedStates)) == 0);
+    assert(memcmp(interpretedResults, generatedResults, sizeof(interpretedResults)) == 0);
+
+    /* The raised event moved the machine on before the next one */
+    assert(strstr(trace, "m1e2|m2en|m2do|m2do|m2ex|m2e3|msen|msdo") != NULL);
+
+    /* Bound modules need fsm_process */
+    fsm_t fsm;
+    fsm_hook_t hook = {0};
+    static const fsm_hook_ops_t ops = {0};
+    hook.ops = &ops;
+    assert(fsm_init(&fsm, &fsm_cfg_main) == FSM_RC_OK);
+    fsm.hooks = &hook;
+    assert(fsm_process_main(&fsm, FSM_EVENT_2) == FSM_RC_ERROR_INVALID_ARG);
+
+    /* So do other configurations */
+    assert(fsm_init(&fsm, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_process_main(&fsm, FSM_EVENT_2) == FSM_RC_ERROR_INVALID_ARG);
+
+    printf("fsm_gen_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static void raiseAction(fsm_arg_t i_message)
+{
+    logAction(i_message);
+    (void)fsm_raise(raiseTarget, FSM_EVENT_3);
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    return (guardCalls++ % 2u) == 1u;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file       fsm_image_test.c
+ * @brief      Binary images against fsm_process
+ *
+ *             Writes the image of a configuration, loads and verifies it and
+ *             asserts that an image instance produces the same action trace
+ *             and states as a fsm_t on the configuration. Asserts that
+ *             configurations, buffers and images which do not fit are
+ *             rejected, an image exceeding the 32 bit offsets included.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"       /* FSM types */
+#include "fsm_image.h" /* fsm_image_write */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stddef.h> /* offsetof */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define EVENTS 6u   /**< Size of the event enum of the machine */
+#define STEPS 2000u /**< Events processed per run */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/**
+ * @brief Guard always failing, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool falseGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static char trace[65536];       /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/*** ACTION TABLE, REGISTERED WHEN LOADING ***/
+static const fsm_image_symbol_t symbols[] = {
+    FSM_IMAGE_ACTION(logAction, "m1en"), FSM_IMAGE_ACTION(logAction, "m1e2"), FSM_IMAGE_ACTION(logAction, "m2do"),
+    FSM_IMAGE_ACTION(logAction, "m2ex"), FSM_IMAGE_ACTION(logAction, "m2e1"), FSM_IMAGE_ACTION(logAction, "m2e3"),
+    FSM_IMAGE_ACTION(logAction, "mse3"), FSM_IMAGE_ACTION(logAction, "mse5"), FSM_IMAGE_GUARD(toggleGuard, NULL),
+    FSM_IMAGE_GUARD(falseGuard, NULL),
+};
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+#define LOG(message) {logAction, (fsm_arg_t)(message)}
+
+/*** ACTIONS, GUARDS, FIRST WINS ON A SHARED EVENT, OWN EVENT ENUM ***/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .eventEnumCount = EVENTS,
+    .dispatch = FSM_DISPATCH_TABLE_FOR(3, FSM_STATE_COUNT, EVENTS),
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = LOG("m1en"),
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT(0), .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT(1), .toState = FSM_STATE_MAIN_2, .action = LOG("m1e2")},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = LOG("m2do"),
+            .exitAction = LOG("m2ex"),
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT(0), .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT(0), .toState = FSM_STATE_MAIN_SUB, .action = LOG("m2e1")},
+                {.event = FSM_EVENT(2), .toState = FSM_STATE_MAIN_SUB, .action = LOG("m2e3")},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT(2), .toState = FSM_STATE_MAIN_2, .action = LOG("mse3")},
+                {.event = FSM_EVENT(5), .toState = FSM_STATE_MAIN_1, .guard = {falseGuard, NULL}},
+                {.event = FSM_EVENT(5), .toState = FSM_STATE_MAIN_SUB, .action = LOG("mse5")},
+            },
+        },
+    },
+};
+
+/*** NOT REPRESENTABLE IN AN IMAGE ***/
+static fsm_t fsmSub = {0}; /**< Sub fsm of fsmSubFsmCfg */
+
+static const fsm_cfg_t fsmSubFsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1}},
+        },
+    },
+};
+
+static const fsm_cfg_t fsmAfterCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .after = 10},
+            },
+        },
+    },
+};
+
+/*** DISPATCH ROWS BEYOND THE 32 BIT OFFSETS OF AN IMAGE ***/
+static const fsm_transition_cfg_t hugeTransitions[1] = {{.event = FSM_EVENT(0), .toState = FSM_STATE_MAIN_1}};
+
+static const fsm_cfg_t fsmHugeCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .eventEnumCount = 0x40000000u,
+    .statesCount = 4,
+    .states = (const fsm_state_cfg_t[4]){
+        {.state = FSM_STATE_MAIN_1, .transitions = hugeTransitions, .transitionsCount = 1},
+        {.state = FSM_STATE_MAIN_2, .transitions = hugeTransitions, .transitionsCount = 1},
+        {.state = FSM_STATE_SUB_1, .transitions = hugeTransitions, .transitionsCount = 1},
+        {.state = FSM_STATE_SUB_2, .transitions = hugeTransitions, .transitionsCount = 1},
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of step i
+ *
+ * @param i_step Index of the step
+ */
+static fsm_event_t eventOf(uint32_t i_step)
+{
+    return FSM_EVENT((i_step * i_step + i_step / 3u) % EVENTS);
+}
+
+/**
+ * @brief Clear the trace and the guard calls
+ */
+static void start(void)
+{
+    trace[0] = '\0';
+    guardCalls = 0;
+}
+
+/**
+ * @brief Assert that an image with one field overwritten is rejected
+ *
+ * Damaged headers are rejected by the load, all other fields by the
+ * verification.
+ *
+ * @param i_image The valid image
+ * @param i_size Size of the image
+ * @param i_offset Offset of the field
+ * @param i_value Value written to the field
+ */
+static void assertDamaged(const uint32_t *i_image, size_t i_size, size_t i_offset, uint32_t i_value)
+{
+    static uint32_t damaged[1024];
+    fsm_image_t image;
+    const uint32_t symbolsCount = sizeof(symbols) / sizeof(symbols[0]);
+    memcpy(damaged, i_image, i_size);
+    memcpy((uint8_t *)damaged + i_offset, &i_value, sizeof(i_value));
+    if (i_offset < sizeof(fsm_image_header_t))
+    {
+        assert(fsm_image_load(&image, damaged, i_size, symbols, symbolsCount) == FSM_RC_ERROR_INVALID_ARG);
+        return;
+    }
+    assert(fsm_image_load(&image, damaged, i_size, symbols, symbolsCount) == FSM_RC_OK);
+    assert(fsm_image_verify(&image) == FSM_RC_ERROR_INVALID_CONFIG);
+}
+
+int main(void)
+{
+    static char expectedTrace[sizeof(trace)];
+    static fsm_state_t expectedStates[STEPS];
+    static uint32_t buffer[1024];
+    fsm_image_t image;
+    fsm_image_fsm_t imageFsm;
+    fsm_t fsm;
+    size_t size = 0;
+    size_t querySize = 0;
+    const uint32_t symbolsCount = sizeof(symbols) / sizeof(symbols[0]);
+
+    /* The reference run on the configuration */
+    start();
+    assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+    for (uint32_t s = 0; s < STEPS; s++)
+    {
+        assert(fsm_process(&fsm, eventOf(s)) == FSM_RC_OK);
+        expectedStates[s] = fsm.currentState;
+    }
+    strcpy(expectedTrace, trace);
+
+    /* Write, load and verify */
+    assert(fsm_image_write(&fsmCfg, symbols, symbolsCount, NULL, 0, &querySize) == FSM_RC_OK);
+    assert(querySize <= sizeof(buffer));
+    assert(fsm_image_write(&fsmCfg, symbols, symbolsCount, buffer, querySize - 1u, &size) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_image_write(&fsmCfg, symbols, symbolsCount, (uint8_t *)buffer + 2, sizeof(buffer) - 4u, &size) ==
+           FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_image_write(&fsmCfg, symbols, symbolsCount - 1u, buffer, sizeof(buffer), &size) ==
+           FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_image_write(&fsmCfg, symbols, symbolsCount, buffer, sizeof(buffer), &size) == FSM_RC_OK);
+    assert(size == querySize);
+
+    const fsm_image_header_t *header = (const fsm_image_header_t *)buffer;
+    assert(header->imageSize == size);
+    assert(header->eventCount == EVENTS);
+    assert(header->statesCount == 3u);
+    assert(header->transitionsCount == 8u);
+    assert(fsm_image_load(&image, buffer, size - 1u, symbols, symbolsCount) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_image_load(&image, buffer, size, symbols, header->symbolsCount - 1u) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_image_load(&image, buffer, size, symbols, symbolsCount) == FSM_RC_OK);
+    assert(fsm_image_verify(&image) == FSM_RC_OK);
+
+    /* The image instance runs like fsm_process */
+    start();
+    assert(fsm_image_fsm_init(&imageFsm, &image) == FSM_RC_OK);
+    for (uint32_t s = 0; s < STEPS; s++)
+    {
+        fsm_state_t state;
+        assert(fsm_image_fsm_process(&imageFsm, eventOf(s)) == FSM_RC_OK);
+        assert(fsm_image_fsm_get_state(&imageFsm, &state) == FSM_RC_OK);
+        assert(state == expectedStates[s]);
+    }
+    assert(strcmp(trace, expectedTrace) == 0);
+
+    /* After a reset the entry action of the initial state runs again */
+    start();
+    assert(fsm_image_fsm_reset(&imageFsm) == FSM_RC_OK);
+    assert(fsm_image_fsm_process(&imageFsm, FSM_EVENT(0)) == FSM_RC_OK);
+    assert(strcmp(trace, "m1en|") == 0);
+
+    /* A damaged offset or symbol index fails the verification, a damaged header the load */
+    {
+        const uint32_t secondTransition = header->transitionsOffset + (uint32_t)sizeof(fsm_image_transition_t);
+        assertDamaged(buffer, size, secondTransition + offsetof(fsm_image_transition_t, toState), header->imageSize);
+        assertDamaged(buffer, size, secondTransition + offsetof(fsm_image_transition_t, action), symbolsCount);
+        assertDamaged(buffer, size, header->statesOffset + offsetof(fsm_image_state_t, transitions), header->imageSize);
+        assertDamaged(buffer, size, header->statesOffset + offsetof(fsm_image_state_t, dispatch), 2u);
+        assertDamaged(buffer, size, offsetof(fsm_image_header_t, magic), 0u);
+    }
+
+    /* Not representable */
+    assert(fsm_image_write(&fsmSubFsmCfg, symbols, symbolsCount, NULL, 0, &size) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_image_write(&fsmAfterCfg, symbols, symbolsCount, NULL, 0, &size) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_image_write(&fsmHugeCfg, NULL, 0, NULL, 0, &size) == FSM_RC_ERROR_INVALID_CONFIG);
+
+    printf("fsm_image_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
+
+static bool falseGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "f|");
+    return false;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file       fsm_optimize_test.c
+ * @brief      Optimized configurations against the input configuration
+ *
+ *             Runs the same events through a configuration and its optimized
+ *             copies, minimized and/or packed, and asserts the same action
+ *             trace and the states mapped to their representatives. Asserts
+ *             that equivalent states are merged unless a merge would turn a
+ *             state change into a self transition.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"          /* FSM types */
+#include "fsm_optimize.h" /* fsm_optimize */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};      /**< Sub fsm linked to MAIN_SUB */
+static fsm_t fsmMain = {0};     /**< Instance running the events */
+static char trace[4096];        /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .exitAction = {logAction, (fsm_arg_t) "s2ex"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, ACTIONS, GUARDS AND A SUB FSM ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {logAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/*** ACTION FREE STATEMACHINE, MAIN_2 AND SUB_2 ARE EQUIVALENT ***/
+static const fsm_cfg_t fsmPlainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 4,
+    .states = (const fsm_state_cfg_t[4]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_SUB},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_SUB},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_SUB},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_SUB_2},
+            },
+        },
+    },
+};
+
+/*** TWO EQUIVALENT STATES TOGGLING INTO EACH OTHER, THE ENTRY ACTIONS MUST STAY ***/
+static const fsm_cfg_t fsmToggleCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "en"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .entryAction = {logAction, (fsm_arg_t) "en"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/*** EVENTS, 'x' HAS NO EVENT OF ITS OWN ***/
+static const char input[] = "aabcabacbbcccaxbaabcbacbcaaxcbbacaccba";
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of an input character
+ *
+ * @param i_char 'a' to 'c', anything else has no event
+ */
+static fsm_event_t eventOf(char i_char)
+{
+    return (i_char >= 'a' && i_char <= 'c') ? (fsm_event_t)(i_char - 'a') : FSM_EVENT_COUNT;
+}
+
+/**
+ * @brief Run the input through fsm_process from a fresh instance
+ *
+ * @param i_config The main configuration
+ * @param o_states State of the main instance after each event
+ */
+static void runProcess(const fsm_cfg_t *i_config, fsm_state_t *o_states)
+{
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsmMain, i_config) == FSM_RC_OK);
+    trace[0] = '\0';
+    guardCalls = 0;
+    for (uint32_t i = 0; input[i] != '\0'; i++)
+    {
+        assert(fsm_process(&fsmMain, eventOf(input[i])) == FSM_RC_OK);
+        o_states[i] = fsmMain.currentState;
+    }
+}
+
+int main(void)
+{
+    enum
+    {
+        EVENTS_COUNT = sizeof(input) - 1u
+    };
+    static char expectedTrace[sizeof(trace)];
+    fsm_state_t expectedStates[EVENTS_COUNT];
+    fsm_state_t states[EVENTS_COUNT];
+    fsm_state_t stateMap[FSM_STATE_COUNT];
+    fsm_builder_t builder;
+    const fsm_cfg_t *optimizedCfg = NULL;
+
+    /* Every combination of the flags, the states map to their representative */
+    const fsm_cfg_t *const cfgs[] = {&fsmMainCfg, &fsmPlainCfg, &fsmToggleCfg};
+    for (uint32_t c = 0; c < sizeof(cfgs) / sizeof(cfgs[0]); c++)
+    {
+        runProcess(cfgs[c], expectedStates);
+        strcpy(expectedTrace, trace);
+        for (uint32_t flags = 0; flags <= (FSM_OPTIMIZE_MINIMIZE | FSM_OPTIMIZE_PACK); flags++)
+        {
+            fsm_optimize_report_t report = {.stateMap = stateMap, .stateMapCount = FSM_STATE_COUNT};
+            assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+            assert(fsm_optimize(cfgs[c], flags, &builder, &optimizedCfg, &report) == FSM_RC_OK);
+            assert(report.statesBefore == cfgs[c]->statesCount);
+            assert(report.statesAfter == optimizedCfg->statesCount);
+            assert(report.statesAfter <= report.statesBefore);
+            assert(report.transitionsAfter <= report.transitionsBefore);
+            assert((optimizedCfg->packed != NULL) == ((flags & FSM_OPTIMIZE_PACK) != 0));
+            if ((flags & FSM_OPTIMIZE_MINIMIZE) == 0)
+            {
+                assert(report.statesAfter == report.statesBefore);
+            }
+
+            runProcess(optimizedCfg, states);
+            assert(strcmp(trace, expectedTrace) == 0);
+            for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+            {
+                assert(states[i] == stateMap[expectedStates[i]]);
+            }
+            assert(fsm_builder_free(&builder) == FSM_RC_OK);
+        }
+    }
+
+    /* Minimization merges the equivalent states of the action free machine */
+    {
+        fsm_optimize_report_t report = {.stateMap = stateMap, .stateMapCount = FSM_STATE_COUNT};
+        assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+        assert(fsm_optimize(&fsmPlainCfg, FSM_OPTIMIZE_MINIMIZE, &builder, &optimizedCfg, &report) == FSM_RC_OK);
+        assert(report.statesAfter == report.statesBefore - 1u);
+        assert(stateMap[FSM_STATE_MAIN_2] == stateMap[FSM_STATE_SUB_2]);
+        assert(stateMap[FSM_STATE_MAIN_1] == FSM_STATE_MAIN_1);
+        assert(stateMap[FSM_STATE_MAIN_SUB] == FSM_STATE_MAIN_SUB);
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    /* Merging the toggling states would drop their entry actions */
+    {
+        fsm_optimize_report_t report = {.stateMap = stateMap, .stateMapCount = FSM_STATE_COUNT};
+        assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+        assert(fsm_optimize(&fsmToggleCfg, FSM_OPTIMIZE_MINIMIZE, &builder, &optimizedCfg, &report) == FSM_RC_OK);
+        assert(report.statesAfter == 2u);
+        assert(stateMap[FSM_STATE_MAIN_1] != stateMap[FSM_STATE_MAIN_2]);
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    /* Errors, a used builder and a too small state map */
+    {
+        fsm_optimize_report_t report = {.stateMap = stateMap, .stateMapCount = FSM_STATE_COUNT - 1u};
+        assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+        assert(fsm_optimize(&fsmPlainCfg, FSM_OPTIMIZE_MINIMIZE, &builder, &optimizedCfg, &report) ==
+               FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_optimize(&fsmPlainCfg, FSM_OPTIMIZE_MINIMIZE, &builder, &optimizedCfg, NULL) == FSM_RC_OK);
+        assert(fsm_optimize(&fsmPlainCfg, FSM_OPTIMIZE_MINIMIZE, &builder, &optimizedCfg, NULL) ==
+               FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_optimize(NULL, FSM_OPTIMIZE_MINIMIZE, &builder, &optimizedCfg, NULL) == FSM_RC_ERROR_NULLPTR);
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    printf("fsm_optimize_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
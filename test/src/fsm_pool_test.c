@@ -0,0 +1,302 @@
+/**
+ * @file       fsm_pool_test.c
+ * @brief      Pool instances against single instances
+ *
+ *             Runs the same interleaved events through the instances of a
+ *             pool and through one fsm_t per instance and asserts the same
+ *             action trace and states, one by one and batched. Asserts that
+ *             configurations the pool can not run are rejected.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_pool.h" /* fsm_pool_t */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};      /**< Sub fsm linked to MAIN_SUB, shared by all instances */
+static char trace[16384];       /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1, .action = {logAction, (fsm_arg_t) "s2e1"}},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, ACTIONS, A GUARD AND A SHARED SUB FSM ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .dispatch = FSM_DISPATCH_TABLE(3),
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {logAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/*** CONFIGURATIONS THE POOL CAN NOT RUN ***/
+static const fsm_cfg_t fsmSubCfgCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .subCfg = &fsmSubCfg,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1}},
+        },
+    },
+};
+
+static const fsm_cfg_t fsmRegionsCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .regions = &(const fsm_regions_t){.configs = (const fsm_cfg_t *const[1]){&fsmSubCfg}, .count = 1},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1}},
+        },
+    },
+};
+
+static const fsm_cfg_t fsmAfterCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .after = 10},
+            },
+        },
+    },
+};
+
+static const fsm_cfg_t fsmEveryCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .every = 5},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Instance and event of step i, instances interleaved
+ *
+ * @param i_step Index of the step
+ * @param o_instance The instance
+ */
+static fsm_event_t stepOf(uint32_t i_step, uint32_t *o_instance)
+{
+    *o_instance = (i_step * 7u) % 37u;
+    return (fsm_event_t)((i_step * i_step + i_step / 3u) % 3u);
+}
+
+/**
+ * @brief Clear the trace and restart the shared sub fsm
+ */
+static void start(void)
+{
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    trace[0] = '\0';
+    guardCalls = 0;
+}
+
+int main(void)
+{
+    enum
+    {
+        INSTANCES = 37,
+        STEPS = 400
+    };
+
+    static fsm_index_t stateIndex[INSTANCES];
+    static uint32_t firstRunBits[FSM_POOL_FIRST_RUN_WORDS(INSTANCES)];
+    static fsm_t instances[INSTANCES];
+    static char expectedTrace[sizeof(trace)];
+    fsm_pool_t pool;
+
+    /* One fsm_t per instance */
+    start();
+    for (uint32_t i = 0; i < INSTANCES; i++)
+    {
+        assert(fsm_init(&instances[i], &fsmMainCfg) == FSM_RC_OK);
+    }
+    for (uint32_t s = 0; s < STEPS; s++)
+    {
+        uint32_t instance;
+        fsm_event_t event = stepOf(s, &instance);
+        assert(fsm_process(&instances[instance], event) == FSM_RC_OK);
+    }
+    strcpy(expectedTrace, trace);
+    fsm_state_t expectedSubState = fsmSub.currentState;
+
+    /* The pool, one event at a time */
+    start();
+    assert(fsm_pool_init(&pool, &fsmMainCfg, stateIndex, firstRunBits, INSTANCES) == FSM_RC_OK);
+    for (uint32_t s = 0; s < STEPS; s++)
+    {
+        uint32_t instance;
+        fsm_event_t event = stepOf(s, &instance);
+        assert(fsm_pool_process(&pool, instance, event) == FSM_RC_OK);
+    }
+    assert(strcmp(trace, expectedTrace) == 0);
+    assert(fsmSub.currentState == expectedSubState);
+    for (uint32_t i = 0; i < INSTANCES; i++)
+    {
+        fsm_state_t state;
+        assert(fsm_pool_get_state(&pool, i, &state) == FSM_RC_OK);
+        assert(state == instances[i].currentState);
+    }
+
+    /* The pool, batched */
+    {
+        static fsm_pool_event_t batch[STEPS];
+        size_t processed = 0;
+        for (uint32_t s = 0; s < STEPS; s++)
+        {
+            batch[s].event = stepOf(s, &batch[s].instance);
+        }
+        start();
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            assert(fsm_pool_reset(&pool, i) == FSM_RC_OK);
+        }
+        assert(fsm_pool_process_batch(&pool, batch, STEPS, &processed) == FSM_RC_OK);
+        assert(processed == STEPS);
+        assert(strcmp(trace, expectedTrace) == 0);
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            fsm_state_t state;
+            assert(fsm_pool_get_state(&pool, i, &state) == FSM_RC_OK);
+            assert(state == instances[i].currentState);
+        }
+
+        /* A batch stops at the first instance out of range */
+        batch[5].instance = INSTANCES;
+        assert(fsm_pool_process_batch(&pool, batch, STEPS, &processed) == FSM_RC_ERROR_INVALID_ARG);
+        assert(processed == 5);
+    }
+
+    /* Reset, instance range */
+    {
+        fsm_state_t state;
+        assert(fsm_pool_reset(&pool, 3) == FSM_RC_OK);
+        assert(fsm_pool_get_state(&pool, 3, &state) == FSM_RC_OK);
+        assert(state == FSM_STATE_MAIN_1);
+        assert(fsm_pool_process(&pool, INSTANCES, FSM_EVENT_1) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_pool_get_state(&pool, INSTANCES, &state) == FSM_RC_ERROR_INVALID_ARG);
+    }
+
+    /* The instances have no storage for sub configurations, regions and timers */
+    assert(fsm_pool_init(&pool, &fsmSubCfgCfg, stateIndex, firstRunBits, INSTANCES) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_pool_init(&pool, &fsmRegionsCfg, stateIndex, firstRunBits, INSTANCES) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_pool_init(&pool, &fsmAfterCfg, stateIndex, firstRunBits, INSTANCES) == FSM_RC_ERROR_INVALID_CONFIG);
+    assert(fsm_pool_init(&pool, &fsmEveryCfg, stateIndex, firstRunBits, INSTANCES) == FSM_RC_ERROR_INVALID_CONFIG);
+
+    printf("fsm_pool_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
@@ -0,0 +1,396 @@
+/**
+ * @file       fsm_prof_test.c
+ * @brief      Profiler call tree, histograms and folded stacks
+ *
+ *             Profiles a main machine with a sub fsm and asserts the counts
+ *             per action and guard against an action trace, the nesting of
+ *             the run frames, the histograms of a slow action and the folded
+ *             stack output, cut to a short buffer included. Asserts the
+ *             dropped measurements of a full tree and the frames beyond the
+ *             maximum depth.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_prof.h" /* fsm_prof_write_folded */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define SPIN (1u << 16) /**< Minimal duration of the slow action */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Append the message to the trace and spin for SPIN ticks
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void slowAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};      /**< Sub fsm linked to MAIN_SUB */
+static fsm_t fsmMain = {0};     /**< Instance running the events */
+static char trace[4096];        /**< Trace of the actions */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard */
+
+/*** NAMES OF THE MAIN MACHINE, THE SUB FSM STATES STAY UNNAMED ***/
+static const char *const stateNames[FSM_STATE_COUNT] = {
+    [FSM_STATE_MAIN_1] = "MAIN_1",
+    [FSM_STATE_MAIN_2] = "MAIN_2",
+    [FSM_STATE_MAIN_SUB] = "MAIN_SUB",
+};
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .exitAction = {logAction, (fsm_arg_t) "s2ex"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, A SLOW DO ACTION, A GUARD AND A SUB FSM ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {slowAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/*** UNNAMED MACHINE ***/
+static const fsm_cfg_t fsmUnnamedCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .action = {logAction, (fsm_arg_t) "u"}},
+            },
+        },
+    },
+};
+
+/*** ACTIONS AND THE NODES THEY ARE ATTRIBUTED TO ***/
+static const struct
+{
+    const char *message;
+    const fsm_cfg_t *config;
+    fsm_state_t state;
+    fsm_prof_slot_t slot;
+} actionNodes[] = {
+    {"m1en|", &fsmMainCfg, FSM_STATE_MAIN_1, FSM_PROF_ENTRY},
+    {"m1e2|", &fsmMainCfg, FSM_STATE_MAIN_1, FSM_PROF_TRANSITION},
+    {"m2do|", &fsmMainCfg, FSM_STATE_MAIN_2, FSM_PROF_DO},
+    {"m2ex|", &fsmMainCfg, FSM_STATE_MAIN_2, FSM_PROF_EXIT},
+    {"m2e3|", &fsmMainCfg, FSM_STATE_MAIN_2, FSM_PROF_TRANSITION},
+    {"g|", &fsmMainCfg, FSM_STATE_MAIN_2, FSM_PROF_GUARD},
+    {"mse3|", &fsmMainCfg, FSM_STATE_MAIN_SUB, FSM_PROF_TRANSITION},
+    {"s1en|", &fsmSubCfg, FSM_STATE_SUB_1, FSM_PROF_ENTRY},
+    {"s1e2|", &fsmSubCfg, FSM_STATE_SUB_1, FSM_PROF_TRANSITION},
+    {"s2ex|", &fsmSubCfg, FSM_STATE_SUB_2, FSM_PROF_EXIT},
+};
+
+/*** EVENTS ***/
+static const char input[] = "aabcabacbbcccabaabcbacbcaacbbacaccba";
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Number of occurrences of a message in the trace
+ *
+ * @param i_message The message
+ */
+static uint64_t occurrences(const char *i_message)
+{
+    uint64_t count = 0;
+    for (const char *pos = strstr(trace, i_message); pos != NULL; pos = strstr(pos + 1, i_message))
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Check if the folded output has a line starting with the prefix
+ *
+ * @param i_folded The folded output
+ * @param i_prefix The prefix, up to the self time
+ */
+static bool hasLine(const char *i_folded, const char *i_prefix)
+{
+    size_t length = strlen(i_prefix);
+    for (const char *line = i_folded; *line != '\0'; line = strchr(line, '\n') + 1)
+    {
+        if (strncmp(line, i_prefix, length) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(void)
+{
+    enum
+    {
+        EVENTS_COUNT = sizeof(input) - 1u
+    };
+    static fsm_prof_node_t nodes[FSM_PROF_MAX_NODES];
+    static char folded[16384];
+
+    assert(fsm_prof_set_names(&fsmMainCfg, "main", stateNames, FSM_STATE_COUNT) == FSM_RC_OK);
+    assert(fsm_prof_set_names(&fsmSubCfg, "sub", NULL, 0) == FSM_RC_OK);
+    assert(fsm_prof_set_names(NULL, "none", NULL, 0) == FSM_RC_ERROR_NULLPTR);
+
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsmMain, &fsmMainCfg) == FSM_RC_OK);
+    for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+    {
+        assert(fsm_process(&fsmMain, (fsm_event_t)(input[i] - 'a')) == FSM_RC_OK);
+    }
+    assert(fsm_prof_dropped() == 0);
+    size_t nodesCount = fsm_prof_copy_nodes(nodes, FSM_PROF_MAX_NODES);
+    assert(nodesCount > 0);
+
+    /* Every node: parents first, histogram matching the count */
+    uint64_t mainRuns = 0;
+    uint64_t rootTotal = 0;
+    for (size_t n = 0; n < nodesCount; n++)
+    {
+        const fsm_prof_node_t *node = &nodes[n];
+        uint64_t histogramCount = 0;
+        for (uint32_t b = 0; b < FSM_PROF_HIST_BUCKETS; b++)
+        {
+            histogramCount += node->histogram[b];
+        }
+        assert(node->count > 0);
+        assert(histogramCount == node->count);
+        assert(node->min <= node->max && node->max <= node->total);
+        assert(node->parent == FSM_PROF_NONE || node->parent < n);
+        if (node->slot == FSM_PROF_RUN && node->config == &fsmMainCfg)
+        {
+            /* The main machine runs at the root */
+            assert(node->parent == FSM_PROF_NONE);
+            mainRuns += node->count;
+            rootTotal += node->total;
+        }
+        else
+        {
+            /* Actions and the runs of the sub fsm within a run frame of the main machine */
+            assert(node->parent != FSM_PROF_NONE && nodes[node->parent].slot == FSM_PROF_RUN);
+            assert(node->config == nodes[node->parent].config || node->slot == FSM_PROF_RUN);
+            if (node->slot == FSM_PROF_RUN)
+            {
+                assert(node->config == &fsmSubCfg && nodes[node->parent].config == &fsmMainCfg);
+            }
+        }
+    }
+    assert(mainRuns == EVENTS_COUNT);
+
+    /* Calls per action and guard, summed over the run frames they happened in */
+    for (uint32_t a = 0; a < sizeof(actionNodes) / sizeof(actionNodes[0]); a++)
+    {
+        uint64_t count = 0;
+        for (size_t n = 0; n < nodesCount; n++)
+        {
+            if (nodes[n].config == actionNodes[a].config && nodes[n].state == actionNodes[a].state &&
+                nodes[n].slot == actionNodes[a].slot)
+            {
+                count += nodes[n].count;
+            }
+        }
+        assert(count == occurrences(actionNodes[a].message));
+        assert(count > 0);
+    }
+
+    /* The slow action is in the buckets of SPIN and above */
+    for (size_t n = 0; n < nodesCount; n++)
+    {
+        if (nodes[n].config == &fsmMainCfg && nodes[n].slot == FSM_PROF_DO)
+        {
+            assert(nodes[n].min >= SPIN);
+            for (uint32_t b = 0; b <= 16u; b++)
+            {
+                assert(nodes[n].histogram[b] == 0);
+            }
+        }
+    }
+
+    /* Folded stacks, one line per node, the self times add up to the roots */
+    size_t length = fsm_prof_write_folded(folded, sizeof(folded));
+    assert(length == strlen(folded));
+    uint32_t lines = 0;
+    uint64_t selfTotal = 0;
+    for (const char *line = folded; *line != '\0'; line = strchr(line, '\n') + 1)
+    {
+        const char *self = strchr(line, ' ');
+        assert(self != NULL && self < strchr(line, '\n'));
+        unsigned long long value = 0;
+        assert(sscanf(self + 1, "%llu", &value) == 1);
+        selfTotal += value;
+        lines++;
+    }
+    assert(lines == nodesCount);
+    assert(selfTotal == rootTotal);
+    assert(hasLine(folded, "main:MAIN_1 ") == true);
+    assert(hasLine(folded, "main:MAIN_2;MAIN_2.do ") == true);
+    assert(hasLine(folded, "main:MAIN_2;MAIN_2.guard ") == true);
+    char label[64];
+    snprintf(label, sizeof(label), "main:MAIN_SUB;sub:%u;%u.transition ", FSM_STATE_SUB_1, FSM_STATE_SUB_1);
+    assert(hasLine(folded, label) == true);
+
+    /* Cut to the buffer, always terminated */
+    char shortBuffer[10];
+    assert(fsm_prof_write_folded(NULL, 0) == length);
+    assert(fsm_prof_write_folded(shortBuffer, sizeof(shortBuffer)) == length);
+    assert(strlen(shortBuffer) == sizeof(shortBuffer) - 1u);
+    assert(strncmp(shortBuffer, folded, sizeof(shortBuffer) - 1u) == 0);
+
+    /* Unnamed machines by address */
+    fsm_prof_reset();
+    assert(fsm_prof_copy_nodes(nodes, FSM_PROF_MAX_NODES) == 0);
+    assert(fsm_prof_write_folded(folded, sizeof(folded)) == 0 && folded[0] == '\0');
+    fsm_t unnamed;
+    assert(fsm_init(&unnamed, &fsmUnnamedCfg) == FSM_RC_OK);
+    assert(fsm_process(&unnamed, FSM_EVENT_1) == FSM_RC_OK);
+    fsm_prof_write_folded(folded, sizeof(folded));
+    snprintf(label, sizeof(label), "cfg_%llx:%u;%u.transition ", (unsigned long long)(uintptr_t)&fsmUnnamedCfg,
+             FSM_STATE_MAIN_1, FSM_STATE_MAIN_1);
+    assert(hasLine(folded, label) == true);
+
+    /* Outside of a run frame and beyond the nodes of the tree */
+    fsm_prof_reset();
+    fsm_prof_record(FSM_STATE_MAIN_1, FSM_PROF_DO, fsm_prof_now());
+    assert(fsm_prof_dropped() == 1u);
+    for (uint32_t s = 0; s < FSM_PROF_MAX_NODES + 5u; s++)
+    {
+        fsm_prof_enter(&fsmUnnamedCfg, (fsm_state_t)s);
+        fsm_prof_leave();
+    }
+    assert(fsm_prof_copy_nodes(nodes, FSM_PROF_MAX_NODES) == FSM_PROF_MAX_NODES);
+    assert(fsm_prof_dropped() == 6u);
+
+    /* Runs nested deeper than the frames count to the innermost frame */
+    fsm_prof_reset();
+    for (uint32_t d = 0; d < FSM_PROF_MAX_DEPTH + 4u; d++)
+    {
+        fsm_prof_enter(&fsmUnnamedCfg, (fsm_state_t)d);
+    }
+    fsm_prof_record(FSM_STATE_MAIN_1, FSM_PROF_DO, fsm_prof_now());
+    for (uint32_t d = 0; d < FSM_PROF_MAX_DEPTH + 4u; d++)
+    {
+        fsm_prof_leave();
+    }
+    assert(fsm_prof_copy_nodes(nodes, FSM_PROF_MAX_NODES) == FSM_PROF_MAX_DEPTH + 1u);
+    assert(nodes[FSM_PROF_MAX_DEPTH].slot == FSM_PROF_DO);
+    assert(nodes[FSM_PROF_MAX_DEPTH].parent == FSM_PROF_MAX_DEPTH - 1u);
+    assert(nodes[FSM_PROF_MAX_DEPTH - 1u].count == 1u);
+    assert(fsm_prof_dropped() == 0);
+
+    printf("fsm_prof_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static void slowAction(fsm_arg_t i_message)
+{
+    logAction(i_message);
+    uint64_t start = fsm_prof_now();
+    while (fsm_prof_now() - start < SPIN)
+    {
+    }
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
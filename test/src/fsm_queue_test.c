@@ -0,0 +1,227 @@
+/**
+ * @file       fsm_queue_test.c
+ * @brief      Event queue with several producers
+ *
+ *             Asserts that a full queue drops and counts the event, that the
+ *             slot sequence numbers keep working when the positions wrap
+ *             around and that the events of every producer thread arrive
+ *             complete and in the order they were posted.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* pthreads */
+
+#include "fsm.h"       /* FSM types */
+#include "fsm_queue.h" /* fsm_post */
+
+#undef NDEBUG
+#include <assert.h>  /* assert */
+#include <pthread.h> /* for threads */
+#include <sched.h>   /* for sched_yield */
+#include <stdio.h>   /* printf */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define PRODUCERS 4u             /**< Producer threads */
+#define LAP 16u                  /**< Events per producer before its sequence repeats */
+#define EVENTS (PRODUCERS * LAP) /**< Size of the event enum: event = producer * LAP + sequence % LAP */
+#define POSTS 50000u             /**< Events posted by every producer */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Check and count the event of a producer
+ *
+ * @param i_event is casted back to the event number
+ */
+static void receiveAction(fsm_arg_t i_event);
+
+/**
+ * @brief Post the events of one producer, retrying while the queue is full
+ *
+ * @param i_producer is casted back to the producer number
+ */
+static void *producerMain(void *i_producer);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsm = {0};                 /**< Instance behind the queue */
+static fsm_queue_t queue;               /**< Queue under test */
+static uint32_t received[PRODUCERS];    /**< Events received per producer */
+static uint32_t fullReturns[PRODUCERS]; /**< FSM_RC_ERROR_QUEUE_FULL seen per producer */
+static fsm_event_t receivedOrder[64];   /**< Events received in the single threaded part */
+static uint32_t receivedCount = 0;      /**< Entries in receivedOrder */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+#define T(e) {.event = FSM_EVENT(e), .toState = FSM_STATE_MAIN_1, .action = {receiveAction, (fsm_arg_t)(uintptr_t)(e)}}
+#define T4(e) T(e), T((e) + 1), T((e) + 2), T((e) + 3)
+#define T16(e) T4(e), T4((e) + 4), T4((e) + 8), T4((e) + 12)
+
+/*** ONE STATE, EVERY EVENT REPORTS ITSELF ***/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .eventEnumCount = EVENTS,
+    .dispatch = FSM_DISPATCH_TABLE_FOR(1, FSM_STATE_COUNT, EVENTS),
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = EVENTS,
+            .transitions = (const fsm_transition_cfg_t[EVENTS]){T16(0), T16(16), T16(32), T16(48)},
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Initialize the queue with its positions just before base
+ *
+ * Sets the positions and slot sequence numbers as if base events had passed.
+ *
+ * @param i_slots Storage of the queue
+ * @param i_capacity Number of slots
+ * @param i_base Position of the next post and dispatch
+ */
+static void startAt(fsm_queue_slot_t *i_slots, size_t i_capacity, size_t i_base)
+{
+    assert(fsm_queue_init(&queue, &fsm, i_slots, i_capacity) == FSM_RC_OK);
+    for (size_t i = 0; i < i_capacity; i++)
+    {
+        size_t pos = i_base + i;
+        atomic_store(&i_slots[pos & (i_capacity - 1u)].sequence, pos);
+    }
+    atomic_store(&queue.head, i_base);
+    queue.tail = i_base;
+    receivedCount = 0;
+}
+
+int main(void)
+{
+    assert(fsm_cfg_prepare(&fsmCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+
+    /* A full queue drops the event and counts it, across the wrap of the positions */
+    {
+        static const size_t bases[] = {0, SIZE_MAX - 20u};
+        fsm_queue_slot_t slots[8];
+        for (uint32_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++)
+        {
+            startAt(slots, 8, bases[b]);
+            for (uint32_t lap = 0; lap < 6u; lap++)
+            {
+                for (uint32_t i = 0; i < 8u; i++)
+                {
+                    assert(fsm_post(&queue, FSM_EVENT((lap * 8u + i) % LAP)) == FSM_RC_OK);
+                }
+                assert(fsm_post(&queue, FSM_EVENT(0)) == FSM_RC_ERROR_QUEUE_FULL);
+                assert(fsm_post(&queue, FSM_EVENT(1)) == FSM_RC_ERROR_QUEUE_FULL);
+                assert(fsm_queue_take_overflows(&queue) == 2u);
+                assert(fsm_queue_take_overflows(&queue) == 0u);
+
+                size_t dispatched = 0;
+                assert(fsm_dispatch_pending(&queue, &dispatched) == FSM_RC_OK);
+                assert(dispatched == 8u);
+                assert(receivedCount == 8u);
+                for (uint32_t i = 0; i < 8u; i++)
+                {
+                    assert(receivedOrder[i] == FSM_EVENT((lap * 8u + i) % LAP));
+                }
+                receivedCount = 0;
+                assert(fsm_dispatch_pending(&queue, &dispatched) == FSM_RC_OK);
+                assert(dispatched == 0u);
+            }
+        }
+        for (uint32_t p = 0; p < PRODUCERS; p++)
+        {
+            received[p] = 0;
+        }
+    }
+
+    /* Producers post concurrently, the owner thread dispatches */
+    {
+        static fsm_queue_slot_t slots[64];
+        pthread_t producers[PRODUCERS];
+        startAt(slots, 64, SIZE_MAX - 1000u);
+        for (uint32_t p = 0; p < PRODUCERS; p++)
+        {
+            assert(pthread_create(&producers[p], NULL, producerMain, (void *)(uintptr_t)p) == 0);
+        }
+
+        uint64_t total = 0;
+        while (total < (uint64_t)PRODUCERS * POSTS)
+        {
+            size_t dispatched = 0;
+            assert(fsm_dispatch_pending(&queue, &dispatched) == FSM_RC_OK);
+            total += dispatched;
+            if (dispatched == 0)
+            {
+                sched_yield();
+            }
+        }
+
+        uint64_t fulls = 0;
+        for (uint32_t p = 0; p < PRODUCERS; p++)
+        {
+            assert(pthread_join(producers[p], NULL) == 0);
+            assert(received[p] == POSTS);
+            fulls += fullReturns[p];
+        }
+        size_t dispatched = 0;
+        assert(fsm_dispatch_pending(&queue, &dispatched) == FSM_RC_OK);
+        assert(dispatched == 0u);
+        assert(fsm_queue_take_overflows(&queue) == fulls);
+        printf("producers: %u x %u events, %llu full returns\n",
+               PRODUCERS, POSTS, (unsigned long long)fulls);
+    }
+
+    printf("fsm_queue_test: passed\n");
+    return 0;
+}
+
+static void receiveAction(fsm_arg_t i_event)
+{
+    uint32_t event = (uint32_t)(uintptr_t)i_event;
+    uint32_t producer = event / LAP;
+    if (receivedCount < sizeof(receivedOrder) / sizeof(receivedOrder[0]))
+    {
+        receivedOrder[receivedCount++] = FSM_EVENT(event);
+    }
+
+    /* In order per producer: the sequence continues where it left off */
+    assert(event % LAP == received[producer] % LAP);
+    received[producer]++;
+}
+
+static void *producerMain(void *i_producer)
+{
+    uint32_t producer = (uint32_t)(uintptr_t)i_producer;
+    for (uint32_t i = 0; i < POSTS; i++)
+    {
+        fsm_event_t event = FSM_EVENT(producer * LAP + i % LAP);
+        fsm_RC_t res;
+        while ((res = fsm_post(&queue, event)) == FSM_RC_ERROR_QUEUE_FULL)
+        {
+            fullReturns[producer]++;
+            sched_yield();
+        }
+        assert(res == FSM_RC_OK);
+    }
+    return NULL;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file       fsm_raise_test.c
+ * @brief      Order of the events raised by actions
+ *
+ *             Asserts that raised events run after the raising event has
+ *             completed, before the next event passed in, by descending
+ *             priority and in raise order within a priority, and that a full
+ *             queue is reported to the raising action.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h" /* FSM types */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message and the current state of the instance to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Log, then raise FSM_EVENT_2 and FSM_EVENT_3
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void raiseTwoAction(fsm_arg_t i_message);
+
+/**
+ * @brief Log, then raise FSM_EVENT_1 with priority 0, FSM_EVENT_2 with 1 and
+ *        FSM_EVENT_3 with 1
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void raisePrioAction(fsm_arg_t i_message);
+
+/**
+ * @brief Log, then process FSM_EVENT_3 from within the action
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void processAction(fsm_arg_t i_message);
+
+/**
+ * @brief Raise FSM_EVENT_2 until the queue is full, log the number of raised
+ *        events
+ *
+ * @param i_message unused
+ */
+static void floodAction(fsm_arg_t i_message);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsm = {0};  /**< Instance under test */
+static char trace[1024]; /**< Trace of the actions */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2, .action = {raiseTwoAction, (fsm_arg_t) "1e1"}},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_SUB, .action = {raisePrioAction, (fsm_arg_t) "1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .entryAction = {logAction, (fsm_arg_t) "2en"},
+            .exitAction = {logAction, (fsm_arg_t) "2ex"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "2e2"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "se1"}},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_SUB, .action = {processAction, (fsm_arg_t) "se2"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "se3"}},
+            },
+        },
+    },
+};
+
+/*** RAISES UNTIL THE QUEUE IS FULL ***/
+static const fsm_cfg_t fsmFloodCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 1,
+    .states = (const fsm_state_cfg_t[1]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .action = {floodAction, NULL}},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_1, .action = {logAction, (fsm_arg_t) "e2"}},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Process one event on a fresh trace and check the queue is drained
+ *
+ * @param i_event The event
+ */
+static void process(fsm_event_t i_event)
+{
+    trace[0] = '\0';
+    assert(fsm_process(&fsm, i_event) == FSM_RC_OK);
+    assert(fsm.isProcessing == false);
+    assert(fsm.raisedCount == 0);
+}
+
+int main(void)
+{
+    assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+
+    /* Raised after the state change, in raise order: E2 in MAIN_2, then E3 */
+    process(FSM_EVENT_1);
+    assert(strcmp(trace, "1e1@0|2en@0|2e2@1|2ex@1|2e3@1|") == 0);
+    assert(fsm.currentState == FSM_STATE_MAIN_SUB);
+
+    /* By priority, raise order within a priority; se2 processes E3, which is queued behind E1 */
+    assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+    process(FSM_EVENT_2);
+    assert(strcmp(trace, "1e2@0|se2@2|se3@2|se1@2|se3@2|") == 0);
+    assert(fsm.currentState == FSM_STATE_MAIN_SUB);
+
+    /* Raised events run before the next event passed in */
+    {
+        static const fsm_event_t events[] = {FSM_EVENT_1, FSM_EVENT_1};
+        size_t processed = 0;
+        assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+        trace[0] = '\0';
+        assert(fsm_process_many(&fsm, events, 2, &processed) == FSM_RC_OK);
+        assert(processed == 2);
+        assert(strcmp(trace, "1e1@0|2en@0|2e2@1|2ex@1|2e3@1|se1@2|") == 0);
+        assert(fsm.currentState == FSM_STATE_MAIN_SUB);
+    }
+
+    /* The queue takes FSM_RAISE_QUEUE_SIZE events, the raised ones are all processed */
+    assert(fsm_init(&fsm, &fsmFloodCfg) == FSM_RC_OK);
+    process(FSM_EVENT_1);
+    {
+        static char expected[sizeof(trace)];
+        snprintf(expected, sizeof(expected), "raised %u|", (unsigned)FSM_RAISE_QUEUE_SIZE);
+        for (uint32_t i = 0; i < FSM_RAISE_QUEUE_SIZE; i++)
+        {
+            strcat(expected, "e2@0|");
+        }
+        assert(strcmp(trace, expected) == 0);
+    }
+
+    /* Outside of fsm_process the event is processed right away */
+    assert(fsm_init(&fsm, &fsmCfg) == FSM_RC_OK);
+    trace[0] = '\0';
+    assert(fsm_raise(&fsm, FSM_EVENT_1) == FSM_RC_OK);
+    assert(strcmp(trace, "1e1@0|2en@0|2e2@1|2ex@1|2e3@1|") == 0);
+    assert(fsm.raisedCount == 0);
+
+    printf("fsm_raise_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    char entry[32];
+    snprintf(entry, sizeof(entry), "%s@%d|", (const char *)i_message, (int)fsm.currentState);
+    strcat(trace, entry);
+}
+
+static void raiseTwoAction(fsm_arg_t i_message)
+{
+    logAction(i_message);
+    assert(fsm_raise(&fsm, FSM_EVENT_2) == FSM_RC_OK);
+    assert(fsm_raise(&fsm, FSM_EVENT_3) == FSM_RC_OK);
+}
+
+static void raisePrioAction(fsm_arg_t i_message)
+{
+    logAction(i_message);
+    assert(fsm_raise_prio(&fsm, FSM_EVENT_1, 0) == FSM_RC_OK);
+    assert(fsm_raise_prio(&fsm, FSM_EVENT_2, 1) == FSM_RC_OK);
+    assert(fsm_raise_prio(&fsm, FSM_EVENT_3, 1) == FSM_RC_OK);
+}
+
+static void processAction(fsm_arg_t i_message)
+{
+    logAction(i_message);
+    assert(fsm_process(&fsm, FSM_EVENT_3) == FSM_RC_OK);
+}
+
+static void floodAction(fsm_arg_t i_message)
+{
+    (void)i_message;
+    uint32_t raised = 0;
+    while (fsm_raise(&fsm, FSM_EVENT_2) == FSM_RC_OK)
+    {
+        raised++;
+    }
+    char entry[32];
+    snprintf(entry, sizeof(entry), "raised %u|", (unsigned)raised);
+    strcat(trace, entry);
+}
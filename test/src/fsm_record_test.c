@@ -0,0 +1,207 @@
+/**
+ * @file       fsm_record_test.c
+ * @brief      Recording and replaying event logs
+ *
+ *             Records the events of two instances, including failing ones,
+ *             replays the log into fresh instances and asserts that every
+ *             event is reproduced, that differing machines are reported as
+ *             mismatches and that corrupt logs are rejected.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"        /* FSM types */
+#include "fsm_record.h" /* fsm_record_bind */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* memcpy */
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmUnset = {0}; /**< Never initialized sub fsm, events forwarded to it fail */
+static uint8_t log_[4096];   /**< The flushed log */
+static size_t logSize = 0;   /**< Bytes in the flushed log */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmUnset,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/*** SAME MACHINE, FSM_EVENT_2 LEAVES MAIN_2 ***/
+static const fsm_cfg_t fsmOtherCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmUnset,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Append the flushed records to the log
+ *
+ * @param i_arg unused
+ * @param i_data The records
+ * @param i_size Number of bytes
+ */
+static fsm_RC_t appendLog(void *i_arg, const uint8_t *i_data, size_t i_size)
+{
+    (void)i_arg;
+    assert(logSize + i_size <= sizeof(log_));
+    memcpy(&log_[logSize], i_data, i_size);
+    logSize += i_size;
+    return FSM_RC_OK;
+}
+
+int main(void)
+{
+    /* Event and instance, FSM_EVENT_1 and FSM_EVENT_2 fail in MAIN_SUB */
+    static const struct
+    {
+        uint32_t instance;
+        fsm_event_t event;
+    } events[] = {
+        {0, FSM_EVENT_1}, {1, FSM_EVENT_3}, {0, FSM_EVENT_2}, {1, FSM_EVENT_1}, {0, FSM_EVENT_2},
+        {1, FSM_EVENT_3}, {0, FSM_EVENT_1}, {1, FSM_EVENT_1}, {0, FSM_EVENT_3}, {0, FSM_EVENT_2},
+        {1, FSM_EVENT_2}, {0, FSM_EVENT_3}, {0, FSM_EVENT_1}, {1, FSM_EVENT_3}, {0, FSM_EVENT_2},
+    };
+    enum
+    {
+        EVENTS_COUNT = sizeof(events) / sizeof(events[0])
+    };
+
+    /* Record through a small buffer, so the log is flushed several times */
+    static uint8_t buffer[sizeof(fsm_record_header_t) + 2u * FSM_RECORD_MAX_SIZE];
+    fsm_recorder_t recorder;
+    fsm_record_t bindings[2];
+    fsm_t instances[2];
+    fsm_state_t finalStates[2];
+    uint32_t failed = 0;
+    assert(fsm_recorder_init(&recorder, buffer, sizeof(buffer), appendLog, NULL) == FSM_RC_OK);
+    for (uint32_t i = 0; i < 2u; i++)
+    {
+        assert(fsm_init(&instances[i], &fsmCfg) == FSM_RC_OK);
+        assert(fsm_record_bind(&instances[i], &bindings[i], &recorder, i) == FSM_RC_OK);
+    }
+    for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+    {
+        if (fsm_process(&instances[events[i].instance], events[i].event) != FSM_RC_OK)
+        {
+            failed++;
+        }
+    }
+    assert(fsm_recorder_flush(&recorder) == FSM_RC_OK);
+    assert(recorder.recordsCount == EVENTS_COUNT);
+    assert(recorder.dropped == 0);
+    assert(failed > 0);
+    for (uint32_t i = 0; i < 2u; i++)
+    {
+        finalStates[i] = instances[i].currentState;
+        assert(fsm_record_unbind(&instances[i]) == FSM_RC_OK);
+    }
+
+    /* Replay into fresh instances: every event, the failures fail again */
+    fsm_t *const replayed[2] = {&instances[0], &instances[1]};
+    fsm_replay_report_t report;
+    for (uint32_t i = 0; i < 2u; i++)
+    {
+        assert(fsm_init(&instances[i], &fsmCfg) == FSM_RC_OK);
+    }
+    assert(fsm_replay(log_, logSize, replayed, 2, &report) == FSM_RC_OK);
+    assert(report.events == EVENTS_COUNT);
+    assert(report.errors == failed);
+    assert(report.mismatches == 0);
+    assert(report.firstMismatch == UINT64_MAX);
+    assert(instances[0].currentState == finalStates[0]);
+    assert(instances[1].currentState == finalStates[1]);
+
+    /* A machine behaving differently is reported from the first differing event */
+    assert(fsm_init(&instances[0], &fsmOtherCfg) == FSM_RC_OK);
+    assert(fsm_init(&instances[1], &fsmCfg) == FSM_RC_OK);
+    assert(fsm_replay(log_, logSize, replayed, 2, &report) == FSM_RC_OK);
+    assert(report.mismatches > 0);
+    assert(report.firstMismatch == 2);
+
+    /* Events of instances without a slot are skipped and counted as errors */
+    assert(fsm_init(&instances[0], &fsmCfg) == FSM_RC_OK);
+    assert(fsm_replay(log_, logSize, replayed, 1, &report) == FSM_RC_OK);
+    assert(report.events == EVENTS_COUNT);
+    assert(report.mismatches == 0);
+    assert(instances[0].currentState == finalStates[0]);
+
+    /* A truncated record or a foreign header is rejected */
+    assert(fsm_init(&instances[0], &fsmCfg) == FSM_RC_OK);
+    assert(fsm_init(&instances[1], &fsmCfg) == FSM_RC_OK);
+    assert(fsm_replay(log_, logSize - 1u, replayed, 2, &report) == FSM_RC_ERROR_INVALID_ARG);
+    assert(report.events == EVENTS_COUNT - 1u);
+    log_[0] ^= 0xFFu;
+    assert(fsm_replay(log_, logSize, replayed, 2, &report) == FSM_RC_ERROR_INVALID_ARG);
+
+    printf("fsm_record_test: passed\n");
+    return 0;
+}
@@ -0,0 +1,425 @@
+/**
+ * @file       fsm_reorder_test.c
+ * @brief      Reordered configurations against the profiled ones
+ *
+ *             Profiles a machine with linear lookups and with builder made
+ *             configurations using the dense, the row displaced and no
+ *             dispatch table, reorders each of them into a copy and in place
+ *             and asserts the same action trace and states. Asserts the
+ *             layout hottest first, the first of the guarded transitions
+ *             sharing an event still winning and every cell of the dispatch
+ *             tables pointing to the moved transition.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"         /* FSM types */
+#include "fsm_reorder.h" /* fsm_reorder */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define STEPS 600u /**< Events processed per run */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static char trace[32768];       /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** COLD STATES AND TRANSITIONS FIRST, THE FIRST OF THE TRANSITIONS ON EVENT_1 OF MAIN_2 WINS ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 4,
+    .states = (const fsm_state_cfg_t[4]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_1, .action = {logAction, (fsm_arg_t) "s1e2"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "s1e1"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_1, .action = {logAction, (fsm_arg_t) "mse2"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {logAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 4,
+            .transitions = (const fsm_transition_cfg_t[4]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m2e2"}},
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e1"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_SUB_1, .action = {logAction, (fsm_arg_t) "m1e3"}},
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of step i, half of them FSM_EVENT_1
+ *
+ * @param i_step Index of the step
+ */
+static fsm_event_t eventOf(uint32_t i_step)
+{
+    uint32_t rand = (i_step * 1103515245u + 12345u) >> 16;
+    return (rand % 10u < 5u) ? FSM_EVENT_1 : ((rand % 10u < 8u) ? FSM_EVENT_3 : FSM_EVENT_2);
+}
+
+/**
+ * @brief Run the events through fsm_process on a fresh instance
+ *
+ * @param i_config The configuration
+ * @param io_hits [optional] Counters to bind the instance to
+ * @param o_states State after each event
+ */
+static void run(const fsm_cfg_t *i_config, fsm_hits_t *io_hits, fsm_state_t *o_states)
+{
+    fsm_t fsm;
+    fsm_hits_binding_t binding;
+    assert(fsm_init(&fsm, i_config) == FSM_RC_OK);
+    if (io_hits != NULL)
+    {
+        assert(fsm_hits_bind(&fsm, &binding, io_hits) == FSM_RC_OK);
+    }
+    trace[0] = '\0';
+    guardCalls = 0;
+    for (uint32_t s = 0; s < STEPS; s++)
+    {
+        assert(fsm_process(&fsm, eventOf(s)) == FSM_RC_OK);
+        o_states[s] = fsm.currentState;
+    }
+    assert(fsm_hits_unbind(&fsm) == FSM_RC_OK);
+}
+
+/**
+ * @brief Stage the states and transitions of fsmMainCfg in declaration order
+ *
+ * @param io_builder The builder
+ */
+static void stage(fsm_builder_t *io_builder)
+{
+    for (uint32_t i = 0; i < fsmMainCfg.statesCount; i++)
+    {
+        const fsm_state_cfg_t *stateCfg = &fsmMainCfg.states[i];
+        assert(fsm_builder_add_state(io_builder, stateCfg->state) == FSM_RC_OK);
+        assert(fsm_builder_set_actions(io_builder, stateCfg->state, stateCfg->entryAction, stateCfg->doAction,
+                                       stateCfg->exitAction) == FSM_RC_OK);
+        for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+        {
+            assert(fsm_builder_add_transition(io_builder, stateCfg->state, &stateCfg->transitions[t]) == FSM_RC_OK);
+        }
+    }
+    assert(fsm_builder_set_initial(io_builder, fsmMainCfg.initialState) == FSM_RC_OK);
+}
+
+/**
+ * @brief Index of a state in the states array of a configuration
+ *
+ * @param i_config The configuration
+ * @param i_state The state
+ */
+static uint32_t indexOf(const fsm_cfg_t *i_config, fsm_state_t i_state)
+{
+    uint32_t i = 0;
+    while (i_config->states[i].state != i_state)
+    {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Index of a transition in the declaration of its state in fsmMainCfg
+ *
+ * @param i_state The state
+ * @param i_transition The transition, equal to a declared one
+ */
+static uint32_t declaredAt(fsm_state_t i_state, const fsm_transition_cfg_t *i_transition)
+{
+    const fsm_state_cfg_t *stateCfg = &fsmMainCfg.states[indexOf(&fsmMainCfg, i_state)];
+    uint32_t t = 0;
+    while (memcmp(&stateCfg->transitions[t], i_transition, sizeof(fsm_transition_cfg_t)) != 0)
+    {
+        t++;
+    }
+    return t;
+}
+
+/**
+ * @brief Assert transitions hottest first, the ones sharing an event in declaration order
+ *
+ * @param i_config The reordered configuration
+ * @param i_hits Counters of the profiled configuration
+ *
+ * @return true if a transition left its declared position
+ */
+static bool assertLayout(const fsm_cfg_t *i_config, const fsm_hits_t *i_hits)
+{
+    bool isMoved = false;
+    assert(i_config->statesCount == fsmMainCfg.statesCount);
+    for (uint32_t i = 0; i < i_config->statesCount; i++)
+    {
+        const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+        const uint32_t *row = &i_hits->counts[indexOf(i_hits->config, stateCfg->state) * i_hits->rowSize];
+        for (uint32_t t = 0; t < stateCfg->transitionsCount; t++)
+        {
+            uint32_t declared = declaredAt(stateCfg->state, &stateCfg->transitions[t]);
+            isMoved = isMoved || (declared != t);
+            if (t == 0)
+            {
+                continue;
+            }
+            const fsm_transition_cfg_t *prev = &stateCfg->transitions[t - 1u];
+            assert(row[prev->event] >= row[stateCfg->transitions[t].event]);
+            assert(prev->event != stateCfg->transitions[t].event || declaredAt(stateCfg->state, prev) < declared);
+        }
+    }
+    return isMoved;
+}
+
+/**
+ * @brief Assert every cell of the dispatch table at the first transition of its event
+ *
+ * @param i_config The reordered configuration
+ */
+static void assertCells(const fsm_cfg_t *i_config)
+{
+    const fsm_dispatch_t *dispatch = i_config->dispatch;
+    const fsm_packed_t *packed = i_config->packed;
+    for (uint32_t i = 0; i < i_config->statesCount; i++)
+    {
+        const fsm_state_cfg_t *stateCfg = &i_config->states[i];
+        for (uint32_t e = 0; e < FSM_EVENT_COUNT; e++)
+        {
+            uint32_t first = 0;
+            while (first < stateCfg->transitionsCount && stateCfg->transitions[first].event != (fsm_event_t)e)
+            {
+                first++;
+            }
+            bool isHandled = first < stateCfg->transitionsCount;
+            fsm_index_t transition = FSM_INDEX_NONE;
+            fsm_index_t toState = FSM_INDEX_NONE;
+            if (dispatch != NULL)
+            {
+                transition = dispatch->cells[i * dispatch->rowSize + e].transition;
+                toState = dispatch->cells[i * dispatch->rowSize + e].toState;
+            }
+            else if (packed->cells[packed->rowBase[i] + e].state == (fsm_index_t)i)
+            {
+                transition = packed->cells[packed->rowBase[i] + e].transition;
+                toState = packed->cells[packed->rowBase[i] + e].toState;
+            }
+            assert((transition != FSM_INDEX_NONE) == isHandled);
+            if (isHandled == true)
+            {
+                assert(transition == (fsm_index_t)first);
+                assert(i_config->states[toState].state == stateCfg->transitions[first].toState);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    static fsm_state_t expectedStates[STEPS];
+    static char expectedTrace[sizeof(trace)];
+    static uint32_t counts[FSM_HITS_COUNT(4, FSM_EVENT_COUNT)];
+    fsm_hits_t hits;
+
+    /* Reference run, its lookups profiled */
+    assert(fsm_hits_init(&hits, &fsmMainCfg, counts, FSM_HITS_COUNT(4, FSM_EVENT_COUNT)) == FSM_RC_OK);
+    run(&fsmMainCfg, &hits, expectedStates);
+    strcpy(expectedTrace, trace);
+
+    /* Counters of two instances add up */
+    {
+        static uint32_t countsOther[FSM_HITS_COUNT(4, FSM_EVENT_COUNT)];
+        static uint32_t countsBoth[FSM_HITS_COUNT(4, FSM_EVENT_COUNT)];
+        fsm_hits_t other;
+        fsm_hits_t both;
+        fsm_state_t states[STEPS];
+        assert(fsm_hits_init(&other, &fsmMainCfg, countsOther, FSM_HITS_COUNT(4, FSM_EVENT_COUNT)) == FSM_RC_OK);
+        assert(fsm_hits_init(&both, &fsmMainCfg, countsBoth, FSM_HITS_COUNT(4, FSM_EVENT_COUNT)) == FSM_RC_OK);
+        run(&fsmMainCfg, &other, states);
+        run(&fsmMainCfg, &both, states);
+        assert(fsm_hits_merge(&both, &other) == FSM_RC_OK);
+        for (uint32_t i = 0; i < FSM_HITS_COUNT(4, FSM_EVENT_COUNT); i++)
+        {
+            assert(countsBoth[i] == 2u * counts[i]);
+        }
+    }
+
+    /* Compound literal without table, builder made with the dense, the row displaced and no table */
+    for (uint32_t mode = 0; mode < 4u; mode++)
+    {
+        fsm_builder_t builder;
+        fsm_builder_t copyBuilder;
+        const fsm_cfg_t *config = &fsmMainCfg;
+        const fsm_cfg_t *copy = NULL;
+        fsm_state_t states[STEPS];
+        if (mode > 0)
+        {
+            assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+            assert(fsm_builder_set_linear(&builder, mode == 3u) == FSM_RC_OK);
+            assert(fsm_builder_set_packed(&builder, mode == 2u) == FSM_RC_OK);
+            stage(&builder);
+            assert(fsm_builder_finalize(&builder, &config) == FSM_RC_OK);
+        }
+        assert(fsm_hits_init(&hits, config, counts, FSM_HITS_COUNT(4, FSM_EVENT_COUNT)) == FSM_RC_OK);
+        run(config, &hits, states);
+        assert(strcmp(trace, expectedTrace) == 0);
+        assert(memcmp(states, expectedStates, sizeof(states)) == 0);
+
+        /* Copy with the lookup of the profiled configuration, hottest state first */
+        assert(fsm_builder_init(&copyBuilder, 0) == FSM_RC_OK);
+        assert(fsm_reorder(config, &hits, &copyBuilder, &copy) == FSM_RC_OK);
+        assert((copy->dispatch != NULL) == (config->dispatch != NULL));
+        assert((copy->packed != NULL) == (config->packed != NULL));
+        for (uint32_t i = 1; i < copy->statesCount; i++)
+        {
+            uint64_t totals[2] = {0};
+            for (uint32_t k = 0; k < 2u; k++)
+            {
+                uint32_t row = indexOf(config, copy->states[i - k].state);
+                for (uint32_t e = 0; e < hits.rowSize; e++)
+                {
+                    totals[k] += counts[row * hits.rowSize + e];
+                }
+            }
+            assert(totals[1] >= totals[0]);
+        }
+        bool isMoved = false;
+        for (uint32_t i = 0; i < copy->statesCount; i++)
+        {
+            isMoved = isMoved || (copy->states[i].state != fsmMainCfg.states[i].state);
+        }
+        assert(isMoved == true);
+        assert(assertLayout(copy, &hits) == true);
+        if (copy->dispatch != NULL || copy->packed != NULL)
+        {
+            assertCells(copy);
+        }
+        run(copy, NULL, states);
+        assert(strcmp(trace, expectedTrace) == 0);
+        assert(memcmp(states, expectedStates, sizeof(states)) == 0);
+        assert(fsm_builder_free(&copyBuilder) == FSM_RC_OK);
+        if (mode == 0)
+        {
+            continue;
+        }
+
+        /* In place, the states stay at their index */
+        assert(fsm_reorder_in_place(&builder, &hits) == FSM_RC_OK);
+        for (uint32_t i = 0; i < config->statesCount; i++)
+        {
+            assert(config->states[i].state == fsmMainCfg.states[i].state);
+        }
+        assert(assertLayout(config, &hits) == true);
+        if (config->dispatch != NULL || config->packed != NULL)
+        {
+            assertCells(config);
+        }
+        run(config, NULL, states);
+        assert(strcmp(trace, expectedTrace) == 0);
+        assert(memcmp(states, expectedStates, sizeof(states)) == 0);
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    /* Counters of another configuration, a used builder, an unfinalized one */
+    {
+        fsm_builder_t builder;
+        fsm_hits_t other;
+        fsm_t fsm;
+        fsm_hits_binding_t binding;
+        const fsm_cfg_t *config = NULL;
+        assert(fsm_hits_init(&hits, &fsmMainCfg, counts, FSM_HITS_COUNT(4, FSM_EVENT_COUNT) - 1u) ==
+               FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_hits_init(&hits, &fsmMainCfg, counts, FSM_HITS_COUNT(4, FSM_EVENT_COUNT)) == FSM_RC_OK);
+        assert(fsm_builder_init(&builder, 0) == FSM_RC_OK);
+        stage(&builder);
+        assert(fsm_reorder(&fsmMainCfg, &hits, &builder, &config) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_reorder_in_place(&builder, &hits) == FSM_RC_ERROR);
+        assert(fsm_builder_finalize(&builder, &config) == FSM_RC_OK);
+        assert(fsm_reorder_in_place(&builder, &hits) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_reorder(config, &hits, &builder, &config) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_init(&fsm, config) == FSM_RC_OK);
+        assert(fsm_hits_bind(&fsm, &binding, &hits) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_hits_init(&other, config, counts, FSM_HITS_COUNT(4, FSM_EVENT_COUNT)) == FSM_RC_OK);
+        assert(fsm_hits_merge(&other, &hits) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_builder_free(&builder) == FSM_RC_OK);
+    }
+
+    printf("fsm_reorder_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
@@ -0,0 +1,264 @@
+/**
+ * @file       fsm_scan_test.c
+ * @brief      Byte scanner against fsm_process
+ *
+ *             Scans the same input as fsm_process in one call, byte by byte,
+ *             in uneven chunks and mixed with fsm_process calls and asserts
+ *             the same action trace and states. Asserts the fast and slow
+ *             cells of the table and the consumed count on errors.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_scan.h" /* fsm_scan */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/**
+ * @brief Guard passing every second call, logged to the trace
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};      /**< Sub fsm linked to MAIN_SUB */
+static fsm_t fsmMain = {0};     /**< Instance running the events */
+static char trace[4096];        /**< Trace of the actions of the current run */
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard in the current run */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .exitAction = {logAction, (fsm_arg_t) "s2ex"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, ACTIONS, GUARDS AND A SUB FSM ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .doAction = {logAction, (fsm_arg_t) "m2do"},
+            .exitAction = {logAction, (fsm_arg_t) "m2ex"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/*** EVENTS, 'x' HAS NO EVENT OF ITS OWN ***/
+static const char input[] = "aabcabacbbcccaxbaabcbacbcaaxcbbacaccba";
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of an input character
+ *
+ * @param i_char 'a' to 'c', anything else has no event
+ */
+static fsm_event_t eventOf(char i_char)
+{
+    return (i_char >= 'a' && i_char <= 'c') ? (fsm_event_t)(i_char - 'a') : FSM_EVENT_COUNT;
+}
+
+/**
+ * @brief Initialize the instances and clear the trace
+ */
+static void start(void)
+{
+    assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_init(&fsmMain, &fsmMainCfg) == FSM_RC_OK);
+    trace[0] = '\0';
+    guardCalls = 0;
+}
+
+int main(void)
+{
+    enum
+    {
+        EVENTS_COUNT = sizeof(input) - 1u
+    };
+    static fsm_event_t byteClass[256];
+    static fsm_index_t table[FSM_SCAN_TABLE_SIZE(3)];
+    static char expectedTrace[sizeof(trace)];
+    fsm_state_t expectedStates[EVENTS_COUNT];
+    fsm_scanner_t scanner;
+    size_t consumed = 0;
+    for (uint32_t i = 0; i < 256u; i++)
+    {
+        byteClass[i] = eventOf((char)i);
+    }
+
+    /* Reference run */
+    start();
+    for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+    {
+        assert(fsm_process(&fsmMain, eventOf(input[i])) == FSM_RC_OK);
+        expectedStates[i] = fsmMain.currentState;
+    }
+    strcpy(expectedTrace, trace);
+    fsm_state_t expectedSubState = fsmSub.currentState;
+
+    /* Table, self transitions without actions and unknown bytes are fast */
+    start();
+    assert(fsm_scanner_init(&scanner, &fsmMain, byteClass, table, FSM_SCAN_TABLE_SIZE(3) - 1u) ==
+           FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_scanner_init(&scanner, &fsmMain, byteClass, NULL, FSM_SCAN_TABLE_SIZE(3)) == FSM_RC_ERROR_NULLPTR);
+    assert(fsm_scanner_init(&scanner, &fsmMain, byteClass, table, FSM_SCAN_TABLE_SIZE(3)) == FSM_RC_OK);
+    assert(table[0u * 256u + 'a'] == 0u);
+    assert(table[0u * 256u + 'b'] == FSM_SCAN_SLOW);
+    assert(table[0u * 256u + 'c'] == 0u);
+    assert(table[0u * 256u + 'x'] == 0u);
+    assert(table[1u * 256u + 'x'] == FSM_SCAN_SLOW);
+    assert(table[2u * 256u + 'x'] == FSM_SCAN_SLOW);
+
+    /* One call for the whole input */
+    assert(fsm_scan(&scanner, (const uint8_t *)input, EVENTS_COUNT, &consumed) == FSM_RC_OK);
+    assert(consumed == EVENTS_COUNT);
+    assert(strcmp(trace, expectedTrace) == 0);
+    assert(fsmMain.currentState == expectedStates[EVENTS_COUNT - 1u]);
+    assert(fsmSub.currentState == expectedSubState);
+
+    /* Byte by byte */
+    start();
+    for (uint32_t i = 0; i < EVENTS_COUNT; i++)
+    {
+        assert(fsm_scan(&scanner, (const uint8_t *)&input[i], 1, NULL) == FSM_RC_OK);
+        assert(fsmMain.currentState == expectedStates[i]);
+    }
+    assert(strcmp(trace, expectedTrace) == 0);
+
+    /* Uneven chunks, every third chunk goes through fsm_process */
+    for (uint32_t seed = 1; seed < 8u; seed++)
+    {
+        start();
+        uint32_t rand = seed;
+        uint32_t chunk = 0;
+        for (uint32_t i = 0; i < EVENTS_COUNT; chunk++)
+        {
+            rand = rand * 1103515245u + 12345u;
+            uint32_t len = (rand >> 16) % 6u;
+            len = (len > EVENTS_COUNT - i) ? EVENTS_COUNT - i : len;
+            if (chunk % 3u == 2u)
+            {
+                for (uint32_t j = 0; j < len; j++)
+                {
+                    assert(fsm_process(&fsmMain, eventOf(input[i + j])) == FSM_RC_OK);
+                }
+            }
+            else
+            {
+                assert(fsm_scan(&scanner, (const uint8_t *)&input[i], len, &consumed) == FSM_RC_OK);
+                assert(consumed == len);
+            }
+            i += len;
+            if (len > 0)
+            {
+                assert(fsmMain.currentState == expectedStates[i - 1u]);
+            }
+        }
+        assert(strcmp(trace, expectedTrace) == 0);
+        assert(fsmSub.currentState == expectedSubState);
+    }
+
+    /* Stops at the first failing byte, entering MAIN_SUB fails with an unlinked sub fsm */
+    start();
+    fsmSub.config = NULL;
+    uint32_t firstSub = 0;
+    while (expectedStates[firstSub] != FSM_STATE_MAIN_SUB)
+    {
+        firstSub++;
+    }
+    assert(fsm_scan(&scanner, (const uint8_t *)input, EVENTS_COUNT, &consumed) == FSM_RC_ERROR_NULLPTR);
+    assert(consumed == firstSub);
+    assert(fsmMain.currentState == expectedStates[firstSub - 1u]);
+    assert(fsm_scan(NULL, (const uint8_t *)input, 1, NULL) == FSM_RC_ERROR_NULLPTR);
+    assert(fsm_scan(&scanner, NULL, 1, NULL) == FSM_RC_ERROR_NULLPTR);
+    assert(fsm_scan(&scanner, NULL, 0, NULL) == FSM_RC_OK);
+
+    printf("fsm_scan_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    strcat(trace, "g|");
+    return (guardCalls++ % 2u) == 1u;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file       fsm_simd_test.c
+ * @brief      Lockstep kernel against fsm_process
+ *
+ *             Runs many instances of an action free machine through the
+ *             lockstep kernel on every supported instruction set, each with
+ *             its own event stream, and asserts the states of a fsm_t per
+ *             instance. Asserts that configurations which do not only
+ *             classify are rejected.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"      /* FSM types */
+#include "fsm_simd.h" /* fsm_simd_run */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Action of the rejected configurations
+ *
+ * @param i_arg unused
+ */
+static void noAction(fsm_arg_t i_arg);
+
+/**
+ * @brief Guard of the rejected configurations
+ *
+ * @param i_arg unused
+ */
+static bool trueGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0}; /**< Sub fsm of a rejected configuration */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** ACTION FREE STATEMACHINE, FIRST WINS ON EVENT_3 OF MAIN_SUB ***/
+static const fsm_cfg_t fsmPlainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 4,
+    .states = (const fsm_state_cfg_t[4]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_SUB},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_SUB},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_SUB},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_SUB_2},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/*** REJECTED, ONE STATE EACH WITH AN ACTION, A GUARD, A SUB FSM OR A TIMER ***/
+#define REJECTED(transition, ...)                                                     \
+    {                                                                                 \
+        .initialState = FSM_STATE_MAIN_1,                                             \
+        .statesCount = 1,                                                             \
+        .states = (const fsm_state_cfg_t[1]){                                         \
+            {                                                                         \
+                .state = FSM_STATE_MAIN_1,                                            \
+                .transitionsCount = 1,                                                \
+                .transitions = (const fsm_transition_cfg_t[1]){                       \
+                    {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, transition}, \
+                },                                                                    \
+                __VA_ARGS__                                                           \
+            },                                                                        \
+        },                                                                            \
+    }
+
+static const fsm_cfg_t fsmRejectedCfgs[] = {
+    REJECTED(.after = 0, .entryAction = {noAction}),
+    REJECTED(.after = 0, .doAction = {noAction}),
+    REJECTED(.after = 0, .exitAction = {noAction}),
+    REJECTED(.after = 0, .subFsm = &fsmSub),
+    REJECTED(.guard = {trueGuard}),
+    REJECTED(.action = {noAction}),
+    REJECTED(.after = 10),
+    REJECTED(.every = 10),
+};
+
+/*** EVENTS, 'x' HAS NO EVENT OF ITS OWN ***/
+static const char input[] = "aabcabacbbcccaxbaabcbacbcaaxcbbacaccba";
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of an input character
+ *
+ * @param i_char 'a' to 'c', anything else has no event
+ */
+static fsm_event_t eventOf(char i_char)
+{
+    return (i_char >= 'a' && i_char <= 'c') ? (fsm_event_t)(i_char - 'a') : FSM_EVENT_COUNT;
+}
+
+int main(void)
+{
+    enum
+    {
+        EVENTS_COUNT = sizeof(input) - 1u,
+        INSTANCES = 37,
+        STEPS = 24
+    };
+    static int32_t table[FSM_SIMD_TABLE_SIZE(4)];
+    static fsm_event_t events[STEPS * INSTANCES];
+    static int32_t cursors[INSTANCES];
+    fsm_simd_t kernel;
+
+    /* Only machines which classify */
+    for (uint32_t i = 0; i < sizeof(fsmRejectedCfgs) / sizeof(fsmRejectedCfgs[0]); i++)
+    {
+        assert(fsm_simd_init(&kernel, &fsmRejectedCfgs[i], table, FSM_SIMD_TABLE_SIZE(4)) ==
+               FSM_RC_ERROR_INVALID_CONFIG);
+    }
+    assert(fsm_simd_init(&kernel, &fsmPlainCfg, table, FSM_SIMD_TABLE_SIZE(4) - 1u) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_simd_init(&kernel, &fsmPlainCfg, table, FSM_SIMD_TABLE_SIZE(4)) == FSM_RC_OK);
+
+    /* Instance i runs the input from offset i, on every instruction set up to the best one */
+    fsm_simd_isa_t best = kernel.isa;
+    for (uint32_t isa = FSM_SIMD_ISA_SCALAR; isa <= (uint32_t)best; isa++)
+    {
+        kernel.isa = (fsm_simd_isa_t)isa;
+
+        /* Partial vectors included */
+        for (uint32_t count = 1; count <= INSTANCES; count += 9u)
+        {
+            for (uint32_t s = 0; s < STEPS; s++)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    events[s * count + i] = eventOf(input[(s + i) % EVENTS_COUNT]);
+                }
+            }
+
+            assert(fsm_simd_reset(&kernel, cursors, count) == FSM_RC_OK);
+            assert(fsm_simd_run(&kernel, cursors, count, events, STEPS / 2u) == FSM_RC_OK);
+            assert(fsm_simd_run(&kernel, cursors, count, &events[(STEPS / 2u) * count], STEPS / 2u) == FSM_RC_OK);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                fsm_t fsm;
+                fsm_state_t state;
+                assert(fsm_init(&fsm, &fsmPlainCfg) == FSM_RC_OK);
+                for (uint32_t s = 0; s < STEPS; s++)
+                {
+                    assert(fsm_process(&fsm, events[s * count + i]) == FSM_RC_OK);
+                }
+                assert(fsm_simd_get_state(&kernel, cursors[i], &state) == FSM_RC_OK);
+                assert(state == fsm.currentState);
+            }
+        }
+    }
+
+    /* A cursor is a row offset */
+    fsm_state_t state;
+    assert(fsm_simd_get_state(&kernel, (int32_t)kernel.rowSize - 1, &state) == FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_simd_get_state(&kernel, (int32_t)(4u * kernel.rowSize), &state) == FSM_RC_ERROR_INVALID_ARG);
+
+    printf("fsm_simd_test: passed\n");
+    return 0;
+}
+
+static void noAction(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+}
+
+static bool trueGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    return true;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file       fsm_snapshot_test.c
+ * @brief      Snapshot and restore round trips
+ *
+ *             Takes snapshots of an instance with a sub configuration and a
+ *             sub fsm and of a pool, restores them and asserts that the
+ *             restored instances continue exactly like the original ones.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"          /* FSM types */
+#include "fsm_pool.h"     /* fsm_pool_t */
+#include "fsm_snapshot.h" /* fsm_snapshot */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+#include <string.h> /* strcat */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Append the message to the trace
+ *
+ * @param i_message is casted back to (const char*)
+ */
+static void logAction(fsm_arg_t i_message);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_t fsmSub = {0};  /**< Sub fsm linked to MAIN_SUB */
+static fsm_t fsmMain = {0}; /**< Instance under test */
+static char trace[1024];    /**< Trace of the actions */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB FSM AND SUB CONFIGURATION OF MAIN_2 ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {logAction, (fsm_arg_t) "s1en"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2, .action = {logAction, (fsm_arg_t) "s1e2"}},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .doAction = {logAction, (fsm_arg_t) "s2do"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1, .action = {logAction, (fsm_arg_t) "s2e1"}},
+            },
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .entryAction = {logAction, (fsm_arg_t) "m1en"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = {logAction, (fsm_arg_t) "m1e3"}},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB, .action = {logAction, (fsm_arg_t) "m2e3"}},
+            },
+            .subCfg = &fsmSubCfg,
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1, .action = {logAction, (fsm_arg_t) "mse3"}},
+            },
+        },
+    },
+};
+
+/*** POOL STATEMACHINE, POOLS TAKE NO SUB CONFIGURATIONS ***/
+static const fsm_cfg_t fsmPoolCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subFsm = &fsmSub,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+    },
+};
+
+/*** EVENTS, THE SNAPSHOTS ARE TAKEN AFTER EACH PREFIX ***/
+static const fsm_event_t events[] = {
+    FSM_EVENT_1, FSM_EVENT_3, FSM_EVENT_2, FSM_EVENT_1, FSM_EVENT_2, FSM_EVENT_3, FSM_EVENT_2, FSM_EVENT_2,
+    FSM_EVENT_1, FSM_EVENT_3, FSM_EVENT_2, FSM_EVENT_3, FSM_EVENT_2, FSM_EVENT_3, FSM_EVENT_1, FSM_EVENT_2,
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Process events on the main instance, tracing into a fresh trace
+ *
+ * @param i_first Index of the first event
+ * @param i_count Number of events
+ */
+static void run(uint32_t i_first, uint32_t i_count)
+{
+    trace[0] = '\0';
+    for (uint32_t i = i_first; i < i_first + i_count; i++)
+    {
+        assert(fsm_process(&fsmMain, events[i]) == FSM_RC_OK);
+    }
+}
+
+int main(void)
+{
+    enum
+    {
+        EVENTS_COUNT = sizeof(events) / sizeof(events[0])
+    };
+
+    /* Every prefix: snapshot, run the rest, restore, run the rest again */
+    for (uint32_t prefix = 0; prefix <= EVENTS_COUNT; prefix++)
+    {
+        _Alignas(8) uint8_t image[256];
+        _Alignas(8) uint8_t restoredImage[256];
+        static char expectedTrace[sizeof(trace)];
+        size_t size = 0;
+        size_t querySize = 0;
+
+        assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+        assert(fsm_init(&fsmMain, &fsmMainCfg) == FSM_RC_OK);
+        run(0, prefix);
+        assert(fsm_snapshot(&fsmMain, NULL, 0, &querySize) == FSM_RC_OK);
+        assert(fsm_snapshot(&fsmMain, image, querySize - 1u, &size) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_snapshot(&fsmMain, image, sizeof(image), &size) == FSM_RC_OK);
+        assert(size == querySize);
+
+        run(prefix, EVENTS_COUNT - prefix);
+        strcpy(expectedTrace, trace);
+        fsm_t expectedMain = fsmMain;
+        fsm_t expectedSub = fsmSub;
+
+        assert(fsm_reset(&fsmSub) == FSM_RC_OK);
+        assert(fsm_reset(&fsmMain) == FSM_RC_OK);
+        assert(fsm_restore(&fsmMain, image, size - 1u) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_restore(&fsmMain, image, size) == FSM_RC_OK);
+        assert(fsm_snapshot(&fsmMain, restoredImage, sizeof(restoredImage), &size) == FSM_RC_OK);
+        assert(memcmp(image, restoredImage, size) == 0);
+
+        run(prefix, EVENTS_COUNT - prefix);
+        assert(strcmp(trace, expectedTrace) == 0);
+        assert(fsmMain.currentState == expectedMain.currentState);
+        assert(fsmMain.isFirstRun == expectedMain.isFirstRun);
+        assert(memcmp(fsmMain.subStates, expectedMain.subStates, sizeof(fsmMain.subStates)) == 0);
+        assert(fsmSub.currentState == expectedSub.currentState);
+        assert(fsmSub.isFirstRun == expectedSub.isFirstRun);
+
+        /* A damaged header is rejected */
+        image[0] ^= 0xFFu;
+        assert(fsm_restore(&fsmMain, image, size) == FSM_RC_ERROR_INVALID_ARG);
+    }
+
+    /* Pool: copying restore and restore in place */
+    {
+        enum
+        {
+            INSTANCES = 37
+        };
+        static fsm_index_t stateIndex[INSTANCES];
+        static uint32_t firstRunBits[FSM_POOL_FIRST_RUN_WORDS(INSTANCES)];
+        static fsm_index_t savedStateIndex[INSTANCES];
+        static uint32_t savedFirstRunBits[FSM_POOL_FIRST_RUN_WORDS(INSTANCES)];
+        _Alignas(8) static uint8_t image[512];
+        fsm_pool_t pool;
+        fsm_pool_t inPlace;
+        size_t size = 0;
+
+        assert(fsm_init(&fsmSub, &fsmSubCfg) == FSM_RC_OK);
+        assert(fsm_pool_init(&pool, &fsmPoolCfg, stateIndex, firstRunBits, INSTANCES) == FSM_RC_OK);
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            for (uint32_t e = 0; e < i % 5u; e++)
+            {
+                assert(fsm_pool_process(&pool, i, events[(i + e) % EVENTS_COUNT]) == FSM_RC_OK);
+            }
+        }
+        assert(fsm_pool_snapshot(&pool, image, sizeof(image), &size) == FSM_RC_OK);
+        memcpy(savedStateIndex, stateIndex, sizeof(stateIndex));
+        memcpy(savedFirstRunBits, firstRunBits, sizeof(firstRunBits));
+
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            assert(fsm_pool_reset(&pool, i) == FSM_RC_OK);
+        }
+        assert(fsm_pool_restore(&pool, image, size) == FSM_RC_OK);
+        assert(memcmp(stateIndex, savedStateIndex, sizeof(stateIndex)) == 0);
+        assert(memcmp(firstRunBits, savedFirstRunBits, sizeof(firstRunBits)) == 0);
+
+        assert(fsm_pool_restore_in_place(&inPlace, &fsmPoolCfg, image, size) == FSM_RC_OK);
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            fsm_state_t expected;
+            fsm_state_t state;
+            assert(fsm_pool_get_state(&pool, i, &expected) == FSM_RC_OK);
+            assert(fsm_pool_get_state(&inPlace, i, &state) == FSM_RC_OK);
+            assert(state == expected);
+        }
+
+        /* Both continue alike */
+        for (uint32_t i = 0; i < INSTANCES; i++)
+        {
+            fsm_state_t expected;
+            fsm_state_t state;
+            assert(fsm_pool_process(&pool, i, FSM_EVENT_3) == FSM_RC_OK);
+            assert(fsm_pool_process(&inPlace, i, FSM_EVENT_3) == FSM_RC_OK);
+            assert(fsm_pool_get_state(&pool, i, &expected) == FSM_RC_OK);
+            assert(fsm_pool_get_state(&inPlace, i, &state) == FSM_RC_OK);
+            assert(state == expected);
+        }
+
+        /* An instance snapshot is no pool snapshot */
+        assert(fsm_init(&fsmMain, &fsmMainCfg) == FSM_RC_OK);
+        assert(fsm_restore(&fsmMain, image, size) == FSM_RC_ERROR_INVALID_ARG);
+    }
+
+    printf("fsm_snapshot_test: passed\n");
+    return 0;
+}
+
+static void logAction(fsm_arg_t i_message)
+{
+    strcat(trace, (const char *)i_message);
+    strcat(trace, "|");
+}
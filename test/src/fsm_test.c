@@ -29,27 +29,69 @@
  */
 static void myLog(fsm_arg_t i_message);
 
-/**
- * @brief Reset Statemachine function
- *
- * Resets the passed statemachine instance
- *
- * @param i_fsam is casted back to (fsm_t *const)
- */
-static void resetFsm(fsm_arg_t i_fsm);
-
 /******************************************************************************/
 /* PRIVATE STATIC VARIABLES                                                   */
 /******************************************************************************/
 static fsm_t fsmMain = {0}; /**< Instance of the Main Statemachine */
-static fsm_t fsmSub = {0};  /**< Instance of the Sub Statemachine */
 
 /******************************************************************************/
 /* STATEMACHINE CONFIGURATION                                                 */
 /******************************************************************************/
+/*** SUB STATEMACHINE ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+
+        /*** SUB STATE 1 ******************************************************/
+        {
+            .state = FSM_STATE_SUB_1,
+            .entryAction = {myLog, (fsm_arg_t) "SUB: STATE1: ENTRY"},
+            .doAction = {myLog, (fsm_arg_t) "SUB: STATE1: DO"},
+            .exitAction = {myLog, (fsm_arg_t) "SUB: STATE1: EXIT"},
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+
+                /*** EVENT 1 ***/
+                {
+                    .event = FSM_EVENT_1,
+                    .action = {myLog, (fsm_arg_t) "SUB: STATE1: EVENT1"},
+                    .toState = FSM_STATE_SUB_1,
+                },
+
+                /*** EVENT 2 ***/
+                {
+                    .event = FSM_EVENT_2,
+                    .action = {myLog, (fsm_arg_t) "SUB: STATE1: EVENT2"},
+                    .toState = FSM_STATE_SUB_2,
+                },
+            },
+        },
+
+        /*** SUB STATE 2 ******************************************************/
+        {
+            .state = FSM_STATE_SUB_2,
+            .entryAction = {myLog, (fsm_arg_t) "SUB: STATE2: ENTRY"},
+            .doAction = {myLog, (fsm_arg_t) "SUB: STATE2: DO"},
+            .exitAction = {myLog, (fsm_arg_t) "SUB: STATE2: EXIT"},
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+
+                /*** EVENT 1 ***/
+                {
+                    .event = FSM_EVENT_1,
+                    .action = {myLog, (fsm_arg_t) "SUB: STATE2: EVENT1"},
+                    .toState = FSM_STATE_SUB_1,
+                },
+            },
+        },
+    },
+};
+
 /*** MAIN STATEMACHINE ***/
 static const fsm_cfg_t fsmMainCfg = {
     .initialState = FSM_STATE_MAIN_1,
+    .dispatch = FSM_DISPATCH_TABLE(3),
     .statesCount = 3,
     .states = (const fsm_state_cfg_t[3]){
 
@@ -106,8 +148,7 @@ static const fsm_cfg_t fsmMainCfg = {
         /*** MAIN STATE SUB ***************************************************/
         {
             .state = FSM_STATE_MAIN_SUB,
-            .entryAction = {resetFsm, (fsm_arg_t)&fsmSub},
-            .subFsm = &fsmSub,
+            .subCfg = &fsmSubCfg,
             .transitionsCount = 1,
             .transitions = (const fsm_transition_cfg_t[1]){
                 /*** EVENT 3 ***/
@@ -121,57 +162,6 @@ static const fsm_cfg_t fsmMainCfg = {
     },
 };
 
-/*** SUB STATEMACHINE ***/
-static const fsm_cfg_t fsmSubCfg = {
-    .initialState = FSM_STATE_SUB_1,
-    .statesCount = 2,
-    .states = (const fsm_state_cfg_t[2]){
-
-        /*** SUB STATE 1 ******************************************************/
-        {
-            .state = FSM_STATE_SUB_1,
-            .entryAction = {myLog, (fsm_arg_t) "SUB: STATE1: ENTRY"},
-            .doAction = {myLog, (fsm_arg_t) "SUB: STATE1: DO"},
-            .exitAction = {myLog, (fsm_arg_t) "SUB: STATE1: EXIT"},
-            .transitionsCount = 2,
-            .transitions = (const fsm_transition_cfg_t[2]){
-
-                /*** EVENT 1 ***/
-                {
-                    .event = FSM_EVENT_1,
-                    .action = {myLog, (fsm_arg_t) "SUB: STATE1: EVENT1"},
-                    .toState = FSM_STATE_SUB_1,
-                },
-
-                /*** EVENT 2 ***/
-                {
-                    .event = FSM_EVENT_2,
-                    .action = {myLog, (fsm_arg_t) "SUB: STATE1: EVENT2"},
-                    .toState = FSM_STATE_SUB_2,
-                },
-            },
-        },
-
-        /*** SUB STATE 2 ******************************************************/
-        {
-            .state = FSM_STATE_SUB_2,
-            .entryAction = {myLog, (fsm_arg_t) "SUB: STATE2: ENTRY"},
-            .doAction = {myLog, (fsm_arg_t) "SUB: STATE2: DO"},
-            .exitAction = {myLog, (fsm_arg_t) "SUB: STATE2: EXIT"},
-            .transitionsCount = 1,
-            .transitions = (const fsm_transition_cfg_t[1]){
-
-                /*** EVENT 1 ***/
-                {
-                    .event = FSM_EVENT_1,
-                    .action = {myLog, (fsm_arg_t) "SUB: STATE2: EVENT1"},
-                    .toState = FSM_STATE_SUB_1,
-                },
-            },
-        },
-    },
-};
-
 /******************************************************************************/
 /* FUNCTION IMPLEMENTATIONS                                                   */
 /******************************************************************************/
@@ -189,14 +179,6 @@ int main(void)
     }
     printf("main: main fsm initialized\n");
 
-    res = fsm_init(&fsmSub, &fsmSubCfg);
-    if (res != FSM_RC_OK)
-    {
-        printf("ERROR: main: error initializing sub fsm\n");
-        return -1;
-    }
-    printf("main: sub fsm initialized\n");
-
     printf("main: simulating events\n");
     /* Simulate events to go through the statemachine */
     fireEvent(FSM_EVENT_1); /* stay in main state 1*/
@@ -240,18 +222,3 @@ static void myLog(fsm_arg_t i_message)
     const char *messageStr = (const char *)i_message;
     printf("myLog: %s\n", messageStr);
 }
-
-static void resetFsm(fsm_arg_t i_fsm)
-{
-    fsm_t *const fsm = (fsm_t *const)i_fsm;
-    if (fsm == NULL)
-    {
-        printf("ERROR: resetFsm: nullptr\n");
-        return;
-    }
-    fsm_RC_t res = fsm_reset(fsm);
-    if (res != FSM_RC_OK)
-    {
-        printf("ERROR: resetFsm: nullptr\n");
-    }
-}
@@ -0,0 +1,297 @@
+/**
+ * @file       fsm_timer_test.c
+ * @brief      Timed transitions on the timing wheel
+ *
+ *             Runs a machine whose timers expire on every level of the wheel,
+ *             beyond its range included, and asserts the fired events and
+ *             their ticks, whether time advances in one call, in uneven steps
+ *             or tick by tick. Asserts that reset and unbind cancel the timers
+ *             and that a bind arms the timers of the current state.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"       /* FSM types */
+#include "fsm_timer.h" /* fsm_advance_time */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define LEVEL2_AFTER 100000u   /**< Timer on the third level */
+#define LEVEL3_EVERY 4999999u  /**< Timer on the last level */
+#define PARKED_AFTER 20000000u /**< Timer beyond the range of the wheel */
+#define END 30000000u          /**< Tick all runs advance to */
+#define MAX_FIRED 512u         /**< Size of the log of fired events */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Log the tick and the event of a timed transition
+ *
+ * @param i_event is casted back to the event
+ */
+static void firedAction(fsm_arg_t i_event);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static fsm_timer_wheel_t wheel; /**< Wheel driving the timers */
+
+static struct
+{
+    uint64_t tick;              /**< Tick of the wheel */
+    fsm_event_t event;          /**< Event of the timer */
+} fired[MAX_FIRED];             /**< Log of the fired events */
+static uint32_t firedCount = 0; /**< Entries in fired */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+#define FIRED(e) {firedAction, (fsm_arg_t)(uintptr_t)(e)}
+
+/*** TIMERS ON EVERY LEVEL OF THE WHEEL ***/
+static const fsm_cfg_t fsmCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 5,
+    .states = (const fsm_state_cfg_t[5]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 3,
+            .transitions = (const fsm_transition_cfg_t[3]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2, .action = FIRED(FSM_EVENT_1), .after = 10},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_1, .action = FIRED(FSM_EVENT_2), .every = 7},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_1},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2, .action = FIRED(FSM_EVENT_3), .every = 300},
+                {.event = FSM_EVENT_1,
+                 .toState = FSM_STATE_MAIN_SUB,
+                 .action = FIRED(FSM_EVENT_1),
+                 .after = LEVEL2_AFTER},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_1, .action = FIRED(FSM_EVENT_2), .after = PARKED_AFTER},
+                {.event = FSM_EVENT_3,
+                 .toState = FSM_STATE_MAIN_SUB,
+                 .action = FIRED(FSM_EVENT_3),
+                 .every = LEVEL3_EVERY},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_2, .action = FIRED(FSM_EVENT_1), .after = 1},
+            },
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1}},
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Append an expected event to a log
+ *
+ * @param io_log The log
+ * @param io_count Entries in the log
+ * @param i_tick Tick of the event
+ * @param i_event The event
+ */
+static void expect(uint64_t *io_log, uint32_t *io_count, uint64_t i_tick, fsm_event_t i_event)
+{
+    assert(*io_count < MAX_FIRED);
+    io_log[*io_count] = (i_tick << 2u) | (uint64_t)i_event;
+    (*io_count)++;
+}
+
+/**
+ * @brief Start an instance at tick 0, its initial state entered with a first event
+ *
+ * @param io_fsm The instance
+ * @param io_timers The binding
+ * @param io_storage Timer storage for two timers
+ */
+static void start(fsm_t *io_fsm, fsm_timers_t *io_timers, fsm_timer_t *io_storage)
+{
+    assert(fsm_timer_wheel_init(&wheel, 0) == FSM_RC_OK);
+    assert(fsm_init(io_fsm, &fsmCfg) == FSM_RC_OK);
+    assert(fsm_timers_bind(io_fsm, io_timers, &wheel, io_storage, 2) == FSM_RC_OK);
+    assert(wheel.armedCount == 0);
+    assert(fsm_process(io_fsm, FSM_EVENT_3) == FSM_RC_OK);
+    assert(wheel.armedCount == 2);
+    firedCount = 0;
+}
+
+/**
+ * @brief Assert the log of fired events
+ *
+ * @param i_expected The expected log
+ * @param i_expectedCount Entries in the expected log
+ */
+static void assertFired(const uint64_t *i_expected, uint32_t i_expectedCount)
+{
+    assert(firedCount == i_expectedCount);
+    for (uint32_t i = 0; i < firedCount; i++)
+    {
+        assert(((fired[i].tick << 2u) | (uint64_t)fired[i].event) == i_expected[i]);
+    }
+}
+
+int main(void)
+{
+    static uint64_t expected[MAX_FIRED];
+    uint32_t expectedCount = 0;
+    fsm_t fsm;
+    fsm_timers_t timers;
+    fsm_timer_t storage[2];
+    size_t count = 0;
+
+    assert(fsm_cfg_prepare(&fsmCfg) == FSM_RC_OK);
+
+    /* after and every, cascaded down from every level and parked beyond the range */
+    expect(expected, &expectedCount, 7, FSM_EVENT_2);
+    expect(expected, &expectedCount, 10, FSM_EVENT_1);
+    for (uint64_t tick = 10u + 300u; tick < 10u + LEVEL2_AFTER; tick += 300u)
+    {
+        expect(expected, &expectedCount, tick, FSM_EVENT_3);
+    }
+    const uint64_t subEntered = 10u + LEVEL2_AFTER;
+    expect(expected, &expectedCount, subEntered, FSM_EVENT_1);
+    for (uint64_t tick = subEntered + LEVEL3_EVERY; tick < subEntered + PARKED_AFTER; tick += LEVEL3_EVERY)
+    {
+        expect(expected, &expectedCount, tick, FSM_EVENT_3);
+    }
+    expect(expected, &expectedCount, subEntered + PARKED_AFTER, FSM_EVENT_2);
+    expect(expected, &expectedCount, subEntered + PARKED_AFTER + 1u, FSM_EVENT_1);
+
+    /* In one call */
+    start(&fsm, &timers, storage);
+    assert(fsm_advance_time(&wheel, END, &count) == FSM_RC_OK);
+    assert(count == expectedCount);
+    assertFired(expected, expectedCount);
+    assert(fsm.currentState == FSM_STATE_SUB_2);
+    assert(wheel.now == END);
+    assert(wheel.armedCount == 0);
+
+    /* In uneven steps, fewer or more ticks than a slot, a level or the range */
+    {
+        start(&fsm, &timers, storage);
+        uint64_t now = 0;
+        size_t total = 0;
+        for (uint32_t step = 1; now < END; step = step * 1103515245u + 12345u)
+        {
+            now += 1u + (step >> 8) % ((step & 0x1000u) ? 4096u : 7000000u);
+            assert(fsm_advance_time(&wheel, now, &count) == FSM_RC_OK);
+            total += count;
+        }
+        assert(total == expectedCount);
+        assertFired(expected, expectedCount);
+        assert(fsm.currentState == FSM_STATE_SUB_2);
+    }
+
+    /* Tick by tick over the first two levels */
+    {
+        start(&fsm, &timers, storage);
+        uint32_t firedBefore = 0;
+        for (uint64_t tick = 1; tick <= 2u * 4096u + 10u; tick++)
+        {
+            assert(fsm_advance_time(&wheel, tick, NULL) == FSM_RC_OK);
+            while (firedBefore < firedCount)
+            {
+                assert(fired[firedBefore].tick == tick);
+                firedBefore++;
+            }
+        }
+        assert(firedCount > 2u);
+        assertFired(expected, firedCount);
+
+        /* Time does not go backwards, the same tick fires nothing */
+        assert(fsm_advance_time(&wheel, 10u, &count) == FSM_RC_OK);
+        assert(count == 0);
+        assert(wheel.now == 2u * 4096u + 10u);
+    }
+
+    /* Reset cancels the timers, the next event arms them again */
+    {
+        start(&fsm, &timers, storage);
+        assert(fsm_advance_time(&wheel, 5u, &count) == FSM_RC_OK);
+        assert(count == 0);
+        assert(fsm_reset(&fsm) == FSM_RC_OK);
+        assert(wheel.armedCount == 0);
+        assert(fsm_advance_time(&wheel, 1000u, &count) == FSM_RC_OK);
+        assert(count == 0);
+        assert(fsm.currentState == FSM_STATE_MAIN_1);
+
+        assert(fsm_process(&fsm, FSM_EVENT_3) == FSM_RC_OK);
+        assert(fsm_advance_time(&wheel, 1010u, &count) == FSM_RC_OK);
+        assert(count == 2);
+        assert(fired[0].tick == 1007u && fired[0].event == FSM_EVENT_2);
+        assert(fired[1].tick == 1010u && fired[1].event == FSM_EVENT_1);
+        assert(fsm.currentState == FSM_STATE_MAIN_2);
+    }
+
+    /* Unbind cancels the timers, a bind arms the timers of the current state */
+    {
+        fsm_timer_t small[1];
+        assert(fsm_timers_unbind(&fsm) == FSM_RC_OK);
+        assert(wheel.armedCount == 0);
+        assert(fsm_advance_time(&wheel, 1000000u, &count) == FSM_RC_OK);
+        assert(count == 0);
+        assert(fsm.currentState == FSM_STATE_MAIN_2);
+
+        assert(fsm_timers_bind(&fsm, &timers, &wheel, small, 1) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_timers_bind(&fsm, &timers, &wheel, storage, 2) == FSM_RC_OK);
+        assert(wheel.armedCount == 2);
+        firedCount = 0;
+        assert(fsm_advance_time(&wheel, 1000000u + LEVEL2_AFTER, &count) == FSM_RC_OK);
+        assert(count == LEVEL2_AFTER / 300u + 1u);
+        assert(fired[firedCount - 1u].tick == 1000000u + LEVEL2_AFTER);
+        assert(fsm.currentState == FSM_STATE_MAIN_SUB);
+
+        /* Binding again replaces the binding, its timers are cancelled */
+        assert(fsm_timers_bind(&fsm, &timers, &wheel, storage, 2) == FSM_RC_OK);
+        assert(wheel.armedCount == 2);
+        assert(fsm_timers_unbind(&fsm) == FSM_RC_OK);
+        assert(fsm_timers_unbind(&fsm) == FSM_RC_OK);
+        assert(wheel.armedCount == 0);
+    }
+
+    printf("fsm_timer_test: passed\n");
+    return 0;
+}
+
+static void firedAction(fsm_arg_t i_event)
+{
+    assert(firedCount < MAX_FIRED);
+    fired[firedCount].tick = wheel.now;
+    fired[firedCount].event = (fsm_event_t)(uintptr_t)i_event;
+    firedCount++;
+}
@@ -0,0 +1,411 @@
+/**
+ * @file       fsm_trace_test.c
+ * @brief      Transition tracing and counters, built with FSM_TRACE=1
+ *
+ *             Asserts the records of the ring of a main fsm with a guard and
+ *             a sub configuration, that the ring keeps the newest records
+ *             when it wraps and that every configuration, pool and image is
+ *             counted in its own block, matching the records. Events of
+ *             configurations without a block are only recorded in the ring.
+ *
+ * @author     Tom Christ
+ * @copyright  Copyright (c) 2025 Tom Christ; MIT License
+ * @date       2025-09-27
+ *
+ * @version    0.1  Initial Version
+ */
+
+/******************************************************************************/
+/*** Include files                                                            */
+/******************************************************************************/
+#include "fsm.h"       /* FSM types */
+#include "fsm_image.h" /* fsm_image_write */
+#include "fsm_pool.h"  /* fsm_pool_t */
+#include "fsm_trace.h" /* fsm_trace_copy_ring */
+
+#undef NDEBUG
+#include <assert.h> /* assert */
+#include <stdio.h>  /* printf */
+
+#if FSM_TRACE == 0 || FSM_TRACE_RING_SIZE != 16u
+#error "Build with FSM_TRACE=1 and FSM_TRACE_RING_SIZE=16u"
+#endif
+
+/******************************************************************************/
+/*** Defines                                                                  */
+/******************************************************************************/
+#define RING FSM_TRACE_RING_SIZE /**< Records kept by the ring */
+#define STEPS 300u               /**< Events of the counter runs */
+
+/******************************************************************************/
+/* FUNCTION PREDECLARATION FOR FSM                                            */
+/******************************************************************************/
+
+/**
+ * @brief Guard passing every second call
+ *
+ * @param i_arg unused
+ */
+static bool toggleGuard(fsm_arg_t i_arg);
+
+/******************************************************************************/
+/* PRIVATE STATIC VARIABLES                                                   */
+/******************************************************************************/
+static uint32_t guardCalls = 0; /**< Calls of toggleGuard */
+
+/******************************************************************************/
+/* STATEMACHINE CONFIGURATION                                                 */
+/******************************************************************************/
+/*** SUB CONFIGURATION ***/
+static const fsm_cfg_t fsmSubCfg = {
+    .initialState = FSM_STATE_SUB_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_SUB_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_2, .toState = FSM_STATE_SUB_2}},
+        },
+        {
+            .state = FSM_STATE_SUB_2,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_1, .toState = FSM_STATE_SUB_1}},
+        },
+    },
+};
+
+/*** MAIN STATEMACHINE, A GUARD AND A SUB CONFIGURATION ***/
+static const fsm_cfg_t fsmMainCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .dispatch = FSM_DISPATCH_TABLE(3),
+    .statesCount = 3,
+    .states = (const fsm_state_cfg_t[3]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1, .guard = {toggleGuard, NULL}},
+                {.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_SUB},
+            },
+        },
+        {
+            .state = FSM_STATE_MAIN_SUB,
+            .subCfg = &fsmSubCfg,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_3, .toState = FSM_STATE_MAIN_2}},
+        },
+    },
+};
+
+/*** FLAT STATEMACHINE FOR THE RING, THE POOL AND THE IMAGE ***/
+static const fsm_cfg_t fsmFlatCfg = {
+    .initialState = FSM_STATE_MAIN_1,
+    .statesCount = 2,
+    .states = (const fsm_state_cfg_t[2]){
+        {
+            .state = FSM_STATE_MAIN_1,
+            .transitionsCount = 1,
+            .transitions = (const fsm_transition_cfg_t[1]){{.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_2}},
+        },
+        {
+            .state = FSM_STATE_MAIN_2,
+            .transitionsCount = 2,
+            .transitions = (const fsm_transition_cfg_t[2]){
+                {.event = FSM_EVENT_1, .toState = FSM_STATE_MAIN_1},
+                {.event = FSM_EVENT_2, .toState = FSM_STATE_MAIN_2},
+            },
+        },
+    },
+};
+
+/******************************************************************************/
+/* FUNCTION IMPLEMENTATIONS                                                   */
+/******************************************************************************/
+
+/**
+ * @brief Event of step i
+ *
+ * @param i_step Index of the step
+ */
+static fsm_event_t eventOf(uint32_t i_step)
+{
+    return (fsm_event_t)((i_step * i_step + i_step / 3u) % FSM_EVENT_COUNT);
+}
+
+/**
+ * @brief Index of a state in the states array of a configuration
+ *
+ * @param i_config The configuration
+ * @param i_state The state
+ */
+static uint32_t indexOf(const fsm_cfg_t *i_config, fsm_state_t i_state)
+{
+    for (uint32_t i = 0; i < i_config->statesCount; i++)
+    {
+        if (i_config->states[i].state == i_state)
+        {
+            return i;
+        }
+    }
+    assert(false);
+    return 0;
+}
+
+/**
+ * @brief Count the records of one configuration like the counters do
+ *
+ * @param i_config The configuration the records belong to
+ * @param i_records The records
+ * @param i_count Number of records
+ * @param io_counts Counters, laid out like a counter block
+ */
+static void countRecords(const fsm_cfg_t *i_config,
+                         const fsm_trace_record_t *i_records,
+                         size_t i_count,
+                         uint32_t *io_counts)
+{
+    const uint32_t rowSize = FSM_EVENT_COUNT;
+    for (size_t i = 0; i < i_count; i++)
+    {
+        uint32_t *row = &io_counts[indexOf(i_config, i_records[i].fromState) * (1u + 2u * rowSize)];
+        row[0]++;
+        if (i_records[i].guard == FSM_TRACE_NO_GUARD || i_records[i].guard == FSM_TRACE_GUARD_PASSED)
+        {
+            row[1u + (uint32_t)i_records[i].event]++;
+        }
+        else if (i_records[i].guard == FSM_TRACE_GUARD_REJECTED)
+        {
+            row[1u + rowSize + (uint32_t)i_records[i].event]++;
+        }
+    }
+}
+
+/**
+ * @brief Assert that a counter block holds the expected counts
+ *
+ * @param i_this The counter block
+ * @param i_counts The expected counts, laid out like a counter block
+ */
+static void assertCounts(const fsm_trace_counters_t *i_this, const uint32_t *i_counts)
+{
+    const uint32_t rowSize = FSM_EVENT_COUNT;
+    for (uint32_t s = 0; s < i_this->statesCount; s++)
+    {
+        const uint32_t *row = &i_counts[s * (1u + 2u * rowSize)];
+        for (uint32_t e = 0; e < rowSize; e++)
+        {
+            fsm_trace_count_t count;
+            assert(fsm_trace_get_count(i_this, s, (fsm_event_t)e, &count) == FSM_RC_OK);
+            assert(count.stateHits == row[0]);
+            assert(count.transitionHits == row[1u + e]);
+            assert(count.guardRejects == row[1u + rowSize + e]);
+        }
+    }
+}
+
+int main(void)
+{
+    enum
+    {
+        MAIN_COUNTS = FSM_TRACE_COUNTERS_SIZE(3u, FSM_EVENT_COUNT),
+        SUB_COUNTS = FSM_TRACE_COUNTERS_SIZE(2u, FSM_EVENT_COUNT),
+        FLAT_COUNTS = FSM_TRACE_COUNTERS_SIZE(2u, FSM_EVENT_COUNT),
+    };
+
+    static atomic_uint mainCounts[MAIN_COUNTS];
+    static atomic_uint subCounts[SUB_COUNTS];
+    static atomic_uint flatCounts[FLAT_COUNTS];
+    static atomic_uint imageCounts[FLAT_COUNTS];
+    fsm_trace_counters_t mainCounters;
+    fsm_trace_counters_t subCounters;
+    fsm_trace_counters_t flatCounters;
+    fsm_trace_counters_t imageCounters;
+    fsm_trace_record_t records[2u * RING];
+    fsm_t fsm;
+
+    assert(fsm_cfg_prepare(&fsmMainCfg) == FSM_RC_OK);
+    assert(fsm_cfg_prepare(&fsmSubCfg) == FSM_RC_OK);
+    assert(fsm_cfg_prepare(&fsmFlatCfg) == FSM_RC_OK);
+    assert(fsm_trace_counters_register(&mainCounters, &fsmMainCfg, mainCounts, MAIN_COUNTS - 1u) ==
+           FSM_RC_ERROR_INVALID_ARG);
+    assert(fsm_trace_counters_register(&mainCounters, &fsmMainCfg, mainCounts, MAIN_COUNTS) == FSM_RC_OK);
+    assert(fsm_trace_counters_register(&subCounters, &fsmSubCfg, subCounts, SUB_COUNTS) == FSM_RC_OK);
+
+    /* The records of a short run, sub configuration records follow their main record */
+    {
+        static const fsm_event_t events[] = {
+            FSM_EVENT_1, FSM_EVENT_2, FSM_EVENT_1, FSM_EVENT_1, FSM_EVENT_3,
+            FSM_EVENT_2, FSM_EVENT_3, FSM_EVENT_2, FSM_EVENT_1, FSM_EVENT_3,
+        };
+        static const fsm_trace_record_t expected[] = {
+            {0, 0, FSM_STATE_MAIN_1, FSM_EVENT_1, FSM_STATE_MAIN_1, FSM_TRACE_NO_GUARD},
+            {0, 0, FSM_STATE_MAIN_1, FSM_EVENT_2, FSM_STATE_MAIN_2, FSM_TRACE_NO_GUARD},
+            {0, 0, FSM_STATE_MAIN_2, FSM_EVENT_1, FSM_STATE_MAIN_2, FSM_TRACE_GUARD_REJECTED},
+            {0, 0, FSM_STATE_MAIN_2, FSM_EVENT_1, FSM_STATE_MAIN_1, FSM_TRACE_GUARD_PASSED},
+            {0, 0, FSM_STATE_MAIN_1, FSM_EVENT_3, FSM_STATE_MAIN_1, FSM_TRACE_NO_TRANSITION},
+            {0, 0, FSM_STATE_MAIN_1, FSM_EVENT_2, FSM_STATE_MAIN_2, FSM_TRACE_NO_GUARD},
+            {0, 0, FSM_STATE_MAIN_2, FSM_EVENT_3, FSM_STATE_MAIN_SUB, FSM_TRACE_NO_GUARD},
+            {0, 0, FSM_STATE_SUB_1, FSM_EVENT_3, FSM_STATE_SUB_1, FSM_TRACE_NO_TRANSITION},
+            {0, 0, FSM_STATE_MAIN_SUB, FSM_EVENT_2, FSM_STATE_MAIN_SUB, FSM_TRACE_NO_TRANSITION},
+            {0, 0, FSM_STATE_SUB_1, FSM_EVENT_2, FSM_STATE_SUB_2, FSM_TRACE_NO_GUARD},
+            {0, 0, FSM_STATE_MAIN_SUB, FSM_EVENT_1, FSM_STATE_MAIN_SUB, FSM_TRACE_NO_TRANSITION},
+            {0, 0, FSM_STATE_SUB_2, FSM_EVENT_1, FSM_STATE_SUB_1, FSM_TRACE_NO_GUARD},
+            {0, 0, FSM_STATE_MAIN_SUB, FSM_EVENT_3, FSM_STATE_MAIN_2, FSM_TRACE_NO_GUARD},
+        };
+        const size_t expectedCount = sizeof(expected) / sizeof(expected[0]);
+
+        assert(fsm_init(&fsm, &fsmMainCfg) == FSM_RC_OK);
+        fsm_trace_reset_ring();
+        assert(fsm_trace_copy_ring(records, 2u * RING) == 0);
+        for (uint32_t i = 0; i < sizeof(events) / sizeof(events[0]); i++)
+        {
+            assert(fsm_process(&fsm, events[i]) == FSM_RC_OK);
+        }
+
+        assert(fsm_trace_copy_ring(records, 2u * RING) == expectedCount);
+        for (size_t i = 0; i < expectedCount; i++)
+        {
+            assert(records[i].instance == (uintptr_t)&fsm);
+            assert(records[i].fromState == expected[i].fromState);
+            assert(records[i].event == expected[i].event);
+            assert(records[i].toState == expected[i].toState);
+            assert(records[i].guard == expected[i].guard);
+            assert(i == 0 || records[i].timestamp >= records[i - 1u].timestamp);
+        }
+    }
+
+    /* Every configuration is counted in its own block, like its records */
+    {
+        static uint32_t expectedMain[MAIN_COUNTS];
+        static uint32_t expectedSub[SUB_COUNTS];
+        fsm_trace_reset_counters();
+        assertCounts(&mainCounters, expectedMain);
+        assertCounts(&subCounters, expectedSub);
+
+        assert(fsm_init(&fsm, &fsmMainCfg) == FSM_RC_OK);
+        for (uint32_t s = 0; s < STEPS; s++)
+        {
+            fsm_trace_reset_ring();
+            assert(fsm_process(&fsm, eventOf(s)) == FSM_RC_OK);
+            size_t count = fsm_trace_copy_ring(records, 2u * RING);
+            assert(count == 1u || count == 2u);
+            countRecords(&fsmMainCfg, records, 1u, expectedMain);
+            countRecords(&fsmSubCfg, &records[1], count - 1u, expectedSub);
+        }
+        assertCounts(&mainCounters, expectedMain);
+        assertCounts(&subCounters, expectedSub);
+
+        fsm_trace_count_t count;
+        assert(fsm_trace_get_count(&mainCounters, 3u, FSM_EVENT_1, &count) == FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_trace_get_count(&mainCounters, 0u, FSM_EVENT_COUNT, &count) == FSM_RC_ERROR_INVALID_ARG);
+    }
+
+    /* The ring keeps the newest records when it wraps, oldest first */
+    {
+        static fsm_trace_record_t history[3u * RING];
+        fsm_t flat;
+        assert(fsm_init(&flat, &fsmFlatCfg) == FSM_RC_OK);
+        fsm_trace_reset_ring();
+        for (uint32_t s = 0; s < 3u * RING; s++)
+        {
+            fsm_state_t fromState = flat.currentState;
+            assert(fsm_process(&flat, eventOf(s)) == FSM_RC_OK);
+            history[s] = (fsm_trace_record_t){0, (uintptr_t)&flat, fromState, eventOf(s), flat.currentState, 0};
+        }
+
+        assert(fsm_trace_copy_ring(records, 2u * RING) == RING);
+        for (uint32_t i = 0; i < RING; i++)
+        {
+            const fsm_trace_record_t *expected = &history[2u * RING + i];
+            assert(records[i].instance == expected->instance);
+            assert(records[i].fromState == expected->fromState);
+            assert(records[i].event == expected->event);
+            assert(records[i].toState == expected->toState);
+        }
+        assert(fsm_trace_copy_ring(records, 4u) == 4u);
+        for (uint32_t i = 0; i < 4u; i++)
+        {
+            assert(records[i].event == history[3u * RING - 4u + i].event);
+            assert(records[i].fromState == history[3u * RING - 4u + i].fromState);
+        }
+    }
+
+    /* Pool instances are recorded by index, an image has its own block */
+    {
+        static uint32_t expectedFlat[FLAT_COUNTS];
+        static uint32_t expectedImage[FLAT_COUNTS];
+        static uint32_t imageBuffer[256];
+        fsm_index_t stateIndex[8];
+        uint32_t firstRunBits[FSM_POOL_FIRST_RUN_WORDS(8)];
+        fsm_pool_t pool;
+        fsm_image_t image;
+        fsm_image_fsm_t imageFsm;
+        size_t imageSize = 0;
+
+        assert(fsm_trace_counters_register(&flatCounters, &fsmFlatCfg, flatCounts, FLAT_COUNTS) == FSM_RC_OK);
+        assert(fsm_image_write(&fsmFlatCfg, NULL, 0, imageBuffer, sizeof(imageBuffer), &imageSize) == FSM_RC_OK);
+        assert(fsm_image_load(&image, imageBuffer, imageSize, NULL, 0) == FSM_RC_OK);
+        assert(fsm_trace_counters_register_image(&imageCounters, &image, imageCounts, FLAT_COUNTS - 1u) ==
+               FSM_RC_ERROR_INVALID_ARG);
+        assert(fsm_trace_counters_register_image(&imageCounters, &image, imageCounts, FLAT_COUNTS) == FSM_RC_OK);
+        assert(fsm_pool_init(&pool, &fsmFlatCfg, stateIndex, firstRunBits, 8) == FSM_RC_OK);
+        assert(fsm_image_fsm_init(&imageFsm, &image) == FSM_RC_OK);
+
+        for (uint32_t s = 0; s < STEPS; s++)
+        {
+            fsm_trace_reset_ring();
+            assert(fsm_pool_process(&pool, s % 8u, eventOf(s)) == FSM_RC_OK);
+            assert(fsm_trace_copy_ring(records, 2u * RING) == 1u);
+            assert(records[0].instance == s % 8u);
+            countRecords(&fsmFlatCfg, records, 1u, expectedFlat);
+
+            fsm_trace_reset_ring();
+            assert(fsm_image_fsm_process(&imageFsm, eventOf(s)) == FSM_RC_OK);
+            assert(fsm_trace_copy_ring(records, 2u * RING) == 1u);
+            assert(records[0].instance == (uintptr_t)&imageFsm);
+            countRecords(&fsmFlatCfg, records, 1u, expectedImage);
+        }
+        assertCounts(&flatCounters, expectedFlat);
+        assertCounts(&imageCounters, expectedImage);
+
+        /* Reset sets every block to zero */
+        static const uint32_t zeros[MAIN_COUNTS];
+        fsm_trace_reset_counters();
+        assertCounts(&mainCounters, zeros);
+        assertCounts(&subCounters, zeros);
+        assertCounts(&flatCounters, zeros);
+        assertCounts(&imageCounters, zeros);
+    }
+
+    /* Without a block the events are only recorded in the ring */
+    {
+        static const uint32_t zeros[MAIN_COUNTS];
+        fsm_trace_counters_clear();
+        assert(fsm_init(&fsm, &fsmMainCfg) == FSM_RC_OK);
+        fsm_trace_reset_ring();
+        for (uint32_t s = 0; s < 8u; s++)
+        {
+            assert(fsm_process(&fsm, eventOf(s)) == FSM_RC_OK);
+        }
+        assert(fsm_trace_copy_ring(records, 2u * RING) >= 8u);
+        assertCounts(&mainCounters, zeros);
+        assertCounts(&subCounters, zeros);
+    }
+
+    printf("fsm_trace_test: passed\n");
+    return 0;
+}
+
+static bool toggleGuard(fsm_arg_t i_arg)
+{
+    (void)i_arg;
+    return (guardCalls++ % 2u) == 1u;
+}